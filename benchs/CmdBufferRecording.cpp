@@ -0,0 +1,105 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/device/Device.h>
+#include <yave/graphics/commands/CmdBufferRecorder.h>
+#include <yave/graphics/commands/RecordedCmdBuffer.h>
+#include <yave/graphics/framebuffer/Framebuffer.h>
+#include <yave/graphics/descriptors/DescriptorSet.h>
+#include <yave/graphics/images/Image.h>
+
+#include <y/concurrent/WorkStealingThreadPool.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+#include <limits>
+
+namespace {
+using namespace yave;
+
+static constexpr usize draw_count = 64 * 1024;
+static constexpr usize draws_per_bind = 16;
+static constexpr usize iterations = 8;
+static constexpr usize max_thread_count = 16;
+
+static void record_draws(RenderPassRecorder& render_pass, const DescriptorSet& descriptor_set, usize count) {
+	const MaterialTemplate* material = render_pass.device()->device_resources()[DeviceResources::ScreenPassthroughMaterialTemplate];
+	for(usize i = 0; i != count; ++i) {
+		if(i % draws_per_bind == 0) {
+			render_pass.bind_material(material, {descriptor_set});
+		}
+		render_pass.draw_array(3);
+	}
+}
+
+// Returns the best CPU recording time in ms, recording is not timed past the last vkCmdExecuteCommands
+template<typename F>
+static double bench_recording(DevicePtr dptr, F&& record) {
+	double best = std::numeric_limits<double>::max();
+	for(usize i = 0; i != iterations; ++i) {
+		CmdBufferRecorder recorder(dptr->create_disposable_cmd_buffer());
+		{
+			core::Chrono chrono;
+			record(recorder);
+			best = std::min(best, chrono.elapsed().to_millis());
+		}
+		dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+	}
+	return best;
+}
+
+y_bench_func("Secondary command buffer recording") {
+	Instance instance(DebugParams::none());
+	const Device device(instance);
+	DevicePtr dptr = &device;
+
+	const ColorAttachment image(dptr, VK_FORMAT_R8G8B8A8_UNORM, math::Vec2ui(256, 256));
+	const std::array<ColorAttachmentView, 1> views = {image};
+	const Framebuffer framebuffer(dptr, views);
+	const DescriptorSet descriptor_set(dptr, {Descriptor(*device.device_resources()[DeviceResources::WhiteTexture])});
+
+	const double inline_ms = bench_recording(dptr, [&](CmdBufferRecorder& recorder) {
+		auto render_pass = recorder.bind_framebuffer(framebuffer);
+		record_draws(render_pass, descriptor_set, draw_count);
+	});
+	log_msg(fmt("    % draws inline: % ms", draw_count, inline_ms), Log::Perf);
+
+	for(usize thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+		concurrent::WorkStealingThreadPool thread_pool(thread_count, "Recording thread");
+		const double ms = bench_recording(dptr, [&](CmdBufferRecorder& recorder) {
+			auto secondaries = std::make_unique<SecondaryCmdBufferRecorder[]>(thread_count);
+			thread_pool.parallel_for(thread_count, 1, [&](usize begin, usize end) {
+				for(usize i = begin; i != end; ++i) {
+					secondaries[i] = SecondaryCmdBufferRecorder(dptr->create_secondary_cmd_buffer(), framebuffer);
+					auto render_pass = secondaries[i].render_pass();
+					record_draws(render_pass, descriptor_set, draw_count / thread_count);
+				}
+			});
+			recorder.execute(framebuffer, core::MutableSpan<SecondaryCmdBufferRecorder>(secondaries.get(), thread_count));
+		});
+		log_msg(fmt("    % draws in % secondaries: % ms (%x)", draw_count, thread_count, ms, inline_ms / ms), Log::Perf);
+	}
+}
+
+}
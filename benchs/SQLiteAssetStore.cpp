@@ -0,0 +1,120 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/assets/SQLiteAssetStore.h>
+#include <yave/utils/FileSystemModel.h>
+
+#include <y/io2/Buffer.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+#include <thread>
+#include <cstdio>
+
+#ifndef YAVE_NO_SQLITE
+
+namespace {
+using namespace yave;
+
+static constexpr usize asset_count = 1000;
+static constexpr usize lookup_count = 100000;
+static constexpr usize thread_count = 4;
+
+static const char* store_filename = "bench_store.sqlite3";
+
+static core::String asset_name(usize i) {
+	return fmt("bench_folder_%/asset_%", i % 16, i);
+}
+
+static void fill_store(SQLiteAssetStore& store, core::Vector<AssetId>& ids) {
+	core::Vector<u8> data(1024, u8(0xAB));
+	for(usize i = 0; i != asset_count; ++i) {
+		io2::Buffer buffer;
+		buffer.write(data.data(), data.size()).unwrap();
+		buffer.reset();
+		ids << store.import(buffer, asset_name(i), AssetType::Unknown).unwrap();
+	}
+}
+
+template<typename F>
+static void bench_lookup(const char* name, F&& func) {
+	core::Chrono chrono;
+	for(usize i = 0; i != lookup_count; ++i) {
+		func(i % asset_count);
+	}
+	const double micros = chrono.elapsed().to_micros();
+	log_msg(fmt("    %: % lookups/s", name, usize(double(lookup_count) / micros * 1000000.0)), Log::Perf);
+}
+
+y_bench_func("SQLiteAssetStore lookups") {
+	std::remove(store_filename);
+
+	{
+		SQLiteAssetStore store(store_filename);
+
+		core::Vector<AssetId> ids;
+		fill_store(store, ids);
+
+		core::Vector<core::String> names;
+		for(usize i = 0; i != asset_count; ++i) {
+			names << asset_name(i);
+		}
+
+		bench_lookup("id(name)", [&](usize i) { store.id(names[i]).unwrap(); });
+		bench_lookup("name(id)", [&](usize i) { store.name(ids[i]).unwrap(); });
+		bench_lookup("asset_type(id)", [&](usize i) { store.asset_type(ids[i]).unwrap(); });
+		bench_lookup("exists(name)", [&](usize i) { store.filesystem()->exists(names[i]).unwrap(); });
+
+		core::Vector<u8> data;
+		bench_lookup("data(id)", [&](usize i) {
+			data.make_empty();
+			store.data(ids[i]).unwrap()->read_all(data).unwrap();
+		});
+
+		{
+			core::Chrono chrono;
+			core::Vector<std::thread> threads;
+			for(usize t = 0; t != thread_count; ++t) {
+				threads.emplace_back([&, t] {
+					core::Vector<u8> thread_data;
+					for(usize i = t; i < lookup_count; i += thread_count) {
+						thread_data.make_empty();
+						store.data(ids[i % asset_count]).unwrap()->read_all(thread_data).unwrap();
+					}
+				});
+			}
+			for(auto& thread : threads) {
+				thread.join();
+			}
+			const double micros = chrono.elapsed().to_micros();
+			log_msg(fmt("    data(id) on % threads: % lookups/s", thread_count, usize(double(lookup_count) / micros * 1000000.0)), Log::Perf);
+		}
+	}
+
+	std::remove(store_filename);
+}
+
+}
+
+#endif
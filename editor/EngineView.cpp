@@ -34,7 +34,7 @@ namespace editor {
 EngineView::EngineView(ContextPtr cptr) :
 		Widget(ICON_FA_DESKTOP " Engine View", ImGuiWindowFlags_MenuBar),
 		ContextLinked(cptr),
-		_resource_pool(std::make_shared<FrameGraphResourcePool>(device())),
+		_resource_pool(context()->resource_pool()),
 		_ibl_probe(device()->device_resources().empty_probe()),
 		_scene_view(&context()->world()),
 		_camera_controller(std::make_unique<HoudiniCameraController>(context())),
@@ -80,6 +80,7 @@ void EngineView::draw(CmdBufferRecorder& recorder) {
 		builder.add_uniform_input(renderer.color, 0, PipelineStage::FragmentBit);
 		builder.add_uniform_input(buffer);
 		builder.map_update(buffer);
+		builder.set_has_side_effects();
 		builder.set_render_func([=, index = u32(_view), &output](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
 				auto out = std::make_unique<TextureView>(self->resources().image<ImageUsage::TextureBit>(output_image));
 				output = out.get();
@@ -179,7 +180,10 @@ void EngineView::update_picking() {
 		return;
 	}
 
-	const auto picking_data = context()->picking_manager().pick_sync(_scene_view, uv, viewport_size);
+	// Editor entities and skinned meshes are only visible to the GPU picking pass
+	const auto picking_data = (_cpu_picking && !_settings.enable_editor_entities)
+		? context()->picking_manager().pick_ray(_scene_view, uv)
+		: context()->picking_manager().pick_sync(_scene_view, uv, viewport_size);
 	if(_camera_controller && _camera_controller->viewport_clicked(picking_data)) {
 		// event has been eaten by the camera controller, don't proceed further
 		_gizmo.set_allow_drag(false);
@@ -200,6 +204,11 @@ void EngineView::draw_menu_bar() {
 
 		if(ImGui::BeginMenu("Render")) {
 			ImGui::MenuItem("Editor entities", nullptr, &_settings.enable_editor_entities);
+			ImGui::MenuItem("CPU picking", nullptr, &_cpu_picking);
+			ImGui::MenuItem("Indirect draws", nullptr, &_settings.renderer_settings.scene.use_indirect);
+			if(ImGui::MenuItem("Parallel recording", nullptr, &_settings.renderer_settings.scene.parallel_recording)) {
+				_settings.renderer_settings.shadow_map.parallel_recording = _settings.renderer_settings.scene.parallel_recording;
+			}
 
 			ImGui::Separator();
 			if(ImGui::BeginMenu("Tone mapping")) {
@@ -84,6 +84,7 @@ class EngineView final : public Widget, public ContextLinked {
 		Gizmo _gizmo;
 
 		bool _disable_render = false;
+		bool _cpu_picking = false;
 };
 
 static_assert(!std::is_move_assignable_v<EngineView>);
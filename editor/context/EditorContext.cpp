@@ -28,6 +28,9 @@ SOFTWARE.
 
 #include <editor/components/EditorComponent.h>
 
+#include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+
 #include <y/io2/File.h>
 
 #include <thread>
@@ -46,9 +49,10 @@ static constexpr std::string_view store_dir = "../store";
 EditorContext::EditorContext(DevicePtr dptr) :
 		DeviceLinked(dptr),
 		_resources(dptr),
+		_resource_pool(std::make_shared<FrameGraphResourcePool>(dptr)),
 		_asset_store(std::make_shared<SQLiteAssetStore>(store_file)),
 		//_asset_store(std::make_shared<FolderAssetStore>(store_dir)),
-		_loader(device(), _asset_store, AssetLoadingFlags::SkipFailedDependenciesBit),
+		_loader(device(), _asset_store, AssetLoadingFlags::SkipFailedDependenciesBit | AssetLoadingFlags::KeepCpuGeometryBit),
 		_scene_view(&_default_scene_view),
 		_ui(this),
 		_notifs(this),
@@ -56,6 +60,9 @@ EditorContext::EditorContext(DevicePtr dptr) :
 		_picking_manager(this),
 		_world(create_editor_world()) {
 
+	_world_systems.schedule("spatial index", ecs::ComponentAccess().read<TransformableComponent, StaticMeshComponent>(), [this](const ecs::EntityWorld& world) {
+		_spatial_index.update(world);
+	});
 
 	load_world();
 }
@@ -117,6 +124,7 @@ void EditorContext::flush_deferred() {
 		_is_flushing_deferred = false;
 	}
 	_world.flush();
+	_world_systems.run(_world);
 
 	if(_perf_capture_frames) {
 		if(perf::is_capturing()) {
@@ -161,6 +169,10 @@ ecs::EntityWorld& EditorContext::world() {
 	return _world;
 }
 
+const SpatialIndex& EditorContext::spatial_index() const {
+	return _spatial_index;
+}
+
 const FileSystemModel* EditorContext::filesystem() const {
 	return _filesystem.get() ? _filesystem.get() : FileSystemModel::local_filesystem();
 }
@@ -173,6 +185,10 @@ EditorResources& EditorContext::resources() {
 	return _resources;
 }
 
+const std::shared_ptr<FrameGraphResourcePool>& EditorContext::resource_pool() const {
+	return _resource_pool;
+}
+
 EditorState& EditorContext::editor_state() {
 	return _editor_state;
 }
@@ -245,11 +261,13 @@ void EditorContext::load_world() {
 	}
 
 	_world = std::move(world);
+	_spatial_index.clear();
 	y_debug_assert(_world.required_component_types().size() == 1);
 }
 
 void EditorContext::new_world() {
 	_world = create_editor_world();
+	_spatial_index.clear();
 }
 
 ecs::EntityWorld EditorContext::create_editor_world() {
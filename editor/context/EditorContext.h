@@ -23,6 +23,8 @@ SOFTWARE.
 #define EDITOR_CONTEXT_EDITORCONTEXT_H
 
 #include <yave/ecs/EntityWorld.h>
+#include <yave/ecs/SystemScheduler.h>
+#include <yave/scene/SpatialIndex.h>
 
 #include "EditorState.h"
 #include "Settings.h"
@@ -68,12 +70,15 @@ class EditorContext : NonMovable, public DeviceLinked {
 		SceneView& default_scene_view();
 
 		ecs::EntityWorld& world();
+		const SpatialIndex& spatial_index() const;
 
 		const FileSystemModel* filesystem() const;
 
 		const EditorResources& resources() const;
 		EditorResources& resources();
 
+		const std::shared_ptr<FrameGraphResourcePool>& resource_pool() const;
+
 		EditorState& editor_state();
 		Settings& settings();
 		Selection& selection();
@@ -121,6 +126,10 @@ class EditorContext : NonMovable, public DeviceLinked {
 		PickingManager _picking_manager;
 
 		ecs::EntityWorld _world;
+		SpatialIndex _spatial_index;
+
+		// Per frame systems, run after deferred functions and world flush
+		ecs::SystemScheduler _world_systems;
 
 		bool _reload_resources = false;
 		usize _perf_capture_frames = 0;
@@ -82,4 +82,29 @@ PickingManager::PickingData PickingManager::pick_sync(const SceneView& scene_vie
 	return data;
 }
 
+PickingManager::PickingData PickingManager::pick_ray(const SceneView& scene_view, const math::Vec2& uv) const {
+	y_profile();
+
+	const Camera& camera = scene_view.camera();
+	const math::Vec3 origin = camera.position();
+
+	const math::Vec4 p = camera.inverse_matrix() * math::Vec4(uv * 2.0f - 1.0f, 0.5f, 1.0f);
+	const math::Vec3 direction = (p.to<3>() / p.w() - origin).normalized();
+
+	const auto hit = context()->spatial_index().raycast(origin, direction);
+	if(!hit) {
+		return PickingData{origin, 0.0f, uv, u32(-1)};
+	}
+
+	const math::Vec3 world_pos = origin + direction * hit.unwrap().distance;
+	const math::Vec4 proj = camera.viewproj_matrix() * math::Vec4(world_pos, 1.0f);
+
+	return PickingData{
+			world_pos,
+			proj.z() / proj.w(),
+			uv,
+			hit.unwrap().index
+		};
+}
+
 }
@@ -48,6 +48,10 @@ class PickingManager : public ContextLinked {
 
 		PickingData pick_sync(const SceneView& scene_view, const math::Vec2& uv, const math::Vec2ui& size = math::Vec2ui(512));
 
+		// Picks against the mesh triangles of the context's spatial index, without any GPU work
+		// Only static meshes can be picked this way, pick_sync remains the default
+		PickingData pick_ray(const SceneView& scene_view, const math::Vec2& uv) const;
+
 	private:
 		ReadBackBuffer _buffer;
 };
@@ -159,7 +159,7 @@ void ThumbmailCache::request_thumbmail(AssetId id) {
 	switch(asset_type) {
 		case AssetType::Mesh:
 			_render_thread.schedule([id, this] {
-				if(const auto& mesh = context()->loader().load<StaticMesh>(id); !mesh.is_failed()) {
+				if(const auto& mesh = context()->loader().load<StaticMesh>(id, AssetLoadingPriority::Background); !mesh.is_failed()) {
 					CmdBufferRecorder rec = device()->create_disposable_cmd_buffer();
 					submit_and_set(rec, render_thumbmail(rec, id, mesh, device()->device_resources()[DeviceResources::EmptyMaterial]));
 				} else {
@@ -170,7 +170,7 @@ void ThumbmailCache::request_thumbmail(AssetId id) {
 
 		case AssetType::Material:
 			_render_thread.schedule([id, this] {
-				if(const auto& material = context()->loader().load<Material>(id); !material.is_failed()) {
+				if(const auto& material = context()->loader().load<Material>(id, AssetLoadingPriority::Background); !material.is_failed()) {
 					CmdBufferRecorder rec = device()->create_disposable_cmd_buffer();
 					submit_and_set(rec, render_thumbmail(rec, id, device()->device_resources()[DeviceResources::SphereMesh], material));
 				} else {
@@ -181,7 +181,7 @@ void ThumbmailCache::request_thumbmail(AssetId id) {
 
 		case AssetType::Image:
 			_render_thread.schedule([id, this] {
-				if(const auto& texture = context()->loader().load<Texture>(id); !texture.is_failed()) {
+				if(const auto& texture = context()->loader().load<Texture>(id, AssetLoadingPriority::Background); !texture.is_failed()) {
 					CmdBufferRecorder rec = device()->create_disposable_cmd_buffer();
 					submit_and_set(rec, render_thumbmail(rec, texture));
 				} else {
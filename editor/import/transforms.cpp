@@ -22,6 +22,8 @@ SOFTWARE.
 
 #include "transforms.h"
 
+#include <y/math/batch.h>
+
 #include <y/utils/log.h>
 #include <y/utils/perf.h>
 
@@ -33,24 +35,6 @@ static core::Vector<T> copy(core::Span<T> t) {
 	return core::Vector<T>(t);
 }
 
-static math::Vec3 h_transform(const math::Vec3& v, const math::Transform<>& tr) {
-	const auto h = tr * math::Vec4(v, 1.0f);
-	return h.to<3>() / h.w();
-}
-
-static math::Vec3 transform(const math::Vec3& v, const math::Transform<>& tr) {
-	return tr.to<3, 3>() * v;
-}
-
-static Vertex transform(const Vertex& v, const math::Transform<>& tr) {
-	return Vertex {
-			h_transform(v.position, tr),
-			transform(v.normal, tr).normalized(),
-			transform(v.tangent, tr).normalized(),
-			v.uv
-		};
-}
-
 static BoneTransform transform(const BoneTransform& bone, const math::Transform<>& tr) {
 	auto [pos, rot, scale] = tr.decompose();
 	return BoneTransform {
@@ -63,8 +47,16 @@ static BoneTransform transform(const BoneTransform& bone, const math::Transform<
 
 MeshData transform(const MeshData& mesh, const math::Transform<>& tr) {
 	y_profile();
-	auto vertices = core::vector_with_capacity<Vertex>(mesh.vertices().size());
-	std::transform(mesh.vertices().begin(), mesh.vertices().end(), std::back_inserter(vertices), [=](const auto& vert) { return transform(vert, tr); });
+	core::Vector<Vertex> vertices = copy(mesh.vertices());
+	if(!vertices.is_empty()) {
+		math::transform_points(tr, &vertices[0].position, vertices.size(), sizeof(Vertex));
+		math::transform_vectors(tr, &vertices[0].normal, vertices.size(), sizeof(Vertex));
+		math::transform_vectors(tr, &vertices[0].tangent, vertices.size(), sizeof(Vertex));
+		for(Vertex& v : vertices) {
+			v.normal.normalize();
+			v.tangent.normalize();
+		}
+	}
 
 	if(mesh.has_skeleton()) {
 		auto bones = core::vector_with_capacity<Bone>(mesh.bones().size());
@@ -121,6 +121,8 @@ int main(int argc, char** argv) {
 
 
 	Device device = create_device(instance);
+	device.device_resources().precompile_material_templates();
+
 	EditorContext ctx = create_context(device);
 	context = &ctx;
 
@@ -144,9 +146,11 @@ int main(int argc, char** argv) {
 		if(swapchain && swapchain->is_valid()) {
 			FrameToken frame = swapchain->next_frame();
 			CmdBufferRecorder recorder(device.create_disposable_cmd_buffer());
+			device.gpu_profiler().begin(recorder);
 
 			ctx.ui().paint(recorder, frame);
 
+			device.gpu_profiler().end(recorder);
 			window.present(recorder, frame);
 		}
 
@@ -157,6 +161,8 @@ int main(int argc, char** argv) {
 			ctx.resources().reload();
 			ctx.set_device_resource_reloaded();
 		}
+
+		device.pipeline_cache().save_if_outdated();
 	}
 
 
@@ -23,12 +23,10 @@ SOFTWARE.
 #include "ScenePickingPass.h"
 
 #include <yave/framegraph/FrameGraph.h>
-
-#include <yave/ecs/EntityWorld.h>
+#include <yave/scene/FrustumCulling.h>
 
 #include <yave/components/TransformableComponent.h>
 #include <yave/components/StaticMeshComponent.h>
-#include <yave/entities/entities.h>
 
 #include <editor/context/EditorContext.h>
 
@@ -46,8 +44,6 @@ static usize render_world(ContextPtr ctx,
 						  usize index = 0) {
 	y_profile();
 
-	const ecs::EntityWorld& world = scene_view.world();
-
 	auto camera_mapping = pass->resources().mapped_buffer(camera_buffer);
 	camera_mapping[0] = scene_view.camera();
 
@@ -60,11 +56,10 @@ static usize render_world(ContextPtr ctx,
 	recorder.bind_attrib_buffers({}, {transforms, ids});
 	recorder.bind_material(ctx->resources()[EditorResources::PickingMaterialTemplate], {pass->descriptor_sets()[0]});
 
-	for(auto ent : world.view(StaticMeshArchetype())) {
-		const auto& [tr, mesh] = ent.components();
-		transform_mapping[index] = tr.transform();
-		id_mapping[index] = ent.index();
-		mesh.render_mesh(recorder, u32(index));
+	for(const VisibleStaticMesh& visible : cull_static_meshes(scene_view)) {
+		transform_mapping[index] = visible.transform->transform();
+		id_mapping[index] = visible.index;
+		visible.mesh->render_mesh(recorder, u32(index));
 		++index;
 	}
 
@@ -37,10 +37,17 @@ SOFTWARE.
 #include <editor/properties/PropertyPanel.h>
 #include <editor/EngineView.h>
 
+#include <yave/assets/BundleAssetStore.h>
+
 #include <imgui/yave_imgui.h>
 
 namespace editor {
 
+static constexpr const char* flight_recorder_file = "../flightrecorder.json";
+static constexpr double flight_recorder_seconds = 10.0;
+
+static constexpr const char* asset_bundle_file = "../assets.bundle";
+
 MenuBar::MenuBar(ContextPtr ctx) : UiElement("Menu bar"), ContextLinked(ctx) {
 }
 
@@ -101,6 +108,22 @@ void MenuBar::paint(CmdBufferRecorder&, const FrameToken&) {
 
 		if(ImGui::BeginMenu("Tools")) {
 			if(ImGui::MenuItem("Reload resources")) context()->reload_device_resources();
+
+			if(ImGui::MenuItem("Pack asset bundle")) {
+				if(!BundleAssetStore::pack(context()->asset_store(), asset_bundle_file)) {
+					log_msg("Unable to pack asset bundle", Log::Error);
+				}
+			}
+
+#ifdef Y_PERF_LOG_ENABLED
+			ImGui::Separator();
+			if(perf::is_flight_recorder_running()) {
+				if(ImGui::MenuItem("Dump flight recorder")) perf::dump_flight_recorder(flight_recorder_file);
+				if(ImGui::MenuItem("Stop flight recorder")) perf::stop_flight_recorder();
+			} else {
+				if(ImGui::MenuItem("Start flight recorder")) perf::start_flight_recorder(flight_recorder_seconds, flight_recorder_file);
+			}
+#endif
 			ImGui::EndMenu();
 		}
 
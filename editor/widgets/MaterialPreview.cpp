@@ -144,6 +144,7 @@ void MaterialPreview::paint_ui(CmdBufferRecorder& recorder, const FrameToken&) {
 		FrameGraphPassBuilder builder = graph.add_pass("ImGui texture pass");
 
 		const auto output_image = builder.declare_copy(renderer.lighting.lit);
+		builder.set_has_side_effects();
 		builder.set_render_func([=, &output](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
 				auto out = std::make_unique<TextureView>(self->resources().image<ImageUsage::TextureBit>(output_image));
 				output = out.get();
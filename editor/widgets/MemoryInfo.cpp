@@ -54,13 +54,16 @@ void MemoryInfo::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 		ImGui::BulletText(fmt_c_str("Heap [%]", memory_type_name(type.second)));
 		ImGui::Indent();
 		for(const auto& heap : heaps) {
-			usize free = heap->available();
-			const usize used = heap->size() - free;
+			const auto stats = heap->stats();
+			const usize used = stats.allocated;
 			total_used += used;
 			total_allocated += heap->size();
 
 			ImGui::ProgressBar(used / float(heap->size()), ImVec2(0, 0), fmt_c_str("%KB / %KB", to_kb(used), to_kb(heap->size())));
-			ImGui::Text("Free blocks: %u", unsigned(heap->free_blocks()));
+			ImGui::Text("Allocations: %u", unsigned(stats.allocations));
+			ImGui::Text("Free blocks: %u", unsigned(stats.free_blocks));
+			ImGui::Text("Largest free block: %uKB", unsigned(to_kb(stats.largest_free_block)));
+			ImGui::Text("Fragmentation: %.1f%%", stats.fragmentation() * 100.0f);
 			ImGui::Spacing();
 		}
 		ImGui::Unindent();
@@ -114,6 +117,56 @@ void MemoryInfo::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 
 		ImGui::ProgressBar(used_sets / float(total_sets), ImVec2(0, 0), fmt_c_str("% / % sets", used_sets, total_sets));
 	}
+
+	{
+		ImGui::Spacing();
+		ImGui::Separator();
+
+		MeshAllocator& alloc = device()->mesh_allocator();
+		const MeshAllocator::Stats stats = alloc.stats();
+
+		ImGui::Text("Mesh blocks: %u, %u meshes", u32(stats.blocks), u32(stats.meshes));
+		ImGui::Text("Free ranges: %u, pending uploads: %u", u32(stats.free_ranges), u32(stats.pending_uploads));
+		if(stats.vertex_capacity) {
+			ImGui::ProgressBar(stats.allocated_vertices / float(stats.vertex_capacity), ImVec2(0, 0), fmt_c_str("% / % vertices", stats.allocated_vertices, stats.vertex_capacity));
+			ImGui::ProgressBar(stats.allocated_triangles / float(stats.triangle_capacity), ImVec2(0, 0), fmt_c_str("% / % triangles", stats.allocated_triangles, stats.triangle_capacity));
+		}
+	}
+
+	{
+		ImGui::Spacing();
+		ImGui::Separator();
+
+		const UploadAllocator::Stats stats = device()->upload_allocator().stats();
+		ImGui::Text("Upload chunks: %u (%u in flight), %uKB", u32(stats.chunks), u32(stats.in_flight_chunks), u32(to_kb(stats.total_size)));
+	}
+
+	{
+		ImGui::Spacing();
+		ImGui::Separator();
+
+		const FrameGraphResourcePool::Stats stats = context()->resource_pool()->stats();
+		const auto hit_rate = [](usize hits, usize misses) {
+			return (hits + misses) ? hits * 100.0f / (hits + misses) : 0.0f;
+		};
+
+		ImGui::Text("Frame graph pool: %u images, %u buffers, %u heaps", u32(stats.pooled_images), u32(stats.pooled_buffers), u32(stats.pooled_heaps));
+		ImGui::Text("Image hits: %u, misses: %u (%.1f%%)", u32(stats.image_hits), u32(stats.image_misses), hit_rate(stats.image_hits, stats.image_misses));
+		ImGui::Text("Buffer hits: %u, misses: %u (%.1f%%)", u32(stats.buffer_hits), u32(stats.buffer_misses), hit_rate(stats.buffer_hits, stats.buffer_misses));
+		ImGui::Text("Heap hits: %u, misses: %u (%.1f%%), recycled: %u", u32(stats.heap_hits), u32(stats.heap_misses), hit_rate(stats.heap_hits, stats.heap_misses), u32(stats.heap_recycles));
+		ImGui::Text("Evictions: %u", u32(stats.evictions));
+		ImGui::SetNextItemWidth(-1);
+		ImGui::ProgressBar(stats.pooled_byte_size / float(stats.budget), ImVec2(0, 0), fmt_c_str("%KB / %KB", to_kb(stats.pooled_byte_size), to_kb(stats.budget)));
+
+		if(ImGui::TreeNode("##schedules", "Frame graph schedules: %u", u32(stats.schedules.size()))) {
+			for(const auto& schedule : stats.schedules) {
+				const float saved = schedule.unaliased_byte_size ? 100.0f - schedule.byte_size * 100.0f / schedule.unaliased_byte_size : 0.0f;
+				ImGui::Text("%016llx: %uKB (%uKB unaliased, %.1f%% saved)", static_cast<unsigned long long>(schedule.hash), u32(to_kb(schedule.byte_size)), u32(to_kb(schedule.unaliased_byte_size)), saved);
+				ImGui::Text("    %u / %u passes culled", u32(schedule.culled_pass_count), u32(schedule.pass_count));
+			}
+			ImGui::TreePop();
+		}
+	}
 }
 
 }
@@ -22,7 +22,12 @@ SOFTWARE.
 
 #include "PerformanceMetrics.h"
 
+#include <editor/context/EditorContext.h>
+
 #include <yave/device/Device.h>
+#include <yave/scene/FrustumCulling.h>
+#include <yave/scene/RenderQueue.h>
+#include <yave/assets/AssetLoader.h>
 
 #include <imgui/yave_imgui.h>
 
@@ -66,6 +71,56 @@ void PerformanceMetrics::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 
 	ImGui::Text("%.3u resources waiting deletion", unsigned(device()->lifetime_manager().pending_deletions()));
 	ImGui::Text("%.3u active command buffers", unsigned(device()->lifetime_manager().active_cmd_buffers()));
+
+	const CullingStats culling = flush_culling_stats();
+	ImGui::Text("%.3u meshes drawn, %.3u culled", unsigned(culling.visible), unsigned(culling.culled));
+
+	for(const auto& [name, stats] : flush_render_queue_stats()) {
+		ImGui::Text("%s: %u draws for %u instances", name.data(), unsigned(stats.draws), unsigned(stats.instances));
+		ImGui::Text("    %u pipeline binds, %u descriptor binds, %u buffer binds", unsigned(stats.pipeline_binds), unsigned(stats.descriptor_binds), unsigned(stats.buffer_binds));
+	}
+
+	const AssetLoadingThreadPool::Stats loading = context()->loader().loading_stats();
+	ImGui::Text("Assets queued: %u immediate, %u visible, %u background, %u prefetch",
+		unsigned(loading.queued[0]), unsigned(loading.queued[1]), unsigned(loading.queued[2]), unsigned(loading.queued[3]));
+	ImGui::Text("%.3u assets waiting for dependencies, %.3u waiting for finalization", unsigned(loading.waiting_for_dependencies), unsigned(loading.ready_to_finalize));
+	ImGui::Text("%u loaded, %u failed, %u cancelled", unsigned(loading.loaded), unsigned(loading.failed), unsigned(loading.cancelled));
+	ImGui::Text("Load latency: %.2fms average, %.2fms max", loading.average_latency_ms, loading.max_latency_ms);
+
+	ImGui::Separator();
+
+	GpuProfiler& profiler = device()->gpu_profiler();
+	if(!profiler.is_supported()) {
+		ImGui::TextUnformatted("GPU timestamps are not supported");
+		return;
+	}
+
+	bool gpu_timings = profiler.is_enabled();
+	if(ImGui::Checkbox("GPU timings", &gpu_timings)) {
+		profiler.set_enabled(gpu_timings);
+	}
+
+	if(gpu_timings) {
+		ImGui::Columns(3);
+		ImGui::TextUnformatted("Region");
+		ImGui::NextColumn();
+		ImGui::TextUnformatted("Start");
+		ImGui::NextColumn();
+		ImGui::TextUnformatted("GPU time");
+		ImGui::NextColumn();
+		ImGui::Separator();
+
+		for(const GpuProfiler::Zone& zone : profiler.last_frame()) {
+			ImGui::Text("%*s%s", int(zone.depth * 2), "", zone.name);
+			ImGui::NextColumn();
+			ImGui::Text("%.3fms", zone.begin_ms);
+			ImGui::NextColumn();
+			ImGui::Text("%.3fms", zone.duration_ms);
+			ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+	}
 }
 
 }
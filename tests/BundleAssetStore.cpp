@@ -0,0 +1,126 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/assets/BundleAssetStore.h>
+#include <yave/assets/FolderAssetStore.h>
+#include <yave/utils/FileSystemModel.h>
+
+#include <y/io2/Buffer.h>
+#include <y/io2/File.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static const char* store_folder = "./bundle_test_store";
+static const char* bundle_file = "./bundle_test.yb";
+
+static core::Vector<u8> create_payload(usize size, u8 seed) {
+	core::Vector<u8> payload;
+	for(usize i = 0; i != size; ++i) {
+		payload << u8(i * 7 + seed);
+	}
+	return payload;
+}
+
+static void remove_test_files() {
+	FileSystemModel::local_filesystem()->remove(store_folder).ignore();
+	FileSystemModel::local_filesystem()->remove(bundle_file).ignore();
+}
+
+y_test_func("BundleAssetStore pack and open") {
+	remove_test_files();
+
+	// Crosses the payload alignment, to check that padding is skipped properly
+	const core::Vector<u8> payloads[] = {create_payload(5000, 1), create_payload(13, 2)};
+	const char* names[] = {"meshes/cube", "material"};
+	const AssetType types[] = {AssetType::Mesh, AssetType::Material};
+
+	AssetId ids[2];
+	{
+		FolderAssetStore store(store_folder);
+		for(usize i = 0; i != 2; ++i) {
+			io2::Buffer buffer;
+			y_test_assert(buffer.write(payloads[i].data(), payloads[i].size()));
+			buffer.seek(0);
+
+			const auto id = store.import(buffer, names[i], types[i]);
+			y_test_assert(id);
+			ids[i] = id.unwrap();
+		}
+
+		y_test_assert(BundleAssetStore::pack(store, bundle_file));
+	}
+
+	auto bundle = BundleAssetStore::open(bundle_file);
+	y_test_assert(bundle);
+
+	const BundleAssetStore& store = *bundle.unwrap();
+	y_test_assert(store.asset_count() == 2);
+	y_test_assert(!store.filesystem());
+
+	for(usize i = 0; i != 2; ++i) {
+		const auto name = store.name(ids[i]);
+		y_test_assert(name);
+		y_test_assert(name.unwrap() == names[i]);
+
+		const auto id = store.id(names[i]);
+		y_test_assert(id && id.unwrap() == ids[i]);
+
+		const auto type = store.asset_type(ids[i]);
+		y_test_assert(type && type.unwrap() == types[i]);
+
+		auto data = store.data(ids[i]);
+		y_test_assert(data);
+
+		core::Vector<u8> content;
+		y_test_assert(data.unwrap()->read_all(content));
+		y_test_assert(content.size() == payloads[i].size());
+		y_test_assert(std::equal(content.begin(), content.end(), payloads[i].begin()));
+	}
+
+	y_test_assert(!store.id("missing"));
+	y_test_assert(!store.data(AssetId::from_id(ids[0].id() + ids[1].id() + 1)));
+
+	remove_test_files();
+}
+
+y_test_func("BundleAssetStore invalid bundles") {
+	remove_test_files();
+
+	y_test_assert(!BundleAssetStore::open(bundle_file));
+
+	{
+		auto file = io2::File::create(bundle_file);
+		y_test_assert(file);
+
+		const u32 truncated[] = {0x42564159, 1, 8};
+		y_test_assert(file.unwrap().write_array(truncated, 3));
+		y_test_assert(file.unwrap().flush());
+	}
+	y_test_assert(!BundleAssetStore::open(bundle_file));
+
+	remove_test_files();
+}
+
+}
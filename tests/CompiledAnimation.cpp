@@ -0,0 +1,139 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/animations/CompiledAnimation.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static BoneTransform bone_transform(const math::Vec3& position, float angle, float scale = 1.0f) {
+	return BoneTransform{position, math::Vec3(scale), math::Quaternion<>::from_axis_angle(math::Vec3(0.0f, 0.0f, 1.0f), angle)};
+}
+
+static AnimationChannel create_channel(const char* name, core::Span<float> times) {
+	core::Vector<AnimationChannel::BoneKey> keys;
+	for(usize i = 0; i != times.size(); ++i) {
+		const float f = float(i + 1);
+		keys << AnimationChannel::BoneKey{times[i], bone_transform(math::Vec3(f, -f, 2.0f * f), 0.7f * f, 1.0f + 0.1f * f)};
+	}
+	return AnimationChannel(name, std::move(keys));
+}
+
+// "middle" has no channel and keeps its bind transform, "unused" matches no bone
+// Keys don't start at 0 since the Animation path divides by zero when sampling the last key otherwise
+static Skeleton create_skeleton() {
+	const Bone bones[] = {
+		Bone{"root", u32(-1), bone_transform(math::Vec3(0.0f), 0.0f)},
+		Bone{"middle", 0, bone_transform(math::Vec3(0.0f, 1.0f, 0.0f), 0.3f)},
+		Bone{"tip", 1, bone_transform(math::Vec3(0.0f, 1.0f, 0.0f), -0.2f)},
+	};
+	return Skeleton(bones);
+}
+
+static Animation create_animation() {
+	const float root_times[] = {0.1f, 0.5f, 1.0f};
+	const float tip_times[] = {0.1f, 0.4f, 0.7f, 1.0f};
+	const float unused_times[] = {0.1f, 0.2f};
+
+	core::Vector<AnimationChannel> channels;
+	channels << create_channel("unused", unused_times);
+	channels << create_channel("tip", tip_times);
+	channels << create_channel("root", root_times);
+	return Animation(1.0f, std::move(channels));
+}
+
+// Skinning palette computed through Animation::bone_transform, key searches are done from scratch for every bone
+static core::Vector<math::Transform<>> reference_palette(const Skeleton& skeleton, const Animation& animation, float time) {
+	const core::Span<Bone> bones = skeleton.bones();
+
+	core::Vector<math::Transform<>> absolute;
+	for(usize i = 0; i != bones.size(); ++i) {
+		const math::Transform<> local = animation.bone_transform(bones[i].name, time).value_or(skeleton.bone_transforms()[i]);
+
+		math::Transform<> transform = local;
+		if(bones[i].has_parent()) {
+			transform = absolute[bones[i].parent] * local;
+		}
+		absolute << transform;
+	}
+
+	core::Vector<math::Transform<>> palette;
+	for(usize i = 0; i != bones.size(); ++i) {
+		math::Transform<> transform;
+		transform = absolute[i] * skeleton.inverse_absolute_transforms()[i];
+		palette << transform;
+	}
+	return palette;
+}
+
+static bool fuzzy_equal(core::Span<math::Transform<>> a, core::Span<math::Transform<>> b) {
+	if(a.size() != b.size()) {
+		return false;
+	}
+	for(usize i = 0; i != a.size(); ++i) {
+		for(usize c = 0; c != 4; ++c) {
+			for(usize r = 0; r != 4; ++r) {
+				if(std::abs(a[i][c][r] - b[i][c][r]) > 0.0001f) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+y_test_func("CompiledAnimation tracks") {
+	const Skeleton skeleton = create_skeleton();
+	const CompiledAnimation compiled(skeleton, create_animation());
+
+	y_test_assert(compiled.bone_count() == 3);
+	y_test_assert(compiled.track_count() == 2);
+	y_test_assert(compiled.duration() == 1.0f);
+}
+
+y_test_func("CompiledAnimation sampling") {
+	const Skeleton skeleton = create_skeleton();
+	const Animation animation = create_animation();
+	const CompiledAnimation compiled(skeleton, animation);
+
+	// First key, last key, exactly on and between keys, then backwards and forward again
+	const float times[] = {0.1f, 0.25f, 0.4f, 0.45f, 0.8f, 1.0f, 0.75f, 0.3f, 0.1f, 0.6f, 0.65f, 0.95f};
+
+	core::Vector<math::Transform<>> palette(compiled.bone_count(), math::Transform<>());
+
+	// The same cursor is reused across all samples
+	CompiledAnimation::Cursor cursor = compiled.create_cursor();
+	for(const float time : times) {
+		const auto expected = reference_palette(skeleton, animation, time);
+
+		compiled.sample(time, cursor, palette);
+		y_test_assert(fuzzy_equal(palette, expected));
+
+		CompiledAnimation::Cursor fresh = compiled.create_cursor();
+		compiled.sample(time, fresh, palette);
+		y_test_assert(fuzzy_equal(palette, expected));
+	}
+}
+
+}
@@ -0,0 +1,194 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/framegraph/FrameGraphScheduleBuilder.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+static constexpr ImageFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+
+struct Graph {
+	FrameGraphScheduleBuilder builder;
+	FrameGraphMutableImageId a;
+	FrameGraphMutableImageId b;
+	FrameGraphMutableImageId c;
+	FrameGraphMutableImageId unused;
+	usize passes[5] = {};
+};
+
+// Chain of compute passes: a -> b -> c -> presented, with a dead pass writing an image nobody reads
+static Graph create_graph(const math::Vec2ui& size = math::Vec2ui(128)) {
+	Graph graph;
+	FrameGraphScheduleBuilder& builder = graph.builder;
+
+	graph.passes[0] = builder.add_pass("write a");
+	graph.a = builder.declare_image(format, size);
+	builder.add_usage(graph.passes[0], graph.a, ImageUsage::StorageBit, true, PipelineStage::ComputeBit);
+
+	graph.passes[1] = builder.add_pass("dead");
+	graph.unused = builder.declare_image(format, size);
+	builder.add_usage(graph.passes[1], graph.a, ImageUsage::TextureBit, false, PipelineStage::ComputeBit);
+	builder.add_usage(graph.passes[1], graph.unused, ImageUsage::StorageBit, true, PipelineStage::ComputeBit);
+
+	graph.passes[2] = builder.add_pass("a to b");
+	graph.b = builder.declare_image(format, size);
+	builder.add_usage(graph.passes[2], graph.a, ImageUsage::TextureBit, false, PipelineStage::FragmentBit);
+	builder.add_usage(graph.passes[2], graph.b, ImageUsage::StorageBit, true, PipelineStage::ComputeBit);
+
+	graph.passes[3] = builder.add_pass("b to c");
+	graph.c = builder.declare_image(format, size);
+	builder.add_usage(graph.passes[3], graph.b, ImageUsage::TextureBit, false, PipelineStage::ComputeBit);
+	builder.add_usage(graph.passes[3], graph.c, ImageUsage::StorageBit, true, PipelineStage::ComputeBit);
+
+	graph.passes[4] = builder.add_pass("present");
+	builder.add_usage(graph.passes[4], graph.c, ImageUsage::TextureBit, false, PipelineStage::FragmentBit);
+	builder.set_has_side_effects(graph.passes[4]);
+
+	return graph;
+}
+
+static const FrameGraphSchedule::ImageAlloc* find_image(const FrameGraphSchedule& schedule, FrameGraphImageId res) {
+	for(const auto& image : schedule.images()) {
+		if(image.res == res) {
+			return &image;
+		}
+	}
+	return nullptr;
+}
+
+static bool is_discarded(const FrameGraphSchedule::PassSchedule& pass, FrameGraphImageId res) {
+	return std::find(pass.discarded.begin(), pass.discarded.end(), res) != pass.discarded.end();
+}
+
+y_test_func("FrameGraphSchedule signature") {
+	const Graph a = create_graph();
+	const Graph b = create_graph();
+	const Graph resized = create_graph(math::Vec2ui(256));
+
+	const core::Vector<u64> sig_a = a.builder.build_signature();
+	const core::Vector<u64> sig_b = b.builder.build_signature();
+	const core::Vector<u64> sig_resized = resized.builder.build_signature();
+
+	y_test_assert(sig_a.size() == sig_b.size());
+	y_test_assert(std::equal(sig_a.begin(), sig_a.end(), sig_b.begin()));
+	y_test_assert(!std::equal(sig_a.begin(), sig_a.end(), sig_resized.begin(), sig_resized.end()));
+
+	y_test_assert(a.builder.build()->hash() == b.builder.build()->hash());
+	y_test_assert(a.builder.build()->matches(sig_b));
+	y_test_assert(!a.builder.build()->matches(sig_resized));
+}
+
+y_test_func("FrameGraphSchedule cache reuse") {
+	FrameGraphScheduleCache cache;
+
+	const auto first = create_graph().builder.build(cache);
+	const auto second = create_graph().builder.build(cache);
+	y_test_assert(first == second);
+	y_test_assert(cache.size() == 1);
+
+	const auto resized = create_graph(math::Vec2ui(256)).builder.build(cache);
+	y_test_assert(resized != first);
+	y_test_assert(cache.size() == 2);
+
+	// Only the resized schedule is used after this
+	for(usize i = 0; i != 4; ++i) {
+		cache.garbage_collect(2);
+		y_test_assert(create_graph(math::Vec2ui(256)).builder.build(cache) == resized);
+	}
+	y_test_assert(cache.size() == 1);
+}
+
+y_test_func("FrameGraphSchedule culling") {
+	const Graph graph = create_graph();
+	const auto schedule = graph.builder.build();
+
+	y_test_assert(schedule->pass_count() == 5);
+	y_test_assert(schedule->culled_pass_count() == 1);
+	y_test_assert(schedule->pass(1).culled);
+	for(const usize i : {0, 2, 3, 4}) {
+		y_test_assert(!schedule->pass(i).culled);
+	}
+
+	// Images only used by culled passes are not allocated
+	y_test_assert(!find_image(*schedule, graph.unused));
+	y_test_assert(find_image(*schedule, graph.a));
+}
+
+// Passes writing external storage (StorageView or writable descriptor bindings) are flagged as having side effects
+y_test_func("FrameGraphSchedule external writes") {
+	Graph graph = create_graph();
+	graph.builder.set_has_side_effects(graph.passes[1]);
+
+	const usize external = graph.builder.add_pass("external only");
+	graph.builder.set_has_side_effects(external);
+
+	const auto schedule = graph.builder.build();
+
+	y_test_assert(schedule->pass_count() == 6);
+	y_test_assert(schedule->culled_pass_count() == 0);
+	for(usize i = 0; i != schedule->pass_count(); ++i) {
+		y_test_assert(!schedule->pass(i).culled);
+	}
+	y_test_assert(find_image(*schedule, graph.unused));
+}
+
+y_test_func("FrameGraphSchedule aliasing") {
+	const Graph graph = create_graph();
+	const auto schedule = graph.builder.build();
+
+	const auto* a = find_image(*schedule, graph.a);
+	const auto* b = find_image(*schedule, graph.b);
+	const auto* c = find_image(*schedule, graph.c);
+	y_test_assert(a && b && c);
+
+	// a dies before c is first written, b overlaps both
+	y_test_assert(schedule->slot_count() == 2);
+	y_test_assert(a->slot == c->slot);
+	y_test_assert(a->slot != b->slot);
+
+	y_test_assert(is_discarded(schedule->pass(0), graph.a));
+	y_test_assert(is_discarded(schedule->pass(2), graph.b));
+	y_test_assert(is_discarded(schedule->pass(3), graph.c));
+}
+
+y_test_func("FrameGraphSchedule barriers") {
+	const Graph graph = create_graph();
+	const auto schedule = graph.builder.build();
+
+	auto has_barrier = [&](usize pass, FrameGraphImageId res, PipelineStage src, PipelineStage dst) {
+		const auto& barriers = schedule->pass(pass).image_barriers;
+		return std::any_of(barriers.begin(), barriers.end(), [&](const auto& b) { return b.res == res && b.src == src && b.dst == dst; });
+	};
+
+	y_test_assert(schedule->pass(0).image_barriers.is_empty());
+	y_test_assert(has_barrier(2, graph.a, PipelineStage::ComputeBit, PipelineStage::FragmentBit));
+	y_test_assert(has_barrier(3, graph.b, PipelineStage::ComputeBit, PipelineStage::ComputeBit));
+	y_test_assert(has_barrier(4, graph.c, PipelineStage::ComputeBit, PipelineStage::FragmentBit));
+
+	// Culled passes don't get barriers
+	y_test_assert(schedule->pass(1).image_barriers.is_empty());
+}
+
+}
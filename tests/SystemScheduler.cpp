@@ -0,0 +1,128 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/SystemScheduler.h>
+#include <yave/ecs/EntityWorld.h>
+#include <y/core/Chrono.h>
+#include <y/test/test.h>
+
+#include <thread>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+struct ComponentA {};
+struct ComponentB {};
+
+// Spins until flag is set, returns false if it takes too long (ie: the other system is not running concurrently)
+static bool wait_for(const std::atomic<bool>& flag) {
+	core::Chrono timer;
+	while(!flag) {
+		if(timer.elapsed().to_secs() > 5.0) {
+			return false;
+		}
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+y_test_func("SystemScheduler conflicts") {
+	const auto write_a = ecs::ComponentAccess().write<ComponentA>();
+	const auto read_a = ecs::ComponentAccess().read<ComponentA>();
+	const auto read_b = ecs::ComponentAccess().read<ComponentB>();
+
+	y_test_assert(write_a.conflicts_with(read_a));
+	y_test_assert(read_a.conflicts_with(write_a));
+	y_test_assert(write_a.conflicts_with(write_a));
+	y_test_assert(!read_a.conflicts_with(read_a));
+	y_test_assert(!write_a.conflicts_with(read_b));
+	y_test_assert(read_a.is_read_only() && !write_a.is_read_only());
+}
+
+y_test_func("SystemScheduler ordering") {
+	ecs::EntityWorld world;
+	ecs::SystemScheduler scheduler;
+
+	std::atomic<u32> step = 0;
+	std::atomic<u32> out_of_order = 0;
+
+	scheduler.schedule("writer", ecs::ComponentAccess().write<ComponentA>(), [&](ecs::EntityWorld&) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		out_of_order += (step++ != 0);
+	});
+	scheduler.schedule("reader", ecs::ComponentAccess().read<ComponentA>(), [&](ecs::EntityWorld&) {
+		out_of_order += (step++ != 1);
+	});
+	scheduler.schedule("second writer", ecs::ComponentAccess().read<ComponentB>().write<ComponentA>(), [&](ecs::EntityWorld&) {
+		out_of_order += (step++ != 2);
+	});
+
+	for(usize i = 0; i != 4; ++i) {
+		step = 0;
+		out_of_order = 0;
+		scheduler.run(world);
+		y_test_assert(!out_of_order && step == 3);
+	}
+}
+
+y_test_func("SystemScheduler concurrency") {
+	ecs::EntityWorld world;
+	ecs::SystemScheduler scheduler;
+
+	// Each system waits for the other one to have started: this only completes if they run concurrently
+	std::atomic<bool> started[2] = {false, false};
+	std::atomic<bool> saw_other[2] = {false, false};
+
+	scheduler.schedule("read A", ecs::ComponentAccess().read<ComponentA>(), [&](ecs::EntityWorld&) {
+		started[0] = true;
+		saw_other[0] = wait_for(started[1]);
+	});
+	scheduler.schedule("write B", ecs::ComponentAccess().read<ComponentA>().write<ComponentB>(), [&](ecs::EntityWorld&) {
+		started[1] = true;
+		saw_other[1] = wait_for(started[0]);
+	});
+
+	scheduler.run(world);
+	y_test_assert(saw_other[0] && saw_other[1]);
+}
+
+y_test_func("SystemScheduler read only") {
+	const ecs::EntityWorld world;
+	ecs::SystemScheduler scheduler;
+
+	std::atomic<u32> runs = 0;
+	scheduler.schedule_read_only("read A", ecs::ComponentAccess().read<ComponentA>(), [&](const ecs::EntityWorld& w) {
+		runs += (&w == &world);
+	});
+	scheduler.schedule_read_only("read A and B", ecs::ComponentAccess().read<ComponentA, ComponentB>(), [&](const ecs::EntityWorld& w) {
+		runs += (&w == &world);
+	});
+
+	// The same scheduler is reused across runs
+	for(usize i = 0; i != 4; ++i) {
+		scheduler.run(world);
+	}
+	y_test_assert(runs == 8);
+}
+
+}
@@ -0,0 +1,160 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/math/BVH.h>
+#include <y/math/random.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+namespace {
+using namespace y;
+using namespace y::math;
+
+#ifndef Y_DEBUG
+static constexpr usize box_count = 1000000;
+#else
+static constexpr usize box_count = 10000;
+#endif
+
+static constexpr usize query_count = 1000;
+static constexpr usize linear_query_count = 10;
+static constexpr float world_size = 1000.0f;
+
+static float random_float(FastRandom& rng, float min, float max) {
+	return min + (max - min) * (float(rng()) / float(FastRandom::max()));
+}
+
+static Vec3 random_point(FastRandom& rng, float size) {
+	return Vec3(random_float(rng, -size, size), random_float(rng, -size, size), random_float(rng, -size, size));
+}
+
+static core::Vector<BVH::Entry> random_entries(usize count) {
+	FastRandom rng;
+	core::Vector<BVH::Entry> entries;
+	entries.set_min_capacity(count);
+	for(usize i = 0; i != count; ++i) {
+		const Vec3 center = random_point(rng, world_size);
+		const Vec3 half_extent(random_float(rng, 0.1f, 2.0f), random_float(rng, 0.1f, 2.0f), random_float(rng, 0.1f, 2.0f));
+		entries << BVH::Entry{center - half_extent, center + half_extent, u32(i)};
+	}
+	return entries;
+}
+
+static double per_query_us(const core::Chrono& chrono, usize count) {
+	return chrono.elapsed().to_micros() / double(count);
+}
+
+y_bench_func("BVH build and query") {
+	const core::Vector<BVH::Entry> entries = random_entries(box_count);
+	log_msg(fmt("% boxes:", box_count), Log::Perf);
+
+	BVH bvh;
+	{
+		core::Chrono chrono;
+		bvh.build(entries);
+		log_msg(fmt("    top-down build: % ms (height: %)", chrono.elapsed().to_millis(), bvh.height()), Log::Perf);
+	}
+
+	{
+		BVH incremental;
+		core::Chrono chrono;
+		for(const BVH::Entry& entry : entries) {
+			incremental.insert(entry.min, entry.max, entry.data);
+		}
+		log_msg(fmt("    incremental build: % ms (height: %)", chrono.elapsed().to_millis(), incremental.height()), Log::Perf);
+	}
+
+	FastRandom rng(0x1234);
+	usize hits = 0;
+
+	{
+		core::Chrono chrono;
+		for(usize i = 0; i != query_count; ++i) {
+			const Vec3 center = random_point(rng, world_size);
+			bvh.for_each_in_box(center - 20.0f, center + 20.0f, [&](u32) { ++hits; });
+		}
+		log_msg(fmt("    box query: % us", per_query_us(chrono, query_count)), Log::Perf);
+	}
+
+	{
+		core::Chrono chrono;
+		for(usize i = 0; i != linear_query_count; ++i) {
+			const Vec3 center = random_point(rng, world_size);
+			const Vec3 min = center - 20.0f;
+			const Vec3 max = center + 20.0f;
+			for(const BVH::Entry& entry : entries) {
+				if(entry.max.x() >= min.x() && entry.min.x() <= max.x() &&
+				   entry.max.y() >= min.y() && entry.min.y() <= max.y() &&
+				   entry.max.z() >= min.z() && entry.min.z() <= max.z()) {
+					++hits;
+				}
+			}
+		}
+		log_msg(fmt("    linear box query: % us", per_query_us(chrono, linear_query_count)), Log::Perf);
+	}
+
+	{
+		core::Chrono chrono;
+		for(usize i = 0; i != query_count; ++i) {
+			bvh.for_each_in_sphere(random_point(rng, world_size), 20.0f, [&](u32) { ++hits; });
+		}
+		log_msg(fmt("    sphere query: % us", per_query_us(chrono, query_count)), Log::Perf);
+	}
+
+	{
+		core::Chrono chrono;
+		for(usize i = 0; i != query_count; ++i) {
+			// Cone looking down +Z from a random point, roughly like a 90° camera frustum with a far plane at 100
+			const Vec3 eye = random_point(rng, world_size);
+			const float s = 0.70710678f;
+			const Vec4 planes[] = {
+				Vec4(s, 0.0f, s, -s * eye.x() - s * eye.z()),
+				Vec4(-s, 0.0f, s, s * eye.x() - s * eye.z()),
+				Vec4(0.0f, s, s, -s * eye.y() - s * eye.z()),
+				Vec4(0.0f, -s, s, s * eye.y() - s * eye.z()),
+				Vec4(0.0f, 0.0f, 1.0f, -eye.z()),
+				Vec4(0.0f, 0.0f, -1.0f, eye.z() + 100.0f),
+			};
+			bvh.for_each_in_frustum(planes, [&](u32) { ++hits; });
+		}
+		log_msg(fmt("    frustum query: % us", per_query_us(chrono, query_count)), Log::Perf);
+	}
+
+	{
+		core::Chrono chrono;
+		for(usize i = 0; i != query_count; ++i) {
+			const Vec3 origin = random_point(rng, world_size);
+			const Vec3 direction = random_point(rng, 1.0f).normalized();
+			bvh.raycast(origin, direction, world_size * 4.0f, [&](u32, float dist) {
+				++hits;
+				return dist;
+			});
+		}
+		log_msg(fmt("    closest hit raycast: % us", per_query_us(chrono, query_count)), Log::Perf);
+	}
+
+	log_msg(fmt("    % total hits", hits), Log::Perf);
+}
+
+}
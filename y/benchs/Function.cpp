@@ -0,0 +1,120 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/core/Functor.h>
+#include <y/core/Vector.h>
+#include <y/core/Chrono.h>
+#include <y/concurrent/StaticThreadPool.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+#include <cstdlib>
+
+// Counts every global allocation made by the benchmark binary
+static std::atomic<y::u64> allocation_count = 0;
+
+void* operator new(std::size_t size) {
+	++allocation_count;
+	if(void* ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace {
+using namespace y;
+
+#ifndef Y_DEBUG
+static constexpr usize func_count = 1000000;
+#else
+static constexpr usize func_count = 10000;
+#endif
+
+// The previous core::Function: always boxed and dispatched through a virtual call
+using BoxedFunction = core::detail::Functor<std::unique_ptr, void()>;
+
+static std::atomic<u64> sink = 0;
+
+struct BenchResult {
+	double ms = 0.0;
+	u64 allocs = 0;
+};
+
+template<typename F>
+static BenchResult measure(F&& f) {
+	const u64 allocs = allocation_count;
+	core::Chrono chrono;
+	f();
+	return {chrono.elapsed().to_millis(), allocation_count - allocs};
+}
+
+// Typical task capture: a few pointers and counters
+template<typename Func>
+static BenchResult bench_create_invoke() {
+	auto funcs = core::vector_with_capacity<Func>(func_count);
+	return measure([&] {
+		for(usize i = 0; i != func_count; ++i) {
+			funcs.emplace_back([a = &sink, i, j = i * 3, k = u64(i) << 2] { a->fetch_add(i + j + k, std::memory_order_relaxed); });
+		}
+		for(const auto& f : funcs) {
+			f();
+		}
+		funcs.make_empty();
+	});
+}
+
+static BenchResult bench_schedule(usize thread_count) {
+	concurrent::StaticThreadPool pool(thread_count);
+	concurrent::DependencyGroup group;
+	const BenchResult result = measure([&] {
+		for(usize i = 0; i != func_count; ++i) {
+			pool.schedule([a = &sink, i] { a->fetch_add(i, std::memory_order_relaxed); }, &group);
+		}
+		while(!group.is_ready()) {
+			pool.process_until_empty();
+		}
+	});
+	return result;
+}
+
+y_bench_func("Function inline storage") {
+	const BenchResult boxed = bench_create_invoke<BoxedFunction>();
+	const BenchResult function = bench_create_invoke<core::Function<void()>>();
+
+	log_msg(fmt("create + invoke % functions:", func_count), Log::Perf);
+	log_msg(fmt("    boxed: % ms, % allocations", boxed.ms, boxed.allocs), Log::Perf);
+	log_msg(fmt("    core::Function: % ms, % allocations (%x)", function.ms, function.allocs, boxed.ms / function.ms), Log::Perf);
+
+	// StaticThreadPool still allocates a list node per task
+	const BenchResult schedule = bench_schedule(4);
+	log_msg(fmt("StaticThreadPool schedule % tasks: % ms, % allocations per task", func_count, schedule.ms, double(schedule.allocs) / func_count), Log::Perf);
+}
+
+}
@@ -0,0 +1,82 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+#include <cstdio>
+
+namespace {
+using namespace y;
+
+static constexpr usize file_size = 64 * 1024 * 1024;
+static const char* bench_file_name = "mapped_file_bench.bin";
+
+// Small reads, like serde headers
+template<typename F>
+static u64 read_small(F& file) {
+	u64 sum = 0;
+	u32 value = 0;
+	while(file.read_one(value)) {
+		sum += value;
+	}
+	return sum;
+}
+
+template<typename F>
+static void bench_reader(const char* name, F&& open) {
+	{
+		auto file = open();
+		core::Vector<u8> data;
+		core::Chrono chrono;
+		file.read_all(data).unwrap();
+		log_msg(fmt("    %: read_all % ms", name, chrono.elapsed().to_millis()), Log::Perf);
+	}
+	{
+		auto file = open();
+		core::Chrono chrono;
+		const u64 sum = read_small(file);
+		log_msg(fmt("    %: u32 reads % ms (%)", name, chrono.elapsed().to_millis(), sum), Log::Perf);
+	}
+}
+
+y_bench_func("MappedFile vs File reads") {
+	{
+		io2::File file = std::move(io2::File::create(bench_file_name).unwrap());
+		core::Vector<u32> data;
+		for(usize i = 0; i != file_size / sizeof(u32); ++i) {
+			data << u32(i);
+		}
+		file.write_array(data.data(), data.size()).unwrap();
+	}
+
+	bench_reader("File", [] { return std::move(io2::File::open(bench_file_name).unwrap()); });
+	bench_reader("MappedFile", [] { return std::move(io2::MappedFile::open(bench_file_name).unwrap()); });
+
+	std::remove(bench_file_name);
+}
+
+}
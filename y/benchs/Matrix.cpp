@@ -0,0 +1,122 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/math/batch.h>
+#include <y/math/Quaternion.h>
+#include <y/math/random.h>
+#include <y/core/Vector.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+namespace {
+using namespace y;
+using namespace y::math;
+
+#ifndef Y_DEBUG
+static constexpr usize item_count = 1 << 16;
+static constexpr usize iterations = 64;
+#else
+static constexpr usize item_count = 1 << 12;
+static constexpr usize iterations = 4;
+#endif
+
+static core::Vector<float> random_floats(usize count) {
+	FastRandom rng;
+	auto floats = core::vector_with_capacity<float>(count);
+	for(usize i = 0; i != count; ++i) {
+		floats << (float(rng() % 2001) / 1000.0f - 1.0f);
+	}
+	return floats;
+}
+
+// Runs kernel over every element of the input, with a stride of Stride floats
+template<usize Stride, typename F>
+static double bench_kernel(const core::Vector<float>& a, const core::Vector<float>& b, core::Vector<float>& out, F&& kernel) {
+	core::Chrono chrono;
+	for(usize it = 0; it != iterations; ++it) {
+		for(usize i = 0; i + Stride <= a.size(); i += Stride) {
+			kernel(a.data() + i, b.data() + i, out.data() + i);
+		}
+	}
+	return chrono.elapsed().to_millis();
+}
+
+static void log_result(const char* name, double scalar_ms, double simd_ms) {
+	log_msg(fmt("    %: scalar % ms, simd % ms (%x)", name, scalar_ms, simd_ms, scalar_ms / simd_ms), Log::Perf);
+}
+
+y_bench_func("Math SIMD kernels") {
+	const core::Vector<float> a = random_floats(item_count * 16);
+	const core::Vector<float> b = random_floats(item_count * 16);
+	core::Vector<float> out(item_count * 16, 0.0f);
+
+	log_msg(fmt("% x % items (simd %):", iterations, item_count, simd::is_enabled() ? "enabled" : "disabled"), Log::Perf);
+
+	log_result("Matrix4 * Matrix4",
+		bench_kernel<16>(a, b, out, [](const float* x, const float* y, float* o) { simd::scalar::mul_mat4(x, y, o); }),
+		bench_kernel<16>(a, b, out, [](const float* x, const float* y, float* o) { simd::mul_mat4(x, y, o); }));
+
+	log_result("Matrix4 * Vec4",
+		bench_kernel<16>(a, b, out, [](const float* x, const float* y, float* o) { simd::scalar::mul_mat4_vec4(x, y, o); }),
+		bench_kernel<16>(a, b, out, [](const float* x, const float* y, float* o) { simd::mul_mat4_vec4(x, y, o); }));
+
+	log_result("Matrix4 inverse",
+		bench_kernel<16>(a, b, out, [](const float* x, const float*, float* o) { simd::scalar::inverse_mat4(x, o); }),
+		bench_kernel<16>(a, b, out, [](const float* x, const float*, float* o) { simd::inverse_mat4(x, o); }));
+
+	log_result("Quaternion * Quaternion",
+		bench_kernel<4>(a, b, out, [](const float* x, const float* y, float* o) { simd::scalar::mul_quat(x, y, o); }),
+		bench_kernel<4>(a, b, out, [](const float* x, const float* y, float* o) { simd::mul_quat(x, y, o); }));
+
+	// Generic Matrix<N, M, T> inverse, as used before the kernels existed
+	{
+		const Matrix4<double> m(Matrix4<float>(std::array<float, 16>{a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15]}));
+		core::Chrono chrono;
+		double sink = 0.0;
+		for(usize i = 0; i != item_count; ++i) {
+			sink += m.inverse()[0][0];
+		}
+		log_msg(fmt("    generic Matrix4<double> inverse: % ms (%)", chrono.elapsed().to_millis() * iterations, sink != 0.0), Log::Perf);
+	}
+
+	{
+		core::Vector<Vec3> points(item_count, Vec3(1.0f, 2.0f, 3.0f));
+		core::Chrono chrono;
+		for(usize it = 0; it != iterations; ++it) {
+			transform_points(Matrix4<>(identity()), points.data(), points.size());
+		}
+		log_msg(fmt("    batch transform_points: % ms", chrono.elapsed().to_millis()), Log::Perf);
+	}
+
+	{
+		core::Vector<Matrix4<>> palette(item_count, Matrix4<>(identity()));
+		const core::Vector<Matrix4<>> inverses(item_count, Matrix4<>(identity()));
+		core::Chrono chrono;
+		for(usize it = 0; it != iterations; ++it) {
+			multiply(palette.data(), inverses.data(), palette.data(), palette.size());
+		}
+		log_msg(fmt("    batch matrix palette multiply: % ms", chrono.elapsed().to_millis()), Log::Perf);
+	}
+}
+
+}
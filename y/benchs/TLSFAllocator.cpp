@@ -0,0 +1,166 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/mem/TLSFAllocator.h>
+#include <y/math/random.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+namespace {
+using namespace y;
+using namespace y::memory;
+
+#ifndef Y_DEBUG
+static constexpr usize operation_count = 200000;
+#else
+static constexpr usize operation_count = 10000;
+#endif
+
+static constexpr usize heap_size = 128 * 1024 * 1024;
+static constexpr usize granularity = 256;
+static constexpr usize live_allocations = 4096;
+
+// Unsorted first fit free list, with free blocks merged by rescanning the list
+class FirstFitAllocator {
+	struct FreeBlock {
+		usize offset;
+		usize size;
+	};
+
+	public:
+		FirstFitAllocator(usize size) {
+			_blocks << FreeBlock{0, size};
+		}
+
+		core::Result<usize> allocate(usize size) {
+			size = (size + granularity - 1) & ~(granularity - 1);
+			for(auto it = _blocks.begin(); it != _blocks.end(); ++it) {
+				if(it->size == size) {
+					const usize offset = it->offset;
+					_blocks.erase_unordered(it);
+					return core::Ok(offset);
+				} else if(it->size > size) {
+					const usize offset = it->offset;
+					it->offset += size;
+					it->size -= size;
+					return core::Ok(offset);
+				}
+			}
+			return core::Err();
+		}
+
+		void free(usize offset, usize size) {
+			FreeBlock block{offset, (size + granularity - 1) & ~(granularity - 1)};
+			bool compacted = false;
+			do {
+				compacted = false;
+				for(auto it = _blocks.begin(); it != _blocks.end(); ++it) {
+					const FreeBlock b = *it;
+					if(b.offset + b.size == block.offset || block.offset + block.size == b.offset) {
+						_blocks.erase_unordered(it);
+						block = FreeBlock{std::min(b.offset, block.offset), b.size + block.size};
+						compacted = true;
+						break;
+					}
+				}
+			} while(compacted);
+			_blocks << block;
+		}
+
+		usize free_blocks() const {
+			return _blocks.size();
+		}
+
+	private:
+		core::Vector<FreeBlock> _blocks;
+};
+
+struct Alloc {
+	usize offset;
+	usize size;
+};
+
+static usize random_size(math::FastRandom& rng) {
+	// Mostly small buffers with the occasional texture
+	return rng() % 16 ? 256 + rng() % (8 * 1024) : 64 * 1024 + rng() % (256 * 1024);
+}
+
+// Fills the heap up to live_allocations then keeps replacing random allocations
+template<typename Allocate, typename Free>
+static double run(Allocate&& allocate, Free&& free, usize& failures) {
+	math::FastRandom rng;
+	core::Vector<Alloc> allocs;
+	allocs.set_min_capacity(live_allocations);
+
+	const auto alloc_one = [&] {
+		const usize size = random_size(rng);
+		if(auto r = allocate(size)) {
+			allocs << Alloc{r.unwrap(), size};
+		} else {
+			++failures;
+		}
+	};
+
+	core::Chrono chrono;
+	while(allocs.size() < live_allocations && failures == 0) {
+		alloc_one();
+	}
+	for(usize i = 0; i != operation_count; ++i) {
+		const usize index = rng() % allocs.size();
+		free(allocs[index]);
+		allocs.erase_unordered(allocs.begin() + index);
+		alloc_one();
+	}
+	for(const Alloc& a : allocs) {
+		free(a);
+	}
+	return chrono.elapsed().to_millis();
+}
+
+y_bench_func("TLSFAllocator vs first fit") {
+	log_msg(fmt("% random alloc/free in a %MB heap with % live allocations:", operation_count, heap_size / (1024 * 1024), live_allocations), Log::Perf);
+
+	{
+		FirstFitAllocator allocator(heap_size);
+		usize failures = 0;
+		usize max_blocks = 0;
+		const double ms = run(
+			[&](usize size) { return allocator.allocate(size); },
+			[&](const Alloc& a) { allocator.free(a.offset, a.size); max_blocks = std::max(max_blocks, allocator.free_blocks()); },
+			failures);
+		log_msg(fmt("    first fit: % ms (% failed allocations, % max free blocks)", ms, failures, max_blocks), Log::Perf);
+	}
+
+	{
+		TLSFAllocator allocator(heap_size, granularity);
+		usize failures = 0;
+		usize max_blocks = 0;
+		const double ms = run(
+			[&](usize size) { return allocator.allocate(size); },
+			[&](const Alloc& a) { allocator.free(a.offset); max_blocks = std::max(max_blocks, allocator.free_blocks()); },
+			failures);
+		log_msg(fmt("    TLSF: % ms (% failed allocations, % max free blocks)", ms, failures, max_blocks), Log::Perf);
+	}
+}
+
+}
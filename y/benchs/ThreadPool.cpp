@@ -0,0 +1,113 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/concurrent/StaticThreadPool.h>
+#include <y/concurrent/WorkStealingThreadPool.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+namespace {
+using namespace y;
+using namespace y::concurrent;
+
+#ifndef Y_DEBUG
+static constexpr usize task_count = 100000;
+#else
+static constexpr usize task_count = 1000;
+#endif
+
+static constexpr usize chain_length = 100;
+
+static std::atomic<u64> sink = 0;
+
+static void tiny_task() {
+	u64 x = sink.load(std::memory_order_relaxed);
+	for(usize i = 0; i != 256; ++i) {
+		x = x * 6364136223846793005ull + 1442695040888963407ull;
+	}
+	sink.fetch_add(x & 1, std::memory_order_relaxed);
+}
+
+template<typename Pool>
+static void wait_for_group(Pool& pool, const DependencyGroup& group) {
+	while(!group.is_ready()) {
+		pool.process_until_empty();
+	}
+}
+
+// Every task is independent
+template<typename Pool>
+static double bench_independent(usize thread_count) {
+	Pool pool(thread_count);
+
+	core::Chrono chrono;
+	DependencyGroup group;
+	for(usize i = 0; i != task_count; ++i) {
+		pool.schedule(tiny_task, &group);
+	}
+	wait_for_group(pool, group);
+	return chrono.elapsed().to_millis();
+}
+
+// Tasks are scheduled upfront in batches that each wait on the previous one
+template<typename Pool>
+static double bench_chained(usize thread_count) {
+	Pool pool(thread_count);
+
+	core::Chrono chrono;
+	DependencyGroup previous;
+	for(usize c = 0; c != chain_length; ++c) {
+		DependencyGroup group;
+		for(usize i = 0; i != task_count / chain_length; ++i) {
+			pool.schedule(tiny_task, &group, previous);
+		}
+		previous = group;
+	}
+	wait_for_group(pool, previous);
+	return chrono.elapsed().to_millis();
+}
+
+template<typename F>
+static void run_scaling(const char* name, F&& bench) {
+	const usize max_threads = std::max(1u, std::thread::hardware_concurrency());
+	log_msg(fmt("%:", name), Log::Perf);
+	for(usize threads = 1; true; threads = std::min(threads * 2, max_threads)) {
+		const auto [static_ms, stealing_ms] = bench(threads);
+		log_msg(fmt("    % threads: StaticThreadPool % ms, WorkStealingThreadPool % ms (%x)", threads, static_ms, stealing_ms, static_ms / stealing_ms), Log::Perf);
+		if(threads == max_threads) {
+			break;
+		}
+	}
+}
+
+y_bench_func("ThreadPool scaling") {
+	run_scaling("independent tasks", [](usize threads) {
+		return std::pair(bench_independent<StaticThreadPool>(threads), bench_independent<WorkStealingThreadPool>(threads));
+	});
+
+	run_scaling("chained tasks", [](usize threads) {
+		return std::pair(bench_chained<StaticThreadPool>(threads), bench_chained<WorkStealingThreadPool>(threads));
+	});
+}
+
+}
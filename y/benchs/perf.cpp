@@ -0,0 +1,66 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/utils/perf.h>
+#include <y/core/Chrono.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/test/bench.h>
+
+#include <cstdio>
+
+namespace {
+using namespace y;
+
+static constexpr usize scope_count = 1000000;
+
+static void profiled_scope() {
+	y_profile_zone("bench scope");
+}
+
+static double ns_per_scope() {
+	core::Chrono chrono;
+	for(usize i = 0; i != scope_count; ++i) {
+		profiled_scope();
+	}
+	return double(chrono.elapsed().to_nanos()) / double(scope_count);
+}
+
+y_bench_func("perf scope overhead") {
+#ifdef Y_PERF_LOG_ENABLED
+	log_msg(fmt("    not recording: % ns per scope", ns_per_scope()), Log::Perf);
+
+	perf::start_flight_recorder(10.0);
+	log_msg(fmt("    flight recorder: % ns per scope", ns_per_scope()), Log::Perf);
+	perf::stop_flight_recorder();
+
+	const char* filename = "perf_bench_capture.json";
+	perf::start_capture(filename);
+	log_msg(fmt("    capture: % ns per scope", ns_per_scope()), Log::Perf);
+	perf::end_capture();
+	std::remove(filename);
+#else
+	log_msg("    profiling disabled", Log::Perf);
+#endif
+}
+
+}
@@ -0,0 +1,230 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/math/BVH.h>
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+#include <algorithm>
+
+namespace {
+using namespace y;
+using namespace y::math;
+
+static float random_float(FastRandom& rng, float min, float max) {
+	return min + (max - min) * (float(rng()) / float(FastRandom::max()));
+}
+
+static BVH::Entry random_entry(FastRandom& rng, u32 data) {
+	const Vec3 center(random_float(rng, -100.0f, 100.0f), random_float(rng, -100.0f, 100.0f), random_float(rng, -100.0f, 100.0f));
+	const Vec3 half_extent(random_float(rng, 0.1f, 5.0f), random_float(rng, 0.1f, 5.0f), random_float(rng, 0.1f, 5.0f));
+	return BVH::Entry{center - half_extent, center + half_extent, data};
+}
+
+static bool overlaps(const BVH::Entry& entry, const Vec3& min, const Vec3& max) {
+	for(usize i = 0; i != 3; ++i) {
+		if(entry.max[i] < min[i] || entry.min[i] > max[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template<typename F>
+static core::Vector<u32> sorted_results(F&& query) {
+	core::Vector<u32> results;
+	query([&](u32 data) { results << data; });
+	std::sort(results.begin(), results.end());
+	return results;
+}
+
+static core::Vector<u32> brute_force_box(core::Span<BVH::Entry> entries, const Vec3& min, const Vec3& max) {
+	core::Vector<u32> results;
+	for(const BVH::Entry& entry : entries) {
+		if(overlaps(entry, min, max)) {
+			results << entry.data;
+		}
+	}
+	std::sort(results.begin(), results.end());
+	return results;
+}
+
+static bool same_results(const core::Vector<u32>& a, const core::Vector<u32>& b) {
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+static bool check_box_queries(const BVH& bvh, core::Span<BVH::Entry> entries, FastRandom& rng) {
+	for(usize i = 0; i != 64; ++i) {
+		const BVH::Entry query = random_entry(rng, 0);
+		const auto results = sorted_results([&](auto&& f) { bvh.for_each_in_box(query.min * 4.0f, query.max * 4.0f, f); });
+		if(!same_results(results, brute_force_box(entries, query.min * 4.0f, query.max * 4.0f))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+y_test_func("BVH build") {
+	FastRandom rng;
+	core::Vector<BVH::Entry> entries;
+	for(u32 i = 0; i != 4096; ++i) {
+		entries << random_entry(rng, i);
+	}
+
+	BVH bvh;
+	const auto proxies = bvh.build(entries);
+	y_test_assert(proxies.size() == entries.size());
+	y_test_assert(bvh.size() == entries.size());
+	y_test_assert(bvh.height() == 13);
+
+	for(usize i = 0; i != entries.size(); ++i) {
+		y_test_assert(bvh.data(proxies[i]) == entries[i].data);
+	}
+
+	y_test_assert(check_box_queries(bvh, entries, rng));
+}
+
+y_test_func("BVH insert update remove") {
+	FastRandom rng;
+	core::Vector<BVH::Entry> entries;
+	core::Vector<BVH::ProxyId> proxies;
+
+	BVH bvh;
+	for(u32 i = 0; i != 2048; ++i) {
+		entries << random_entry(rng, i);
+		proxies << bvh.insert(entries.last().min, entries.last().max, i);
+	}
+	y_test_assert(bvh.size() == entries.size());
+	// Balancing should keep the tree within a small factor of the optimal height
+	y_test_assert(bvh.height() < 3 * 11);
+	y_test_assert(check_box_queries(bvh, entries, rng));
+
+	for(usize i = 0; i < entries.size(); i += 3) {
+		entries[i] = random_entry(rng, entries[i].data);
+		bvh.update(proxies[i], entries[i].min, entries[i].max);
+	}
+	y_test_assert(check_box_queries(bvh, entries, rng));
+
+	for(usize i = entries.size(); i > 0; i -= 2) {
+		bvh.remove(proxies[i - 1]);
+		entries.erase(entries.begin() + (i - 1));
+	}
+	y_test_assert(bvh.size() == entries.size());
+	y_test_assert(check_box_queries(bvh, entries, rng));
+
+	bvh.clear();
+	y_test_assert(bvh.is_empty());
+	y_test_assert(bvh.height() == 0);
+}
+
+y_test_func("BVH margin") {
+	BVH bvh(1.0f);
+	const BVH::ProxyId id = bvh.insert(Vec3(0.0f), Vec3(1.0f), 7);
+	bvh.insert(Vec3(10.0f), Vec3(11.0f), 8);
+
+	y_test_assert(!bvh.update(id, Vec3(0.5f), Vec3(1.5f)));
+	y_test_assert(bvh.update(id, Vec3(5.0f), Vec3(6.0f)));
+	y_test_assert(bvh.data(id) == 7);
+
+	const auto results = sorted_results([&](auto&& f) { bvh.for_each_in_box(Vec3(5.5f), Vec3(5.5f), f); });
+	y_test_assert(results.size() == 1 && results[0] == 7);
+}
+
+y_test_func("BVH sphere and frustum") {
+	FastRandom rng;
+	core::Vector<BVH::Entry> entries;
+	for(u32 i = 0; i != 1024; ++i) {
+		entries << random_entry(rng, i);
+	}
+
+	BVH bvh;
+	bvh.build(entries);
+
+	{
+		const Vec3 center(10.0f, -20.0f, 5.0f);
+		const float radius = 30.0f;
+		const auto results = sorted_results([&](auto&& f) { bvh.for_each_in_sphere(center, radius, f); });
+
+		core::Vector<u32> expected;
+		for(const BVH::Entry& entry : entries) {
+			if((center.max(entry.min).min(entry.max) - center).length2() <= radius * radius) {
+				expected << entry.data;
+			}
+		}
+		y_test_assert(!expected.is_empty());
+		y_test_assert(same_results(results, expected));
+	}
+
+	{
+		// Axis aligned "frustum" so that the expected result is a box query
+		const Vec3 min(-50.0f, -10.0f, 0.0f);
+		const Vec3 max(20.0f, 40.0f, 60.0f);
+		const Vec4 planes[] = {
+			Vec4(1.0f, 0.0f, 0.0f, -min.x()), Vec4(-1.0f, 0.0f, 0.0f, max.x()),
+			Vec4(0.0f, 1.0f, 0.0f, -min.y()), Vec4(0.0f, -1.0f, 0.0f, max.y()),
+			Vec4(0.0f, 0.0f, 1.0f, -min.z()), Vec4(0.0f, 0.0f, -1.0f, max.z()),
+		};
+		const auto results = sorted_results([&](auto&& f) { bvh.for_each_in_frustum(planes, f); });
+		y_test_assert(same_results(results, brute_force_box(entries, min, max)));
+	}
+}
+
+y_test_func("BVH raycast") {
+	BVH bvh;
+	for(u32 i = 0; i != 16; ++i) {
+		const Vec3 center(float(i) * 10.0f, 0.0f, 0.0f);
+		bvh.insert(center - 1.0f, center + 1.0f, i);
+	}
+	bvh.insert(Vec3(50.0f, 10.0f, -1.0f), Vec3(52.0f, 12.0f, 1.0f), 100);
+
+	{
+		u32 closest = u32(-1);
+		float closest_dist = 0.0f;
+		bvh.raycast(Vec3(35.0f, 0.0f, 0.0f), Vec3(1.0f, 0.0f, 0.0f), 1000.0f, [&](u32 data, float dist) {
+			closest = data;
+			closest_dist = dist;
+			return dist;
+		});
+		y_test_assert(closest == 4);
+		y_test_assert(std::abs(closest_dist - 4.0f) < 0.001f);
+	}
+
+	{
+		usize hits = 0;
+		bvh.raycast(Vec3(-5.0f, 0.0f, 0.0f), Vec3(1.0f, 0.0f, 0.0f), 1000.0f, [&](u32, float) {
+			++hits;
+			return 1000.0f;
+		});
+		y_test_assert(hits == 16);
+	}
+
+	{
+		usize hits = 0;
+		bvh.raycast(Vec3(-5.0f, 0.0f, 0.0f), Vec3(1.0f, 0.0f, 0.0f), 20.0f, [&](u32, float) {
+			++hits;
+			return 20.0f;
+		});
+		y_test_assert(hits == 2);
+	}
+}
+
+}
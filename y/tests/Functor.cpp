@@ -131,6 +131,53 @@ y_test_func("Function void boxing") {
 	y_test_assert(i == 1);
 }
 
+y_test_func("Function move only") {
+	auto ptr = std::make_unique<int>(7);
+	auto get = function([p = std::move(ptr)]() { return *p; });
+	y_test_assert(get() == 7);
+
+	const auto moved = std::move(get);
+	y_test_assert(moved() == 7);
+}
+
+y_test_func("Function storage") {
+	struct Counted {
+		Counted(int& a) : alive(&a) {
+			++*alive;
+		}
+
+		Counted(Counted&& other) noexcept : alive(other.alive) {
+			++*alive;
+		}
+
+		~Counted() {
+			--*alive;
+		}
+
+		int* alive = nullptr;
+	};
+
+	int alive = 0;
+	{
+		std::array<u64, 32> big = {};
+		big[31] = 9;
+
+		core::Function<u64()> small = [c = Counted(alive)] { return u64(*c.alive); };
+		core::Function<u64()> large = [c = Counted(alive), big] { return big[31]; };
+		y_test_assert(alive == 2);
+		y_test_assert(small() == 2 && large() == 9);
+
+		core::Function<u64()> other = std::move(small);
+		y_test_assert(alive == 2);
+		y_test_assert(small.is_empty() && !other.is_empty());
+
+		other = std::move(large);
+		y_test_assert(alive == 1);
+		y_test_assert(other() == 9);
+	}
+	y_test_assert(alive == 0);
+}
+
 y_test_func("Functor creation") {
 	int i = 0;
 	const auto inc = functor([&i]() { ++i; });
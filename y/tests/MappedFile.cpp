@@ -0,0 +1,118 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/io2/MappedFile.h>
+#include <y/io2/File.h>
+#include <y/io2/Buffer.h>
+#include <y/test/test.h>
+
+#include <cstdio>
+
+namespace {
+using namespace y;
+using namespace y::io2;
+
+static const char* test_file_name = "mapped_file_test.bin";
+
+static void create_test_file(usize size) {
+	File file = std::move(File::create(test_file_name).unwrap());
+	for(usize i = 0; i != size; ++i) {
+		file.write_one(u8(i * 7)).unwrap();
+	}
+}
+
+y_test_func("MappedFile read") {
+	create_test_file(1000);
+	{
+		MappedFile file = std::move(MappedFile::open(test_file_name).unwrap());
+		y_test_assert(file.is_open());
+		y_test_assert(file.size() == 1000);
+
+		u8 bytes[10] = {};
+		y_test_assert(file.read(bytes, 10));
+		for(usize i = 0; i != 10; ++i) {
+			y_test_assert(bytes[i] == u8(i * 7));
+		}
+
+		file.seek(990);
+		y_test_assert(file.remaining() == 10);
+		y_test_assert(file.read_up_to(bytes, 100).unwrap() == 10);
+		y_test_assert(bytes[0] == u8(990 * 7));
+		y_test_assert(file.at_end());
+		y_test_assert(!file.read(bytes, 1));
+
+		file.seek(500);
+		core::Vector<u8> all;
+		y_test_assert(file.read_all(all).unwrap() == 500);
+		y_test_assert(all.size() == 500);
+		y_test_assert(all[0] == u8(500 * 7));
+	}
+	std::remove(test_file_name);
+}
+
+y_test_func("MappedFile try_view") {
+	create_test_file(100);
+	{
+		MappedFile file = std::move(MappedFile::open(test_file_name).unwrap());
+
+		const u8* view = file.try_view(50);
+		y_test_assert(view == file.data());
+		y_test_assert(file.tell() == 50);
+
+		y_test_assert(!file.try_view(51));
+		y_test_assert(file.tell() == 50);
+		y_test_assert(file.try_view(50) == file.data() + 50);
+		y_test_assert(file.at_end());
+	}
+	std::remove(test_file_name);
+}
+
+y_test_func("MappedFile empty and missing") {
+	create_test_file(0);
+	{
+		MappedFile file = std::move(MappedFile::open(test_file_name).unwrap());
+		y_test_assert(file.is_open());
+		y_test_assert(file.at_end());
+		y_test_assert(file.size() == 0);
+	}
+	std::remove(test_file_name);
+
+	y_test_assert(!MappedFile::open(test_file_name));
+}
+
+y_test_func("Reader try_view") {
+	Buffer buffer;
+	buffer.write_one(u32(4)).unwrap();
+	buffer.reset();
+	y_test_assert(buffer.try_view(sizeof(u32)));
+	y_test_assert(!buffer.try_view(1));
+
+	create_test_file(16);
+	{
+		File file = std::move(File::open(test_file_name).unwrap());
+		y_test_assert(!file.try_view(4));
+		y_test_assert(file.tell() == 0);
+	}
+	std::remove(test_file_name);
+}
+
+}
@@ -21,6 +21,7 @@ SOFTWARE.
 **********************************/
 
 #include <y/math/Matrix.h>
+#include <y/math/batch.h>
 #include <y/test/test.h>
 
 namespace {
@@ -68,6 +69,71 @@ y_test_func("Matrix inverse") {
 	y_test_assert(e == i);
 }
 
+static bool almost_equal(const Matrix4<>& a, const Matrix4<>& b) {
+	for(usize i = 0; i != a.size(); ++i) {
+		if(std::abs(a.begin()[i] - b.begin()[i]) > 0.0001f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static const Matrix4<> mat4_a(2, 0, 1, 3,
+							  1, 3, 0, -1,
+							  0, 1, 4, 2,
+							  0, 0, 0, 1);
+
+static const Matrix4<> mat4_b(1, 2, 3, 4,
+							  0, 1, -2, 5,
+							  3, 0, 1, 2,
+							  1, 1, 0, 1);
+
+y_test_func("Matrix4 multiply") {
+	Matrix4<> scalar;
+	simd::scalar::mul_mat4(mat4_a.begin(), mat4_b.begin(), scalar.begin());
+	y_test_assert(mat4_a * mat4_b == scalar);
+	y_test_assert(mat4_a * mat4_b == Matrix4<>(8, 7, 7, 13,
+											   0, 4, -3, 18,
+											   14, 3, 2, 15,
+											   1, 1, 0, 1));
+
+	const Vec4 v(1.0f, -2.0f, 3.0f, 1.0f);
+	y_test_assert(mat4_a * v == Vec4(8, -6, 12, 1));
+}
+
+y_test_func("Matrix4 inverse") {
+	for(const Matrix4<>& m : {mat4_a, mat4_b, mat4_a * mat4_b}) {
+		Matrix4<> scalar;
+		y_test_assert(simd::scalar::inverse_mat4(m.begin(), scalar.begin()));
+		y_test_assert(almost_equal(m.inverse(), scalar));
+		y_test_assert(almost_equal(m * m.inverse(), identity()));
+	}
+
+	y_test_assert(Matrix4<>(1, 2, 3, 4,
+							2, 4, 6, 8,
+							0, 1, 0, 1,
+							1, 0, 1, 0).inverse() == Matrix4<>());
+}
+
+y_test_func("Matrix4 batch") {
+	Matrix4<> mats[] = {mat4_a, mat4_b, identity()};
+	multiply(mat4_a, mats, mats, 3);
+	y_test_assert(mats[0] == mat4_a * mat4_a && mats[1] == mat4_a * mat4_b && mats[2] == mat4_a);
+
+	const Matrix4<> others[] = {mat4_b, mat4_b, mat4_b};
+	multiply(mats, others, mats, 3);
+	y_test_assert(mats[2] == mat4_a * mat4_b);
+
+	struct {
+		Vec3 point;
+		Vec3 vector;
+	} data[] = {{{1.0f, -2.0f, 3.0f}, {1.0f, -2.0f, 3.0f}}, {{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}};
+
+	transform_points(mat4_a, &data[0].point, 2, sizeof(data[0]));
+	transform_vectors(mat4_a, &data[0].vector, 2, sizeof(data[0]));
+	y_test_assert(data[0].point == Vec3(8, -6, 12) && data[1].point == Vec3(3, -1, 2));
+	y_test_assert(data[0].vector == Vec3(5, -5, 10) && data[1].vector == Vec3(0, 3, 1));
+}
 
 y_test_func("Matrix asymetrical") {
 	const Matrix<2, 3> mat(1, 2, 3,
@@ -85,5 +85,22 @@ y_test_func("Quaternion euler") {
 		}
 	}
 }
+y_test_func("Quaternion multiply") {
+	const auto a = Quaternion<>::from_euler(to_rad(30), to_rad(45), to_rad(10));
+	const auto b = Quaternion<>::from_euler(to_rad(-20), to_rad(5), to_rad(70));
+
+	Vec4 scalar;
+	const Vec4 va(a.x(), a.y(), a.z(), a.w());
+	const Vec4 vb(b.x(), b.y(), b.z(), b.w());
+	simd::scalar::mul_quat(va.data(), vb.data(), scalar.data());
+
+	Quaternion<> q = a;
+	q *= b;
+	y_test_assert((Vec4(q.x(), q.y(), q.z(), q.w()) - scalar).length() < 0.0001f);
+
+	const Vec3 v(1.0f, 2.0f, 3.0f);
+	y_test_assert((q(v) - a(b(v))).length() < 0.0001f);
+}
+
 }
 
@@ -0,0 +1,144 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/test.h>
+#include <y/mem/TLSFAllocator.h>
+#include <y/math/random.h>
+
+#include <algorithm>
+
+namespace {
+using namespace y;
+using namespace y::memory;
+
+y_test_func("TLSFAllocator basic") {
+	static constexpr usize size = 1024 * 256;
+	TLSFAllocator allocator(size, 256);
+
+	y_test_assert(allocator.size() == size);
+	y_test_assert(allocator.is_empty());
+	y_test_assert(allocator.free_blocks() == 1);
+
+	const usize a = allocator.allocate(1000).unwrap();
+	const usize b = allocator.allocate(256).unwrap();
+	const usize c = allocator.allocate(1).unwrap();
+	y_test_assert(a != b && b != c && a != c);
+	y_test_assert(a % 256 == 0 && b % 256 == 0 && c % 256 == 0);
+	y_test_assert(allocator.allocated() == 1024 + 256 + 256);
+	y_test_assert(allocator.allocations() == 3);
+
+	allocator.free(b);
+	y_test_assert(allocator.free_blocks() == 2);
+
+	allocator.free(a);
+	allocator.free(c);
+	y_test_assert(allocator.is_empty());
+	y_test_assert(allocator.free_blocks() == 1);
+	y_test_assert(allocator.stats().largest_free_block == size);
+}
+
+y_test_func("TLSFAllocator full") {
+	static constexpr usize count = 64;
+	TLSFAllocator allocator(count * 256, 256);
+
+	core::Vector<usize> offsets;
+	for(usize i = 0; i != count; ++i) {
+		offsets << allocator.allocate(256).unwrap();
+	}
+	y_test_assert(allocator.allocate(1).is_error());
+	y_test_assert(allocator.free_blocks() == 0);
+
+	// Every other block: nothing can be coalesced
+	for(usize i = 0; i < count; i += 2) {
+		allocator.free(offsets[i]);
+	}
+	y_test_assert(allocator.free_blocks() == count / 2);
+	y_test_assert(allocator.allocate(512).is_error());
+	y_test_assert(allocator.stats().fragmentation() > 0.9f);
+
+	for(usize i = 1; i < count; i += 2) {
+		allocator.free(offsets[i]);
+	}
+	y_test_assert(allocator.free_blocks() == 1);
+	y_test_assert(allocator.allocate(count * 256).unwrap() == 0);
+}
+
+y_test_func("TLSFAllocator alignment") {
+	TLSFAllocator allocator(1024 * 1024, 256);
+
+	const usize small = allocator.allocate(256).unwrap();
+	const usize aligned = allocator.allocate(1000, 64 * 1024).unwrap();
+	y_test_assert(aligned % (64 * 1024) == 0);
+	y_test_assert(aligned != small);
+
+	// The padding in front of the aligned block should be usable
+	const usize padding = allocator.allocate(1024).unwrap();
+	y_test_assert(padding < aligned);
+
+	allocator.free(small);
+	allocator.free(aligned);
+	allocator.free(padding);
+	y_test_assert(allocator.is_empty());
+	y_test_assert(allocator.free_blocks() == 1);
+}
+
+y_test_func("TLSFAllocator stress") {
+	static constexpr usize size = 16 * 1024 * 1024;
+	TLSFAllocator allocator(size, 256);
+
+	struct Alloc {
+		usize offset;
+		usize size;
+	};
+
+	math::FastRandom rng;
+	core::Vector<Alloc> allocs;
+	for(usize i = 0; i != 20000; ++i) {
+		if(allocs.is_empty() || rng() % 3) {
+			const usize alloc_size = 1 + rng() % (64 * 1024);
+			const usize alignment = usize(256) << (rng() % 4);
+			if(auto r = allocator.allocate(alloc_size, alignment)) {
+				y_test_assert(r.unwrap() % alignment == 0);
+				y_test_assert(r.unwrap() + alloc_size <= size);
+				allocs << Alloc{r.unwrap(), alloc_size};
+			}
+		} else {
+			const usize index = rng() % allocs.size();
+			allocator.free(allocs[index].offset);
+			allocs.erase_unordered(allocs.begin() + index);
+		}
+	}
+
+	// No allocation should overlap
+	std::sort(allocs.begin(), allocs.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+	for(usize i = 1; i < allocs.size(); ++i) {
+		y_test_assert(allocs[i - 1].offset + allocs[i - 1].size <= allocs[i].offset);
+	}
+
+	for(const auto& a : allocs) {
+		allocator.free(a.offset);
+	}
+	y_test_assert(allocator.is_empty());
+	y_test_assert(allocator.free_blocks() == 1);
+	y_test_assert(allocator.stats().largest_free_block == size);
+}
+
+}
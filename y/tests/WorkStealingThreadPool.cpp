@@ -0,0 +1,130 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/concurrent/WorkStealingThreadPool.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace y::concurrent;
+
+static void wait_for_group(WorkStealingThreadPool& pool, const DependencyGroup& group) {
+	while(!group.is_ready()) {
+		pool.process_until_empty();
+	}
+}
+
+y_test_func("WorkStealingThreadPool schedule") {
+	WorkStealingThreadPool pool(4);
+
+	std::atomic<usize> counter = 0;
+	DependencyGroup group;
+	for(usize i = 0; i != 1024; ++i) {
+		pool.schedule([&] { ++counter; }, &group);
+	}
+
+	wait_for_group(pool, group);
+	y_test_assert(counter == 1024);
+	y_test_assert(group.is_expired());
+}
+
+y_test_func("WorkStealingThreadPool dependencies") {
+	WorkStealingThreadPool pool(4);
+
+	std::atomic<usize> counter = 0;
+	std::atomic<bool> ok = true;
+
+	DependencyGroup first;
+	for(usize i = 0; i != 256; ++i) {
+		pool.schedule([&] { ++counter; }, &first);
+	}
+
+	DependencyGroup second;
+	for(usize i = 0; i != 256; ++i) {
+		pool.schedule([&] {
+			if(counter.fetch_add(1) < 256) {
+				ok = false;
+			}
+		}, &second, first);
+	}
+
+	wait_for_group(pool, second);
+	y_test_assert(first.is_ready());
+	y_test_assert(counter == 512);
+	y_test_assert(ok);
+}
+
+y_test_func("WorkStealingThreadPool nested schedule") {
+	WorkStealingThreadPool pool(4);
+
+	std::atomic<usize> counter = 0;
+	DependencyGroup group;
+	for(usize i = 0; i != 64; ++i) {
+		pool.schedule([&] {
+			for(usize j = 0; j != 16; ++j) {
+				pool.schedule([&] { ++counter; }, &group);
+			}
+		}, &group);
+	}
+
+	wait_for_group(pool, group);
+	y_test_assert(counter == 64 * 16);
+}
+
+y_test_func("WorkStealingThreadPool future") {
+	WorkStealingThreadPool pool(2);
+
+	DependencyGroup group;
+	pool.schedule([] {}, &group);
+
+	auto future = pool.schedule_with_future([] { return 7; }, nullptr, group);
+	y_test_assert(future.get() == 7);
+	y_test_assert(pool.pending_tasks() == 0);
+}
+
+y_test_func("WorkStealingThreadPool parallel_for") {
+	WorkStealingThreadPool pool(4);
+
+	core::Vector<usize> values(1000, usize(0));
+	pool.parallel_for(values.size(), 64, [&](usize begin, usize end) {
+		for(usize i = begin; i != end; ++i) {
+			values[i] += i;
+		}
+	});
+
+	for(usize i = 0; i != values.size(); ++i) {
+		y_test_assert(values[i] == i);
+	}
+}
+
+y_test_func("WorkStealingThreadPool no thread") {
+	WorkStealingThreadPool pool(0);
+
+	usize counter = 0;
+	DependencyGroup group;
+	pool.schedule([&] { ++counter; }, &group);
+	y_test_assert(counter == 1);
+
+	pool.schedule([&] { counter *= 3; }, nullptr, group);
+	y_test_assert(counter == 3);
+}
+
+}
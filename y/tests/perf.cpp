@@ -0,0 +1,126 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/utils/perf.h>
+#include <y/io2/File.h>
+#include <y/test/test.h>
+
+#include <thread>
+#include <cstdio>
+
+namespace {
+using namespace y;
+
+#ifdef Y_PERF_LOG_ENABLED
+
+static core::String read_file(const char* filename) {
+	core::Vector<u8> data;
+	io2::File::open(filename).unwrap().read_all(data).unwrap();
+	return core::String(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+static usize count(std::string_view str, std::string_view pattern) {
+	usize n = 0;
+	for(usize pos = str.find(pattern); pos != std::string_view::npos; pos = str.find(pattern, pos + 1)) {
+		++n;
+	}
+	return n;
+}
+
+static void profiled_func() {
+	y_profile_zone("perf test zone");
+}
+
+y_test_func("perf capture") {
+	const char* filename = "perf_test_capture.json";
+
+	profiled_func();
+	perf::start_capture(filename);
+	y_test_assert(perf::is_capturing());
+
+	for(usize i = 0; i != 100; ++i) {
+		profiled_func();
+	}
+	std::thread([] {
+		for(usize i = 0; i != 100; ++i) {
+			profiled_func();
+		}
+	}).join();
+
+	perf::end_capture();
+	y_test_assert(!perf::is_capturing());
+
+	const core::String json = read_file(filename);
+	y_test_assert(json.starts_with(R"({"traceEvents":[)"));
+	y_test_assert(json.ends_with("]}"));
+	y_test_assert(count(json, R"("name":"perf test zone","cat":"","ph":"B")") == 200);
+	y_test_assert(count(json, R"("name":"perf test zone","cat":"","ph":"E")") == 200);
+
+	std::remove(filename);
+}
+
+y_test_func("perf virtual track") {
+	const char* filename = "perf_test_track.json";
+
+	perf::start_capture(filename);
+
+	const u64 reference = perf::timestamp();
+	for(usize i = 0; i != 10; ++i) {
+		perf::track_enter("Test track", "track test zone", reference, i * 1000);
+		perf::track_leave("Test track", "track test zone", reference, i * 1000 + 500);
+	}
+
+	perf::end_capture();
+
+	const core::String json = read_file(filename);
+	y_test_assert(json.ends_with("]}"));
+	y_test_assert(count(json, R"("name":"track test zone","cat":"Test track","ph":"B")") == 10);
+	y_test_assert(count(json, R"("name":"track test zone","cat":"Test track","ph":"E")") == 10);
+	y_test_assert(count(json, "Test track\"}}") == 1);
+
+	std::remove(filename);
+}
+
+y_test_func("perf flight recorder") {
+	const char* filename = "perf_test_flight_recorder.json";
+
+	perf::start_flight_recorder(60.0);
+	y_test_assert(perf::is_flight_recorder_running());
+
+	for(usize i = 0; i != 10; ++i) {
+		profiled_func();
+	}
+
+	perf::dump_flight_recorder(filename);
+	perf::stop_flight_recorder();
+	y_test_assert(!perf::is_flight_recorder_running());
+
+	const core::String json = read_file(filename);
+	y_test_assert(json.ends_with("]}"));
+	y_test_assert(count(json, R"("name":"perf test zone","cat":"","ph":"B")") >= 10);
+
+	std::remove(filename);
+}
+
+#endif
+
+}
@@ -0,0 +1,80 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/utils/sort.h>
+
+#include <y/test/test.h>
+
+#include <y/core/Vector.h>
+
+#include <random>
+
+namespace {
+using namespace y;
+
+y_test_func("radix_sort u64") {
+	std::mt19937_64 rng(42);
+	core::Vector<u64> values;
+	for(usize i = 0; i != 10000; ++i) {
+		values << rng();
+	}
+
+	core::Vector<u64> expected = values;
+	std::sort(expected.begin(), expected.end());
+
+	core::Vector<u64> buffer(values.size(), 0);
+	radix_sort(values.data(), values.data() + values.size(), buffer.data(), [](u64 v) { return v; });
+
+	y_test_assert(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+}
+
+y_test_func("radix_sort stable") {
+	std::mt19937 rng(7);
+	core::Vector<std::pair<u32, u32>> values;
+	for(u32 i = 0; i != 5000; ++i) {
+		values << std::pair<u32, u32>(u32(rng() % 64) << 12, i);
+	}
+
+	core::Vector<std::pair<u32, u32>> buffer(values.size(), std::pair<u32, u32>());
+	radix_sort(values.data(), values.data() + values.size(), buffer.data(), [](const auto& p) { return p.first; });
+
+	for(usize i = 1; i < values.size(); ++i) {
+		y_test_assert(values[i - 1].first <= values[i].first);
+		if(values[i - 1].first == values[i].first) {
+			y_test_assert(values[i - 1].second < values[i].second);
+		}
+	}
+}
+
+y_test_func("radix_sort trivial") {
+	u32 values[] = {3, 3, 3};
+	u32 buffer[3] = {};
+	radix_sort(values, values + 3, buffer, [](u32 v) { return v; });
+	y_test_assert(values[0] == 3 && values[1] == 3 && values[2] == 3);
+
+	u32 one[] = {7};
+	radix_sort(one, one + 1, buffer, [](u32 v) { return v; });
+	y_test_assert(one[0] == 7);
+}
+
+}
+
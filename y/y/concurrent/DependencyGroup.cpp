@@ -0,0 +1,89 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "DependencyGroup.h"
+#include "WorkStealingThreadPool.h"
+
+namespace y {
+namespace concurrent {
+
+DependencyGroup::SharedData::~SharedData() {
+	// Tasks still waiting here will never be run
+	for(detail::ScheduledTask* task : continuations) {
+		delete task;
+	}
+}
+
+bool DependencyGroup::is_ready() const {
+	return dependency_count() == 0;
+}
+
+bool DependencyGroup::is_expired() const {
+	return _data != nullptr && _data->counter == 0;
+}
+
+u32 DependencyGroup::dependency_count() const {
+	return !_data ? u32(0) : u32(_data->counter);
+}
+
+void DependencyGroup::add_dependency() {
+	if(!_data) {
+		_data = std::make_shared<SharedData>();
+	} else {
+		++_data->counter;
+	}
+}
+
+void DependencyGroup::solve_dependency() {
+	if(!_data) {
+		return;
+	}
+
+	core::Vector<detail::ScheduledTask*> ready;
+	{
+		const std::unique_lock lock(_data->lock);
+		y_debug_assert(_data->counter != 0);
+		if(--_data->counter == 0) {
+			ready.swap(_data->continuations);
+		}
+	}
+
+	for(detail::ScheduledTask* task : ready) {
+		task->pool->push_task(task);
+	}
+}
+
+bool DependencyGroup::add_continuation(detail::ScheduledTask* task) {
+	if(!_data) {
+		return false;
+	}
+
+	const std::unique_lock lock(_data->lock);
+	if(_data->counter == 0) {
+		return false;
+	}
+	_data->continuations << task;
+	return true;
+}
+
+}
+}
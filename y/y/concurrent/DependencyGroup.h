@@ -0,0 +1,76 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CONCURRENT_DEPENDENCYGROUP_H
+#define Y_CONCURRENT_DEPENDENCYGROUP_H
+
+#include <y/core/Vector.h>
+
+#include "SpinLock.h"
+
+#include <memory>
+#include <atomic>
+
+namespace y {
+namespace concurrent {
+
+class StaticThreadPool;
+class WorkStealingThreadPool;
+
+namespace detail {
+struct ScheduledTask;
+}
+
+class DependencyGroup {
+	public:
+		DependencyGroup() = default;
+
+		bool is_ready() const;
+		bool is_expired() const;
+		u32 dependency_count() const;
+
+	private:
+		friend class StaticThreadPool;
+		friend class WorkStealingThreadPool;
+
+		struct SharedData : NonMovable {
+			~SharedData();
+
+			std::atomic<u32> counter = 1;
+
+			// Tasks waiting on this group, they are pushed back to their pool when the counter reaches 0
+			SpinLock lock;
+			core::Vector<detail::ScheduledTask*> continuations;
+		};
+
+		void add_dependency();
+		void solve_dependency();
+
+		// Takes ownership of the task if the group is not ready, returns false otherwise
+		bool add_continuation(detail::ScheduledTask* task);
+
+		std::shared_ptr<SharedData> _data;
+};
+
+}
+}
+
+#endif // Y_CONCURRENT_DEPENDENCYGROUP_H
@@ -30,34 +30,6 @@ namespace y {
 namespace concurrent {
 
 
-bool DependencyGroup::is_ready() const {
-	return dependency_count() == 0;
-}
-
-bool DependencyGroup::is_expired() const {
-	return _counter != nullptr && (*_counter) == 0;
-}
-
-u32 DependencyGroup::dependency_count() const {
-	return !_counter ? u32(0) : u32(*_counter);
-}
-
-void DependencyGroup::add_dependency() {
-	if(!_counter) {
-		_counter = std::make_shared<std::atomic<u32>>(1);
-	} else {
-		++(*_counter);
-	}
-}
-
-void DependencyGroup::solve_dependency() {
-	if(_counter) {
-		y_debug_assert(*_counter != 0); // not 100% thread safe but we don't care
-		--(*_counter);
-	}
-}
-
-
 StaticThreadPool::FuncData::FuncData(Func func, DependencyGroup wait, DependencyGroup done) :
 		function(std::move(func)),
 		wait_for(std::move(wait)),
@@ -25,6 +25,7 @@ SOFTWARE.
 #include <y/core/Functor.h>
 #include <y/core/Vector.h>
 
+#include "DependencyGroup.h"
 #include "concurrent.h"
 
 #include <list>
@@ -37,25 +38,6 @@ SOFTWARE.
 namespace y {
 namespace concurrent {
 
-class StaticThreadPool;
-
-class DependencyGroup {
-	public:
-		DependencyGroup() = default;
-
-		bool is_ready() const;
-		bool is_expired() const;
-		u32 dependency_count() const;
-
-	private:
-		friend class StaticThreadPool;
-
-		void add_dependency();
-		void solve_dependency();
-
-		std::shared_ptr<std::atomic<u32>> _counter;
-};
-
 class StaticThreadPool : NonMovable {
 	private:
 		using Func = core::Function<void()>;
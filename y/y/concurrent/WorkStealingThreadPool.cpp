@@ -0,0 +1,184 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "WorkStealingThreadPool.h"
+
+#include <y/utils/perf.h>
+
+namespace y {
+namespace concurrent {
+
+namespace detail {
+static thread_local const WorkStealingThreadPool* current_pool = nullptr;
+static thread_local usize current_queue = 0;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(usize thread_count, const char* thread_names) :
+		_queues(std::make_unique<WorkQueue[]>(std::max(thread_count, usize(1)))),
+		_queue_count(std::max(thread_count, usize(1))) {
+
+	for(usize i = 0; i != thread_count; ++i) {
+		_threads.emplace_back([thread_names, i, this] {
+			concurrent::set_thread_name(thread_names);
+			detail::current_pool = this;
+			detail::current_queue = i;
+			worker(i);
+		});
+	}
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+	{
+		const std::unique_lock lock(_sleep_lock);
+		_run = false;
+	}
+	_sleep_condition.notify_all();
+
+	for(auto& thread : _threads) {
+		thread.join();
+	}
+
+	for(usize i = 0; i != _queue_count; ++i) {
+		for(Task* task : _queues[i].tasks) {
+			delete task;
+		}
+	}
+}
+
+usize WorkStealingThreadPool::concurency() const {
+	return _threads.size();
+}
+
+usize WorkStealingThreadPool::pending_tasks() const {
+	return _pending;
+}
+
+void WorkStealingThreadPool::process_until_empty() {
+	const bool is_worker = detail::current_pool == this;
+	const usize index = is_worker ? detail::current_queue : 0;
+	while(Task* task = pop_task(index, is_worker)) {
+		run_task(task);
+	}
+}
+
+void WorkStealingThreadPool::wait_until_ready(const DependencyGroup& group) {
+	while(!group.is_ready()) {
+		process_until_empty();
+		if(!group.is_ready()) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void WorkStealingThreadPool::schedule(Func&& func, DependencyGroup* on_done, DependencyGroup wait_for) {
+	Task* task = new Task{std::move(func), DependencyGroup(), this};
+	if(on_done) {
+		on_done->add_dependency();
+		task->on_done = *on_done;
+	}
+
+	++_pending;
+
+	if(!wait_for.add_continuation(task)) {
+		push_task(task);
+	}
+
+	if(!concurency()) {
+		process_until_empty();
+	}
+}
+
+void WorkStealingThreadPool::push_task(Task* task) {
+	y_debug_assert(task->pool == this);
+
+	const usize index = detail::current_pool == this ? detail::current_queue : (_next_queue++ % _queue_count);
+	WorkQueue& queue = _queues[index];
+	{
+		const std::unique_lock lock(queue.lock);
+		queue.tasks.push_back(task);
+		++queue.size;
+	}
+
+	++_queued;
+	if(_sleeping) {
+		const std::unique_lock lock(_sleep_lock);
+		_sleep_condition.notify_one();
+	}
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::pop_task(usize queue_index, bool owner) {
+	for(usize i = 0; i != _queue_count && _queued; ++i) {
+		WorkQueue& queue = _queues[(queue_index + i) % _queue_count];
+		if(!queue.size) {
+			continue;
+		}
+
+		const std::unique_lock lock(queue.lock);
+		if(queue.tasks.empty()) {
+			continue;
+		}
+
+		Task* task = nullptr;
+		if(owner && i == 0) {
+			task = queue.tasks.back();
+			queue.tasks.pop_back();
+		} else {
+			task = queue.tasks.front();
+			queue.tasks.pop_front();
+		}
+
+		--queue.size;
+		--_queued;
+		return task;
+	}
+	return nullptr;
+}
+
+void WorkStealingThreadPool::run_task(Task* task) {
+	--_pending;
+	{
+		y_profile_zone("exec");
+		task->function();
+	}
+
+	DependencyGroup on_done = std::move(task->on_done);
+	delete task;
+
+	on_done.solve_dependency();
+}
+
+void WorkStealingThreadPool::worker(usize index) {
+	while(_run) {
+		if(Task* task = pop_task(index, true)) {
+			run_task(task);
+			continue;
+		}
+
+		std::unique_lock lock(_sleep_lock);
+		++_sleeping;
+		_sleep_condition.wait(lock, [&] { return _queued || !_run; });
+		--_sleeping;
+	}
+}
+
+}
+}
@@ -0,0 +1,132 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CONCURRENT_WORKSTEALINGTHREADPOOL_H
+#define Y_CONCURRENT_WORKSTEALINGTHREADPOOL_H
+
+#include <y/core/Functor.h>
+#include <y/core/Vector.h>
+
+#include "DependencyGroup.h"
+#include "SpinLock.h"
+#include "concurrent.h"
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <condition_variable>
+
+namespace y {
+namespace concurrent {
+
+namespace detail {
+struct ScheduledTask {
+	core::Function<void()> function;
+	DependencyGroup on_done;
+	WorkStealingThreadPool* pool = nullptr;
+};
+}
+
+// Each worker owns a deque: it pushes and pops at the back while idle workers steal from the front of the others.
+// Tasks waiting on a DependencyGroup are parked in the group and only enqueued once its last dependency is solved.
+class WorkStealingThreadPool : NonMovable {
+	private:
+		using Func = core::Function<void()>;
+		using Task = detail::ScheduledTask;
+
+		struct alignas(64) WorkQueue : NonMovable {
+			SpinLock lock;
+			std::deque<Task*> tasks;
+			std::atomic<usize> size = 0;
+		};
+
+	public:
+		// Thread names must have static storage
+		WorkStealingThreadPool(usize thread_count = std::max(4u, std::thread::hardware_concurrency()), const char* thread_names = nullptr);
+		~WorkStealingThreadPool();
+
+		usize concurency() const;
+		usize pending_tasks() const;
+
+		// Empty means all tasks are scheduled, not done!
+		void process_until_empty();
+
+		void schedule(Func&& func, DependencyGroup* on_done = nullptr, DependencyGroup wait_for = DependencyGroup());
+
+		template<typename F, typename R = decltype(std::declval<F>()())>
+		std::future<R> schedule_with_future(F&& func, DependencyGroup* on_done = nullptr, DependencyGroup wait_for = DependencyGroup()) {
+			struct { mutable std::promise<R> promise; } box;
+			auto future = box.promise.get_future();
+			schedule([b = std::move(box), f = y_fwd(func)]() { b.promise.set_value(f()); }, on_done, wait_for);
+			return future;
+		}
+
+		// Calls func(begin, end) on chunks of [0, size) and returns once every chunk is done
+		template<typename F>
+		void parallel_for(usize size, usize chunk_size, F&& func) {
+			y_debug_assert(chunk_size);
+			if(!size) {
+				return;
+			}
+
+			DependencyGroup group;
+			for(usize begin = chunk_size; begin < size; begin += chunk_size) {
+				const usize end = std::min(begin + chunk_size, size);
+				schedule([&func, begin, end] { func(begin, end); }, &group);
+			}
+			func(usize(0), std::min(chunk_size, size));
+			wait_until_ready(group);
+		}
+
+		// Processes tasks on the calling thread until the group is ready
+		void wait_until_ready(const DependencyGroup& group);
+
+	private:
+		friend class DependencyGroup;
+
+		void push_task(Task* task);
+		Task* pop_task(usize queue_index, bool owner);
+		void run_task(Task* task);
+
+		void worker(usize index);
+
+		std::unique_ptr<WorkQueue[]> _queues;
+		usize _queue_count = 0;
+
+		std::atomic<usize> _next_queue = 0;
+		std::atomic<usize> _queued = 0;
+		std::atomic<usize> _pending = 0;
+
+		std::mutex _sleep_lock;
+		std::condition_variable _sleep_condition;
+		std::atomic<usize> _sleeping = 0;
+
+		std::atomic<bool> _run = true;
+
+		core::Vector<std::thread> _threads;
+};
+
+}
+}
+
+#endif // Y_CONCURRENT_WORKSTEALINGTHREADPOOL_H
@@ -22,7 +22,7 @@ SOFTWARE.
 #include "concurrent.h"
 
 
-#include "StaticThreadPool.h"
+#include "WorkStealingThreadPool.h"
 
 namespace y {
 namespace concurrent {
@@ -30,8 +30,8 @@ namespace detail {
 static thread_local const char* thread_name = nullptr;
 }
 
-StaticThreadPool& default_thread_pool() {
-	static StaticThreadPool _pool;
+WorkStealingThreadPool& default_thread_pool() {
+	static WorkStealingThreadPool _pool;
 	return _pool;
 }
 
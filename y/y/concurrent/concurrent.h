@@ -27,9 +27,9 @@ SOFTWARE.
 namespace y {
 namespace concurrent {
 
-class StaticThreadPool;
+class WorkStealingThreadPool;
 
-StaticThreadPool& default_thread_pool();
+WorkStealingThreadPool& default_thread_pool();
 
 u32 thread_id();
 
@@ -26,6 +26,8 @@ SOFTWARE.
 #include <y/utils/traits.h>
 
 #include <memory>
+#include <new>
+#include <cstddef>
 
 #define Y_NON_CONST_FUNCTORS
 
@@ -146,13 +148,150 @@ class Functor<Container, Ret(Args...)> {
 		Container<FunctionBase<Ret, Args...>> _function;
 };
 
-}
 
+// Non virtual dispatch table for Function: one static instance per stored type
+template<typename Ret, typename... Args>
+struct FunctionOps {
+	Ret (*invoke)(void* storage, Args&&... args);
+
+	// Move constructs into dst and destroys src
+	void (*relocate)(void* dst, void* src);
+	void (*destroy)(void* storage);
+};
+
+}
 
 
+template<typename T>
+class Function {};
 
+// Move only function with inline storage.
+// Callables that fit in inline_size bytes are stored in place, larger ones are boxed on the heap.
 template<typename Ret, typename... Args>
-using Function = detail::Functor<std::unique_ptr, Ret, Args...>;
+class Function<Ret(Args...)> : NonCopyable {
+	public:
+		static constexpr usize inline_size = 56;
+
+	private:
+		template<typename T>
+		static constexpr bool is_inline = sizeof(T) <= inline_size &&
+										  alignof(T) <= alignof(std::max_align_t) &&
+										  std::is_nothrow_move_constructible_v<T>;
+
+	public:
+		Function() = default;
+
+		template<typename T,
+				 typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, Function>>>
+		Function(T&& func) {
+			using F = std::decay_t<T>;
+			if constexpr(is_inline<F>) {
+				new(_storage) F(y_fwd(func));
+			} else {
+				*reinterpret_cast<F**>(_storage) = new F(y_fwd(func));
+			}
+			_ops = &ops<F>;
+		}
+
+		Function(Function&& other) {
+			move_from(other);
+		}
+
+		Function& operator=(Function&& other) {
+			if(&other != this) {
+				clear();
+				move_from(other);
+			}
+			return *this;
+		}
+
+		~Function() {
+			clear();
+		}
+
+		bool is_empty() const {
+			return !_ops;
+		}
+
+		// Functions are move only: two functions are only equal if they are the same object or both empty
+		bool operator==(const Function& other) const {
+			return this == &other || (is_empty() && other.is_empty());
+		}
+
+		bool operator!=(const Function& other) const {
+			return !operator==(other);
+		}
+
+		Ret operator()(Args... args) const {
+			y_debug_assert(_ops);
+			return _ops->invoke(_storage, y_fwd(args)...);
+		}
+
+	private:
+		using Ops = detail::FunctionOps<Ret, Args...>;
+
+		template<typename F>
+		static F* get(void* storage) {
+			if constexpr(is_inline<F>) {
+				return std::launder(reinterpret_cast<F*>(storage));
+			} else {
+				return *reinterpret_cast<F**>(storage);
+			}
+		}
+
+		template<typename F>
+		static Ret invoke(void* storage, Args&&... args) {
+			if constexpr(std::is_void_v<Ret>) {
+				(*get<F>(storage))(y_fwd(args)...);
+			} else {
+				return (*get<F>(storage))(y_fwd(args)...);
+			}
+		}
+
+		template<typename F>
+		static void relocate(void* dst, void* src) {
+			if constexpr(is_inline<F>) {
+				F* f = get<F>(src);
+				new(dst) F(std::move(*f));
+				f->~F();
+			} else {
+				*reinterpret_cast<F**>(dst) = get<F>(src);
+			}
+		}
+
+		template<typename F>
+		static void destroy(void* storage) {
+			if constexpr(is_inline<F>) {
+				get<F>(storage)->~F();
+			} else {
+				delete get<F>(storage);
+			}
+		}
+
+		template<typename F>
+		static constexpr Ops ops = {&invoke<F>, &relocate<F>, &destroy<F>};
+
+
+		void move_from(Function& other) {
+			if(other._ops) {
+				other._ops->relocate(_storage, other._storage);
+				_ops = other._ops;
+				other._ops = nullptr;
+			}
+		}
+
+		void clear() {
+			if(_ops) {
+				_ops->destroy(_storage);
+				_ops = nullptr;
+			}
+		}
+
+		// Mutable: like the callables it stores, Function can be called through a const reference
+		alignas(std::max_align_t) mutable std::byte _storage[inline_size];
+		const Ops* _ops = nullptr;
+};
+
 
 template<typename Ret, typename... Args>
 using Functor = detail::Functor<std::shared_ptr, Ret, Args...>;
@@ -52,11 +52,10 @@ void break_in_debugger();
 
 #define y_fwd(var) std::forward<decltype(var)>(var)
 
-#ifdef Y_DEBUG
+// Profiling is cheap enough when not recording to be kept in release builds
 #ifndef Y_PERF_LOG_DISABLED
 #define Y_PERF_LOG_ENABLED
 #endif
-#endif
 
 
 /****************** OS DEFINES BELOW ******************/
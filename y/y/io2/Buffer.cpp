@@ -92,6 +92,15 @@ ReadUpToResult Buffer::read_all(core::Vector<u8>& data) {
 	return core::Ok(r);
 }
 
+const u8* Buffer::try_view(usize bytes) {
+	if(remaining() < bytes) {
+		return nullptr;
+	}
+	const u8* view = _buffer.data() + _cursor;
+	_cursor += bytes;
+	return view;
+}
+
 WriteResult Buffer::write(const void* data, usize bytes) {
 	const u8* data_bytes = static_cast<const u8*>(data);
 	if(at_end()) {
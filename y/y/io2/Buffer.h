@@ -46,6 +46,8 @@ class Buffer final : public Reader, public Writer {
 		ReadUpToResult read_up_to(void* data, usize max_bytes) override;
 		ReadUpToResult read_all(core::Vector<u8>& data) override;
 
+		const u8* try_view(usize bytes) override;
+
 		WriteResult write(const void* data, usize bytes) override;
 
 		FlushResult flush() override;
@@ -31,6 +31,7 @@ namespace y {
 namespace io2 {
 
 class File;
+class MappedFile;
 class Buffer;
 
 using ReadUpToResult = core::Result<usize, usize>;
@@ -53,6 +54,13 @@ class Reader : NonCopyable {
 		virtual void seek(usize byte) = 0;
 		virtual usize tell() const = 0;
 
+		// Returns the next bytes in contiguous memory and skips them, or null (without moving) if the reader can't do that.
+		// The memory stays valid until the reader is destroyed or written to.
+		virtual const u8* try_view(usize bytes) {
+			unused(bytes);
+			return nullptr;
+		}
+
 		template<typename T>
 		ReadResult read_one(T& t) {
 			static_assert(std::is_trivially_copyable_v<T>);
@@ -0,0 +1,387 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "BVH.h"
+
+#include <algorithm>
+
+namespace y {
+namespace math {
+
+static float half_area(const Vec3& min, const Vec3& max) {
+	const Vec3 extent = max - min;
+	return extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x();
+}
+
+static float half_area_union(const Vec3& min_a, const Vec3& max_a, const Vec3& min_b, const Vec3& max_b) {
+	return half_area(min_a.min(min_b), max_a.max(max_b));
+}
+
+
+BVH::BVH(float margin) : _margin(margin) {
+}
+
+BVH::ProxyId BVH::insert(const Vec3& min, const Vec3& max, u32 data) {
+	const u32 leaf = alloc_node();
+	{
+		Node& node = _nodes[leaf];
+		node.min = min - _margin;
+		node.max = max + _margin;
+		node.right = data;
+	}
+	insert_leaf(leaf);
+	++_leaf_count;
+	return leaf;
+}
+
+bool BVH::update(ProxyId id, const Vec3& min, const Vec3& max) {
+	y_debug_assert(id < _nodes.size() && _nodes[id].is_leaf() && _nodes[id].height >= 0);
+
+	Node& node = _nodes[id];
+	for(usize i = 0; i != 3; ++i) {
+		if(min[i] < node.min[i] || max[i] > node.max[i]) {
+			remove_leaf(id);
+			node.min = min - _margin;
+			node.max = max + _margin;
+			insert_leaf(id);
+			return true;
+		}
+	}
+	return false;
+}
+
+void BVH::remove(ProxyId id) {
+	y_debug_assert(id < _nodes.size() && _nodes[id].is_leaf() && _nodes[id].height >= 0);
+
+	remove_leaf(id);
+	free_node(id);
+	--_leaf_count;
+}
+
+core::Vector<BVH::ProxyId> BVH::build(core::Span<Entry> entries) {
+	clear();
+
+	core::Vector<ProxyId> proxies(entries.size(), invalid_proxy);
+	if(entries.is_empty()) {
+		return proxies;
+	}
+
+	core::Vector<BuildItem> items;
+	items.set_min_capacity(entries.size());
+	for(usize i = 0; i != entries.size(); ++i) {
+		items << BuildItem{entries[i].min + entries[i].max, u32(i)};
+	}
+
+	_nodes.set_min_capacity(entries.size() * 2 - 1);
+	_root = build_range(entries.data(), items.data(), items.size(), proxies.data());
+	_leaf_count = entries.size();
+
+	return proxies;
+}
+
+void BVH::clear() {
+	_nodes.clear();
+	_root = invalid_index;
+	_free = invalid_index;
+	_leaf_count = 0;
+}
+
+usize BVH::size() const {
+	return _leaf_count;
+}
+
+bool BVH::is_empty() const {
+	return !_leaf_count;
+}
+
+usize BVH::height() const {
+	return _root == invalid_index ? 0 : usize(_nodes[_root].height) + 1;
+}
+
+u32 BVH::data(ProxyId id) const {
+	y_debug_assert(id < _nodes.size() && _nodes[id].is_leaf());
+	return _nodes[id].right;
+}
+
+u32 BVH::alloc_node() {
+	if(_free != invalid_index) {
+		const u32 index = _free;
+		_free = _nodes[index].parent;
+		_nodes[index] = Node();
+		return index;
+	}
+
+	const u32 index = u32(_nodes.size());
+	y_debug_assert(index < inside_bit);
+	_nodes.emplace_back();
+	return index;
+}
+
+void BVH::free_node(u32 index) {
+	Node& node = _nodes[index];
+	node.parent = _free;
+	node.height = -1;
+	_free = index;
+}
+
+void BVH::insert_leaf(u32 leaf) {
+	if(_root == invalid_index) {
+		_root = leaf;
+		_nodes[leaf].parent = invalid_index;
+		return;
+	}
+
+	const Vec3 leaf_min = _nodes[leaf].min;
+	const Vec3 leaf_max = _nodes[leaf].max;
+
+	// Walk down the tree, picking the child that increases the total surface area the least
+	u32 index = _root;
+	while(!_nodes[index].is_leaf()) {
+		const Node& node = _nodes[index];
+
+		const float area = half_area(node.min, node.max);
+		const float combined_area = half_area_union(node.min, node.max, leaf_min, leaf_max);
+
+		// Cost of creating a new parent for this node and the leaf
+		const float cost = 2.0f * combined_area;
+		// Minimum cost of pushing the leaf further down
+		const float inheritance_cost = 2.0f * (combined_area - area);
+
+		const auto child_cost = [&](u32 child_index) {
+			const Node& child = _nodes[child_index];
+			const float child_area = half_area_union(child.min, child.max, leaf_min, leaf_max);
+			return (child.is_leaf() ? child_area : child_area - half_area(child.min, child.max)) + inheritance_cost;
+		};
+
+		const float left_cost = child_cost(node.left);
+		const float right_cost = child_cost(node.right);
+
+		if(cost < left_cost && cost < right_cost) {
+			break;
+		}
+
+		index = left_cost < right_cost ? node.left : node.right;
+	}
+
+	const u32 sibling = index;
+	const u32 old_parent = _nodes[sibling].parent;
+	const u32 new_parent = alloc_node();
+
+	{
+		Node& parent = _nodes[new_parent];
+		const Node& sibling_node = _nodes[sibling];
+		parent.parent = old_parent;
+		parent.min = leaf_min.min(sibling_node.min);
+		parent.max = leaf_max.max(sibling_node.max);
+		parent.height = sibling_node.height + 1;
+		parent.left = sibling;
+		parent.right = leaf;
+	}
+
+	if(old_parent != invalid_index) {
+		Node& parent = _nodes[old_parent];
+		(parent.left == sibling ? parent.left : parent.right) = new_parent;
+	} else {
+		_root = new_parent;
+	}
+
+	_nodes[sibling].parent = new_parent;
+	_nodes[leaf].parent = new_parent;
+
+	refit(old_parent);
+}
+
+void BVH::remove_leaf(u32 leaf) {
+	if(leaf == _root) {
+		_root = invalid_index;
+		return;
+	}
+
+	const u32 parent = _nodes[leaf].parent;
+	const u32 grand_parent = _nodes[parent].parent;
+	const u32 sibling = _nodes[parent].left == leaf ? _nodes[parent].right : _nodes[parent].left;
+
+	free_node(parent);
+
+	if(grand_parent != invalid_index) {
+		Node& grand_parent_node = _nodes[grand_parent];
+		(grand_parent_node.left == parent ? grand_parent_node.left : grand_parent_node.right) = sibling;
+		_nodes[sibling].parent = grand_parent;
+		refit(grand_parent);
+	} else {
+		_root = sibling;
+		_nodes[sibling].parent = invalid_index;
+	}
+}
+
+void BVH::refit(u32 index) {
+	while(index != invalid_index) {
+		index = balance(index);
+
+		Node& node = _nodes[index];
+		const Node& left = _nodes[node.left];
+		const Node& right = _nodes[node.right];
+
+		node.min = left.min.min(right.min);
+		node.max = left.max.max(right.max);
+		node.height = std::max(left.height, right.height) + 1;
+
+		index = node.parent;
+	}
+}
+
+// Rotates the tallest grand child up if the subtree is unbalanced, returns the new subtree root
+u32 BVH::balance(u32 a_index) {
+	Node& a = _nodes[a_index];
+	if(a.is_leaf() || a.height < 2) {
+		return a_index;
+	}
+
+	const u32 b_index = a.left;
+	const u32 c_index = a.right;
+	Node& b = _nodes[b_index];
+	Node& c = _nodes[c_index];
+
+	const auto replace_in_parent = [&](Node& node, u32 old_index, u32 new_index) {
+		if(node.parent != invalid_index) {
+			Node& parent = _nodes[node.parent];
+			(parent.left == old_index ? parent.left : parent.right) = new_index;
+		} else {
+			_root = new_index;
+		}
+	};
+
+	const auto fit = [](Node& node, const Node& x, const Node& y) {
+		node.min = x.min.min(y.min);
+		node.max = x.max.max(y.max);
+		node.height = std::max(x.height, y.height) + 1;
+	};
+
+	const i32 balance = c.height - b.height;
+
+	if(balance > 1) {
+		const u32 f_index = c.left;
+		const u32 g_index = c.right;
+		Node& f = _nodes[f_index];
+		Node& g = _nodes[g_index];
+
+		c.left = a_index;
+		c.parent = a.parent;
+		a.parent = c_index;
+		replace_in_parent(c, a_index, c_index);
+
+		if(f.height > g.height) {
+			c.right = f_index;
+			a.right = g_index;
+			g.parent = a_index;
+			fit(a, b, g);
+			fit(c, a, f);
+		} else {
+			c.right = g_index;
+			a.right = f_index;
+			f.parent = a_index;
+			fit(a, b, f);
+			fit(c, a, g);
+		}
+		return c_index;
+	}
+
+	if(balance < -1) {
+		const u32 d_index = b.left;
+		const u32 e_index = b.right;
+		Node& d = _nodes[d_index];
+		Node& e = _nodes[e_index];
+
+		b.left = a_index;
+		b.parent = a.parent;
+		a.parent = b_index;
+		replace_in_parent(b, a_index, b_index);
+
+		if(d.height > e.height) {
+			b.right = d_index;
+			a.left = e_index;
+			e.parent = a_index;
+			fit(a, c, e);
+			fit(b, a, d);
+		} else {
+			b.right = e_index;
+			a.left = d_index;
+			d.parent = a_index;
+			fit(a, c, d);
+			fit(b, a, e);
+		}
+		return b_index;
+	}
+
+	return a_index;
+}
+
+// Median split along the axis where centers are the most spread out
+u32 BVH::build_range(const Entry* entries, BuildItem* items, usize size, ProxyId* proxies) {
+	const u32 index = alloc_node();
+
+	if(size == 1) {
+		const Entry& entry = entries[items[0].index];
+		Node& node = _nodes[index];
+		node.min = entry.min - _margin;
+		node.max = entry.max + _margin;
+		node.right = entry.data;
+		proxies[items[0].index] = index;
+		return index;
+	}
+
+	Vec3 center_min = items[0].center;
+	Vec3 center_max = center_min;
+	for(usize i = 1; i != size; ++i) {
+		center_min = center_min.min(items[i].center);
+		center_max = center_max.max(items[i].center);
+	}
+
+	const Vec3 spread = center_max - center_min;
+	const usize axis = spread.x() > spread.y() ? (spread.x() > spread.z() ? 0 : 2) : (spread.y() > spread.z() ? 1 : 2);
+
+	const usize half = size / 2;
+	std::nth_element(items, items + half, items + size, [=](const BuildItem& a, const BuildItem& b) {
+		return a.center[axis] < b.center[axis];
+	});
+
+	const u32 left = build_range(entries, items, half, proxies);
+	const u32 right = build_range(entries, items + half, size - half, proxies);
+
+	Node& node = _nodes[index];
+	Node& left_node = _nodes[left];
+	Node& right_node = _nodes[right];
+
+	left_node.parent = index;
+	right_node.parent = index;
+
+	node.left = left;
+	node.right = right;
+	node.min = left_node.min.min(right_node.min);
+	node.max = left_node.max.max(right_node.max);
+	node.height = std::max(left_node.height, right_node.height) + 1;
+
+	return index;
+}
+
+}
+}
@@ -0,0 +1,279 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MATH_BVH_H
+#define Y_MATH_BVH_H
+
+#include "Vec.h"
+
+#include <y/core/Vector.h>
+#include <y/core/Span.h>
+
+namespace y {
+namespace math {
+
+// Dynamic AABB tree: leaves are enlarged by a margin so that small moves don't touch the tree
+// Queries test the enlarged boxes and may report leaves whose exact bounds don't intersect
+class BVH : NonCopyable {
+
+	static constexpr u32 invalid_index = u32(-1);
+	static constexpr u32 inside_bit = u32(1) << 31;
+	static constexpr usize max_stack_size = 256;
+
+	struct Node {
+		Vec3 min;
+		Vec3 max;
+		u32 parent = invalid_index;
+		u32 left = invalid_index;
+		u32 right = invalid_index; // user data for leaves
+		i32 height = 0; // -1 for free nodes
+
+		bool is_leaf() const {
+			return left == invalid_index;
+		}
+	};
+
+	struct BuildItem {
+		Vec3 center; // doubled
+		u32 index;
+	};
+
+	public:
+		using ProxyId = u32;
+		static constexpr ProxyId invalid_proxy = invalid_index;
+
+		struct Entry {
+			Vec3 min;
+			Vec3 max;
+			u32 data = 0;
+		};
+
+		BVH(float margin = 0.0f);
+
+		ProxyId insert(const Vec3& min, const Vec3& max, u32 data);
+		// Returns true if the proxy had to be moved in the tree
+		bool update(ProxyId id, const Vec3& min, const Vec3& max);
+		void remove(ProxyId id);
+
+		// Rebuilds the whole tree top-down, much faster than inserting entries one by one
+		// Returns the proxy of each entry in order
+		core::Vector<ProxyId> build(core::Span<Entry> entries);
+
+		void clear();
+
+		usize size() const;
+		bool is_empty() const;
+		usize height() const;
+
+		u32 data(ProxyId id) const;
+
+
+		template<typename F>
+		void for_each_in_box(const Vec3& min, const Vec3& max, F&& func) const {
+			traverse([&](const Node& node) {
+				return overlaps(node, min, max);
+			}, func);
+		}
+
+		template<typename F>
+		void for_each_in_sphere(const Vec3& center, float radius, F&& func) const {
+			const float radius2 = radius * radius;
+			traverse([&](const Node& node) {
+				return (center.max(node.min).min(node.max) - center).length2() <= radius2;
+			}, func);
+		}
+
+		// Planes point inward: a point p is inside if dot(plane.xyz, p) + plane.w >= 0 for every plane
+		template<typename F>
+		void for_each_in_frustum(core::Span<Vec4> planes, F&& func) const {
+			if(_root == invalid_index) {
+				return;
+			}
+
+			u32 stack[max_stack_size];
+			usize stack_size = 0;
+			stack[stack_size++] = _root;
+
+			while(stack_size) {
+				const u32 top = stack[--stack_size];
+				const Node& node = _nodes[top & ~inside_bit];
+
+				// Subtrees fully inside the frustum are reported without any further test
+				bool inside = top & inside_bit;
+				if(!inside) {
+					const Vec3 center = (node.min + node.max) * 0.5f;
+					const Vec3 half_extent = (node.max - node.min) * 0.5f;
+
+					bool outside = false;
+					inside = true;
+					for(const Vec4& plane : planes) {
+						const float dist = plane.to<3>().dot(center) + plane.w();
+						const float radius = plane.to<3>().abs().dot(half_extent);
+						// Written this way so degenerate (NaN) planes never cull anything
+						if(dist + radius < 0.0f) {
+							outside = true;
+							break;
+						}
+						inside &= dist - radius >= 0.0f;
+					}
+					if(outside) {
+						continue;
+					}
+				}
+
+				if(node.is_leaf()) {
+					func(node.right);
+				} else {
+					y_debug_assert(stack_size + 2 <= max_stack_size);
+					const u32 flag = inside ? inside_bit : 0;
+					stack[stack_size++] = node.left | flag;
+					stack[stack_size++] = node.right | flag;
+				}
+			}
+		}
+
+		// func(data, distance) is called for every leaf hit closer than max_dist and returns the new max distance
+		// Return distance to only find the closest hit, or max_dist to find all of them
+		template<typename F>
+		void raycast(const Vec3& origin, const Vec3& direction, float max_dist, F&& func) const {
+			if(_root == invalid_index) {
+				return;
+			}
+
+			const Vec3 inv_dir(1.0f / direction.x(), 1.0f / direction.y(), 1.0f / direction.z());
+
+			u32 stack[max_stack_size];
+			float dists[max_stack_size];
+			usize stack_size = 0;
+
+			float dist = 0.0f;
+			if(!ray_hit(_nodes[_root], origin, inv_dir, max_dist, dist)) {
+				return;
+			}
+			stack[stack_size] = _root;
+			dists[stack_size++] = dist;
+
+			while(stack_size) {
+				--stack_size;
+				if(dists[stack_size] > max_dist) {
+					continue;
+				}
+
+				const Node& node = _nodes[stack[stack_size]];
+				if(node.is_leaf()) {
+					max_dist = func(node.right, dists[stack_size]);
+					continue;
+				}
+
+				float left_dist = 0.0f;
+				float right_dist = 0.0f;
+				const bool left_hit = ray_hit(_nodes[node.left], origin, inv_dir, max_dist, left_dist);
+				const bool right_hit = ray_hit(_nodes[node.right], origin, inv_dir, max_dist, right_dist);
+
+				y_debug_assert(stack_size + 2 <= max_stack_size);
+
+				// Closest child is pushed last so it gets visited first
+				const bool left_first = left_dist < right_dist;
+				if(right_hit && left_first) {
+					stack[stack_size] = node.right;
+					dists[stack_size++] = right_dist;
+				}
+				if(left_hit) {
+					stack[stack_size] = node.left;
+					dists[stack_size++] = left_dist;
+				}
+				if(right_hit && !left_first) {
+					stack[stack_size] = node.right;
+					dists[stack_size++] = right_dist;
+				}
+			}
+		}
+
+	private:
+		template<typename T, typename F>
+		void traverse(T&& test, F&& func) const {
+			if(_root == invalid_index) {
+				return;
+			}
+
+			u32 stack[max_stack_size];
+			usize stack_size = 0;
+			stack[stack_size++] = _root;
+
+			while(stack_size) {
+				const Node& node = _nodes[stack[--stack_size]];
+				if(!test(node)) {
+					continue;
+				}
+
+				if(node.is_leaf()) {
+					func(node.right);
+				} else {
+					y_debug_assert(stack_size + 2 <= max_stack_size);
+					stack[stack_size++] = node.left;
+					stack[stack_size++] = node.right;
+				}
+			}
+		}
+
+		static bool overlaps(const Node& node, const Vec3& min, const Vec3& max) {
+			for(usize i = 0; i != 3; ++i) {
+				if(node.max[i] < min[i] || node.min[i] > max[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static bool ray_hit(const Node& node, const Vec3& origin, const Vec3& inv_dir, float max_dist, float& dist) {
+			float t_min = 0.0f;
+			float t_max = max_dist;
+			for(usize i = 0; i != 3; ++i) {
+				const float t0 = (node.min[i] - origin[i]) * inv_dir[i];
+				const float t1 = (node.max[i] - origin[i]) * inv_dir[i];
+				t_min = std::max(t_min, std::min(t0, t1));
+				t_max = std::min(t_max, std::max(t0, t1));
+			}
+			dist = t_min;
+			return t_min <= t_max;
+		}
+
+		u32 alloc_node();
+		void free_node(u32 index);
+
+		void insert_leaf(u32 leaf);
+		void remove_leaf(u32 leaf);
+		void refit(u32 index);
+		u32 balance(u32 index);
+
+		u32 build_range(const Entry* entries, BuildItem* items, usize size, ProxyId* proxies);
+
+		core::Vector<Node> _nodes;
+		u32 _root = invalid_index;
+		u32 _free = invalid_index;
+		usize _leaf_count = 0;
+		float _margin = 0.0f;
+};
+
+}
+}
+
+#endif // Y_MATH_BVH_H
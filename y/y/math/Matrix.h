@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <y/utils.h>
 #include "Vec.h"
+#include "simd.h"
 
 namespace y {
 namespace math {
@@ -74,6 +75,9 @@ class Matrix {
 			static_assert(P == N * M, "Wrong number of arguments");
 		}
 
+		// Matrix4<float> products and inverse go through the SIMD kernels
+		static constexpr bool is_simd_mat4 = N == 4 && M == 4 && std::is_same_v<T, float>;
+
 		template<typename U>
 		void set_at(usize i, U u) {
 			const usize r = i / M;
@@ -191,6 +195,14 @@ class Matrix {
 		}
 
 		Matrix inverse() const {
+			if constexpr(is_simd_mat4) {
+				Matrix inv;
+				if(!simd::inverse_mat4(begin(), inv.begin())) {
+					return Matrix();
+				}
+				return inv;
+			}
+
 			T d = determinant();
 			if(d == 0) {
 				return Matrix();
@@ -236,6 +248,12 @@ class Matrix {
 		}
 
 		Column operator*(const Row& v) const {
+			if constexpr(is_simd_mat4) {
+				Column tr;
+				simd::mul_mat4_vec4(begin(), v.data(), tr.data());
+				return tr;
+			}
+
 			Column tr;
 			for(usize i = 0; i != M; ++i) {
 				tr += column(i) * v[i];
@@ -246,6 +264,11 @@ class Matrix {
 		template<typename U, usize P>
 		auto operator*(const Matrix<M, P, U>& m) const {
 			Matrix<N, P, decltype(std::declval<T>() * std::declval<U>())> mat;
+			if constexpr(is_simd_mat4 && P == 4 && std::is_same_v<U, float>) {
+				simd::mul_mat4(begin(), m.begin(), mat.begin());
+				return mat;
+			}
+
 			for(usize i = 0; i != N; ++i) {
 				for(usize j = 0; j != P; ++j) {
 					decltype(std::declval<T>() * std::declval<U>()) tmp(0);
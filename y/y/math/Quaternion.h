@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include "math.h"
 #include "Vec.h"
+#include "simd.h"
 
 #include <limits>
 
@@ -119,6 +120,11 @@ class Quaternion {
 		}
 
 		Quaternion& operator*=(const Quaternion& q) {
+			if constexpr(std::is_same_v<T, float>) {
+				simd::mul_quat(_quat.data(), q._quat.data(), _quat.data());
+				return *this;
+			}
+
 			_quat = {w() * q.x() + x() * q.w() + y() * q.z() - z() * q.y(),
 					 w() * q.y() + y() * q.w() + z() * q.x() - x() * q.z(),
 					 w() * q.z() + z() * q.w() + x() * q.y() - y() * q.x(),
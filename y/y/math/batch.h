@@ -0,0 +1,76 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MATH_BATCH_H
+#define Y_MATH_BATCH_H
+
+#include "Matrix.h"
+
+namespace y {
+namespace math {
+
+// Batch versions of the Matrix4<float> kernels.
+// Strides are in bytes so that a member of an array of structs (like Vertex::position) can be processed in place.
+
+// Applies m to count points, including the homogeneous divide
+inline void transform_points(const Matrix4<float>& m, Vec<3, float>* points, usize count, usize stride = sizeof(Vec<3, float>)) {
+	u8* data = reinterpret_cast<u8*>(points);
+	for(usize i = 0; i != count; ++i, data += stride) {
+		Vec<3, float>& p = *reinterpret_cast<Vec<3, float>*>(data);
+		Vec<4, float> h(p, 1.0f);
+		simd::mul_mat4_vec4(m.begin(), h.data(), h.data());
+		p = h.to<3>() / h.w();
+	}
+}
+
+// Applies the upper 3x3 part of m to count vectors
+inline void transform_vectors(const Matrix4<float>& m, Vec<3, float>* vectors, usize count, usize stride = sizeof(Vec<3, float>)) {
+	u8* data = reinterpret_cast<u8*>(vectors);
+	for(usize i = 0; i != count; ++i, data += stride) {
+		Vec<3, float>& v = *reinterpret_cast<Vec<3, float>*>(data);
+		Vec<4, float> h(v, 0.0f);
+		simd::mul_mat4_vec4(m.begin(), h.data(), h.data());
+		v = h.to<3>();
+	}
+}
+
+// out[i] = a[i] * b[i], out can be a or b. M can be any type with the layout of Matrix4<float> (like Transform<float>)
+template<typename M>
+inline void multiply(const M* a, const M* b, M* out, usize count) {
+	static_assert(std::is_base_of_v<Matrix4<float>, M> && sizeof(M) == sizeof(Matrix4<float>));
+	for(usize i = 0; i != count; ++i) {
+		simd::mul_mat4(a[i].begin(), b[i].begin(), out[i].begin());
+	}
+}
+
+// out[i] = m * in[i], out can be in
+template<typename M>
+inline void multiply(const Matrix4<float>& m, const M* in, M* out, usize count) {
+	static_assert(std::is_base_of_v<Matrix4<float>, M> && sizeof(M) == sizeof(Matrix4<float>));
+	for(usize i = 0; i != count; ++i) {
+		simd::mul_mat4(m.begin(), in[i].begin(), out[i].begin());
+	}
+}
+
+}
+}
+
+#endif // Y_MATH_BATCH_H
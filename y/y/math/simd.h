@@ -0,0 +1,301 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MATH_SIMD_H
+#define Y_MATH_SIMD_H
+
+#include <y/utils.h>
+
+// Define Y_NO_SIMD to force the scalar kernels
+#ifndef Y_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define Y_SIMD_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define Y_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace y {
+namespace math {
+namespace simd {
+
+// Kernels for 4x4 column major float matrices, Vec4 and quaternions (x, y, z, w).
+// Pointers don't need to be aligned and out can alias any of the inputs.
+
+inline constexpr bool is_enabled() {
+#if defined(Y_SIMD_SSE) || defined(Y_SIMD_NEON)
+	return true;
+#else
+	return false;
+#endif
+}
+
+namespace scalar {
+
+inline void mul_mat4(const float* a, const float* b, float* out) {
+	float res[16];
+	for(usize j = 0; j != 4; ++j) {
+		for(usize i = 0; i != 4; ++i) {
+			float tmp = 0.0f;
+			for(usize k = 0; k != 4; ++k) {
+				tmp = tmp + a[k * 4 + i] * b[j * 4 + k];
+			}
+			res[j * 4 + i] = tmp;
+		}
+	}
+	std::copy(res, res + 16, out);
+}
+
+inline void mul_mat4_vec4(const float* m, const float* v, float* out) {
+	float res[4] = {};
+	for(usize k = 0; k != 4; ++k) {
+		for(usize i = 0; i != 4; ++i) {
+			res[i] += m[k * 4 + i] * v[k];
+		}
+	}
+	std::copy(res, res + 4, out);
+}
+
+inline void mul_quat(const float* a, const float* b, float* out) {
+	const float res[] = {
+		a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1],
+		a[3] * b[1] + a[1] * b[3] + a[2] * b[0] - a[0] * b[2],
+		a[3] * b[2] + a[2] * b[3] + a[0] * b[1] - a[1] * b[0],
+		a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2]
+	};
+	std::copy(res, res + 4, out);
+}
+
+// Returns false and leaves out untouched if the matrix is singular
+inline bool inverse_mat4(const float* m, float* out) {
+	float inv[16];
+	inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+	inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+	inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+	inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+	inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+	inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+	inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+	inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+	inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+	inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+	inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+	inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+	inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+	inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+	inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+	inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+	const float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+	if(det == 0.0f) {
+		return false;
+	}
+
+	const float inv_det = 1.0f / det;
+	for(usize i = 0; i != 16; ++i) {
+		out[i] = inv[i] * inv_det;
+	}
+	return true;
+}
+
+}
+
+
+#if defined(Y_SIMD_SSE)
+
+namespace detail {
+#define Y_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+
+template<int X, int Y, int Z, int W>
+inline __m128 swizzle(__m128 v) {
+	return _mm_shuffle_ps(v, v, Y_SHUFFLE_MASK(X, Y, Z, W));
+}
+
+template<int X, int Y, int Z, int W>
+inline __m128 shuffle(__m128 a, __m128 b) {
+	return _mm_shuffle_ps(a, b, Y_SHUFFLE_MASK(X, Y, Z, W));
+}
+
+#undef Y_SHUFFLE_MASK
+
+// 2x2 matrices stored as (m00, m01, m10, m11)
+// A * B
+inline __m128 mat2_mul(__m128 a, __m128 b) {
+	return _mm_add_ps(_mm_mul_ps(a, swizzle<0, 3, 0, 3>(b)), _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+
+// adj(A) * B
+inline __m128 mat2_adj_mul(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(a), b), _mm_mul_ps(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+}
+
+// A * adj(B)
+inline __m128 mat2_mul_adj(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(a, swizzle<3, 0, 3, 0>(b)), _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+}
+
+inline void mul_mat4(const float* a, const float* b, float* out) {
+	const __m128 a0 = _mm_loadu_ps(a);
+	const __m128 a1 = _mm_loadu_ps(a + 4);
+	const __m128 a2 = _mm_loadu_ps(a + 8);
+	const __m128 a3 = _mm_loadu_ps(a + 12);
+
+	__m128 res[4];
+	for(usize j = 0; j != 4; ++j) {
+		const float* col = b + j * 4;
+		__m128 r = _mm_mul_ps(a0, _mm_set1_ps(col[0]));
+		r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(col[1])));
+		r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(col[2])));
+		r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(col[3])));
+		res[j] = r;
+	}
+	for(usize j = 0; j != 4; ++j) {
+		_mm_storeu_ps(out + j * 4, res[j]);
+	}
+}
+
+inline void mul_mat4_vec4(const float* m, const float* v, float* out) {
+	__m128 r = _mm_mul_ps(_mm_loadu_ps(m), _mm_set1_ps(v[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(v[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(v[2])));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(v[3])));
+	_mm_storeu_ps(out, r);
+}
+
+inline void mul_quat(const float* a, const float* b, float* out) {
+	using namespace detail;
+	const __m128 qa = _mm_loadu_ps(a);
+	const __m128 qb = _mm_loadu_ps(b);
+	const __m128 flip_w = _mm_setr_ps(1.0f, 1.0f, 1.0f, -1.0f);
+
+	__m128 r = _mm_mul_ps(swizzle<3, 3, 3, 3>(qa), qb);
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(swizzle<0, 1, 2, 0>(qa), swizzle<3, 3, 3, 0>(qb)), flip_w));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(swizzle<1, 2, 0, 1>(qa), swizzle<2, 0, 1, 1>(qb)), flip_w));
+	r = _mm_sub_ps(r, _mm_mul_ps(swizzle<2, 0, 1, 2>(qa), swizzle<1, 2, 0, 2>(qb)));
+	_mm_storeu_ps(out, r);
+}
+
+// Block wise inverse using 2x2 sub matrices.
+// The algorithm is written for row major matrices, but inverse(transpose(M)) == transpose(inverse(M)) so it works as is on column major data.
+inline bool inverse_mat4(const float* m, float* out) {
+	using namespace detail;
+	const __m128 c0 = _mm_loadu_ps(m);
+	const __m128 c1 = _mm_loadu_ps(m + 4);
+	const __m128 c2 = _mm_loadu_ps(m + 8);
+	const __m128 c3 = _mm_loadu_ps(m + 12);
+
+	const __m128 a = _mm_movelh_ps(c0, c1);
+	const __m128 b = _mm_movehl_ps(c1, c0);
+	const __m128 c = _mm_movelh_ps(c2, c3);
+	const __m128 d = _mm_movehl_ps(c3, c2);
+
+	// (det(A), det(B), det(C), det(D))
+	const __m128 det_sub = _mm_sub_ps(
+		_mm_mul_ps(shuffle<0, 2, 0, 2>(c0, c2), shuffle<1, 3, 1, 3>(c1, c3)),
+		_mm_mul_ps(shuffle<1, 3, 1, 3>(c0, c2), shuffle<0, 2, 0, 2>(c1, c3))
+	);
+	const __m128 det_a = swizzle<0, 0, 0, 0>(det_sub);
+	const __m128 det_b = swizzle<1, 1, 1, 1>(det_sub);
+	const __m128 det_c = swizzle<2, 2, 2, 2>(det_sub);
+	const __m128 det_d = swizzle<3, 3, 3, 3>(det_sub);
+
+	const __m128 d_c = mat2_adj_mul(d, c);
+	const __m128 a_b = mat2_adj_mul(a, b);
+
+	__m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), mat2_mul(b, d_c));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), mat2_mul(c, a_b));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), mat2_mul_adj(d, a_b));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), mat2_mul_adj(a, d_c));
+
+	// tr(adj(A)B * adj(D)C)
+	__m128 tr = _mm_mul_ps(a_b, swizzle<0, 2, 1, 3>(d_c));
+	tr = _mm_add_ps(tr, swizzle<1, 0, 3, 2>(tr));
+	tr = _mm_add_ps(tr, swizzle<2, 3, 0, 1>(tr));
+
+	const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+	if(_mm_cvtss_f32(det) == 0.0f) {
+		return false;
+	}
+
+	const __m128 inv_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+	x = _mm_mul_ps(x, inv_det);
+	y = _mm_mul_ps(y, inv_det);
+	z = _mm_mul_ps(z, inv_det);
+	w = _mm_mul_ps(w, inv_det);
+
+	_mm_storeu_ps(out, shuffle<3, 1, 3, 1>(x, y));
+	_mm_storeu_ps(out + 4, shuffle<2, 0, 2, 0>(x, y));
+	_mm_storeu_ps(out + 8, shuffle<3, 1, 3, 1>(z, w));
+	_mm_storeu_ps(out + 12, shuffle<2, 0, 2, 0>(z, w));
+	return true;
+}
+
+#elif defined(Y_SIMD_NEON)
+
+inline void mul_mat4(const float* a, const float* b, float* out) {
+	const float32x4_t a0 = vld1q_f32(a);
+	const float32x4_t a1 = vld1q_f32(a + 4);
+	const float32x4_t a2 = vld1q_f32(a + 8);
+	const float32x4_t a3 = vld1q_f32(a + 12);
+
+	float32x4_t res[4];
+	for(usize j = 0; j != 4; ++j) {
+		const float32x4_t col = vld1q_f32(b + j * 4);
+		float32x4_t r = vmulq_lane_f32(a0, vget_low_f32(col), 0);
+		r = vmlaq_lane_f32(r, a1, vget_low_f32(col), 1);
+		r = vmlaq_lane_f32(r, a2, vget_high_f32(col), 0);
+		r = vmlaq_lane_f32(r, a3, vget_high_f32(col), 1);
+		res[j] = r;
+	}
+	for(usize j = 0; j != 4; ++j) {
+		vst1q_f32(out + j * 4, res[j]);
+	}
+}
+
+inline void mul_mat4_vec4(const float* m, const float* v, float* out) {
+	const float32x4_t vec = vld1q_f32(v);
+	float32x4_t r = vmulq_lane_f32(vld1q_f32(m), vget_low_f32(vec), 0);
+	r = vmlaq_lane_f32(r, vld1q_f32(m + 4), vget_low_f32(vec), 1);
+	r = vmlaq_lane_f32(r, vld1q_f32(m + 8), vget_high_f32(vec), 0);
+	r = vmlaq_lane_f32(r, vld1q_f32(m + 12), vget_high_f32(vec), 1);
+	vst1q_f32(out, r);
+}
+
+using scalar::mul_quat;
+using scalar::inverse_mat4;
+
+#else
+
+using scalar::mul_mat4;
+using scalar::mul_mat4_vec4;
+using scalar::mul_quat;
+using scalar::inverse_mat4;
+
+#endif
+
+}
+}
+}
+
+#endif // Y_MATH_SIMD_H
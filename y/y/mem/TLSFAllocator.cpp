@@ -0,0 +1,363 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "TLSFAllocator.h"
+
+#ifdef Y_MSVC
+#include <intrin.h>
+#endif
+
+namespace y {
+namespace memory {
+
+static u32 find_last_set(u32 x) {
+	y_debug_assert(x);
+#ifdef Y_MSVC
+	unsigned long index = 0;
+	_BitScanReverse(&index, x);
+	return u32(index);
+#else
+	return u32(31 - __builtin_clz(x));
+#endif
+}
+
+static u32 find_first_set(u32 x) {
+	y_debug_assert(x);
+#ifdef Y_MSVC
+	unsigned long index = 0;
+	_BitScanForward(&index, x);
+	return u32(index);
+#else
+	return u32(__builtin_ctz(x));
+#endif
+}
+
+
+usize TLSFAllocator::Stats::available() const {
+	return size - allocated;
+}
+
+float TLSFAllocator::Stats::fragmentation() const {
+	const usize free = available();
+	return free ? 1.0f - float(largest_free_block) / float(free) : 0.0f;
+}
+
+
+TLSFAllocator::TLSFAllocator(usize size, usize granularity) : _granularity(granularity) {
+	y_always_assert(granularity && size % granularity == 0, "Size is not a multiple of granularity");
+	y_always_assert(size / granularity <= usize(u32(-1)), "Size is too big");
+
+	for(auto& lists : _free_lists) {
+		lists.fill(null_block);
+	}
+
+	_size = u32(size / granularity);
+	if(_size) {
+		insert_free(create_block(0, _size));
+	}
+}
+
+TLSFAllocator::TLSFAllocator(TLSFAllocator&& other) {
+	swap(other);
+}
+
+TLSFAllocator& TLSFAllocator::operator=(TLSFAllocator&& other) {
+	swap(other);
+	return *this;
+}
+
+void TLSFAllocator::swap(TLSFAllocator& other) {
+	std::swap(_blocks, other._blocks);
+	std::swap(_unused, other._unused);
+	std::swap(_allocated, other._allocated);
+	std::swap(_fl_bitmap, other._fl_bitmap);
+	std::swap(_sl_bitmaps, other._sl_bitmaps);
+	std::swap(_free_lists, other._free_lists);
+	std::swap(_granularity, other._granularity);
+	std::swap(_size, other._size);
+	std::swap(_allocated_size, other._allocated_size);
+	std::swap(_free_block_count, other._free_block_count);
+}
+
+// First level is the power of two range, second level linearly subdivides it in sl_count lists
+std::pair<u32, u32> TLSFAllocator::mapping(u32 size) {
+	if(size < sl_count) {
+		return {0, size};
+	}
+	const u32 fl = find_last_set(size);
+	return {fl - sl_bits + 1, (size >> (fl - sl_bits)) ^ sl_count};
+}
+
+u32 TLSFAllocator::to_units(usize bytes) const {
+	const usize units = (std::max(bytes, usize(1)) + _granularity - 1) / _granularity;
+	return units > _size ? u32(-1) : u32(units);
+}
+
+u32 TLSFAllocator::create_block(u32 offset, u32 size) {
+	u32 index = null_block;
+	if(_unused.is_empty()) {
+		index = u32(_blocks.size());
+		_blocks.emplace_back();
+	} else {
+		index = _unused.pop();
+	}
+
+	Block& block = _blocks[index];
+	block = Block{};
+	block.offset = offset;
+	block.size = size;
+	return index;
+}
+
+void TLSFAllocator::recycle_block(u32 index) {
+	_unused << index;
+}
+
+void TLSFAllocator::insert_free(u32 index) {
+	Block& block = _blocks[index];
+	y_debug_assert(!block.is_free);
+
+	const auto [fl, sl] = mapping(block.size);
+	const u32 head = _free_lists[fl][sl];
+
+	block.is_free = true;
+	block.prev_free = null_block;
+	block.next_free = head;
+	if(head != null_block) {
+		_blocks[head].prev_free = index;
+	}
+
+	_free_lists[fl][sl] = index;
+	_sl_bitmaps[fl] |= u32(1) << sl;
+	_fl_bitmap |= u32(1) << fl;
+	++_free_block_count;
+}
+
+void TLSFAllocator::remove_free(u32 index) {
+	Block& block = _blocks[index];
+	y_debug_assert(block.is_free);
+
+	if(block.prev_free != null_block) {
+		_blocks[block.prev_free].next_free = block.next_free;
+	}
+	if(block.next_free != null_block) {
+		_blocks[block.next_free].prev_free = block.prev_free;
+	}
+
+	const auto [fl, sl] = mapping(block.size);
+	if(_free_lists[fl][sl] == index) {
+		_free_lists[fl][sl] = block.next_free;
+		if(block.next_free == null_block) {
+			if(!(_sl_bitmaps[fl] &= ~(u32(1) << sl))) {
+				_fl_bitmap &= ~(u32(1) << fl);
+			}
+		}
+	}
+
+	block.is_free = false;
+	block.prev_free = block.next_free = null_block;
+	--_free_block_count;
+}
+
+u32 TLSFAllocator::find_free(u32 size) const {
+	// Round up to the next list so that any block found is big enough
+	u64 rounded = size;
+	if(size >= sl_count) {
+		rounded += (u64(1) << (find_last_set(size) - sl_bits)) - 1;
+	}
+
+	if(rounded <= u64(u32(-1))) {
+		const auto [fl, sl] = mapping(u32(rounded));
+		if(u32 sl_map = _sl_bitmaps[fl] & (~u32(0) << sl)) {
+			return _free_lists[fl][find_first_set(sl_map)];
+		}
+		if(fl + 1 < fl_count) {
+			if(const u32 fl_map = _fl_bitmap & (~u32(0) << (fl + 1))) {
+				const u32 first = find_first_set(fl_map);
+				return _free_lists[first][find_first_set(_sl_bitmaps[first])];
+			}
+		}
+	}
+
+	// Nothing in the bigger lists: the list containing size might still have a block that fits
+	const auto [fl, sl] = mapping(size);
+	for(u32 index = _free_lists[fl][sl]; index != null_block; index = _blocks[index].next_free) {
+		if(_blocks[index].size >= size) {
+			return index;
+		}
+	}
+
+	return null_block;
+}
+
+u32 TLSFAllocator::split(u32 index, u32 size) {
+	y_debug_assert(_blocks[index].size > size);
+
+	const u32 next = create_block(_blocks[index].offset + size, _blocks[index].size - size);
+
+	Block& block = _blocks[index];
+	Block& next_block = _blocks[next];
+
+	next_block.prev_phys = index;
+	next_block.next_phys = block.next_phys;
+	if(block.next_phys != null_block) {
+		_blocks[block.next_phys].prev_phys = next;
+	}
+
+	block.next_phys = next;
+	block.size = size;
+
+	return next;
+}
+
+core::Result<usize> TLSFAllocator::allocate(usize size, usize alignment) {
+	y_debug_assert(alignment);
+	y_debug_assert(alignment % _granularity == 0 || _granularity % alignment == 0);
+
+	const u32 units = to_units(size);
+	const u32 align_units = alignment > _granularity ? u32(alignment / _granularity) : 1;
+
+	// Alignments bigger than the granularity might need extra room in front of the block
+	const u64 padded = u64(units) + align_units - 1;
+	if(units == u32(-1) || padded > _size) {
+		return core::Err();
+	}
+
+	u32 index = find_free(u32(padded));
+	if(index == null_block) {
+		return core::Err();
+	}
+
+	remove_free(index);
+
+	{
+		const u32 offset = _blocks[index].offset;
+		const u32 aligned = (offset + align_units - 1) / align_units * align_units;
+		if(aligned != offset) {
+			const u32 next = split(index, aligned - offset);
+			insert_free(index);
+			index = next;
+		}
+	}
+
+	if(_blocks[index].size > units) {
+		insert_free(split(index, units));
+	}
+
+	const Block& block = _blocks[index];
+	y_debug_assert(block.size == units);
+
+	_allocated[block.offset] = index;
+	_allocated_size += block.size;
+
+	return core::Ok(usize(block.offset) * _granularity);
+}
+
+void TLSFAllocator::free(usize offset) {
+	y_debug_assert(offset % _granularity == 0);
+
+	const auto it = _allocated.find(u32(offset / _granularity));
+	if(it == _allocated.end()) {
+		y_fatal("Invalid offset: block was not allocated.");
+	}
+
+	u32 index = it->second;
+	_allocated.erase(it);
+	_allocated_size -= _blocks[index].size;
+
+	// Free blocks never have free neighbours: we only need to look at the direct ones
+	if(const u32 prev = _blocks[index].prev_phys; prev != null_block && _blocks[prev].is_free) {
+		remove_free(prev);
+
+		const Block& block = _blocks[index];
+		_blocks[prev].size += block.size;
+		_blocks[prev].next_phys = block.next_phys;
+		if(block.next_phys != null_block) {
+			_blocks[block.next_phys].prev_phys = prev;
+		}
+
+		recycle_block(index);
+		index = prev;
+	}
+
+	if(const u32 next = _blocks[index].next_phys; next != null_block && _blocks[next].is_free) {
+		remove_free(next);
+
+		const Block& next_block = _blocks[next];
+		_blocks[index].size += next_block.size;
+		_blocks[index].next_phys = next_block.next_phys;
+		if(next_block.next_phys != null_block) {
+			_blocks[next_block.next_phys].prev_phys = index;
+		}
+
+		recycle_block(next);
+	}
+
+	insert_free(index);
+}
+
+usize TLSFAllocator::size() const {
+	return usize(_size) * _granularity;
+}
+
+usize TLSFAllocator::granularity() const {
+	return _granularity;
+}
+
+usize TLSFAllocator::allocated() const {
+	return usize(_allocated_size) * _granularity;
+}
+
+usize TLSFAllocator::allocations() const {
+	return _allocated.size();
+}
+
+usize TLSFAllocator::free_blocks() const {
+	return _free_block_count;
+}
+
+bool TLSFAllocator::is_empty() const {
+	return _allocated.is_empty();
+}
+
+TLSFAllocator::Stats TLSFAllocator::stats() const {
+	Stats stats;
+	stats.size = size();
+	stats.allocated = allocated();
+	stats.allocations = allocations();
+	stats.free_blocks = free_blocks();
+
+	if(_fl_bitmap) {
+		const u32 fl = find_last_set(_fl_bitmap);
+		const u32 sl = find_last_set(_sl_bitmaps[fl]);
+		u32 largest = 0;
+		for(u32 index = _free_lists[fl][sl]; index != null_block; index = _blocks[index].next_free) {
+			largest = std::max(largest, _blocks[index].size);
+		}
+		stats.largest_free_block = usize(largest) * _granularity;
+	}
+
+	return stats;
+}
+
+}
+}
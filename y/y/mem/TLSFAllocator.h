@@ -0,0 +1,125 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MEM_TLSFALLOCATOR_H
+#define Y_MEM_TLSFALLOCATOR_H
+
+#include <y/core/Vector.h>
+#include <y/core/HashMap.h>
+#include <y/core/Result.h>
+
+#include <array>
+
+namespace y {
+namespace memory {
+
+// Two-level segregated fit allocator for ranges that live outside of the CPU address space (GPU heaps, buffer suballocations...)
+// It only hands out offsets in [0, size), blocks bookkeeping is kept on the side.
+// Allocation and deallocation are O(1) and free blocks are coalesced immediately.
+// Not thread safe.
+class TLSFAllocator : NonCopyable {
+	static constexpr u32 sl_bits = 5;
+	static constexpr u32 sl_count = 1 << sl_bits;
+	static constexpr u32 fl_count = 32 - sl_bits + 1;
+
+	static constexpr u32 null_block = u32(-1);
+
+	struct Block {
+		u32 offset = 0;
+		u32 size = 0;
+
+		u32 prev_phys = null_block;
+		u32 next_phys = null_block;
+
+		u32 prev_free = null_block;
+		u32 next_free = null_block;
+
+		bool is_free = false;
+	};
+
+	public:
+		struct Stats {
+			usize size = 0;
+			usize allocated = 0;
+			usize allocations = 0;
+			usize free_blocks = 0;
+			usize largest_free_block = 0;
+
+			usize available() const;
+
+			// 0 means all the free memory is in a single block
+			float fragmentation() const;
+		};
+
+		TLSFAllocator() = default;
+		TLSFAllocator(usize size, usize granularity = 1);
+
+		TLSFAllocator(TLSFAllocator&& other);
+		TLSFAllocator& operator=(TLSFAllocator&& other);
+
+		core::Result<usize> allocate(usize size, usize alignment = 1);
+		void free(usize offset);
+
+		usize size() const;
+		usize granularity() const;
+
+		usize allocated() const;
+		usize allocations() const;
+		usize free_blocks() const;
+
+		bool is_empty() const;
+
+		Stats stats() const;
+
+	private:
+		void swap(TLSFAllocator& other);
+
+		u32 to_units(usize bytes) const;
+
+		u32 create_block(u32 offset, u32 size);
+		void recycle_block(u32 index);
+
+		void insert_free(u32 index);
+		void remove_free(u32 index);
+
+		u32 find_free(u32 size) const;
+		u32 split(u32 index, u32 size);
+
+		static std::pair<u32, u32> mapping(u32 size);
+
+		core::Vector<Block> _blocks;
+		core::Vector<u32> _unused;
+		core::ExternalHashMap<u32, u32> _allocated;
+
+		u32 _fl_bitmap = 0;
+		std::array<u32, fl_count> _sl_bitmaps = {};
+		std::array<std::array<u32, sl_count>, fl_count> _free_lists = {};
+
+		usize _granularity = 1;
+		u32 _size = 0;
+		u32 _allocated_size = 0;
+		u32 _free_block_count = 0;
+};
+
+}
+}
+
+#endif // Y_MEM_TLSFALLOCATOR_H
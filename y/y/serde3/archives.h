@@ -23,6 +23,7 @@ SOFTWARE.
 #define Y_SERDE3_ARCHIVES_H
 
 #include <memory>
+#include <cstring>
 
 #include <y/core/Range.h>
 #include <y/core/Vector.h>
@@ -717,7 +718,12 @@ class ReadableArchive final {
 								object.object.emplace_back();
 							}
 						}
-						y_try_discard(_file.read_array(object.object.begin(), collection_size));
+						const usize bytes = sizeof(*object.object.begin()) * collection_size;
+						if(const u8* view = _file.try_view(bytes)) {
+							std::memcpy(object.object.begin(), view, bytes);
+						} else {
+							y_try_discard(_file.read_array(object.object.begin(), collection_size));
+						}
 					}
 
 				} else {
@@ -0,0 +1,71 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_TEST_BENCH_H
+#define Y_TEST_BENCH_H
+
+#include <y/utils.h>
+
+namespace y {
+namespace test {
+
+namespace detail {
+struct BenchItem {
+	const char* name = "Unknown bench";
+	void (*bench_func)() = nullptr;
+	BenchItem* next = nullptr;
+};
+
+void register_bench(BenchItem* bench);
+}
+
+void run_benchs();
+
+}
+}
+
+#ifdef Y_BUILD_BENCHS
+
+#define Y_BENCH_FUNC y_create_name_with_prefix(bench_func)
+#define Y_BENCH_RUNNER y_create_name_with_prefix(bench_runner)
+
+#define y_bench_func(name)																				\
+static void Y_BENCH_FUNC();																				\
+namespace {																								\
+	class Y_BENCH_RUNNER {																				\
+		Y_BENCH_RUNNER() : bench_item({name, &Y_BENCH_FUNC, nullptr}) {									\
+			y::test::detail::register_bench(&bench_item);												\
+		}																								\
+		y::test::detail::BenchItem bench_item;															\
+		static Y_BENCH_RUNNER runner;																	\
+	};																									\
+	Y_BENCH_RUNNER Y_BENCH_RUNNER::runner = Y_BENCH_RUNNER();											\
+}																										\
+void Y_BENCH_FUNC()
+
+#else
+
+#define y_bench_func(name)																				\
+[[maybe_unused]] static void y_create_name_with_prefix(bench_func)()
+
+#endif
+
+#endif // Y_TEST_BENCH_H
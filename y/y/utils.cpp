@@ -23,6 +23,7 @@ SOFTWARE.
 #include "utils.h"
 
 #include <y/utils/log.h>
+#include <y/utils/perf.h>
 #include <y/utils/format.h>
 #include <y/core/String.h>
 
@@ -63,6 +64,7 @@ void fatal(const char* msg, const char* file, int line) {
 		msg_str += fmt(" at line %", line);
 	}
 	log_msg(msg_str, Log::Error);
+	perf::detail::dump_flight_recorder_on_fatal();
 	y_breakpoint;
 	std::abort();
 }
@@ -22,7 +22,7 @@ SOFTWARE.
 
 #include "perf.h"
 
-#include <y/core/Chrono.h>
+#include <y/core/Vector.h>
 #include <y/io2/File.h>
 
 #include <y/concurrent/concurrent.h>
@@ -30,7 +30,18 @@ SOFTWARE.
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define Y_PERF_USE_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define Y_PERF_USE_TSC
+#endif
 
 
 namespace y {
@@ -53,196 +64,511 @@ static struct Guard {
 }
 
 
-class ThreadData;
+enum class EventType : u32 {
+	Enter,
+	Leave,
+	Instant
+};
 
-static std::recursive_mutex mutex;
-static std::shared_ptr<io2::File> output_file;
+struct Event {
+	u64 ticks;
+	const char* cat;
+	const char* name;
+	EventType type;
+};
 
-static constexpr usize buffer_size = 1024 * 1024;
+// Events per thread, must be a power of 2
+static constexpr usize ring_buffer_size = 64 * 1024;
+static constexpr usize write_buffer_size = 1024 * 1024;
 static constexpr usize print_buffer_len = 512;
+static constexpr auto flush_interval = std::chrono::milliseconds(10);
 
-static std::shared_ptr<ThreadData> head;
-static std::atomic<bool> capturing = false;
-static std::atomic<u32> capture_id = 0;
-
-
-static thread_local ThreadData* thread_local_ptr = nullptr;
-static thread_local u32 thread_capture_id = 0;
+static_assert(!(ring_buffer_size & (ring_buffer_size - 1)));
 
 
+static u64 ticks() {
+#ifdef Y_PERF_USE_TSC
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
 
+struct ClockStart {
+	const u64 ticks = perf::ticks();
+	const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+};
 
-static double micros() {
-	return core::Chrono::program().to_micros();
+static const ClockStart& clock_start() {
+	static const ClockStart start;
+	return start;
 }
 
-static bool is_thread_capturing() {
-	return capturing && thread_capture_id == capture_id;
+static double ticks_per_micro() {
+#ifdef Y_PERF_USE_TSC
+	// Calibrate the TSC against the steady clock over the whole program lifetime, but at least 10ms
+	const ClockStart& start = clock_start();
+	while(std::chrono::steady_clock::now() - start.time < std::chrono::milliseconds(10)) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	const u64 elapsed_ticks = ticks() - start.ticks;
+	const double elapsed_micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start.time).count();
+	return double(elapsed_ticks) / elapsed_micros;
+#else
+	return 1000.0;
+#endif
 }
 
-bool is_capturing() {
-	return capturing;
-}
 
-class ThreadData final : public std::enable_shared_from_this<ThreadData>, NonMovable {
+class ThreadBuffer : NonMovable {
 	public:
-		ThreadData(std::shared_ptr<io2::File> output, std::shared_ptr<ThreadData> next_thread) :
-				_output_file(std::move(output)),
-				_next(std::move(next_thread)),
-				_original_thread_id(concurrent::thread_id()) {
-
-			if(_output_file) {
-				_buffer = std::make_unique<u8[]>(buffer_size);
-				if(const char* name = concurrent::thread_name()) {
-					char b[print_buffer_len];
-					const usize len = std::snprintf(b, sizeof(b), R"({"name":"thread_name","ph":"M","pid":0,"tid":%u,"args":{"name":"%u: %s"}},)", concurrent::thread_id(), concurrent::thread_id(), name);
-					if(len >= sizeof(b)) {
-						y_fatal("Too long.");
-					}
-					write(b, len);
+		ThreadBuffer() : ThreadBuffer(concurrent::thread_id(), concurrent::thread_name()) {
+		}
+
+		ThreadBuffer(u32 thread_id, const char* thread_name) :
+				_events(std::make_unique<Event[]>(ring_buffer_size)),
+				_thread_id(thread_id),
+				_thread_name(thread_name) {
+		}
+
+		void push(EventType type, const char* cat, const char* name, u64 t = ticks()) {
+			const u64 pos = _write_pos.load(std::memory_order_relaxed);
+			Event& event = _events[pos & (ring_buffer_size - 1)];
+			event.ticks = t;
+			event.cat = cat;
+			event.name = name;
+			event.type = type;
+			_write_pos.store(pos + 1, std::memory_order_release);
+		}
+
+		// Appends every event from begin that is still in the buffer to out and returns the position after the last one
+		// Events that were overwritten before or while being copied are counted in lost
+		u64 read(u64 begin, core::Vector<Event>& out, u64& lost) const {
+			const u64 end = _write_pos.load(std::memory_order_acquire);
+			const u64 first_available = end > ring_buffer_size ? end - ring_buffer_size : 0;
+			if(begin < first_available) {
+				lost += first_available - begin;
+				begin = first_available;
+			}
+
+			const usize first = out.size();
+			for(u64 i = begin; i != end; ++i) {
+				out << _events[i & (ring_buffer_size - 1)];
+			}
+
+			// The writer might have wrapped around while we were copying
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const u64 after = _write_pos.load(std::memory_order_relaxed);
+			if(after + 1 > begin + ring_buffer_size) {
+				const usize overwritten = usize(std::min(after + 1 - ring_buffer_size - begin, end - begin));
+				std::copy(out.begin() + first + overwritten, out.end(), out.begin() + first);
+				for(usize i = 0; i != overwritten; ++i) {
+					out.pop();
 				}
+				lost += overwritten;
 			}
+
+			return end;
 		}
 
-		~ThreadData() {
-			y_debug_assert(!_buffer == !_output_file);
-			if(_buffer) {
-				flush();
-				// last thread to be deleted writes the end
-				if(!_next) {
+		u64 write_pos() const {
+			return _write_pos.load(std::memory_order_acquire);
+		}
+
+		u32 thread_id() const {
+			return _thread_id;
+		}
+
+		const char* thread_name() const {
+			return _thread_name;
+		}
+
+		// Only accessed by the capture thread, with buffers_mutex held
+		u64 read_pos = 0;
+		std::atomic<bool> retired = false;
+
+	private:
+		alignas(64) std::atomic<u64> _write_pos = 0;
+		std::unique_ptr<Event[]> _events;
+
+		const u32 _thread_id;
+		const char* _thread_name;
+};
+
+
+// Converts events to the chrome://tracing JSON format
+class TraceWriter : NonMovable {
+	public:
+		TraceWriter(io2::File file) : _file(std::move(file)), _buffer(std::make_unique<char[]>(write_buffer_size)), _ticks_per_micro(ticks_per_micro()) {
+			const std::string_view start = R"({"traceEvents":[)";
+			write(start.data(), start.size());
+		}
+
+		~TraceWriter() {
+			char b[print_buffer_len];
+			const usize len = std::snprintf(b, sizeof(b), R"({"name":"capture ended","cat":"perf","ph":"I","pid":0,"tid":%u,"ts":%.1f}]})", concurrent::thread_id(), micros(ticks()));
+			write(b, len);
+			flush();
+		}
+
+		void write_events(const ThreadBuffer& thread, core::Span<Event> events, u64 lost) {
+			const u32 tid = thread.thread_id();
+			if(events.is_empty() && !lost) {
+				return;
+			}
+
+			if(std::find(_named_threads.begin(), _named_threads.end(), tid) == _named_threads.end()) {
+				_named_threads << tid;
+				if(const char* name = thread.thread_name()) {
 					char b[print_buffer_len];
-					const usize len = std::snprintf(b, sizeof(b), R"({"name":"capture ended","cat":"perf","ph":"I","pid":0,"tid":%u,"ts":%.1f}]})", concurrent::thread_id(), micros());
-					_output_file->write(b, len).expected("Unable to write perf dump.");
+					const usize len = std::snprintf(b, sizeof(b), R"({"name":"thread_name","ph":"M","pid":0,"tid":%u,"args":{"name":"%u: %s"}},)", tid, tid, name);
+					check_len(len);
+					write(b, len);
 				}
 			}
 
-		}
+			if(lost) {
+				char b[print_buffer_len];
+				const usize len = std::snprintf(b, sizeof(b), R"({"name":"%u events lost","cat":"perf","ph":"I","pid":0,"tid":%u,"ts":%.1f},)", unsigned(lost), tid, events.is_empty() ? micros(ticks()) : micros(events[0].ticks));
+				check_len(len);
+				write(b, len);
+			}
 
-		void write(const char* str, usize len) {
-			if(_buffer) {
-				const usize remaining = buffer_size - _buffer_offset;
-				if(len >= remaining) {
-					flush();
-				}
-				std::memcpy(_buffer.get() + _buffer_offset, str, len);
-				_buffer_offset += len;
+			for(const Event& event : events) {
+				char b[print_buffer_len];
+				const char* phase = event.type == EventType::Enter ? "B" : (event.type == EventType::Leave ? "E" : "I");
+				const int name_len = event.type == EventType::Instant ? int(std::strlen(event.name)) : paren(event.name);
+				const usize len = std::snprintf(b, sizeof(b), R"({"name":"%.*s","cat":"%s","ph":"%s","pid":0,"tid":%u,"ts":%.1f},)", name_len, event.name, event.cat, phase, tid, micros(event.ticks));
+				check_len(len);
+				write(b, len);
 			}
 		}
 
-		bool is_empty() const {
-			return !_buffer;
+		u64 ticks_ago(double seconds) const {
+			const u64 delta = u64(seconds * 1000000.0 * _ticks_per_micro);
+			const u64 now = ticks();
+			return now > delta ? now - delta : 0;
 		}
 
 	private:
+		static int paren(const char* buff) {
+			if(const char* p = std::strchr(buff, '('); p) {
+				return int(p - buff);
+			}
+			return int(print_buffer_len);
+		}
+
+		static void check_len(usize len) {
+			if(len >= print_buffer_len) {
+				y_fatal("Too long.");
+			}
+		}
+
+		double micros(u64 t) const {
+			const u64 start = clock_start().ticks;
+			return t > start ? double(t - start) / _ticks_per_micro : 0.0;
+		}
+
+		void write(const char* str, usize len) {
+			if(len >= write_buffer_size - _buffer_offset) {
+				flush();
+			}
+			std::memcpy(_buffer.get() + _buffer_offset, str, len);
+			_buffer_offset += len;
+		}
+
 		void flush() {
-			const std::unique_lock lock(mutex);
-			y_debug_assert(output_file);
-			y_debug_assert(output_file->is_open());
-			_output_file->write(_buffer.get(), _buffer_offset).expected("Unable to write perf dump.");
+			_file.write(_buffer.get(), _buffer_offset).expected("Unable to write perf dump.");
 			_buffer_offset = 0;
 		}
 
-		std::unique_ptr<u8[]> _buffer;
+		io2::File _file;
+		std::unique_ptr<char[]> _buffer;
 		usize _buffer_offset = 0;
 
-		std::shared_ptr<io2::File> _output_file;
-		std::shared_ptr<ThreadData> _next;
-		const u32 _original_thread_id;
-
+		core::Vector<u32> _named_threads;
+		const double _ticks_per_micro;
 };
 
-void start_capture(const char* out_filename) {
-	auto file = std::make_shared<io2::File>(std::move(io2::File::create(out_filename).expected("Unable to open output file.")));
 
-	{
-		const std::string_view start = R"({"traceEvents":[)";
-		file->write(start.data(), start.size()).expected("Unable to write perf dump.");
+static std::atomic<bool> recording = false;
+static std::atomic<bool> capturing = false;
+static std::atomic<bool> flight_recorder = false;
+
+// Protects the capture and flight recorder state
+static std::mutex state_mutex;
+static std::unique_ptr<TraceWriter> capture_writer;
+static double flight_recorder_seconds = 0.0;
+static const char* fatal_dump_filename = nullptr;
+
+static std::thread flusher;
+static std::mutex flusher_mutex;
+static std::condition_variable flusher_condition;
+static bool stop_flusher = false;
+
+// Protects the list of buffers and the read positions
+static std::mutex buffers_mutex;
+static core::Vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+// Virtual tracks are never retired, pushes are serialized by tracks_mutex
+static std::mutex tracks_mutex;
+static core::Vector<std::pair<const char*, ThreadBuffer*>> tracks;
+
+
+static thread_local ThreadBuffer* thread_buffer = nullptr;
+
+namespace {
+static thread_local struct ThreadBufferRetirer {
+	~ThreadBufferRetirer() {
+		if(thread_buffer) {
+			thread_buffer->retired = true;
+		}
 	}
 
-	const std::unique_lock lock(mutex);
+	void use() {
+	}
+} thread_buffer_retirer;
+}
+
+
+static void update_recording() {
+	recording = capturing || flight_recorder;
+}
+
+// buffers_mutex needs to be held
+static void collect_retired_buffers() {
+	for(usize i = 0; i < buffers.size();) {
+		const ThreadBuffer& buffer = *buffers[i];
+		if(buffer.retired && (!capturing || buffer.read_pos == buffer.write_pos())) {
+			buffers.erase_unordered(buffers.begin() + i);
+		} else {
+			++i;
+		}
+	}
+}
+
+static ThreadBuffer* create_thread_buffer() {
+	// The start needs to be initialized before the first event is recorded
+	clock_start();
+
+	auto buffer = std::make_unique<ThreadBuffer>();
+	thread_buffer = buffer.get();
+	thread_buffer_retirer.use();
+
+	const std::unique_lock lock(buffers_mutex);
+	collect_retired_buffers();
+	buffers.emplace_back(std::move(buffer));
+	return thread_buffer;
+}
+
+static void push_event(EventType type, const char* cat, const char* name) {
+	if(!recording.load(std::memory_order_relaxed)) {
+		return;
+	}
+	ThreadBuffer* buffer = thread_buffer ? thread_buffer : create_thread_buffer();
+	buffer->push(type, cat, name);
+}
+
+
+// buffers_mutex needs to be held
+static void drain_buffers(TraceWriter& writer) {
+	static core::Vector<Event> events;
+	for(const auto& buffer : buffers) {
+		events.make_empty();
+		u64 lost = 0;
+		buffer->read_pos = buffer->read(buffer->read_pos, events, lost);
+		writer.write_events(*buffer, events, lost);
+	}
+	collect_retired_buffers();
+}
+
+static void flush_loop() {
+	concurrent::set_thread_name("Perf capture");
+
+	std::unique_lock lock(flusher_mutex);
+	while(!stop_flusher) {
+		flusher_condition.wait_for(lock, flush_interval);
+
+		const std::unique_lock buffers_lock(buffers_mutex);
+		drain_buffers(*capture_writer);
+	}
+}
+
+bool is_capturing() {
+	return capturing;
+}
+
+void start_capture(const char* out_filename) {
+	io2::File file = std::move(io2::File::create(out_filename).expected("Unable to open output file."));
+
+	const std::unique_lock lock(state_mutex);
 
 	if(is_capturing()) {
 		y_fatal("Capture already in progress.");
 	}
 
-	output_file = std::move(file);
-	guard.use();
-	++capture_id;
-	capturing = true;
-}
+	capture_writer = std::make_unique<TraceWriter>(std::move(file));
 
+	{
+		// Skip everything recorded before the capture started
+		const std::unique_lock buffers_lock(buffers_mutex);
+		for(const auto& buffer : buffers) {
+			buffer->read_pos = buffer->write_pos();
+		}
+		guard.use();
+		capturing = true;
+		update_recording();
+	}
+
+	stop_flusher = false;
+	flusher = std::thread(&flush_loop);
+}
 
 void end_capture() {
-	const std::unique_lock lock(mutex);
+	const std::unique_lock lock(state_mutex);
 
 	if(!is_capturing()) {
 		y_fatal("Not capturing.");
 	}
 
 	capturing = false;
-	head = nullptr;
-	output_file = nullptr;
-}
-
-static std::shared_ptr<ThreadData> thread_data() {
-	std::shared_ptr<ThreadData> data;
-	if(!is_thread_capturing()) {
-		std::unique_lock lock(mutex);
-		auto file = output_file;
-		data = std::make_shared<ThreadData>(output_file, head);
-		if(!data->is_empty()) {
-			head = data;
-		}
-		thread_local_ptr = data.get();
-		thread_capture_id = capture_id;
-	} else {
-		y_debug_assert(thread_local_ptr);
-		data = thread_local_ptr->shared_from_this();
+	update_recording();
+
+	{
+		const std::unique_lock flusher_lock(flusher_mutex);
+		stop_flusher = true;
 	}
-	return data;
-}
+	flusher_condition.notify_one();
+	flusher.join();
 
-static int paren(const char* buff) {
-	if(const char* p = std::strchr(buff, '('); p) {
-		return p - buff;
+	{
+		const std::unique_lock buffers_lock(buffers_mutex);
+		drain_buffers(*capture_writer);
 	}
-	return print_buffer_len;
+
+	capture_writer = nullptr;
 }
 
-void enter(const char* cat, const char* func) {
-	if(!is_capturing()) {
-		return;
+
+void start_flight_recorder(double seconds, const char* fatal_dump_file) {
+	const std::unique_lock lock(state_mutex);
+	flight_recorder_seconds = seconds;
+	fatal_dump_filename = fatal_dump_file;
+	flight_recorder = true;
+	update_recording();
+}
+
+void stop_flight_recorder() {
+	const std::unique_lock lock(state_mutex);
+	flight_recorder = false;
+	fatal_dump_filename = nullptr;
+	update_recording();
+}
+
+bool is_flight_recorder_running() {
+	return flight_recorder;
+}
+
+static void dump_flight_recorder(const char* out_filename, double seconds, std::unique_lock<std::mutex>& buffers_lock) {
+	y_debug_assert(buffers_lock.owns_lock());
+	unused(buffers_lock);
+
+	TraceWriter writer(std::move(io2::File::create(out_filename).expected("Unable to open output file.")));
+	const u64 first_ticks = writer.ticks_ago(seconds);
+
+	core::Vector<Event> events;
+	for(const auto& buffer : buffers) {
+		events.make_empty();
+		u64 lost = 0;
+		buffer->read(0, events, lost);
+
+		const auto first = std::find_if(events.begin(), events.end(), [=](const Event& e) { return e.ticks >= first_ticks; });
+		writer.write_events(*buffer, core::Span<Event>(first, events.end() - first), 0);
 	}
-	char b[print_buffer_len];
-	const usize len = std::snprintf(b, sizeof(b), R"({"name":"%.*s","cat":"%s","ph":"B","pid":0,"tid":%u,"ts":%.1f},)", paren(func), func, cat, concurrent::thread_id(), micros());
-	if(len >= sizeof(b)) {
-		y_fatal("Too long.");
+}
+
+void dump_flight_recorder(const char* out_filename) {
+	double seconds = 0.0;
+	{
+		const std::unique_lock lock(state_mutex);
+		seconds = flight_recorder_seconds;
 	}
-	thread_data()->write(b, len);
+
+	std::unique_lock buffers_lock(buffers_mutex);
+	dump_flight_recorder(out_filename, seconds, buffers_lock);
 }
 
-void leave(const char* cat, const char* func) {
-	if(!is_capturing()) {
+namespace detail {
+void dump_flight_recorder_on_fatal() {
+	static std::atomic<bool> dumping = false;
+	if(!flight_recorder || !fatal_dump_filename || dumping.exchange(true)) {
 		return;
 	}
-	char b[print_buffer_len];
-	const usize len = std::snprintf(b, sizeof(b), R"({"name":"%.*s","cat":"%s","ph":"E","pid":0,"tid":%u,"ts":%.1f},)", paren(func), func, cat, concurrent::thread_id(), micros());
-	if(len >= sizeof(b)) {
-		y_fatal("Too long.");
+
+	// The fatal error might have happened with one of the locks held
+	std::unique_lock buffers_lock(buffers_mutex, std::try_to_lock);
+	if(buffers_lock.owns_lock()) {
+		dump_flight_recorder(fatal_dump_filename, flight_recorder_seconds, buffers_lock);
 	}
-	thread_data()->write(b, len);
+}
+}
+
+
+void enter(const char* cat, const char* func) {
+	push_event(EventType::Enter, cat, func);
+}
+
+void leave(const char* cat, const char* func) {
+	push_event(EventType::Leave, cat, func);
 }
 
 void event(const char* cat, const char* name) {
-	if(!is_capturing()) {
-		return;
+	push_event(EventType::Instant, cat, name);
+}
+
+
+// tracks_mutex needs to be held
+static ThreadBuffer* find_track(const char* track) {
+	for(const auto& [name, buffer] : tracks) {
+		if(!std::strcmp(name, track)) {
+			return buffer;
+		}
 	}
-	char b[print_buffer_len];
-	const usize len = std::snprintf(b, sizeof(b), R"({"name":"%s","cat":"%s","ph":"I","pid":0,"tid":%u,"ts":%.1f},)", name, cat, concurrent::thread_id(), micros());
-	if(len >= sizeof(b)) {
-		y_fatal("Too long.");
+
+	// Keep track ids away from the thread ids
+	const u32 track_id = u32(-1) - u32(tracks.size());
+	auto buffer = std::make_unique<ThreadBuffer>(track_id, track);
+	tracks.emplace_back(track, buffer.get());
+
+	clock_start();
+
+	const std::unique_lock lock(buffers_mutex);
+	buffers.emplace_back(std::move(buffer));
+	return tracks.last().second;
+}
+
+static void push_track_event(EventType type, const char* track, const char* name, u64 reference, u64 nanoseconds) {
+	if(!recording.load(std::memory_order_relaxed)) {
+		return;
 	}
-	thread_data()->write(b, len);
+
+	static const double ticks_per_nano = ticks_per_micro() / 1000.0;
+	const u64 t = reference + u64(nanoseconds * ticks_per_nano);
+
+	const std::unique_lock lock(tracks_mutex);
+	find_track(track)->push(type, track, name, t);
+}
+
+u64 timestamp() {
+	return ticks();
+}
+
+void track_enter(const char* track, const char* name, u64 reference, u64 nanoseconds) {
+	push_track_event(EventType::Enter, track, name, reference, nanoseconds);
+}
+
+void track_leave(const char* track, const char* name, u64 reference, u64 nanoseconds) {
+	push_track_event(EventType::Leave, track, name, reference, nanoseconds);
 }
 
 
@@ -250,9 +576,19 @@ void event(const char* cat, const char* name) {
 void start_capture(const char*) {}
 void end_capture() {}
 bool is_capturing() { return false; }
+void start_flight_recorder(double, const char*) {}
+void stop_flight_recorder() {}
+bool is_flight_recorder_running() { return false; }
+void dump_flight_recorder(const char*) {}
+namespace detail {
+void dump_flight_recorder_on_fatal() {}
+}
 void enter(const char*, const char*) {}
 void leave(const char*, const char*) {}
 void event(const char*, const char*) {}
+u64 timestamp() { return 0; }
+void track_enter(const char*, const char*, u64, u64) {}
+void track_leave(const char*, const char*, u64, u64) {}
 #endif
 
 }
@@ -30,15 +30,37 @@ namespace perf {
 // For use with chrome://tracing
 // Format described here: https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
 
+// Events are stored as binary records in per thread ring buffers, a background thread converts them while capturing
 void start_capture(const char* out_filename);
 void end_capture();
 
 bool is_capturing();
 
+// Keeps the last events of every thread in memory, limited by the ring buffer size
+// If fatal_dump_filename is not null, the recorded events are dumped there on y_fatal
+void start_flight_recorder(double seconds, const char* fatal_dump_filename = nullptr);
+void stop_flight_recorder();
+
+bool is_flight_recorder_running();
+
+// Writes the events of the last recorded seconds, can be called while capturing
+void dump_flight_recorder(const char* out_filename);
+
+namespace detail {
+void dump_flight_recorder_on_fatal();
+}
+
 void enter(const char* cat, const char* func);
 void leave(const char* cat, const char* func);
 void event(const char* cat, const char* name);
 
+// Virtual tracks hold events that did not happen on a CPU thread, like GPU timings.
+// Events are placed nanoseconds after reference, which must be a value returned by timestamp().
+// Names are not copied and must outlive the capture.
+u64 timestamp();
+void track_enter(const char* track, const char* name, u64 reference, u64 nanoseconds);
+void track_leave(const char* track, const char* name, u64 reference, u64 nanoseconds);
+
 inline auto log_func(const char* func, const char* cat = "") {
 	class Logger : NonCopyable {
 		const char* _cat;
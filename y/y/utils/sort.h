@@ -24,12 +24,13 @@ SOFTWARE.
 
 #include "types.h"
 #include <array>
+#include <type_traits>
+#include <algorithm>
 
 #if __has_include(<pdqsort.h>)
 #include <pdqsort.h>
 #define Y_USE_PDQSORT
 #else
-#include <algorithm>
 // you can find pdqsort at https://github.com/orlp/pdqsort
 #endif
 
@@ -56,6 +57,53 @@ inline void sort(It begin, It end) {
 
 
 
+// LSD radix sort on an unsigned integer key, one byte per pass
+// buffer must be able to hold end - begin elements. Passes where all keys share the same byte are skipped
+template<typename T, typename K>
+inline void radix_sort(T* begin, T* end, T* buffer, K&& key) {
+	using key_type = std::decay_t<decltype(key(*begin))>;
+	static_assert(std::is_unsigned_v<key_type>, "Radix sort key should be an unsigned integer");
+
+	const usize size = usize(end - begin);
+	if(size < 2) {
+		return;
+	}
+
+	usize histograms[sizeof(key_type)][256] = {};
+	for(const T* it = begin; it != end; ++it) {
+		const key_type k = key(*it);
+		for(usize d = 0; d != sizeof(key_type); ++d) {
+			++histograms[d][(k >> (d * 8)) & 0xFF];
+		}
+	}
+
+	T* src = begin;
+	T* dst = buffer;
+	for(usize d = 0; d != sizeof(key_type); ++d) {
+		usize* histogram = histograms[d];
+		if(histogram[(key(*src) >> (d * 8)) & 0xFF] == size) {
+			continue;
+		}
+
+		usize offset = 0;
+		for(usize i = 0; i != 256; ++i) {
+			const usize count = histogram[i];
+			histogram[i] = offset;
+			offset += count;
+		}
+
+		for(T* it = src; it != src + size; ++it) {
+			dst[histogram[(key(*it) >> (d * 8)) & 0xFF]++] = std::move(*it);
+		}
+		std::swap(src, dst);
+	}
+
+	if(src != begin) {
+		std::move(src, src + size, begin);
+	}
+}
+
+
 // waiting for C++20
 template<typename It, typename C = std::less<>>
 inline constexpr bool is_sorted(It b, It e, C comp = C()) {
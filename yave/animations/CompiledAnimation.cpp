@@ -0,0 +1,150 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "CompiledAnimation.h"
+
+#include <y/concurrent/WorkStealingThreadPool.h>
+#include <y/math/batch.h>
+#include <y/utils/perf.h>
+
+namespace yave {
+
+CompiledAnimation::CompiledAnimation(const Skeleton& skeleton, const Animation& animation) : _duration(animation.duration()) {
+	y_profile();
+
+	const core::Span<Bone> bones = skeleton.bones();
+	const core::Span<AnimationChannel> channels = animation.channels();
+
+	_parents = core::vector_with_capacity<u32>(bones.size());
+	_bone_tracks = core::vector_with_capacity<u32>(bones.size());
+	_bind_transforms = core::Vector<math::Transform<>>(skeleton.bone_transforms());
+	_inverses = core::Vector<math::Transform<>>(skeleton.inverse_absolute_transforms());
+
+	for(const Bone& bone : bones) {
+		y_debug_assert(!bone.has_parent() || bone.parent < _parents.size());
+		_parents << bone.parent;
+
+		const auto channel = std::find_if(channels.begin(), channels.end(), [&](const auto& ch) { return ch.name() == bone.name; });
+		if(channel == channels.end()) {
+			_bone_tracks << no_track;
+			continue;
+		}
+
+		const core::Span<AnimationChannel::BoneKey> keys = channel->keys();
+		_bone_tracks << u32(_tracks.size());
+		_tracks << Track{u32(_times.size()), u32(keys.size())};
+		for(const auto& key : keys) {
+			_times << key.time;
+			_positions << key.local_transform.position;
+			_scales << key.local_transform.scale;
+			_rotations << key.local_transform.rotation;
+		}
+	}
+}
+
+float CompiledAnimation::duration() const {
+	return _duration;
+}
+
+usize CompiledAnimation::bone_count() const {
+	return _parents.size();
+}
+
+usize CompiledAnimation::track_count() const {
+	return _tracks.size();
+}
+
+CompiledAnimation::Cursor CompiledAnimation::create_cursor() const {
+	Cursor cursor;
+	cursor._keys = core::Vector<u32>(_tracks.size(), 0);
+	return cursor;
+}
+
+math::Transform<> CompiledAnimation::sample_track(u32 track_index, float time, u32& cursor) const {
+	const Track& track = _tracks[track_index];
+	const float* times = _times.data() + track.first_key;
+	const u32 count = track.key_count;
+
+	// Index of the first key after time, same convention as AnimationChannel::bone_transform
+	const auto is_upper_bound = [&](u32 k) {
+		return (k == count || times[k] > time) && (k == 0 || times[k - 1] <= time);
+	};
+
+	u32 upper = cursor;
+	if(!is_upper_bound(upper)) {
+		if(upper < count && is_upper_bound(upper + 1)) {
+			++upper;
+		} else {
+			upper = u32(std::upper_bound(times, times + count, time) - times);
+		}
+	}
+	cursor = upper;
+
+	const u32 next = upper == count ? 0 : upper;
+	const u32 key = upper == 0 ? 0 : upper - 1;
+
+	float delta = times[next] - times[key];
+	delta = delta < 0.0f ? delta + times[count - 1] : delta;
+
+	const float factor = delta > 0.0f ? (time - times[key]) / delta : 0.0f;
+
+	const BoneTransform begin{_positions[track.first_key + key], _scales[track.first_key + key], _rotations[track.first_key + key]};
+	const BoneTransform end{_positions[track.first_key + next], _scales[track.first_key + next], _rotations[track.first_key + next]};
+	return begin.lerp(end, factor);
+}
+
+void CompiledAnimation::sample(float time, Cursor& cursor, core::MutableSpan<math::Transform<>> out) const {
+	y_debug_assert(out.size() >= bone_count());
+	y_debug_assert(cursor._keys.size() == _tracks.size());
+
+	for(usize i = 0; i != _parents.size(); ++i) {
+		const u32 track = _bone_tracks[i];
+		const math::Transform<> local = track == no_track
+			? _bind_transforms[i]
+			: sample_track(track, time, cursor._keys[track]);
+
+		// Parents always come before their children
+		const u32 parent = _parents[i];
+		if(parent != u32(-1)) {
+			out[i] = out[parent] * local;
+		} else {
+			out[i] = local;
+		}
+	}
+
+	math::multiply(out.data(), _inverses.data(), out.data(), _parents.size());
+}
+
+void CompiledAnimation::sample_all(core::MutableSpan<SampleJob> jobs) {
+	y_profile();
+
+	static constexpr usize jobs_per_task = 16;
+	concurrent::default_thread_pool().parallel_for(jobs.size(), jobs_per_task, [&](usize begin, usize end) {
+		y_profile_zone("sample animations");
+		for(usize i = begin; i != end; ++i) {
+			const SampleJob& job = jobs[i];
+			job.animation->sample(job.time, *job.cursor, job.out);
+		}
+	});
+}
+
+}
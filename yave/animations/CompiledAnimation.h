@@ -0,0 +1,98 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ANIMATIONS_COMPILEDANIMATION_H
+#define YAVE_ANIMATIONS_COMPILEDANIMATION_H
+
+#include <yave/meshes/Skeleton.h>
+
+#include "Animation.h"
+
+namespace yave {
+
+// Animation resolved against a skeleton: every bone is mapped to its channel once,
+// and keys are stored as structure of arrays so that key search only touches times.
+// Immutable once built, can be shared by any number of instances and sampled concurrently.
+class CompiledAnimation : NonCopyable {
+	public:
+		static constexpr u32 no_track = u32(-1);
+
+		// Per instance playback state: the last key used by each track.
+		// Sampling forward in time is O(1) per track, other lookups fall back to a binary search.
+		class Cursor {
+			public:
+				Cursor() = default;
+
+			private:
+				friend class CompiledAnimation;
+
+				core::Vector<u32> _keys;
+		};
+
+		struct SampleJob {
+			const CompiledAnimation* animation = nullptr;
+			Cursor* cursor = nullptr;
+			float time = 0.0f;
+			core::MutableSpan<math::Transform<>> out;
+		};
+
+		CompiledAnimation() = default;
+		CompiledAnimation(const Skeleton& skeleton, const Animation& animation);
+
+		float duration() const;
+		usize bone_count() const;
+
+		// Channels that don't match any bone are dropped
+		usize track_count() const;
+
+		Cursor create_cursor() const;
+
+		// Writes the skinning palette (absolute bone transform * inverse bind transform) of every bone into out
+		void sample(float time, Cursor& cursor, core::MutableSpan<math::Transform<>> out) const;
+
+		// Samples every job on concurrent::default_thread_pool() and returns once they are all done
+		static void sample_all(core::MutableSpan<SampleJob> jobs);
+
+	private:
+		struct Track {
+			u32 first_key = 0;
+			u32 key_count = 0;
+		};
+
+		math::Transform<> sample_track(u32 track_index, float time, u32& cursor) const;
+
+		float _duration = 0.0f;
+
+		core::Vector<u32> _parents;
+		core::Vector<u32> _bone_tracks;
+		core::Vector<math::Transform<>> _bind_transforms;
+		core::Vector<math::Transform<>> _inverses;
+
+		core::Vector<Track> _tracks;
+		core::Vector<float> _times;
+		core::Vector<math::Vec3> _positions;
+		core::Vector<math::Vec3> _scales;
+		core::Vector<math::Quaternion<>> _rotations;
+};
+
+}
+
+#endif // YAVE_ANIMATIONS_COMPILEDANIMATION_H
@@ -23,6 +23,8 @@ SOFTWARE.
 #include "SkeletonInstance.h"
 #include <yave/graphics/buffers/TypedWrapper.h>
 
+#include <y/utils/perf.h>
+
 namespace yave {
 
 SkeletonInstance::SkeletonInstance(DevicePtr dptr, const Skeleton* skeleton) :
@@ -35,40 +37,69 @@ SkeletonInstance::SkeletonInstance(DevicePtr dptr, const Skeleton* skeleton) :
 }
 
 void SkeletonInstance::flush_reload() {
-	_animation.flush_reload();
+	if(_animation.flush_reload()) {
+		_compiled = nullptr;
+	}
 }
 
 void SkeletonInstance::animate(const AssetPtr<Animation>& anim) {
 	_animation = anim;
+	_compiled = nullptr;
+	_anim_timer.reset();
+}
+
+void SkeletonInstance::animate(std::shared_ptr<const CompiledAnimation> anim) {
+	y_debug_assert(!anim || anim->bone_count() == _skeleton->bones().size());
+	_animation = nullptr;
+	_compiled = std::move(anim);
+	_cursor = _compiled ? _compiled->create_cursor() : CompiledAnimation::Cursor();
 	_anim_timer.reset();
 }
 
+bool SkeletonInstance::ensure_compiled() {
+	if(!_compiled) {
+		if(!_animation) {
+			return false;
+		}
+		_compiled = std::make_shared<const CompiledAnimation>(*_skeleton, *_animation);
+		_cursor = _compiled->create_cursor();
+	}
+	return true;
+}
+
+CompiledAnimation::SampleJob SkeletonInstance::sample_job() {
+	const float time = std::fmod(float(_anim_timer.elapsed().to_secs()), _compiled->duration());
+	return {_compiled.get(), &_cursor, time, *_bone_transforms};
+}
+
 void SkeletonInstance::update() {
-	if(!_animation) {
+	if(!ensure_compiled()) {
 		return;
 	}
 
-	const float time = std::fmod(float(_anim_timer.elapsed().to_secs()), _animation->duration());
+	const CompiledAnimation::SampleJob job = sample_job();
+	_compiled->sample(job.time, _cursor, job.out);
 
-	const auto& anim = *_animation;
-	const auto& bones = _skeleton->bones();
-	const auto& bone_transforms = _skeleton->bone_transforms();
-	const auto& invs = _skeleton->inverse_absolute_transforms();
+	flush_data();
+}
 
-	auto& out_transforms = *_bone_transforms;
+void SkeletonInstance::update_all(core::MutableSpan<SkeletonInstance*> instances) {
+	y_profile();
 
+	auto animated = core::vector_with_capacity<SkeletonInstance*>(instances.size());
+	auto jobs = core::vector_with_capacity<CompiledAnimation::SampleJob>(instances.size());
+	for(SkeletonInstance* instance : instances) {
+		if(instance->ensure_compiled()) {
+			animated << instance;
+			jobs << instance->sample_job();
+		}
+	}
 
-	for(usize i = 0; i != bones.size(); ++i) {
-		const auto& bone = bones[i];
-		auto bone_tr = anim.bone_transform(bone.name, time).value_or(bone_transforms[i]);
+	CompiledAnimation::sample_all(jobs);
 
-		out_transforms[i] = (bone.has_parent() ? out_transforms[bone.parent] * bone_tr : bone_tr);
-	}
-	for(usize i = 0; i != bones.size(); ++i) {
-		out_transforms[i] *= invs[i];
+	for(SkeletonInstance* instance : animated) {
+		instance->flush_data();
 	}
-
-	flush_data();
 }
 
 void SkeletonInstance::flush_data() {
@@ -29,7 +29,7 @@ SOFTWARE.
 #include <yave/graphics/buffers/buffers.h>
 #include <yave/graphics/descriptors/DescriptorSet.h>
 
-#include "Animation.h"
+#include "CompiledAnimation.h"
 
 namespace yave {
 
@@ -45,13 +45,22 @@ class SkeletonInstance {
 
 		void animate(const AssetPtr<Animation>& anim);
 
+		// Use this to share a single compiled animation between many instances of the same skeleton
+		void animate(std::shared_ptr<const CompiledAnimation> anim);
+
 		void update();
 
+		// Same as calling update() on every instance, but sampling is spread across the thread pool
+		static void update_all(core::MutableSpan<SkeletonInstance*> instances);
+
 		const auto& descriptor_set() const {
 			return _descriptor_set;
 		}
 
 	private:
+		bool ensure_compiled();
+		CompiledAnimation::SampleJob sample_job();
+
 		void flush_data();
 
 		const Skeleton* _skeleton = nullptr;
@@ -61,6 +70,8 @@ class SkeletonInstance {
 		DescriptorSet _descriptor_set;
 
 		AssetPtr<Animation> _animation;
+		std::shared_ptr<const CompiledAnimation> _compiled;
+		CompiledAnimation::Cursor _cursor;
 		core::Chrono _anim_timer;
 
 };
@@ -57,6 +57,15 @@ AssetLoadingState AssetDependencies::state() const {
 	return AssetLoadingState::Loaded;
 }
 
+GenericAssetPtr AssetDependencies::pending() const {
+	for(const auto& d : _deps) {
+		if(d.is_loading()) {
+			return d;
+		}
+	}
+	return GenericAssetPtr();
+}
+
 AssetLoadingErrorType AssetDependencies::error() const {
 	for(const auto& d : _deps) {
 		if(!d.is_failed()) {
@@ -39,6 +39,9 @@ class AssetDependencies {
 		AssetLoadingState state() const;
 		AssetLoadingErrorType error() const;
 
+		// First dependency that is still loading, empty if none
+		GenericAssetPtr pending() const;
+
 	private:
 		core::Vector<GenericAssetPtr> _deps;
 		AssetLoadingFlags _flags;
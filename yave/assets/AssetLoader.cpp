@@ -72,6 +72,14 @@ void AssetLoader::wait_until_loaded(const GenericAssetPtr& ptr) {
 	y_debug_assert(!ptr.is_loading());
 }
 
+void AssetLoader::set_priority(const GenericAssetPtr& ptr, AssetLoadingPriority priority) {
+	_thread_pool.set_priority(ptr, priority);
+}
+
+AssetLoadingThreadPool::Stats AssetLoader::loading_stats() const {
+	return _thread_pool.stats();
+}
+
 core::Result<AssetId> AssetLoader::load_or_import(std::string_view name, std::string_view import_from, AssetType type) {
 	if(auto id = _store->id(name)) {
 		return id;
@@ -78,8 +78,8 @@ class AssetLoader : NonMovable, public DeviceLinked {
 				Loader(AssetLoader* parent);
 				~Loader();
 
-				inline AssetPtr<T> load(AssetId id);
-				inline AssetPtr<T> load_async(AssetId id);
+				inline AssetPtr<T> load(AssetId id, AssetLoadingPriority priority);
+				inline AssetPtr<T> load_async(AssetId id, AssetLoadingPriority priority);
 
 				inline AssetPtr<T> reload(const AssetPtr<T>& ptr);
 
@@ -108,16 +108,21 @@ class AssetLoader : NonMovable, public DeviceLinked {
 		// This is dangerous: Do not call in loading threads!
 		void wait_until_loaded(const GenericAssetPtr& ptr);
 
+		// Only affects loads that have not started yet
+		void set_priority(const GenericAssetPtr& ptr, AssetLoadingPriority priority);
+
+		AssetLoadingThreadPool::Stats loading_stats() const;
+
 
 		template<typename T>
-		inline Result<T> load_res(AssetId id);
+		inline Result<T> load_res(AssetId id, AssetLoadingPriority priority = AssetLoadingPriority::Immediate);
 		template<typename T>
-		inline Result<T> load_res(std::string_view name);
+		inline Result<T> load_res(std::string_view name, AssetLoadingPriority priority = AssetLoadingPriority::Immediate);
 
 		template<typename T>
-		inline AssetPtr<T> load(AssetId id);
+		inline AssetPtr<T> load(AssetId id, AssetLoadingPriority priority = AssetLoadingPriority::Immediate);
 		template<typename T>
-		inline AssetPtr<T> load_async(AssetId id);
+		inline AssetPtr<T> load_async(AssetId id, AssetLoadingPriority priority = AssetLoadingPriority::Visible);
 
 		template<typename T>
 		inline AssetPtr<T> reload(const AssetPtr<T>& ptr);
@@ -132,7 +137,7 @@ class AssetLoader : NonMovable, public DeviceLinked {
 		friend class AssetLoadingContext;
 
 		template<typename T, typename E>
-		inline Result<T> load(core::Result<AssetId, E> id);
+		inline Result<T> load(core::Result<AssetId, E> id, AssetLoadingPriority priority = AssetLoadingPriority::Immediate);
 
 		template<typename T>
 		inline Loader<T>& loader_for_type();
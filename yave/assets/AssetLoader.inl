@@ -59,6 +59,7 @@ void AssetPtr<T>::reload() {
 template<typename T>
 void AssetPtr<T>::wait_until_loaded() const {
 	if(has_loader() && !is_loaded()) {
+		loader()->set_priority(*this, AssetLoadingPriority::Immediate);
 		loader()->wait_until_loaded(*this);
 		y_debug_assert(is_loaded());
 	}
@@ -119,9 +120,9 @@ bool AssetLoader::Loader<T>::find_ptr(AssetPtr<T>& ptr) {
 
 
 template<typename T>
-AssetPtr<T> AssetLoader::Loader<T>::load(AssetId id) {
+AssetPtr<T> AssetLoader::Loader<T>::load(AssetId id, AssetLoadingPriority priority) {
 	y_profile();
-	auto ptr = load_async(id);
+	auto ptr = load_async(id, priority);
 	parent()->wait_until_loaded(ptr);
 	y_debug_assert(!ptr.is_loading());
 	return ptr;
@@ -129,11 +130,13 @@ AssetPtr<T> AssetLoader::Loader<T>::load(AssetId id) {
 }
 
 template<typename T>
-AssetPtr<T> AssetLoader::Loader<T>::load_async(AssetId id) {
+AssetPtr<T> AssetLoader::Loader<T>::load_async(AssetId id, AssetLoadingPriority priority) {
 	y_profile();
 	AssetPtr<T> ptr(id);
 	if(!find_ptr(ptr)) {
-		parent()->_thread_pool.add_loading_job(create_loading_job(ptr));
+		parent()->_thread_pool.add_loading_job(create_loading_job(ptr), priority);
+	} else if(ptr.is_loading()) {
+		parent()->_thread_pool.raise_priority(ptr, priority);
 	}
 	return ptr;
 }
@@ -151,7 +154,7 @@ AssetPtr<T> AssetLoader::Loader<T>::reload(const AssetPtr<T>& ptr) {
 
 	AssetPtr<T> reloaded(id, parent());
 	{
-		parent()->_thread_pool.add_loading_job(create_loading_job(reloaded));
+		parent()->_thread_pool.add_loading_job(create_loading_job(reloaded), AssetLoadingPriority::Immediate);
 		parent()->wait_until_loaded(reloaded);
 		y_debug_assert(!reloaded.is_loading());
 	}
@@ -171,13 +174,23 @@ template<typename T>
 std::unique_ptr<AssetLoader::LoadingJob> AssetLoader::Loader<T>::create_loading_job(AssetPtr<T> ptr) {
 	class Job : public LoadingJob {
 		public:
-			Job(AssetLoader* loader, std::shared_ptr<Data> data) : LoadingJob(loader), _data(std::move(data)) {
-				y_always_assert(_data, "Invalid asset");
+			Job(AssetLoader* loader, const std::shared_ptr<Data>& data) : LoadingJob(loader, data.get()), _weak_data(data) {
+				y_always_assert(data, "Invalid asset");
+			}
+
+			bool is_cancelled() const override {
+				return _weak_data.expired();
 			}
 
 			core::Result<void> read() override {
 				y_profile_zone("loading");
 
+				// Only keep the asset alive once we start loading it, so dropping every AssetPtr cancels the load
+				_data = _weak_data.lock();
+				if(!_data) {
+					return core::Err();
+				}
+
 				const AssetId id = _data->id;
 
 				y_always_assert(_data->is_loading(), "Asset is not in a loading state");
@@ -206,7 +219,11 @@ std::unique_ptr<AssetLoader::LoadingJob> AssetLoader::Loader<T>::create_loading_
 
 				y_profile_zone("finalizing");
 				y_debug_assert(_data->is_loading());
-				_data->finalize_loading(T(dptr, std::move(_load_from)));
+				if constexpr(std::is_constructible_v<T, DevicePtr, LoadFrom&&, AssetLoadingFlags>) {
+					_data->finalize_loading(T(dptr, std::move(_load_from), parent()->loading_flags()));
+				} else {
+					_data->finalize_loading(T(dptr, std::move(_load_from)));
+				}
 			}
 
 			void set_dependencies_failed() {
@@ -219,6 +236,7 @@ std::unique_ptr<AssetLoader::LoadingJob> AssetLoader::Loader<T>::create_loading_
 			}
 
 		private:
+			std::weak_ptr<Data> _weak_data;
 			std::shared_ptr<Data> _data;
 			LoadFrom _load_from;
 
@@ -226,7 +244,7 @@ std::unique_ptr<AssetLoader::LoadingJob> AssetLoader::Loader<T>::create_loading_
 				return AssetPtr<T>(_data).name().unwrap_or("asset");
 			}
 	};
-	return std::make_unique<Job>(parent(), std::move(ptr._data));
+	return std::make_unique<Job>(parent(), ptr._data);
 }
 
 
@@ -239,8 +257,8 @@ std::unique_ptr<AssetLoader::LoadingJob> AssetLoader::Loader<T>::create_loading_
 // --------------------------- AssetLoader ---------------------------
 
 template<typename T>
-AssetLoader::Result<T> AssetLoader::load_res(AssetId id) {
-	auto ptr = load<T>(id);
+AssetLoader::Result<T> AssetLoader::load_res(AssetId id, AssetLoadingPriority priority) {
+	auto ptr = load<T>(id, priority);
 	if(ptr.is_failed()) {
 		return core::Err(ptr.error());
 	}
@@ -248,19 +266,19 @@ AssetLoader::Result<T> AssetLoader::load_res(AssetId id) {
 }
 
 template<typename T>
-AssetLoader::Result<T> AssetLoader::load_res(std::string_view name) {
-	return load<T>(store().id(name));
+AssetLoader::Result<T> AssetLoader::load_res(std::string_view name, AssetLoadingPriority priority) {
+	return load<T>(store().id(name), priority);
 }
 
 
 template<typename T>
-AssetPtr<T> AssetLoader::load(AssetId id) {
-	return loader_for_type<T>().load(id);
+AssetPtr<T> AssetLoader::load(AssetId id, AssetLoadingPriority priority) {
+	return loader_for_type<T>().load(id, priority);
 }
 
 template<typename T>
-AssetPtr<T> AssetLoader::load_async(AssetId id) {
-	return loader_for_type<T>().load_async(id);
+AssetPtr<T> AssetLoader::load_async(AssetId id, AssetLoadingPriority priority) {
+	return loader_for_type<T>().load_async(id, priority);
 }
 
 
@@ -275,9 +293,9 @@ AssetLoader::Result<T> AssetLoader::import(std::string_view name, std::string_vi
 }
 
 template<typename T, typename E>
-AssetLoader::Result<T> AssetLoader::load(core::Result<AssetId, E> id) {
+AssetLoader::Result<T> AssetLoader::load(core::Result<AssetId, E> id, AssetLoadingPriority priority) {
 	if(id) {
-		return load_res<T>(id.unwrap());
+		return load_res<T>(id.unwrap(), priority);
 	}
 	return core::Err(ErrorType::UnknownID);
 }
@@ -303,14 +321,14 @@ AssetLoader::Loader<T>& AssetLoader::loader_for_type() {
 
 template<typename T>
 AssetPtr<T> AssetLoadingContext::load(AssetId id) {
-	auto ptr = _parent->load<T>(id);
+	auto ptr = _parent->load<T>(id, _priority);
 	_dependencies.add_dependency(ptr);
 	return ptr;
 }
 
 template<typename T>
 AssetPtr<T> AssetLoadingContext::load_async(AssetId id) {
-	auto ptr = _parent->load_async<T>(id);
+	auto ptr = _parent->load_async<T>(id, _priority);
 	_dependencies.add_dependency(ptr);
 	return ptr;
 }
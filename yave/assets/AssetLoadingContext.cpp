@@ -41,4 +41,8 @@ AssetLoader* AssetLoadingContext::parent() const {
 	return _parent;
 }
 
+AssetLoadingPriority AssetLoadingContext::priority() const {
+	return _priority;
+}
+
 }
@@ -40,14 +40,19 @@ class AssetLoadingContext {
 		const AssetDependencies& dependencies() const;
 		AssetLoader* parent() const;
 
+		// Dependencies are loaded with the priority of the asset that needs them
+		AssetLoadingPriority priority() const;
+
 	private:
 		template<typename T>
 		friend class Loader;
 
 		friend class AssetLoader;
+		friend class AssetLoadingThreadPool;
 
 		AssetLoader* _parent;
 		AssetDependencies _dependencies;
+		AssetLoadingPriority _priority = AssetLoadingPriority::Visible;
 };
 
 }
@@ -35,7 +35,7 @@ namespace yave {
 AssetLoadingThreadPool::LoadingJob::~LoadingJob() {
 }
 
-AssetLoadingThreadPool::LoadingJob::LoadingJob(AssetLoader* loader) : _ctx(loader) {
+AssetLoadingThreadPool::LoadingJob::LoadingJob(AssetLoader* loader, const detail::AssetPtrDataBase* asset) : _ctx(loader), _asset(asset) {
 }
 
 const AssetDependencies& AssetLoadingThreadPool::LoadingJob::dependencies() const {
@@ -46,6 +46,10 @@ AssetLoader* AssetLoadingThreadPool::LoadingJob::parent() const {
 	return _ctx.parent();
 }
 
+AssetLoadingPriority AssetLoadingThreadPool::LoadingJob::priority() const {
+	return _ctx.priority();
+}
+
 AssetLoadingContext& AssetLoadingThreadPool::LoadingJob::loading_context() {
 	return _ctx;
 }
@@ -78,60 +82,191 @@ DevicePtr AssetLoadingThreadPool::device() const {
 }
 
 void AssetLoadingThreadPool::wait_until_loaded(const GenericAssetPtr& ptr) {
+	auto lock = y_profile_unique_lock(_lock);
 	while(ptr.is_loading()) {
-		process_one(y_profile_unique_lock(_lock));
+		if(has_pending_work()) {
+			process_one(std::move(lock));
+			lock = y_profile_unique_lock(_lock);
+		} else {
+			// Every completed job notifies, no need to poll
+			_condition.wait(lock);
+		}
 	}
 }
 
-void AssetLoadingThreadPool::add_loading_job(std::unique_ptr<LoadingJob> job) {
+void AssetLoadingThreadPool::add_loading_job(std::unique_ptr<LoadingJob> job, AssetLoadingPriority priority) {
+	y_debug_assert(usize(priority) < priority_count);
+
+	job->_ctx._priority = priority;
+	job->_queued_time.start();
 	{
 		const auto lock = y_profile_unique_lock(_lock);
-		_loading_jobs.emplace_back(std::move(job));
+		_loading_jobs[usize(priority)].emplace_back(std::move(job));
 	}
 	_condition.notify_one();
 }
 
-void AssetLoadingThreadPool::process_one(std::unique_lock<std::mutex> lock) {
-	y_debug_assert(lock.owns_lock());
+void AssetLoadingThreadPool::set_priority(const GenericAssetPtr& ptr, AssetLoadingPriority priority) {
+	if(ptr.is_loading()) {
+		const auto lock = y_profile_unique_lock(_lock);
+		move_job(ptr._data.get(), priority, false);
+	}
+}
+
+void AssetLoadingThreadPool::raise_priority(const GenericAssetPtr& ptr, AssetLoadingPriority priority) {
+	if(ptr.is_loading()) {
+		const auto lock = y_profile_unique_lock(_lock);
+		move_job(ptr._data.get(), priority, true);
+	}
+}
+
+AssetLoadingThreadPool::Stats AssetLoadingThreadPool::stats() const {
+	const auto lock = y_profile_unique_lock(_lock);
+
+	Stats stats;
+	for(usize i = 0; i != priority_count; ++i) {
+		stats.queued[i] = _loading_jobs[i].size();
+	}
+	stats.waiting_for_dependencies = _waiting_count;
+	stats.ready_to_finalize = _finalize_jobs.size();
+	stats.loaded = _loaded;
+	stats.failed = _failed;
+	stats.cancelled = _cancelled;
+	stats.average_latency_ms = _loaded ? _total_latency_ms / double(_loaded) : 0.0;
+	stats.max_latency_ms = _max_latency_ms;
+	return stats;
+}
+
+bool AssetLoadingThreadPool::has_pending_work() const {
+	if(!_finalize_jobs.empty()) {
+		return true;
+	}
+	for(const JobQueue& queue : _loading_jobs) {
+		if(!queue.empty()) {
+			return true;
+		}
+	}
+	return false;
+}
 
-	for(auto it = _finalize_jobs.begin(); it != _finalize_jobs.end(); ++it) {
-		const AssetLoadingState state = (*it)->dependencies().state();
-		if(state != AssetLoadingState::NotLoaded) {
-			auto job = std::move(*it);
-			_finalize_jobs.erase(it);
-			lock.unlock();
-
-			if(state == AssetLoadingState::Loaded) {
-				job->finalize(device());
-			} else if(state == AssetLoadingState::Failed) {
-				job->set_dependencies_failed();
+// Called with the lock held. Linear, but only done when a job starts waiting or on explicit requests
+void AssetLoadingThreadPool::move_job(const detail::AssetPtrDataBase* asset, AssetLoadingPriority priority, bool raise_only) {
+	const usize target = usize(priority);
+	for(usize i = raise_only ? target + 1 : 0; i < priority_count; ++i) {
+		if(i == target) {
+			continue;
+		}
+
+		JobQueue& queue = _loading_jobs[i];
+		for(auto it = queue.begin(); it != queue.end(); ++it) {
+			if((*it)->_asset == asset) {
+				auto job = std::move(*it);
+				queue.erase(it);
+				job->_ctx._priority = priority;
+				_loading_jobs[target].emplace_back(std::move(job));
+				return;
 			}
-			_condition.notify_all();
-			return;
 		}
 	}
+}
 
+// Called with the lock held
+void AssetLoadingThreadPool::wait_for_dependencies(std::unique_ptr<LoadingJob> job) {
+	const GenericAssetPtr pending = job->dependencies().pending();
+	if(pending.is_empty()) {
+		_finalize_jobs.emplace_back(std::move(job));
+		_condition.notify_one();
+		return;
+	}
+
+	// Don't let a visible asset wait on a prefetch
+	const detail::AssetPtrDataBase* dependency = pending._data.get();
+	move_job(dependency, job->priority(), true);
+
+	_waiting_jobs[dependency].emplace_back(std::move(job));
+	++_waiting_count;
+}
+
+void AssetLoadingThreadPool::complete(std::unique_ptr<LoadingJob> job, bool read) {
+	bool loaded = false;
+	if(read) {
+		const AssetLoadingState state = job->dependencies().state();
+		y_debug_assert(state != AssetLoadingState::NotLoaded);
+		if(state == AssetLoadingState::Loaded) {
+			job->finalize(device());
+			loaded = true;
+		} else {
+			job->set_dependencies_failed();
+		}
+	}
+
+	const double latency = job->_queued_time.elapsed().to_millis();
+
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+
+		if(loaded) {
+			++_loaded;
+			_total_latency_ms += latency;
+			_max_latency_ms = std::max(_max_latency_ms, latency);
+		} else if(job->is_cancelled()) {
+			++_cancelled;
+		} else {
+			++_failed;
+		}
+
+		if(const auto it = _waiting_jobs.find(job->_asset); it != _waiting_jobs.end()) {
+			core::Vector<std::unique_ptr<LoadingJob>> waiting = std::move(it->second);
+			_waiting_jobs.erase(it);
+			_waiting_count -= waiting.size();
+
+			for(auto& waiting_job : waiting) {
+				wait_for_dependencies(std::move(waiting_job));
+			}
+		}
+	}
+
+	_condition.notify_all();
+}
+
+void AssetLoadingThreadPool::process_one(std::unique_lock<std::mutex> lock) {
 	y_debug_assert(lock.owns_lock());
 
-	if(!_loading_jobs.empty()) {
-		auto job = std::move(_loading_jobs.front());
-		_loading_jobs.pop_front();
+	if(!_finalize_jobs.empty()) {
+		auto job = std::move(_finalize_jobs.front());
+		_finalize_jobs.pop_front();
+		lock.unlock();
+
+		complete(std::move(job), true);
+		return;
+	}
+
+	for(JobQueue& queue : _loading_jobs) {
+		if(queue.empty()) {
+			continue;
+		}
+
+		auto job = std::move(queue.front());
+		queue.pop_front();
+
+		if(job->is_cancelled()) {
+			++_cancelled;
+			return;
+		}
+
 		lock.unlock();
 
 		if(job->read()) {
-			const AssetLoadingState state = job->dependencies().state();
-			if(state != AssetLoadingState::NotLoaded) {
-				if(state == AssetLoadingState::Loaded) {
-					job->finalize(device());
-				} else if(state == AssetLoadingState::Failed) {
-					job->set_dependencies_failed();
-				}
-				_condition.notify_all();
+			if(job->dependencies().state() == AssetLoadingState::NotLoaded) {
+				const auto inner_lock = y_profile_unique_lock(_lock);
+				wait_for_dependencies(std::move(job));
 			} else {
-				auto inner_lock = y_profile_unique_lock(_lock);
-				_finalize_jobs.emplace_back(std::move(job));
+				complete(std::move(job), true);
 			}
+		} else {
+			complete(std::move(job), false);
 		}
+		return;
 	}
 }
 
@@ -139,7 +274,7 @@ void AssetLoadingThreadPool::worker() {
 	while(_run) {
 		auto lock = y_profile_unique_lock(_lock);
 		_condition.wait(lock, [this] {
-			return !_loading_jobs.empty() || !_finalize_jobs.empty() ||  !_run;
+			return has_pending_work() || !_run;
 		});
 		process_one(std::move(lock));
 	}
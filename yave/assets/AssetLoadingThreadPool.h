@@ -26,12 +26,14 @@ SOFTWARE.
 
 #include <y/core/Vector.h>
 #include <y/core/Functor.h>
+#include <y/core/HashMap.h>
+#include <y/core/Chrono.h>
 
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <deque>
-#include <list>
+#include <array>
 
 namespace yave {
 
@@ -40,6 +42,8 @@ class AssetLoadingThreadPool : NonMovable {
 		using CreateFunc = core::Function<void()>;
 		using ReadFunc = core::Function<CreateFunc(AssetLoadingContext&)>;
 
+		static constexpr usize priority_count = usize(AssetLoadingPriority::Prefetch) + 1;
+
 		class LoadingJob : NonMovable {
 			public:
 				virtual ~LoadingJob();
@@ -48,16 +52,38 @@ class AssetLoadingThreadPool : NonMovable {
 				virtual void finalize(DevicePtr dptr) = 0;
 				virtual void set_dependencies_failed() = 0;
 
+				// Every AssetPtr to the asset has been dropped before the job started
+				virtual bool is_cancelled() const = 0;
+
 				const AssetDependencies& dependencies() const;
 				AssetLoader* parent() const;
 
+				AssetLoadingPriority priority() const;
+
 			protected:
-				LoadingJob(AssetLoader* loader);
+				LoadingJob(AssetLoader* loader, const detail::AssetPtrDataBase* asset);
 
 				AssetLoadingContext& loading_context();
 
 			private:
+				friend class AssetLoadingThreadPool;
+
 				AssetLoadingContext _ctx;
+				const detail::AssetPtrDataBase* _asset = nullptr;
+				core::Chrono _queued_time;
+		};
+
+		struct Stats {
+			std::array<usize, priority_count> queued = {};
+			usize waiting_for_dependencies = 0;
+			usize ready_to_finalize = 0;
+
+			u64 loaded = 0;
+			u64 failed = 0;
+			u64 cancelled = 0;
+
+			double average_latency_ms = 0.0;
+			double max_latency_ms = 0.0;
 		};
 
 
@@ -69,16 +95,40 @@ class AssetLoadingThreadPool : NonMovable {
 
 		void wait_until_loaded(const GenericAssetPtr& ptr);
 
-		void add_loading_job(std::unique_ptr<LoadingJob> job);
+		void add_loading_job(std::unique_ptr<LoadingJob> job, AssetLoadingPriority priority = AssetLoadingPriority::Visible);
+
+		// Moves a queued load to another priority, does nothing if ptr is not waiting to be read
+		void set_priority(const GenericAssetPtr& ptr, AssetLoadingPriority priority);
+		void raise_priority(const GenericAssetPtr& ptr, AssetLoadingPriority priority);
+
+		Stats stats() const;
 
 	private:
+		using JobQueue = std::deque<std::unique_ptr<LoadingJob>>;
+
 		void process_one(std::unique_lock<std::mutex> lock);
 		void worker();
 
-		std::deque<std::unique_ptr<LoadingJob>> _loading_jobs;
-		std::list<std::unique_ptr<LoadingJob>> _finalize_jobs;
+		bool has_pending_work() const;
+
+		void complete(std::unique_ptr<LoadingJob> job, bool loaded);
+		void wait_for_dependencies(std::unique_ptr<LoadingJob> job);
+		void move_job(const detail::AssetPtrDataBase* asset, AssetLoadingPriority priority, bool raise_only);
+
+		std::array<JobQueue, priority_count> _loading_jobs;
+		JobQueue _finalize_jobs;
+
+		// Jobs waiting for a dependency, keyed by the first dependency that was still loading
+		core::ExternalHashMap<const detail::AssetPtrDataBase*, core::Vector<std::unique_ptr<LoadingJob>>> _waiting_jobs;
+		usize _waiting_count = 0;
+
+		u64 _loaded = 0;
+		u64 _failed = 0;
+		u64 _cancelled = 0;
+		double _total_latency_ms = 0.0;
+		double _max_latency_ms = 0.0;
 
-		std::mutex _lock;
+		mutable std::mutex _lock;
 		std::condition_variable _condition;
 
 		core::Vector<std::thread> _threads;
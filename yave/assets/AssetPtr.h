@@ -55,7 +55,18 @@ enum class AssetLoadingErrorType : u32 {
 
 enum class AssetLoadingFlags : u32 {
 	None = 0,
-	SkipFailedDependenciesBit = 0x01
+	SkipFailedDependenciesBit = 0x01,
+
+	// Meshes keep a CPU side copy of their geometry, needed for CPU picking
+	KeepCpuGeometryBit = 0x02
+};
+
+// Lower values are loaded first
+enum class AssetLoadingPriority : u32 {
+	Immediate = 0,
+	Visible = 1,
+	Background = 2,
+	Prefetch = 3
 };
 
 inline constexpr AssetLoadingFlags operator|(AssetLoadingFlags l, AssetLoadingFlags r) {
@@ -0,0 +1,438 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "BundleAssetStore.h"
+
+#include <yave/utils/FileSystemModel.h>
+
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/core/FixedArray.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <algorithm>
+
+namespace yave {
+
+static constexpr u32 bundle_magic = 0x42564159; // "YAVB"
+static constexpr u32 bundle_version = 1;
+
+// Payloads start on page boundaries so they can be mapped directly
+static constexpr usize payload_alignment = 4096;
+
+enum class BundleCompression : u32 {
+	None = 0,
+};
+
+struct BundleAssetStore::Header {
+	u32 magic;
+	u32 version;
+
+	u64 entry_count;
+
+	u64 entries_offset;
+	u64 names_offset;
+	u64 strings_offset;
+	u64 strings_size;
+};
+
+// Sorted by id
+struct BundleAssetStore::Entry {
+	u64 id;
+
+	u64 offset;
+	u64 size;
+	u64 stored_size;
+
+	u32 name_offset;
+	u32 name_size;
+
+	u32 type;
+	u32 compression;
+};
+
+// Sorted by hash
+struct BundleAssetStore::NameEntry {
+	u64 hash;
+	u64 entry_index;
+};
+
+
+// FNV-1a, has to be stable since it is stored in the bundle
+static u64 name_hash(std::string_view name) {
+	u64 hash = 0xcbf29ce484222325;
+	for(const char c : name) {
+		hash = (hash ^ u8(c)) * 0x100000001b3;
+	}
+	return hash;
+}
+
+static usize align_up(usize value, usize alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool in_file(u64 offset, u64 size, usize file_size) {
+	return offset <= file_size && size <= file_size - offset;
+}
+
+
+class BundleReader final : public io2::Reader {
+	public:
+		BundleReader(std::shared_ptr<const io2::MappedFile> file, const u8* data, usize size) :
+				_file(std::move(file)),
+				_data(data),
+				_size(size) {
+		}
+
+		bool at_end() const override {
+			return _cursor == _size;
+		}
+
+		usize remaining() const override {
+			return _size - _cursor;
+		}
+
+		void seek(usize byte) override {
+			_cursor = std::min(byte, _size);
+		}
+
+		usize tell() const override {
+			return _cursor;
+		}
+
+		io2::ReadResult read(void* data, usize bytes) override {
+			if(remaining() < bytes) {
+				return core::Err<usize>(0);
+			}
+			std::copy_n(_data + _cursor, bytes, static_cast<u8*>(data));
+			_cursor += bytes;
+			return core::Ok();
+		}
+
+		io2::ReadUpToResult read_up_to(void* data, usize max_bytes) override {
+			const usize max = std::min(max_bytes, remaining());
+			std::copy_n(_data + _cursor, max, static_cast<u8*>(data));
+			_cursor += max;
+			return core::Ok(max);
+		}
+
+		io2::ReadUpToResult read_all(core::Vector<u8>& data) override {
+			const usize r = remaining();
+			data.push_back(_data + _cursor, _data + _size);
+			_cursor = _size;
+			return core::Ok(r);
+		}
+
+		const u8* try_view(usize bytes) override {
+			if(remaining() < bytes) {
+				return nullptr;
+			}
+			const u8* view = _data + _cursor;
+			_cursor += bytes;
+			return view;
+		}
+
+	private:
+		std::shared_ptr<const io2::MappedFile> _file;
+		const u8* _data = nullptr;
+		usize _size = 0;
+		usize _cursor = 0;
+};
+
+
+
+AssetStore::Result<std::unique_ptr<BundleAssetStore>> BundleAssetStore::open(const core::String& filename) {
+	y_profile();
+
+	auto file = io2::MappedFile::open(filename);
+	if(!file) {
+		log_msg(fmt("Unable to open asset bundle \"%\"", filename), Log::Error);
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	auto mapped = std::make_shared<io2::MappedFile>(std::move(file.unwrap()));
+	if(!is_valid(*mapped)) {
+		log_msg(fmt("\"%\" is not a valid asset bundle", filename), Log::Error);
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	std::unique_ptr<BundleAssetStore> store(new BundleAssetStore(std::move(mapped)));
+	log_msg(fmt("Asset bundle opened: % assets", store->asset_count()));
+	return core::Ok(std::move(store));
+}
+
+bool BundleAssetStore::is_valid(const io2::MappedFile& file) {
+	static_assert(std::is_trivially_copyable_v<Header>);
+	static_assert(sizeof(Header) % 8 == 0 && sizeof(Entry) % 8 == 0 && sizeof(NameEntry) % 8 == 0);
+
+	const usize file_size = file.size();
+	if(file_size < sizeof(Header)) {
+		return false;
+	}
+
+	const Header* header = reinterpret_cast<const Header*>(file.data());
+	if(header->magic != bundle_magic || header->version != bundle_version) {
+		return false;
+	}
+
+	const u64 count = header->entry_count;
+	return
+		count <= file_size / sizeof(Entry) &&
+		header->entries_offset % alignof(Entry) == 0 &&
+		header->names_offset % alignof(NameEntry) == 0 &&
+		in_file(header->entries_offset, count * sizeof(Entry), file_size) &&
+		in_file(header->names_offset, count * sizeof(NameEntry), file_size) &&
+		in_file(header->strings_offset, header->strings_size, file_size);
+}
+
+BundleAssetStore::BundleAssetStore(std::shared_ptr<const io2::MappedFile> file) : _file(std::move(file)) {
+	const u8* data = _file->data();
+
+	_header = reinterpret_cast<const Header*>(data);
+	_entries = reinterpret_cast<const Entry*>(data + _header->entries_offset);
+	_names = reinterpret_cast<const NameEntry*>(data + _header->names_offset);
+	_strings = reinterpret_cast<const char*>(data + _header->strings_offset);
+}
+
+BundleAssetStore::~BundleAssetStore() {
+}
+
+usize BundleAssetStore::asset_count() const {
+	return usize(_header->entry_count);
+}
+
+const FileSystemModel* BundleAssetStore::filesystem() const {
+	return nullptr;
+}
+
+const BundleAssetStore::Entry* BundleAssetStore::find(AssetId id) const {
+	const Entry* end = _entries + _header->entry_count;
+	const Entry* entry = std::lower_bound(_entries, end, id.id(), [](const Entry& e, u64 i) { return e.id < i; });
+	return (entry != end && entry->id == id.id()) ? entry : nullptr;
+}
+
+std::string_view BundleAssetStore::entry_name(const Entry& entry) const {
+	if(!in_file(entry.name_offset, entry.name_size, _header->strings_size)) {
+		return {};
+	}
+	return std::string_view(_strings + entry.name_offset, entry.name_size);
+}
+
+AssetStore::Result<AssetId> BundleAssetStore::import(io2::Reader&, std::string_view, AssetType) {
+	return core::Err(ErrorType::UnsupportedOperation);
+}
+
+AssetStore::Result<AssetId> BundleAssetStore::id(std::string_view name) const {
+	y_profile();
+
+	const u64 hash = name_hash(name);
+	const NameEntry* end = _names + _header->entry_count;
+	for(const NameEntry* it = std::lower_bound(_names, end, hash, [](const NameEntry& e, u64 h) { return e.hash < h; });
+		it != end && it->hash == hash; ++it) {
+
+		if(it->entry_index < _header->entry_count) {
+			const Entry& entry = _entries[it->entry_index];
+			if(entry_name(entry) == name) {
+				return core::Ok(AssetId::from_id(entry.id));
+			}
+		}
+	}
+
+	return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<core::String> BundleAssetStore::name(AssetId id) const {
+	y_profile();
+
+	if(const Entry* entry = find(id)) {
+		return core::Ok(core::String(entry_name(*entry)));
+	}
+	return core::Err(ErrorType::UnknownID);
+}
+
+AssetStore::Result<io2::ReaderPtr> BundleAssetStore::data(AssetId id) const {
+	y_profile();
+
+	const Entry* entry = find(id);
+	if(!entry) {
+		return core::Err(ErrorType::UnknownID);
+	}
+
+	if(!in_file(entry->offset, entry->stored_size, _file->size())) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	// No codec is linked yet, bundles are only written uncompressed
+	if(BundleCompression(entry->compression) != BundleCompression::None || entry->stored_size != entry->size) {
+		return core::Err(ErrorType::UnsupportedOperation);
+	}
+
+	return core::Ok(io2::ReaderPtr(std::make_unique<BundleReader>(_file, _file->data() + entry->offset, usize(entry->size))));
+}
+
+AssetStore::Result<AssetType> BundleAssetStore::asset_type(AssetId id) const {
+	y_profile();
+
+	if(const Entry* entry = find(id)) {
+		return core::Ok(AssetType(entry->type));
+	}
+	return core::Err(ErrorType::UnknownID);
+}
+
+
+
+AssetStore::Result<> BundleAssetStore::pack(const AssetStore& store, const core::String& filename) {
+	y_profile();
+
+	const FileSystemModel* filesystem = store.filesystem();
+	if(!filesystem) {
+		return core::Err(ErrorType::UnsupportedOperation);
+	}
+
+	core::Vector<core::String> names;
+	{
+		auto root = filesystem->current_path();
+		if(!root) {
+			return core::Err(ErrorType::FilesytemError);
+		}
+
+		core::Vector<core::String> folders;
+		folders << root.unwrap();
+		while(!folders.is_empty()) {
+			const core::String folder = folders.pop();
+			const auto r = filesystem->for_each(folder, [&](std::string_view entry) {
+				core::String full_name = filesystem->join(folder, filesystem->filename(entry));
+				if(filesystem->is_directory(full_name).unwrap_or(false)) {
+					folders << std::move(full_name);
+				} else {
+					names << std::move(full_name);
+				}
+			});
+			if(!r) {
+				return core::Err(ErrorType::FilesytemError);
+			}
+		}
+	}
+
+	core::Vector<Entry> entries;
+	core::String strings;
+	for(const core::String& name : names) {
+		const auto id = store.id(name);
+		const auto type = store.asset_type(id ? id.unwrap() : AssetId());
+		const auto data = store.data(id ? id.unwrap() : AssetId());
+		if(!id || !type || !data) {
+			log_msg(fmt("Unable to pack \"%\"", name), Log::Error);
+			return core::Err(ErrorType::Unknown);
+		}
+
+		Entry entry = {};
+		entry.id = id.unwrap().id();
+		entry.size = data.unwrap()->remaining();
+		entry.stored_size = entry.size;
+		entry.name_offset = u32(strings.size());
+		entry.name_size = u32(name.size());
+		entry.type = u32(type.unwrap());
+		entry.compression = u32(BundleCompression::None);
+		entries << entry;
+
+		strings += name;
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.id < b.id; });
+
+	core::Vector<NameEntry> name_index;
+	for(usize i = 0; i != entries.size(); ++i) {
+		name_index << NameEntry{name_hash(std::string_view(strings.data() + entries[i].name_offset, entries[i].name_size)), i};
+	}
+	std::sort(name_index.begin(), name_index.end(), [](const NameEntry& a, const NameEntry& b) { return a.hash < b.hash; });
+
+	Header header = {};
+	header.magic = bundle_magic;
+	header.version = bundle_version;
+	header.entry_count = entries.size();
+	header.entries_offset = sizeof(Header);
+	header.names_offset = header.entries_offset + entries.size() * sizeof(Entry);
+	header.strings_offset = header.names_offset + name_index.size() * sizeof(NameEntry);
+	header.strings_size = strings.size();
+
+	{
+		usize offset = align_up(header.strings_offset + header.strings_size, payload_alignment);
+		for(Entry& entry : entries) {
+			entry.offset = offset;
+			offset = align_up(offset + entry.stored_size, payload_alignment);
+		}
+	}
+
+	auto file = io2::File::create(filename);
+	if(!file) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+	io2::File& out = file.unwrap();
+
+	const bool index_written =
+		out.write_one(header) &&
+		out.write_array(entries.data(), entries.size()) &&
+		out.write_array(name_index.data(), name_index.size()) &&
+		out.write_array(strings.data(), strings.size());
+
+	if(!index_written) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	core::FixedArray<u8> buffer(payload_alignment * 16);
+	std::fill(buffer.begin(), buffer.end(), u8(0));
+
+	for(const Entry& entry : entries) {
+		y_debug_assert(out.tell() <= entry.offset);
+		if(!out.write(buffer.data(), entry.offset - out.tell())) {
+			return core::Err(ErrorType::FilesytemError);
+		}
+
+		auto data = store.data(AssetId::from_id(entry.id));
+		if(!data || data.unwrap()->remaining() != entry.size) {
+			return core::Err(ErrorType::Unknown);
+		}
+
+		io2::Reader& reader = *data.unwrap();
+		for(usize written = 0; written != entry.size;) {
+			const auto r = reader.read_up_to(buffer.data(), std::min(buffer.size(), usize(entry.size) - written));
+			if(!r || !r.unwrap() || !out.write(buffer.data(), r.unwrap())) {
+				return core::Err(ErrorType::FilesytemError);
+			}
+			written += r.unwrap();
+		}
+
+		// buffer is used for padding
+		std::fill(buffer.begin(), buffer.end(), u8(0));
+	}
+
+	if(!out.flush()) {
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	log_msg(fmt("% assets packed into \"%\"", entries.size(), filename));
+
+	return core::Ok();
+}
+
+}
@@ -0,0 +1,86 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ASSETS_BUNDLEASSETSTORE_H
+#define YAVE_ASSETS_BUNDLEASSETSTORE_H
+
+#include "AssetStore.h"
+
+#include <y/core/String.h>
+
+namespace y {
+namespace io2 {
+class MappedFile;
+}
+}
+
+namespace yave {
+
+// Read only store backed by a single mapped packfile, meant for shipping.
+// Lookups are binary searches on the mapped index, nothing is parsed when opening.
+// Bundles are flat and have no filesystem: filesystem() returns null.
+class BundleAssetStore final : NonMovable, public AssetStore {
+
+	struct Header;
+	struct Entry;
+	struct NameEntry;
+
+	public:
+		// Fails if the file can not be mapped or if its index is invalid
+		static Result<std::unique_ptr<BundleAssetStore>> open(const core::String& filename);
+
+		// Packs every asset visible through store's filesystem into a bundle
+		static Result<> pack(const AssetStore& store, const core::String& filename);
+
+		~BundleAssetStore() override;
+
+		usize asset_count() const;
+
+		const FileSystemModel* filesystem() const override;
+
+		Result<AssetId> import(io2::Reader& data, std::string_view dst_name, AssetType type) override;
+
+		Result<AssetId> id(std::string_view name) const override;
+		Result<core::String> name(AssetId id) const override;
+
+		Result<io2::ReaderPtr> data(AssetId id) const override;
+
+		Result<AssetType> asset_type(AssetId id) const override;
+
+	private:
+		BundleAssetStore(std::shared_ptr<const io2::MappedFile> file);
+
+		static bool is_valid(const io2::MappedFile& file);
+
+		const Entry* find(AssetId id) const;
+		std::string_view entry_name(const Entry& entry) const;
+
+		std::shared_ptr<const io2::MappedFile> _file;
+
+		const Header* _header = nullptr;
+		const Entry* _entries = nullptr;
+		const NameEntry* _names = nullptr;
+		const char* _strings = nullptr;
+};
+
+}
+
+#endif // YAVE_ASSETS_BUNDLEASSETSTORE_H
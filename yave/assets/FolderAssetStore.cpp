@@ -23,6 +23,7 @@ SOFTWARE.
 #include "FolderAssetStore.h"
 
 #include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
 
 #include <y/utils/log.h>
 #include <y/serde3/archives.h>
@@ -341,6 +342,24 @@ core::String FolderAssetStore::asset_file_name(AssetId id) const {
 	return _filesystem.join(_root, name);
 }
 
+// Asset files might be mapped by readers (see data()), so they are never modified in place:
+// data is written to a temporary file that then replaces the asset file
+FolderAssetStore::Result<> FolderAssetStore::write_asset_file(const core::String& filename, io2::Reader& data) const {
+	const core::String tmp_file = filename + "_";
+
+	if(!io2::File::copy(data, tmp_file)) {
+		FileSystemModel::local_filesystem()->remove(tmp_file).ignore();
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	if(!FileSystemModel::local_filesystem()->rename(tmp_file, filename)) {
+		FileSystemModel::local_filesystem()->remove(tmp_file).ignore();
+		return core::Err(ErrorType::FilesytemError);
+	}
+
+	return core::Ok();
+}
+
 void FolderAssetStore::rebuild_id_map() const {
 	y_profile();
 
@@ -378,9 +397,7 @@ AssetStore::Result<AssetId> FolderAssetStore::import(io2::Reader& data, std::str
 	const AssetId id = next_id();
 	const core::String filename = asset_file_name(id);
 
-	if(!io2::File::copy(data, filename)) {
-		return core::Err(ErrorType::FilesytemError);
-	}
+	y_try(write_asset_file(filename, data));
 
 	_assets[dst_name] = AssetData{id, type};
 
@@ -398,17 +415,21 @@ AssetStore::Result<> FolderAssetStore::write(AssetId id, io2::Reader& data) {
 		return core::Err(ErrorType::UnknownID);
 	}
 
-	if(!io2::File::copy(data, filename)) {
-		return core::Err(ErrorType::FilesytemError);
-	}
-
-	return core::Ok();
+	return write_asset_file(filename, data);
 }
 
 AssetStore::Result<io2::ReaderPtr> FolderAssetStore::data(AssetId id) const {
 	y_profile();
 
-	if(auto file = io2::File::open(asset_file_name(id))) {
+	const core::String filename = asset_file_name(id);
+
+	if(auto file = io2::MappedFile::open(filename)) {
+		io2::ReaderPtr ptr = std::make_unique<io2::MappedFile>(std::move(file.unwrap()));
+		return core::Ok(std::move(ptr));
+	}
+
+	// Mapping can fail (out of address space, special files), fallback to regular reads
+	if(auto file = io2::File::open(filename)) {
 		io2::ReaderPtr ptr = std::make_unique<io2::File>(std::move(file.unwrap()));
 		return core::Ok(std::move(ptr));
 	}
@@ -94,6 +94,7 @@ class FolderAssetStore final : NonMovable, public AssetStore {
 	private:
 		core::String index_file_name() const;
 		core::String asset_file_name(AssetId id) const;
+		Result<> write_asset_file(const core::String& filename, io2::Reader& data) const;
 		AssetId next_id();
 		void rebuild_id_map() const;
 
@@ -23,17 +23,25 @@ SOFTWARE.
 #include "SQLiteAssetStore.h"
 
 #include <y/utils/log.h>
+#include <y/core/FixedArray.h>
 
 #ifndef YAVE_NO_SQLITE
 
 #include <sqlite/sqlite3.h>
 
+#include <algorithm>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 // https://stackoverflow.com/questions/1711631/improve-insert-per-second-performance-of-sqlite
 
 namespace yave {
+
+static constexpr usize max_read_connections = 8;
+static constexpr usize blob_chunk_size = 64 * 1024;
+
 static bool is_row(int res) {
 	return res == SQLITE_ROW;
 }
@@ -51,6 +59,400 @@ static int step_db(sqlite3_stmt* stmt) {
 	return sqlite3_step(stmt);
 }
 
+static void check(sqlite3* database, int res) {
+	if(res != SQLITE_OK) {
+		// We might leak memory here, but we don't care
+		y_fatal(database ? sqlite3_errmsg(database) : "Unknown SQLite error.");
+	}
+}
+
+
+namespace {
+class Connection : NonMovable {
+	public:
+		Connection(const core::String& path, bool read_only) {
+			const int flags = read_only ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+			check(sqlite3_open_v2(path.data(), &_database, flags, nullptr));
+		}
+
+		~Connection() {
+			for(const auto& [sql, stmt] : _statements) {
+				sqlite3_finalize(stmt);
+			}
+
+			while(sqlite3_stmt* stmt = sqlite3_next_stmt(_database, nullptr)) {
+				log_msg(fmt("Database has pending statements (busy: %).", !!sqlite3_stmt_busy(stmt)), Log::Warning);
+				sqlite3_finalize(stmt);
+			}
+
+			check(sqlite3_close(_database));
+		}
+
+		void check(int res) const {
+			yave::check(_database, res);
+		}
+
+		sqlite3* handle() const {
+			return _database;
+		}
+
+		int exec(const char* sql) {
+			return sqlite3_exec(_database, sql, nullptr, nullptr, nullptr);
+		}
+
+		// sql is used as the cache key and has to outlive the connection (string literals only)
+		sqlite3_stmt* cached_statement(const char* sql) {
+			for(const auto& [cached_sql, stmt] : _statements) {
+				if(cached_sql == sql) {
+					return stmt;
+				}
+			}
+
+			sqlite3_stmt* stmt = nullptr;
+			check(sqlite3_prepare_v3(_database, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr));
+			_statements.emplace_back(sql, stmt);
+			return stmt;
+		}
+
+		std::mutex& mutex() {
+			return _mutex;
+		}
+
+	private:
+		sqlite3* _database = nullptr;
+		std::mutex _mutex;
+		core::Vector<std::pair<const char*, sqlite3_stmt*>> _statements;
+};
+
+// Read only connections used by statements and blob readers, each connection is used by one of them at a time.
+// Waits for any connection to be released once max_read_connections are in use,
+// except if the calling thread already holds one: it might be the one we are waiting on (nested reads).
+// Blob readers can be released by another thread than the one that acquired their connection.
+class ReadConnectionPool : NonMovable {
+	struct Holder {
+		Connection* connection = nullptr;
+		std::thread::id thread;
+	};
+
+	public:
+		ReadConnectionPool(const core::String& path) : _path(path) {
+		}
+
+		Connection& acquire() {
+			std::unique_lock lock(_lock);
+
+			if(_idle.is_empty() && (_connections.size() < max_read_connections || held_by_this_thread())) {
+				Connection& connection = *_connections.emplace_back(std::make_unique<Connection>(_path, true));
+				connection.check(connection.exec("PRAGMA case_sensitive_like = ON"));
+				_idle << &connection;
+			}
+
+			_released.wait(lock, [&] { return !_idle.is_empty(); });
+
+			Connection* connection = _idle.pop();
+			_holders.emplace_back(Holder{connection, std::this_thread::get_id()});
+			return *connection;
+		}
+
+		void release(Connection& connection) {
+			{
+				const std::unique_lock lock(_lock);
+				const auto it = std::find_if(_holders.begin(), _holders.end(), [&](const Holder& h) { return h.connection == &connection; });
+				y_debug_assert(it != _holders.end());
+				_holders.erase_unordered(it);
+				_idle << &connection;
+			}
+			_released.notify_one();
+		}
+
+	private:
+		bool held_by_this_thread() const {
+			const auto thread = std::this_thread::get_id();
+			return std::any_of(_holders.begin(), _holders.end(), [&](const Holder& h) { return h.thread == thread; });
+		}
+
+		core::String _path;
+
+		std::mutex _lock;
+		std::condition_variable _released;
+		core::Vector<std::unique_ptr<Connection>> _connections;
+		core::Vector<Connection*> _idle;
+		core::Vector<Holder> _holders;
+};
+
+// Cached statement with exclusive access to its connection, reset and unbound on destruction
+// lock can be empty if the caller already has exclusive access (in a Transaction for example)
+class Statement : NonCopyable {
+	public:
+		Statement(Connection& connection, const char* sql, std::unique_lock<std::mutex> lock = {}) :
+				_lock(std::move(lock)),
+				_connection(&connection),
+				_stmt(connection.cached_statement(sql)) {
+		}
+
+		// Takes a connection from the pool and gives it back on destruction
+		Statement(ReadConnectionPool& pool, const char* sql) :
+				_pool(&pool),
+				_connection(&pool.acquire()),
+				_stmt(_connection->cached_statement(sql)) {
+		}
+
+		Statement(Statement&& other) : _lock(std::move(other._lock)), _pool(other._pool), _connection(other._connection), _stmt(other._stmt) {
+			other._pool = nullptr;
+			other._stmt = nullptr;
+		}
+
+		~Statement() {
+			if(_stmt) {
+				sqlite3_reset(_stmt);
+				sqlite3_clear_bindings(_stmt);
+			}
+			if(_pool) {
+				_pool->release(*_connection);
+			}
+		}
+
+		operator sqlite3_stmt*() const {
+			return _stmt;
+		}
+
+		void check(int res) const {
+			_connection->check(res);
+		}
+
+	private:
+		std::unique_lock<std::mutex> _lock;
+		ReadConnectionPool* _pool = nullptr;
+		Connection* _connection = nullptr;
+		sqlite3_stmt* _stmt = nullptr;
+};
+
+// Locks the connection and rolls back unless commit() succeeded
+class Transaction : NonMovable {
+	public:
+		Transaction(Connection& connection) : _lock(connection.mutex()), _connection(connection) {
+			_connection.check(_connection.exec("BEGIN TRANSACTION"));
+		}
+
+		~Transaction() {
+			if(!_committed) {
+				_connection.exec("ROLLBACK");
+			}
+		}
+
+		bool commit() {
+			y_debug_assert(!_committed);
+			return _committed = is_ok(_connection.exec("COMMIT"));
+		}
+
+		Statement statement(const char* sql) {
+			return Statement(_connection, sql);
+		}
+
+		Connection& connection() {
+			return _connection;
+		}
+
+	private:
+		std::unique_lock<std::mutex> _lock;
+		Connection& _connection;
+		bool _committed = false;
+};
+
+// Reads the blob lazily, small reads go through a chunk buffer.
+// The blob keeps a read transaction open (which prevents WAL checkpoints) and holds a pooled connection:
+// both are released as soon as the whole blob has been read, and reopened if the reader seeks back.
+class SQLiteBlobReader final : public io2::Reader {
+	public:
+		SQLiteBlobReader(ReadConnectionPool& pool, Connection& connection, sqlite3_blob* blob, i64 row) :
+				_pool(pool),
+				_connection(&connection),
+				_blob(blob),
+				_row(row),
+				_size(sqlite3_blob_bytes(blob)) {
+			release_if_done();
+		}
+
+		~SQLiteBlobReader() override {
+			release();
+		}
+
+		bool at_end() const override {
+			return !remaining();
+		}
+
+		usize remaining() const override {
+			return _size - _cursor;
+		}
+
+		void seek(usize byte) override {
+			y_debug_assert(byte <= _size);
+			_cursor = byte;
+		}
+
+		usize tell() const override {
+			return _cursor;
+		}
+
+		io2::ReadResult read(void* data, usize bytes) override {
+			if(remaining() < bytes) {
+				return core::Err<usize>(0);
+			}
+			if(!read_blob(static_cast<u8*>(data), bytes)) {
+				return core::Err<usize>(0);
+			}
+			return core::Ok();
+		}
+
+		io2::ReadUpToResult read_up_to(void* data, usize max_bytes) override {
+			const usize max = std::min(max_bytes, remaining());
+			if(!read_blob(static_cast<u8*>(data), max)) {
+				return core::Err<usize>(0);
+			}
+			return core::Ok(max);
+		}
+
+		io2::ReadUpToResult read_all(core::Vector<u8>& data) override {
+			const usize r = remaining();
+			data.set_min_capacity(data.size() + r);
+			while(!at_end()) {
+				if(!fill_chunk()) {
+					return core::Err<usize>(r - remaining());
+				}
+				const u8* begin = _chunk.data() + (_cursor - _chunk_begin);
+				const u8* end = _chunk.data() + _chunk_size;
+				data.push_back(begin, end);
+				_cursor += end - begin;
+			}
+			release_if_done();
+			return core::Ok(r);
+		}
+
+	private:
+		bool read_blob(u8* data, usize bytes) {
+			y_debug_assert(_cursor + bytes <= _size);
+
+			if(bytes >= blob_chunk_size) {
+				if(!reopen() || !is_ok(sqlite3_blob_read(_blob, data, int(bytes), int(_cursor)))) {
+					return false;
+				}
+				_cursor += bytes;
+				release_if_done();
+				return true;
+			}
+
+			while(bytes) {
+				if(!fill_chunk()) {
+					return false;
+				}
+				const usize offset = _cursor - _chunk_begin;
+				const usize size = std::min(bytes, _chunk_size - offset);
+				std::copy_n(_chunk.data() + offset, size, data);
+				data += size;
+				bytes -= size;
+				_cursor += size;
+			}
+			release_if_done();
+			return true;
+		}
+
+		// Makes sure _cursor is inside the chunk
+		bool fill_chunk() {
+			if(_cursor >= _chunk_begin && _cursor < _chunk_begin + _chunk_size) {
+				return true;
+			}
+
+			if(!_chunk.size()) {
+				_chunk = core::FixedArray<u8>(std::min(blob_chunk_size, _size));
+			}
+
+			const usize size = std::min(_chunk.size(), remaining());
+			if(!reopen() || !is_ok(sqlite3_blob_read(_blob, _chunk.data(), int(size), int(_cursor)))) {
+				_chunk_size = 0;
+				return false;
+			}
+
+			_chunk_begin = _cursor;
+			_chunk_size = size;
+			return true;
+		}
+
+		// Fails if the asset has been removed or resized since the reader was created
+		bool reopen() {
+			if(_blob) {
+				return true;
+			}
+
+			_connection = &_pool.acquire();
+			if(!is_ok(sqlite3_blob_open(_connection->handle(), "main", "Assets", "data", _row, 0, &_blob)) || usize(sqlite3_blob_bytes(_blob)) != _size) {
+				release();
+				return false;
+			}
+			return true;
+		}
+
+		void release_if_done() {
+			if(at_end()) {
+				release();
+			}
+		}
+
+		void release() {
+			if(_connection) {
+				sqlite3_blob_close(_blob);
+				_pool.release(*_connection);
+				_connection = nullptr;
+				_blob = nullptr;
+			}
+		}
+
+		ReadConnectionPool& _pool;
+		Connection* _connection = nullptr;
+		sqlite3_blob* _blob = nullptr;
+		i64 _row = 0;
+
+		usize _size = 0;
+		usize _cursor = 0;
+
+		core::FixedArray<u8> _chunk;
+		usize _chunk_begin = 0;
+		usize _chunk_size = 0;
+};
+}
+
+
+class SQLiteAssetStore::Database : NonMovable {
+	public:
+		Database(const core::String& path) : _write(path, false), _read(path) {
+		}
+
+		ReadConnectionPool& read_connections() {
+			return _read;
+		}
+
+		Connection& write_connection() {
+			return _write;
+		}
+
+		Statement write(const char* sql) {
+			return Statement(_write, sql, std::unique_lock(_write.mutex()));
+		}
+
+		int exec(const char* sql) {
+			const std::unique_lock lock(_write.mutex());
+			return _write.exec(sql);
+		}
+
+		// Reads don't block each other or the writer thanks to WAL
+		Statement read(const char* sql) {
+			return Statement(_read, sql);
+		}
+
+	private:
+		Connection _write;
+		ReadConnectionPool _read;
+};
+
 template<auto F = sqlite3_column_text>
 static auto rows(sqlite3_stmt* stmt, int col = 0) {
 	class RowIterator {
@@ -101,13 +503,6 @@ static auto rows(sqlite3_stmt* stmt, int col = 0) {
 }
 
 
-void SQLiteAssetStore::SQLiteFileSystemModel::check(int res) const {
-	if(res != SQLITE_OK) {
-		// We might leak memory here, but we don't care
-		y_fatal(_database ? sqlite3_errmsg(_database) : "Unknown SQLite error.");
-	}
-}
-
 bool SQLiteAssetStore::SQLiteFileSystemModel::is_delimiter(char c) const {
 	return c == '\\' || c == '/';
 }
@@ -155,11 +550,9 @@ FileSystemModel::Result<bool> SQLiteAssetStore::SQLiteFileSystemModel::exists(st
 
 	const bool has_delim = !path.empty() && is_delimiter(path.back());
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT 1 FROM Assets WHERE name = ? UNION SELECT 1 FROM Folders WHERE name = ?", -1, &stmt, nullptr));
-	check(sqlite3_bind_text(stmt, 1, path.data(), path.size(), nullptr));
-	check(sqlite3_bind_text(stmt, 2, path.data(), path.size() - has_delim, nullptr));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->read("SELECT 1 FROM Assets WHERE name = ? UNION SELECT 1 FROM Folders WHERE name = ?");
+	stmt.check(sqlite3_bind_text(stmt, 1, path.data(), path.size(), nullptr));
+	stmt.check(sqlite3_bind_text(stmt, 2, path.data(), path.size() - has_delim, nullptr));
 
 	return core::Ok(is_row(step_db(stmt)));
 }
@@ -169,10 +562,8 @@ FileSystemModel::Result<bool> SQLiteAssetStore::SQLiteFileSystemModel::is_direct
 
 	const bool has_delim = !path.empty() && is_delimiter(path.back());
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT 1 FROM Folders WHERE name = ?", -1, &stmt, nullptr));
-	check(sqlite3_bind_text(stmt, 1, path.data(), path.size() - has_delim, nullptr));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->read("SELECT 1 FROM Folders WHERE name = ?");
+	stmt.check(sqlite3_bind_text(stmt, 1, path.data(), path.size() - has_delim, nullptr));
 
 	return core::Ok(is_row(step_db(stmt)));
 }
@@ -189,11 +580,9 @@ FileSystemModel::Result<> SQLiteAssetStore::SQLiteFileSystemModel::for_each(std:
 	y_try(fid);
 
 	{
-		sqlite3_stmt* stmt = nullptr;
-		check(sqlite3_prepare_v2(_database, "SELECT name FROM (SELECT name FROM Assets WHERE folderid = ? UNION SELECT name FROM Folders WHERE parentid = ?)", -1, &stmt, nullptr));
-		check(sqlite3_bind_int64(stmt, 1, fid.unwrap()));
-		check(sqlite3_bind_int64(stmt, 2, fid.unwrap()));
-		y_defer(sqlite3_finalize(stmt));
+		const Statement stmt = _database->read("SELECT name FROM (SELECT name FROM Assets WHERE folderid = ? UNION SELECT name FROM Folders WHERE parentid = ?)");
+		stmt.check(sqlite3_bind_int64(stmt, 1, fid.unwrap()));
+		stmt.check(sqlite3_bind_int64(stmt, 2, fid.unwrap()));
 
 		for(auto row : rows(stmt)) {
 			std::string_view name = reinterpret_cast<const char*>(row);
@@ -220,11 +609,9 @@ FileSystemModel::Result<> SQLiteAssetStore::SQLiteFileSystemModel::create_direct
 	{
 		const bool has_delim = !path.empty() && is_delimiter(path.back());
 
-		sqlite3_stmt* stmt = nullptr;
-		check(sqlite3_prepare_v2(_database, "INSERT INTO Folders(name, folderid, parentid) VALUES(?, (SELECT MAX(folderid) FROM Folders) + 1, ?)", -1, &stmt, nullptr));
-		check(sqlite3_bind_text(stmt, 1, path.data(), path.size() - has_delim, nullptr));
-		check(sqlite3_bind_int64(stmt, 2, fid.unwrap()));
-		y_defer(sqlite3_finalize(stmt));
+		const Statement stmt = _database->write("INSERT INTO Folders(name, folderid, parentid) VALUES(?, (SELECT MAX(folderid) FROM Folders) + 1, ?)");
+		stmt.check(sqlite3_bind_text(stmt, 1, path.data(), path.size() - has_delim, nullptr));
+		stmt.check(sqlite3_bind_int64(stmt, 2, fid.unwrap()));
 
 		if(!is_done(step_db(stmt))) {
 			return core::Err();
@@ -258,7 +645,7 @@ FileSystemModel::Result<> SQLiteAssetStore::SQLiteFileSystemModel::remove(std::s
 			no_delim, '%'
 		);
 
-		if(!is_ok(sqlite3_exec(_database, transaction.data(), nullptr, nullptr, nullptr))) {
+		if(!is_ok(_database->exec(transaction.data()))) {
 			return core::Err();
 		}
 	}
@@ -296,16 +683,14 @@ FileSystemModel::Result<> SQLiteAssetStore::SQLiteFileSystemModel::rename(std::s
 			to, from.size() + 1, from_path_wildcard
 		);
 
-		if(!is_ok(sqlite3_exec(_database, transaction.data(), nullptr, nullptr, nullptr))) {
+		if(!is_ok(_database->exec(transaction.data()))) {
 			return core::Err();
 		}
 	} else {
-		sqlite3_stmt* stmt = nullptr;
-		check(sqlite3_prepare_v2(_database, "UPDATE Assets SET name = ?, folderid = ? WHERE name = ?", -1, &stmt, nullptr));
-		check(sqlite3_bind_text(stmt, 1, to.data(), to.size(), nullptr));
-		check(sqlite3_bind_int64(stmt, 2, fid.unwrap()));
-		check(sqlite3_bind_text(stmt, 3, from.data(), from.size(), nullptr));
-		y_defer(sqlite3_finalize(stmt));
+		const Statement stmt = _database->write("UPDATE Assets SET name = ?, folderid = ? WHERE name = ?");
+		stmt.check(sqlite3_bind_text(stmt, 1, to.data(), to.size(), nullptr));
+		stmt.check(sqlite3_bind_int64(stmt, 2, fid.unwrap()));
+		stmt.check(sqlite3_bind_text(stmt, 3, from.data(), from.size(), nullptr));
 
 		if(!is_done(step_db(stmt))) {
 			return core::Err();
@@ -320,11 +705,9 @@ FileSystemModel::Result<core::Vector<core::String>> SQLiteAssetStore::SQLiteFile
 
 	core::Vector<core::String> results;
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT name FROM (SELECT name FROM Folders WHERE UPPER(name) LIKE UPPER(?) UNION SELECT name FROM Assets WHERE name LIKE ? COLLATE NOCASE)", -1, &stmt, nullptr));
-	check(sqlite3_bind_text(stmt, 1, pattern.data(), pattern.size(), nullptr));
-	check(sqlite3_bind_text(stmt, 2, pattern.data(), pattern.size(), nullptr));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->read("SELECT name FROM (SELECT name FROM Folders WHERE UPPER(name) LIKE UPPER(?) UNION SELECT name FROM Assets WHERE name LIKE ? COLLATE NOCASE)");
+	stmt.check(sqlite3_bind_text(stmt, 1, pattern.data(), pattern.size(), nullptr));
+	stmt.check(sqlite3_bind_text(stmt, 2, pattern.data(), pattern.size(), nullptr));
 
 	for(auto row : rows(stmt)) {
 		std::string_view name = reinterpret_cast<const char*>(row);
@@ -344,10 +727,8 @@ FileSystemModel::Result<i64> SQLiteAssetStore::SQLiteFileSystemModel::folder_id(
 	}
 
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT folderid FROM Folders WHERE name = ?", -1, &stmt, nullptr));
-	check(sqlite3_bind_text(stmt, 1, path.data(), path.size() - has_delim, nullptr));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->read("SELECT folderid FROM Folders WHERE name = ?");
+	stmt.check(sqlite3_bind_text(stmt, 1, path.data(), path.size() - has_delim, nullptr));
 
 	if(!is_row(step_db(stmt))) {
 		return core::Err();
@@ -359,35 +740,24 @@ FileSystemModel::Result<i64> SQLiteAssetStore::SQLiteFileSystemModel::folder_id(
 }
 
 
-
-void SQLiteAssetStore::check(int res) const {
-	if(res != SQLITE_OK) {
-		// We might leak memory here, but we don't care
-		y_fatal(_database ? sqlite3_errmsg(_database) : "Unknown SQLite error.");
-	}
-}
-
-SQLiteAssetStore::SQLiteAssetStore(const core::String& path) {
+SQLiteAssetStore::SQLiteAssetStore(const core::String& path) : _database(std::make_unique<Database>(path)) {
 	y_profile();
 
-	check(sqlite3_open(path.data(), &_database));
-	_filesystem._database = _database;
+	_filesystem._database = _database.get();
 
-	log_msg(fmt("Max BLOB length = % bytes", sqlite3_limit(_database, SQLITE_LIMIT_LENGTH, -1)));
+	Connection& connection = _database->write_connection();
+
+	log_msg(fmt("Max BLOB length = % bytes", sqlite3_limit(connection.handle(), SQLITE_LIMIT_LENGTH, -1)));
 
 	{
-		sqlite3_stmt* stmt = nullptr;
-		check(sqlite3_prepare_v2(_database, "SELECT name FROM sqlite_master WHERE type = 'table'", -1, &stmt, nullptr));
-		y_defer(sqlite3_finalize(stmt));
+		const Statement stmt = _database->write("SELECT name FROM sqlite_master WHERE type = 'table'");
 
 		for(auto name : rows(stmt)) {
 			log_msg(fmt("Found: TABLE %", reinterpret_cast<const char*>(name)), Log::Debug);
 		}
 	}
 	{
-		sqlite3_stmt* stmt = nullptr;
-		check(sqlite3_prepare_v2(_database, "SELECT name FROM sqlite_master WHERE type = 'index'", -1, &stmt, nullptr));
-		y_defer(sqlite3_finalize(stmt));
+		const Statement stmt = _database->write("SELECT name FROM sqlite_master WHERE type = 'index'");
 
 		for(auto name : rows(stmt)) {
 			log_msg(fmt("Found: INDEX %", reinterpret_cast<const char*>(name)), Log::Debug);
@@ -397,65 +767,53 @@ SQLiteAssetStore::SQLiteAssetStore(const core::String& path) {
 	// Set pragmas
 	{
 		// Dangerous!!
-		check(sqlite3_exec(_database, "PRAGMA synchronous = OFF", nullptr, nullptr, nullptr)); // unsafe if the OS crashes
-
-		check(sqlite3_exec(_database, "PRAGMA page_size = 65536", nullptr, nullptr, nullptr));
-		check(sqlite3_exec(_database, "PRAGMA temp_store = MEMORY", nullptr, nullptr, nullptr));
-		check(sqlite3_exec(_database, "PRAGMA foreign_keys = ON", nullptr, nullptr, nullptr));
-		check(sqlite3_exec(_database, "PRAGMA case_sensitive_like = ON", nullptr, nullptr, nullptr));
-		check(sqlite3_exec(_database, "PRAGMA auto_vacuum = INCREMENTAL;", nullptr, nullptr, nullptr));
+		connection.check(connection.exec("PRAGMA synchronous = OFF")); // unsafe if the OS crashes
+
+		connection.check(connection.exec("PRAGMA page_size = 65536"));
+		// Readers don't block the writer and each other
+		connection.check(connection.exec("PRAGMA journal_mode = WAL"));
+		connection.check(connection.exec("PRAGMA temp_store = MEMORY"));
+		connection.check(connection.exec("PRAGMA foreign_keys = ON"));
+		connection.check(connection.exec("PRAGMA case_sensitive_like = ON"));
+		connection.check(connection.exec("PRAGMA auto_vacuum = INCREMENTAL;"));
 	}
 
 	// Create tables & indexes
 	{
-		check(sqlite3_exec(_database, "CREATE TABLE IF NOT EXISTS Folders (name TEXT    PRIMARY KEY, folderid INTEGER UNIQUE, parentid INTEGER,"
-											"FOREIGN KEY(parentid) REFERENCES Folders(folderid) ON DELETE CASCADE)", nullptr, nullptr, nullptr));
-		check(sqlite3_exec(_database, "CREATE TABLE IF NOT EXISTS Assets  (uid  INTEGER PRIMARY KEY, name TEXT UNIQUE, folderid INTEGER, type INTEGER, data BLOB,"
-											"FOREIGN KEY(folderid) REFERENCES Folders(folderid) ON DELETE CASCADE)", nullptr, nullptr, nullptr));
+		connection.check(connection.exec("CREATE TABLE IF NOT EXISTS Folders (name TEXT    PRIMARY KEY, folderid INTEGER UNIQUE, parentid INTEGER,"
+											"FOREIGN KEY(parentid) REFERENCES Folders(folderid) ON DELETE CASCADE)"));
+		connection.check(connection.exec("CREATE TABLE IF NOT EXISTS Assets  (uid  INTEGER PRIMARY KEY, name TEXT UNIQUE, folderid INTEGER, type INTEGER, data BLOB,"
+											"FOREIGN KEY(folderid) REFERENCES Folders(folderid) ON DELETE CASCADE)"));
 
-		/*check(sqlite3_exec(_database, "CREATE TABLE IF NOT EXISTS NextID (nextid INTEGER)", nullptr, nullptr, nullptr));
-		check(sqlite3_exec(_database, "INSERT INTO NextID(nextid) SELECT (SELECT MAX(uid) + 1 FROM Assets) WHERE NOT EXISTS (SELECT 1 FROM NextID)", nullptr, nullptr, nullptr));*/
+		/*connection.check(connection.exec("CREATE TABLE IF NOT EXISTS NextID (nextid INTEGER)"));
+		connection.check(connection.exec("INSERT INTO NextID(nextid) SELECT (SELECT MAX(uid) + 1 FROM Assets) WHERE NOT EXISTS (SELECT 1 FROM NextID)"));*/
 
-		check(sqlite3_exec(_database, "CREATE INDEX IF NOT EXISTS assetidindex ON Assets(uid)", nullptr, nullptr, nullptr));
+		connection.check(connection.exec("CREATE INDEX IF NOT EXISTS assetidindex ON Assets(uid)"));
 
 	}
 
 	// Create triggers
 	{
-		check(sqlite3_exec(_database, "DROP TRIGGER IF EXISTS renameassetstrigger", nullptr, nullptr, nullptr));
-		check(sqlite3_exec(_database, "DROP TRIGGER IF EXISTS renamefolderstrigger", nullptr, nullptr, nullptr));
+		connection.check(connection.exec("DROP TRIGGER IF EXISTS renameassetstrigger"));
+		connection.check(connection.exec("DROP TRIGGER IF EXISTS renamefolderstrigger"));
 
-		check(sqlite3_exec(_database, "CREATE TRIGGER renameassetstrigger AFTER UPDATE ON Folders "
+		connection.check(connection.exec("CREATE TRIGGER renameassetstrigger AFTER UPDATE ON Folders "
 											"BEGIN UPDATE Assets SET name = NEW.name || SUBSTR(name, LENGTH(OLD.name) + 1) "
-											"WHERE SUBSTR(name, 0, LENGTH(OLD.name) + 1) LIKE OLD.name; END", nullptr, nullptr, nullptr));
-		check(sqlite3_exec(_database, "CREATE TRIGGER renamefolderstrigger AFTER UPDATE ON Folders "
+											"WHERE SUBSTR(name, 0, LENGTH(OLD.name) + 1) LIKE OLD.name; END"));
+		connection.check(connection.exec("CREATE TRIGGER renamefolderstrigger AFTER UPDATE ON Folders "
 											"BEGIN UPDATE Folders SET name = NEW.name || SUBSTR(name, LENGTH(OLD.name) + 1) "
-											"WHERE SUBSTR(name, 0, LENGTH(OLD.name) + 1) LIKE OLD.name AND folderid <> NEW.folderid; END", nullptr, nullptr, nullptr));
+											"WHERE SUBSTR(name, 0, LENGTH(OLD.name) + 1) LIKE OLD.name AND folderid <> NEW.folderid; END"));
 	}
 
 
 	// Create root folder
-	check(sqlite3_exec(_database, "INSERT INTO Folders(name, folderid) SELECT '', 0 "
-										"WHERE NOT EXISTS(SELECT 1 FROM Folders WHERE folderid = 0);", nullptr, nullptr, nullptr));
+	connection.check(connection.exec("INSERT INTO Folders(name, folderid) SELECT '', 0 "
+										"WHERE NOT EXISTS(SELECT 1 FROM Folders WHERE folderid = 0);"));
 
 }
 
 SQLiteAssetStore::~SQLiteAssetStore() {
 	y_profile();
-
-	/*u32 timeout = 8;
-	while(sqlite3_next_stmt(_database, nullptr)) {
-		log_msg("Waiting for DB to finish.");
-		std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
-		timeout = std::min(timeout * 2, u32(1024));
-	}*/
-
-	while(sqlite3_stmt* stmt = sqlite3_next_stmt(_database, nullptr)) {
-		log_msg(fmt("Database has pending statements (busy: %).", !!sqlite3_stmt_busy(stmt)), Log::Warning);
-		sqlite3_finalize(stmt);
-	}
-
-	check(sqlite3_close(_database));
 }
 
 const FileSystemModel* SQLiteAssetStore::filesystem() const {
@@ -493,19 +851,21 @@ AssetStore::Result<AssetId> SQLiteAssetStore::import(io2::Reader& data, std::str
 	// this is not thread safe
 	AssetId id = next_id();
 
+	bool inserted = false;
 	{
-		sqlite3_stmt* stmt = nullptr;
-		check(sqlite3_prepare_v2(_database, "INSERT INTO Assets(name, uid, folderid, type) VALUES(?, ?, ?, ?)", -1, &stmt, nullptr));
-		check(sqlite3_bind_text(stmt, 1, dst_name.data(), dst_name.size(), nullptr));
-		check(sqlite3_bind_int64(stmt, 2, id.id()));
-		check(sqlite3_bind_int64(stmt, 3, folder_id.unwrap()));
-		check(sqlite3_bind_int(stmt, 4, int(type)));
-		y_defer(sqlite3_finalize(stmt));
+		const Statement stmt = _database->write("INSERT INTO Assets(name, uid, folderid, type) VALUES(?, ?, ?, ?)");
+		stmt.check(sqlite3_bind_text(stmt, 1, dst_name.data(), dst_name.size(), nullptr));
+		stmt.check(sqlite3_bind_int64(stmt, 2, id.id()));
+		stmt.check(sqlite3_bind_int64(stmt, 3, folder_id.unwrap()));
+		stmt.check(sqlite3_bind_int(stmt, 4, int(type)));
 
-		if(!is_done(step_db(stmt))) {
-			remove(id).ignore();
-			return core::Err(ErrorType::Unknown);
-		}
+		inserted = is_done(step_db(stmt));
+	}
+
+	// remove needs the write connection, which stmt was holding
+	if(!inserted) {
+		remove(id).ignore();
+		return core::Err(ErrorType::Unknown);
 	}
 
 	if(const auto w = write(id, data); !w) {
@@ -519,32 +879,58 @@ AssetStore::Result<AssetId> SQLiteAssetStore::import(io2::Reader& data, std::str
 AssetStore::Result<> SQLiteAssetStore::write(AssetId id, io2::Reader& data) {
 	y_profile();
 
-	core::Vector<u8> buffer;
-	if(!data.read_all(buffer) || buffer.size() > usize(std::numeric_limits<int>::max())) {
+	const usize size = data.remaining();
+	if(size > usize(std::numeric_limits<int>::max())) {
 		return core::Err(ErrorType::FilesytemError);
 	}
 
+	Transaction transaction(_database->write_connection());
+
 	{
-		sqlite3_stmt* stmt = nullptr;
-		check(sqlite3_prepare_v2(_database, "UPDATE Assets SET data = ? WHERE uid = ?", -1, &stmt, nullptr));
-		check(sqlite3_bind_blob(stmt, 1, buffer.data(), buffer.size(), nullptr));
-		check(sqlite3_bind_int64(stmt, 2, id.id()));
-		y_defer(sqlite3_finalize(stmt));
+		const Statement stmt = transaction.statement("UPDATE Assets SET data = zeroblob(?) WHERE uid = ?");
+		stmt.check(sqlite3_bind_int64(stmt, 1, i64(size)));
+		stmt.check(sqlite3_bind_int64(stmt, 2, id.id()));
 
 		if(!is_done(step_db(stmt))) {
 			return core::Err(ErrorType::UnknownID);
 		}
 	}
+
+	{
+		sqlite3_blob* blob = nullptr;
+		y_defer(sqlite3_blob_close(blob));
+
+		if(!is_ok(sqlite3_blob_open(transaction.connection().handle(), "main", "Assets", "data", i64(id.id()), 1, &blob))) {
+			return core::Err(ErrorType::UnknownID);
+		}
+
+		core::FixedArray<u8> buffer(std::min(size, blob_chunk_size));
+		for(usize offset = 0; offset != size;) {
+			const auto r = data.read_up_to(buffer.data(), std::min(buffer.size(), size - offset));
+			if(!r || !r.unwrap()) {
+				return core::Err(ErrorType::FilesytemError);
+			}
+
+			const usize read = r.unwrap();
+			if(!is_ok(sqlite3_blob_write(blob, buffer.data(), int(read), int(offset)))) {
+				return core::Err(ErrorType::Unknown);
+			}
+			offset += read;
+		}
+	}
+
+	if(!transaction.commit()) {
+		return core::Err(ErrorType::Unknown);
+	}
+
 	return core::Ok();
 }
 
 AssetStore::Result<AssetId> SQLiteAssetStore::id(std::string_view name) const {
 	y_profile();
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT uid FROM Assets WHERE name = ?", -1, &stmt, nullptr));
-	check(sqlite3_bind_text(stmt, 1, name.data(), name.size(), nullptr));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->read("SELECT uid FROM Assets WHERE name = ?");
+	stmt.check(sqlite3_bind_text(stmt, 1, name.data(), name.size(), nullptr));
 
 	if(!is_row(step_db(stmt))) {
 		return core::Err(ErrorType::UnknownID);
@@ -556,10 +942,8 @@ AssetStore::Result<AssetId> SQLiteAssetStore::id(std::string_view name) const {
 AssetStore::Result<core::String> SQLiteAssetStore::name(AssetId id) const {
 	y_profile();
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT name FROM Assets WHERE uid = ?", -1, &stmt, nullptr));
-	check(sqlite3_bind_int64(stmt, 1, i64(id.id())));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->read("SELECT name FROM Assets WHERE uid = ?");
+	stmt.check(sqlite3_bind_int64(stmt, 1, i64(id.id())));
 
 	if(!is_row(step_db(stmt))) {
 		return core::Err(ErrorType::UnknownID);
@@ -570,90 +954,28 @@ AssetStore::Result<core::String> SQLiteAssetStore::name(AssetId id) const {
 }
 
 
-class SQLiteBuffer final : public io2::Reader {
-	public:
-		SQLiteBuffer(sqlite3_stmt* stmt) :
-				_stmt(stmt),
-				_buffer(static_cast<const u8*>(sqlite3_column_blob(stmt, 0))),
-				_size(sqlite3_column_bytes(stmt, 0)) {
-		}
-
-		~SQLiteBuffer() override {
-			sqlite3_finalize(_stmt);
-		}
-
-		bool at_end() const override {
-			return !remaining();
-		}
-
-		usize remaining() const override {
-			return _size - _cursor;
-		}
-
-		void seek(usize byte) override {
-			y_debug_assert(byte <= _size);
-			_cursor = byte;
-		}
-
-		usize tell() const override {
-			return _cursor;
-		}
-
-		io2::ReadResult read(void* data, usize bytes) override {
-			if(remaining() < bytes) {
-				return core::Err<usize>(0);
-			}
-			std::copy_n(&_buffer[_cursor], bytes, static_cast<u8*>(data));
-			_cursor += bytes;
-			return core::Ok();
-		}
-
-		io2::ReadUpToResult read_up_to(void* data, usize max_bytes) override {
-			const usize max = std::min(max_bytes, remaining());
-			y_debug_assert(_cursor < _size || !max);
-			std::copy_n(&_buffer[_cursor], max, static_cast<u8*>(data));
-			_cursor += max;
-			y_debug_assert(_cursor < _size);
-			return core::Ok(max);
-		}
-
-		io2::ReadUpToResult read_all(core::Vector<u8>& data) override {
-			const usize r = _size - _cursor;
-			data.push_back(_buffer + _cursor, _buffer + _size);
-			_cursor = _size;
-			return core::Ok(r);
-		}
-
-	private:
-		sqlite3_stmt* _stmt = nullptr;
-		const u8* _buffer = nullptr;
-		usize _size = 0;
-		usize _cursor = 0;
-};
-
-
 AssetStore::Result<io2::ReaderPtr> SQLiteAssetStore::data(AssetId id) const {
 	y_profile();
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT data FROM Assets WHERE uid = ?", -1, &stmt, nullptr));
-	check(sqlite3_bind_int64(stmt, 1, i64(id.id())));
+	ReadConnectionPool& pool = _database->read_connections();
+	Connection& connection = pool.acquire();
 
-	if(!is_row(step_db(stmt))) {
+	// uid is the rowid
+	const i64 row = i64(id.id());
+	sqlite3_blob* blob = nullptr;
+	if(!is_ok(sqlite3_blob_open(connection.handle(), "main", "Assets", "data", row, 0, &blob))) {
+		pool.release(connection);
 		return core::Err(ErrorType::UnknownID);
 	}
 
-	auto buffer = std::make_unique<SQLiteBuffer>(stmt);
-	return core::Ok(io2::ReaderPtr(std::move(buffer)));
+	return core::Ok(io2::ReaderPtr(std::make_unique<SQLiteBlobReader>(pool, connection, blob, row)));
 }
 
 AssetStore::Result<> SQLiteAssetStore::remove(AssetId id) {
 	y_profile();
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "DELETE FROM Assets WHERE uid = ?", -1, &stmt, nullptr));
-	check(sqlite3_bind_int64(stmt, 1, i64(id.id())));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->write("DELETE FROM Assets WHERE uid = ?");
+	stmt.check(sqlite3_bind_int64(stmt, 1, i64(id.id())));
 
 	if(!is_done(step_db(stmt))) {
 		return core::Err(ErrorType::UnknownID);
@@ -694,10 +1016,8 @@ AssetStore::Result<> SQLiteAssetStore::rename(std::string_view from, std::string
 AssetStore::Result<AssetType> SQLiteAssetStore::asset_type(AssetId id) const {
 	y_profile();
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT type FROM Assets WHERE uid = ?", -1, &stmt, nullptr));
-	check(sqlite3_bind_int64(stmt, 1, i64(id.id())));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->read("SELECT type FROM Assets WHERE uid = ?");
+	stmt.check(sqlite3_bind_int64(stmt, 1, i64(id.id())));
 
 	if(!is_row(step_db(stmt))) {
 		return core::Err(ErrorType::UnknownID);
@@ -712,9 +1032,7 @@ AssetId SQLiteAssetStore::next_id() {
 
 	Y_TODO(This can recycle ids!)
 
-	sqlite3_stmt* stmt = nullptr;
-	check(sqlite3_prepare_v2(_database, "SELECT MAX(uid) FROM Assets", -1, &stmt, nullptr));
-	y_defer(sqlite3_finalize(stmt));
+	const Statement stmt = _database->write("SELECT MAX(uid) FROM Assets");
 
 	const auto to_id = [](i64 id) { return AssetIdFactory::create(u64(id)).create_id(); };
 	if(!is_row(step_db(stmt))) {
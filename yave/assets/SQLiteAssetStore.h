@@ -30,12 +30,13 @@ SOFTWARE.
 
 #ifndef YAVE_NO_SQLITE
 
-struct sqlite3;
-
 namespace yave {
 
 class SQLiteAssetStore final : public AssetStore {
 
+	// One write connection and a pool of read only connections, each with its own statement cache
+	class Database;
+
 	class SQLiteFileSystemModel final : public SearchableFileSystemModel {
 		public:
 			core::String filename(std::string_view path) const override;
@@ -62,11 +63,9 @@ class SQLiteAssetStore final : public AssetStore {
 
 			SQLiteFileSystemModel() = default;
 
-			void check(int res) const;
-
 			Result<i64> folder_id(std::string_view path) const;
 
-			sqlite3* _database = nullptr;
+			Database* _database = nullptr;
 	};
 
 	public:
@@ -91,13 +90,11 @@ class SQLiteAssetStore final : public AssetStore {
 		Result<AssetType> asset_type(AssetId id) const override;
 
 	private:
-		void check(int res) const;
-
 		Result<i64> find_folder(std::string_view name, bool or_create = true);
 
 		AssetId next_id();
 
-		sqlite3* _database = nullptr;
+		std::unique_ptr<Database> _database;
 		SQLiteFileSystemModel _filesystem;
 
 };
@@ -56,7 +56,8 @@ void StaticMeshComponent::render_mesh(RenderPassRecorder& recorder, u32 instance
 		return;
 	}
 
-	recorder.bind_buffers(TriangleSubBuffer(_mesh->triangle_buffer()), VertexSubBuffer(_mesh->vertex_buffer()));
+	const MeshBuffers& buffers = _mesh->mesh_buffers();
+	recorder.bind_buffers(TriangleSubBuffer(buffers.triangles), VertexSubBuffer(buffers.vertices));
 	VkDrawIndexedIndirectCommand indirect = _mesh->indirect_data();
 	indirect.firstInstance = instance_index;
 	recorder.draw(indirect);
@@ -24,6 +24,7 @@ SOFTWARE.
 #include "PhysicalDevice.h"
 
 #include <yave/device/extentions/RayTracing.h>
+#include <yave/device/extentions/TimelineSemaphore.h>
 
 #include <y/concurrent/concurrent.h>
 
@@ -126,6 +127,11 @@ static VkDevice create_device(
 	try_enable_extension(extensions, VK_EXT_INLINE_UNIFORM_BLOCK_EXTENSION_NAME, physical);
 	try_enable_extension(extensions, RayTracing::extension_name(), physical);
 
+	const bool timeline_semaphore = TimelineSemaphore::is_supported(physical);
+	if(timeline_semaphore) {
+		extensions << TimelineSemaphore::extension_name();
+	}
+
 
 	VkPhysicalDeviceFeatures required = {};
 	{
@@ -159,6 +165,12 @@ static VkDevice create_device(
 		create_info.pEnabledFeatures = &required;
 	}
 
+	VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features = vk_struct();
+	if(timeline_semaphore) {
+		timeline_features.timelineSemaphore = true;
+		create_info.pNext = &timeline_features;
+	}
+
 	VkDevice device = {};
 	vk_check(vkCreateDevice(physical, &create_info, nullptr, &device));
 	return device;
@@ -204,11 +216,15 @@ Device::Device(Instance& instance) :
 		_queue_families(QueueFamily::all(_physical)),
 		_device{create_device(_physical.vk_physical_device(), _queue_families, _instance.debug_params())},
 		_properties(create_properties(_physical)),
+		_pipeline_cache(this),
 		_allocator(this),
 		_lifetime_manager(this),
 		_queues(create_queues(this, _queue_families)),
 		_samplers(create_samplers(this)),
-		_descriptor_set_allocator(this) {
+		_descriptor_set_allocator(this),
+		_mesh_allocator(this),
+		_upload_allocator(this),
+		_gpu_profiler(this) {
 
 	if(is_extension_supported(RayTracing::extension_name(), _physical.vk_physical_device())) {
 		_extensions.raytracing = std::make_unique<RayTracing>(this);
@@ -253,6 +269,14 @@ DescriptorSetAllocator& Device::descriptor_set_allocator() const {
 	return _descriptor_set_allocator;
 }
 
+MeshAllocator& Device::mesh_allocator() const {
+	return _mesh_allocator;
+}
+
+UploadAllocator& Device::upload_allocator() const {
+	return _upload_allocator;
+}
+
 const QueueFamily& Device::queue_family(VkQueueFlags flags) const {
 	for(const auto& q : _queue_families) {
 		if((q.flags() & flags) == flags) {
@@ -312,6 +336,14 @@ LifetimeManager& Device::lifetime_manager() const {
 	return _lifetime_manager;
 }
 
+PipelineCache& Device::pipeline_cache() const {
+	return _pipeline_cache;
+}
+
+GpuProfiler& Device::gpu_profiler() const {
+	return _gpu_profiler;
+}
+
 const DeviceProperties& Device::device_properties() const {
 	return _properties;
 }
@@ -337,6 +369,10 @@ CmdBuffer<CmdBufferUsage::Disposable> Device::create_disposable_cmd_buffer() con
 	return thread_device()->create_disposable_cmd_buffer();
 }
 
+CmdBuffer<CmdBufferUsage::Secondary> Device::create_secondary_cmd_buffer() const {
+	return thread_device()->create_secondary_cmd_buffer();
+}
+
 const DebugUtils* Device::debug_utils() const {
 	return _instance.debug_utils();
 }
@@ -29,12 +29,16 @@ SOFTWARE.
 #include "ThreadLocalDevice.h"
 #include "DeviceResources.h"
 #include "LifetimeManager.h"
+#include "PipelineCache.h"
 
 #include <yave/graphics/descriptors/DescriptorSetAllocator.h>
 
 #include <yave/graphics/images/Sampler.h>
 #include <yave/graphics/queues/QueueFamily.h>
 #include <yave/graphics/memory/DeviceMemoryAllocator.h>
+#include <yave/meshes/MeshAllocator.h>
+#include <yave/graphics/buffers/UploadAllocator.h>
+#include <yave/graphics/commands/GpuProfiler.h>
 
 #include <thread>
 
@@ -56,8 +60,11 @@ class Device : NonMovable {
 
 		DeviceMemoryAllocator& allocator() const;
 		DescriptorSetAllocator& descriptor_set_allocator() const;
+		MeshAllocator& mesh_allocator() const;
+		UploadAllocator& upload_allocator() const;
 
 		CmdBuffer<CmdBufferUsage::Disposable> create_disposable_cmd_buffer() const;
+		CmdBuffer<CmdBufferUsage::Secondary> create_secondary_cmd_buffer() const;
 
 		const QueueFamily& queue_family(VkQueueFlags flags) const;
 		const Queue& graphic_queue() const;
@@ -72,6 +79,8 @@ class Device : NonMovable {
 		const DeviceProperties& device_properties() const;
 
 		LifetimeManager& lifetime_manager() const;
+		PipelineCache& pipeline_cache() const;
+		GpuProfiler& gpu_profiler() const;
 
 		VkDevice vk_device() const;
 		const VkAllocationCallbacks* vk_allocation_callbacks() const;
@@ -112,6 +121,8 @@ class Device : NonMovable {
 		ScopedDevice _device;
 		DeviceProperties _properties;
 
+		mutable PipelineCache _pipeline_cache;
+
 		mutable DeviceMemoryAllocator _allocator;
 		mutable LifetimeManager _lifetime_manager;
 
@@ -120,6 +131,9 @@ class Device : NonMovable {
 		std::array<Sampler, 2> _samplers;
 
 		mutable DescriptorSetAllocator _descriptor_set_allocator;
+		mutable MeshAllocator _mesh_allocator;
+		mutable UploadAllocator _upload_allocator;
+		mutable GpuProfiler _gpu_profiler;
 
 		mutable concurrent::SpinLock _lock;
 		mutable core::Vector<std::unique_ptr<ThreadLocalDevice>> _thread_devices;
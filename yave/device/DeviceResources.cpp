@@ -29,8 +29,11 @@ SOFTWARE.
 #include <yave/meshes/MeshData.h>
 #include <yave/meshes/StaticMesh.h>
 #include <yave/graphics/images/IBLProbe.h>
+#include <yave/device/Device.h>
 
 #include <y/core/Chrono.h>
+#include <y/concurrent/concurrent.h>
+#include <y/concurrent/WorkStealingThreadPool.h>
 #include <y/io2/File.h>
 #include <y/utils/log.h>
 #include <y/utils/format.h>
@@ -186,6 +189,7 @@ DeviceResources& DeviceResources::operator=(DeviceResources&& other) {
 }
 
 DeviceResources::~DeviceResources() {
+	wait_for_precompile();
 }
 
 bool DeviceResources::is_init() const {
@@ -193,6 +197,9 @@ bool DeviceResources::is_init() const {
 }
 
 void DeviceResources::swap(DeviceResources& other) {
+	wait_for_precompile();
+	other.wait_for_precompile();
+
 	std::swap(_device, other._device);
 
 #ifdef Y_DEBUG
@@ -215,6 +222,7 @@ void DeviceResources::swap(DeviceResources& other) {
 	std::swap(other._probe, _probe);
 	std::swap(other._empty_probe, _empty_probe);
 	std::swap(other._brdf_lut, _brdf_lut);
+	std::swap(other._precompile, _precompile);
 }
 
 void DeviceResources::load_resources() {
@@ -302,6 +310,18 @@ const MaterialTemplate* DeviceResources::operator[](MaterialTemplates i) const {
 	return &_material_templates[usize(i)];
 }
 
+DeviceResources::MaterialTemplates DeviceResources::material_template_index(const MaterialTemplate* material) const {
+	if(!is_init()) {
+		return MaxMaterialTemplates;
+	}
+	for(usize i = 0; i != template_count; ++i) {
+		if(&_material_templates[i] == material) {
+			return MaterialTemplates(i);
+		}
+	}
+	return MaxMaterialTemplates;
+}
+
 const AssetPtr<Texture>& DeviceResources::operator[](Textures i) const {
 	y_debug_assert(is_init());
 	y_debug_assert(usize(i) < usize(MaxTextures));
@@ -337,6 +357,7 @@ const ComputeProgram& DeviceResources::program_from_file(std::string_view file)
 void DeviceResources::reload() {
 	y_debug_assert(is_init());
 	y_profile();
+	wait_for_precompile();
 	device()->wait_all_queues();
 
 #ifdef Y_DEBUG
@@ -348,4 +369,28 @@ void DeviceResources::reload() {
 	log_msg("Resources reloaded");
 }
 
+void DeviceResources::precompile_material_templates() {
+	y_debug_assert(is_init());
+	y_profile();
+
+	auto& thread_pool = concurrent::default_thread_pool();
+	for(const auto& l : device()->pipeline_cache().material_layouts()) {
+		if(l.material_template >= template_count) {
+			continue;
+		}
+
+		const MaterialTemplate* material = &_material_templates[l.material_template];
+		thread_pool.schedule([material, layout = l.layout] {
+			const RenderPass render_pass(material->device(), layout);
+			material->compile(render_pass);
+		}, &_precompile);
+	}
+}
+
+void DeviceResources::wait_for_precompile() const {
+	if(!_precompile.is_ready()) {
+		concurrent::default_thread_pool().wait_until_ready(_precompile);
+	}
+}
+
 }
@@ -31,6 +31,7 @@ SOFTWARE.
 
 #include <y/core/String.h>
 #include <y/core/HashMap.h>
+#include <y/concurrent/DependencyGroup.h>
 
 #include <y/utils/hash.h>
 
@@ -163,16 +164,23 @@ class DeviceResources final : NonCopyable {
 		const ComputeProgram& operator[](ComputePrograms i) const;
 		const MaterialTemplate* operator[](MaterialTemplates i) const;
 
+		// Returns MaxMaterialTemplates if the template isn't owned by these resources
+		MaterialTemplates material_template_index(const MaterialTemplate* material) const;
+
 		const AssetPtr<Texture>& operator[](Textures i) const;
 		const AssetPtr<Material>& operator[](Materials i) const;
 		const AssetPtr<StaticMesh>& operator[](Meshes i) const;
 
 		void reload();
 
+		// Compiles every material template for all the layouts recorded in the device pipeline cache, on the default thread pool
+		void precompile_material_templates();
+
 	private:
 		void swap(DeviceResources& other);
 
 		void load_resources();
+		void wait_for_precompile() const;
 
 		DevicePtr _device = nullptr;
 
@@ -188,6 +196,7 @@ class DeviceResources final : NonCopyable {
 		std::shared_ptr<IBLProbe> _empty_probe;
 		Texture _brdf_lut;
 
+		concurrent::DependencyGroup _precompile;
 
 #ifdef Y_DEBUG
 		std::unique_ptr<std::recursive_mutex> _lock;
@@ -37,23 +37,14 @@ SOFTWARE.
 namespace yave {
 
 LifetimeManager::LifetimeManager(DevicePtr dptr) : DeviceLinked(dptr) {
-#ifdef YAVE_ASYNC_RESOURCE_COLLECTION
+	if(TimelineSemaphore::is_supported(device()->vk_physical_device())) {
+		_timeline = std::make_unique<TimelineSemaphore>(dptr);
+	} else {
+		log_msg("VK_KHR_timeline_semaphore not supported, falling back to fence polling.", Log::Warning);
+	}
+
 	_run_async = true;
-	_collect_thread = std::make_unique<std::thread>([this] {
-		concurrent::set_thread_name("Resource collection thread");
-		std::mutex mutex;
-		while(_run_async) {
-			auto lock = y_profile_unique_lock(mutex);
-			const u32 ms = _collection_interval;
-			if(ms) {
-				_collect_condition.wait_for(lock, std::chrono::milliseconds(ms));
-			} else {
-				_collect_condition.wait(lock);
-			}
-			collect();
-		}
-	});
-#endif
+	_collect_thread = std::make_unique<std::thread>([this] { collection_thread(); });
 }
 
 LifetimeManager::~LifetimeManager() {
@@ -72,38 +63,68 @@ LifetimeManager::~LifetimeManager() {
 }
 
 void LifetimeManager::stop_async_collection() {
-#ifdef YAVE_ASYNC_RESOURCE_COLLECTION
 	if(is_async()) {
 		y_profile();
-		_run_async = false;
+		{
+			const auto lock = y_profile_unique_lock(_cmd_lock);
+			_run_async = false;
+		}
 		_collect_condition.notify_all();
 		_collect_thread->join();
 		_collect_thread = nullptr;
 	}
-#endif
 }
 
 bool LifetimeManager::is_async() const {
-#ifdef YAVE_ASYNC_RESOURCE_COLLECTION
 	return _run_async;
-#else
-	return false;
-#endif
 }
 
-void LifetimeManager::schedule_collection() {
-#ifdef YAVE_ASYNC_RESOURCE_COLLECTION
-	if(is_async()) {
-		y_profile_event();
-		_collect_condition.notify_all();
-	} else {
+void LifetimeManager::collection_thread() {
+	concurrent::set_thread_name("Resource collection thread");
+	while(_run_async) {
+		wait_for_front();
 		collect();
 	}
-#else
-	collect();
-#endif
 }
 
+void LifetimeManager::wait_for_front() {
+	VkFence fence = {};
+	u64 timeline_value = 0;
+	{
+		auto lock = y_profile_unique_lock(_cmd_lock);
+		// Collection is done in fence order: if the front is not the next fence we need to wait for it to be recycled
+		const auto front_is_next = [this] { return !_in_flight.empty() && _in_flight.front().resource_fence()._value == _done_counter + 1; };
+		_collect_condition.wait(lock, [&] { return !_run_async || front_is_next(); });
+		if(!front_is_next()) {
+			return;
+		}
+
+		// Only this thread pops _in_flight while async, so the front can not be released while we wait on it
+		const CmdBufferData& front = _in_flight.front();
+		fence = front.vk_fence();
+		timeline_value = front.timeline_value();
+	}
+
+	y_profile_zone("wait");
+
+	// Time out regularly so we don't block shutdown on a command buffer that never got submitted
+	const core::Duration timeout = core::Duration::milliseconds(100);
+	if(_timeline && timeline_value) {
+		_timeline->wait(timeline_value, timeout);
+	} else {
+		vkWaitForFences(device()->vk_device(), 1, &fence, true, timeout.to_nanos());
+	}
+}
+
+
+const TimelineSemaphore* LifetimeManager::timeline_semaphore() const {
+	return _timeline.get();
+}
+
+u64 LifetimeManager::next_timeline_value() {
+	y_debug_assert(_timeline);
+	return ++_timeline_value;
+}
 
 ResourceFence LifetimeManager::create_fence() {
 	return ++_counter;
@@ -122,8 +143,20 @@ void LifetimeManager::recycle(CmdBufferData&& cmd) {
 	}
 
 	if(run_collect) {
-		schedule_collection();
+		if(is_async()) {
+			// Collection and destruction both happen on the collection thread
+			_collect_condition.notify_one();
+		} else {
+			collect();
+		}
+	}
+}
+
+bool LifetimeManager::is_done(const CmdBufferData& cmd, u64 timeline_value) const {
+	if(cmd.timeline_value()) {
+		return cmd.timeline_value() <= timeline_value;
 	}
+	return vkGetFenceStatus(device()->vk_device(), cmd.vk_fence()) == VK_SUCCESS;
 }
 
 void LifetimeManager::collect() {
@@ -132,6 +165,9 @@ void LifetimeManager::collect() {
 	u64 next = 0;
 	bool clear = false;
 
+	// A single query covers every command buffer submitted with a timeline value
+	const u64 timeline_value = _timeline ? _timeline->completed_value() : 0;
+
 	// To ensure that CmdBufferData keep alives are freed outside the lock
 	core::Vector<CmdBufferData> to_clean;
 	{
@@ -145,7 +181,7 @@ void LifetimeManager::collect() {
 				break;
 			}
 
-			if(vkGetFenceStatus(device()->vk_device(), cmd.vk_fence()) == VK_SUCCESS) {
+			if(is_done(cmd, timeline_value)) {
 				next = fence;
 				to_clean.emplace_back(std::move(_in_flight.front()));
 				_in_flight.pop_front();
@@ -194,6 +230,12 @@ void LifetimeManager::destroy_resource(ManagedResource& resource) const {
 			} else if constexpr(std::is_same_v<decltype(res), DescriptorSetData&>) {
 				y_profile_zone("recycle");
 				res.recycle();
+			} else if constexpr(std::is_same_v<decltype(res), MeshAllocation&>) {
+				y_profile_zone("free mesh");
+				res.free();
+			} else if constexpr(std::is_same_v<decltype(res), UploadFrame&>) {
+				y_profile_zone("release upload frame");
+				res.free();
 			} else {
 				y_profile_zone("destroy");
 				detail::destroy(dptr, res);
@@ -208,7 +250,7 @@ void LifetimeManager::clear_resources(u64 up_to) {
 
 	{
 		y_profile_zone("collection");
-		const auto lock = y_profile_unique_lock(_cmd_lock);
+		const auto lock = y_profile_unique_lock(_resource_lock);
 		while(!_to_destroy.empty() && _to_destroy.front().first <= up_to) {
 			to_del << std::move(_to_destroy.front().second);
 			_to_destroy.pop_front();
@@ -27,8 +27,11 @@ SOFTWARE.
 #include <yave/graphics/descriptors/DescriptorSetAllocator.h>
 #include <yave/graphics/commands/data/CmdBufferData.h>
 #include <yave/graphics/memory/DeviceMemory.h>
+#include <yave/meshes/MeshAllocator.h>
+#include <yave/graphics/buffers/UploadAllocator.h>
 #include <yave/graphics/vk/vk.h>
 
+#include <yave/device/extentions/TimelineSemaphore.h>
 
 #include <variant>
 #include <thread>
@@ -36,8 +39,6 @@ SOFTWARE.
 #include <condition_variable>
 #include <deque>
 
-//#define YAVE_ASYNC_RESOURCE_COLLECTION
-
 namespace yave {
 
 class CmdBufferData;
@@ -45,6 +46,8 @@ class CmdBufferData;
 using ManagedResource = std::variant<
 		DeviceMemory,
 		DescriptorSetData,
+		MeshAllocation,
+		UploadFrame,
 
 		VkBuffer,
 		VkImage,
@@ -83,6 +86,12 @@ class LifetimeManager : NonCopyable, public DeviceLinked {
 
 		void collect();
 
+		// Signaled by every submission when VK_KHR_timeline_semaphore is available, null otherwise
+		const TimelineSemaphore* timeline_semaphore() const;
+
+		// Must be called in submission order
+		u64 next_timeline_value();
+
 		usize pending_deletions() const;
 		usize active_cmd_buffers() const;
 
@@ -102,6 +111,8 @@ class LifetimeManager : NonCopyable, public DeviceLinked {
 		void destroy_resource(ManagedResource& resource) const;
 		void clear_resources(u64 up_to);
 
+		bool is_done(const CmdBufferData& cmd, u64 timeline_value) const;
+
 
 		std::deque<std::pair<u64, ManagedResource>> _to_destroy;
 		std::deque<CmdBufferData> _in_flight;
@@ -112,15 +123,16 @@ class LifetimeManager : NonCopyable, public DeviceLinked {
 		std::atomic<u64> _counter = 0;
 		u64 _done_counter = 0;
 
+		std::unique_ptr<TimelineSemaphore> _timeline;
+		std::atomic<u64> _timeline_value = 0;
+
 		// Async collection
-		void schedule_collection();
+		void collection_thread();
+		void wait_for_front();
 
-#ifdef YAVE_ASYNC_RESOURCE_COLLECTION
 		std::condition_variable _collect_condition;
 		std::unique_ptr<std::thread> _collect_thread;
 		std::atomic<bool> _run_async = false;
-		std::atomic<u32> _collection_interval = 0;
-#endif
 };
 
 }
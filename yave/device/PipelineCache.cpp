@@ -0,0 +1,257 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "PipelineCache.h"
+#include "Device.h"
+
+#include <yave/utils/FileSystemModel.h>
+
+#include <y/io2/File.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <array>
+#include <cstring>
+
+namespace yave {
+
+static constexpr u32 pipeline_cache_magic = 0x68435059;
+static constexpr u32 pipeline_cache_version = 1;
+
+struct PipelineCacheHeader {
+	u32 magic = pipeline_cache_magic;
+	u32 version = pipeline_cache_version;
+
+	u32 vendor_id = 0;
+	u32 device_id = 0;
+	u32 driver_version = 0;
+	std::array<u8, VK_UUID_SIZE> uuid = {};
+
+	u32 layout_count = 0;
+	u64 data_size = 0;
+
+	// Caches are only valid for the exact device and driver that created them
+	bool is_compatible(const PipelineCacheHeader& other) const {
+		return magic == other.magic &&
+			   version == other.version &&
+			   vendor_id == other.vendor_id &&
+			   device_id == other.device_id &&
+			   driver_version == other.driver_version &&
+			   uuid == other.uuid;
+	}
+};
+
+static PipelineCacheHeader create_header(DevicePtr dptr) {
+	const VkPhysicalDeviceProperties& properties = dptr->physical_device().vk_properties();
+
+	PipelineCacheHeader header;
+	header.vendor_id = properties.vendorID;
+	header.device_id = properties.deviceID;
+	header.driver_version = properties.driverVersion;
+	std::memcpy(header.uuid.data(), properties.pipelineCacheUUID, VK_UUID_SIZE);
+	return header;
+}
+
+static bool read_cache(io2::File& file, const PipelineCacheHeader& expected, core::Vector<PipelineCache::MaterialLayout>& layouts, core::Vector<u8>& data) {
+	PipelineCacheHeader header;
+	if(!file.read_one(header) || !header.is_compatible(expected)) {
+		return false;
+	}
+
+	// Sizes come from the file and are checked against what is left in it before allocating anything
+	if(header.layout_count > file.remaining() / (3 * sizeof(u32))) {
+		return false;
+	}
+
+	for(u32 i = 0; i != header.layout_count; ++i) {
+		u32 material = 0;
+		u32 depth = 0;
+		u32 color_count = 0;
+		if(!file.read_one(material) || !file.read_one(depth) || !file.read_one(color_count)) {
+			return false;
+		}
+
+		if(color_count > file.remaining() / sizeof(u32)) {
+			return false;
+		}
+
+		core::Vector<RenderPass::ImageData> colors;
+		for(u32 c = 0; c != color_count; ++c) {
+			u32 color = 0;
+			if(!file.read_one(color)) {
+				return false;
+			}
+			colors.emplace_back(ImageFormat(VkFormat(color)), ImageUsage::ColorBit, RenderPass::LoadOp::Clear);
+		}
+
+		const RenderPass::ImageData depth_data(ImageFormat(VkFormat(depth)), ImageUsage::DepthBit, RenderPass::LoadOp::Clear);
+		layouts.emplace_back(PipelineCache::MaterialLayout{material, RenderPass::Layout(depth_data, colors)});
+	}
+
+	if(header.data_size != file.remaining()) {
+		return false;
+	}
+
+	data = core::Vector<u8>(usize(header.data_size), u8(0));
+	return file.read_array(data.data(), data.size()).is_ok();
+}
+
+static bool write_cache(io2::File& file, const PipelineCacheHeader& header, core::Span<PipelineCache::MaterialLayout> layouts, core::Span<u8> data) {
+	if(!file.write_one(header)) {
+		return false;
+	}
+
+	for(const auto& layout : layouts) {
+		const auto colors = layout.layout.color_formats();
+		if(!file.write_one(layout.material_template) ||
+		   !file.write_one(u32(layout.layout.depth_format().vk_format())) ||
+		   !file.write_one(u32(colors.size()))) {
+			return false;
+		}
+		for(const ImageFormat& color : colors) {
+			if(!file.write_one(u32(color.vk_format()))) {
+				return false;
+			}
+		}
+	}
+
+	return file.write_array(data.data(), data.size()) && file.flush();
+}
+
+
+
+PipelineCache::PipelineCache(DevicePtr dptr, std::string_view file_name) : DeviceLinked(dptr), _file_name(file_name) {
+	load();
+}
+
+PipelineCache::~PipelineCache() {
+	save();
+	vkDestroyPipelineCache(device()->vk_device(), _cache, device()->vk_allocation_callbacks());
+}
+
+void PipelineCache::load() {
+	y_profile();
+
+	core::Vector<u8> data;
+	if(auto file = io2::File::open(_file_name)) {
+		if(!read_cache(file.unwrap(), create_header(device()), _layouts, data)) {
+			log_msg("Pipeline cache is invalid or was created by a different device, discarding.", Log::Warning);
+			_layouts.clear();
+			data.clear();
+		}
+	}
+
+	VkPipelineCacheCreateInfo create_info = vk_struct();
+	{
+		create_info.initialDataSize = data.size();
+		create_info.pInitialData = data.data();
+	}
+
+	vk_check(vkCreatePipelineCache(device()->vk_device(), &create_info, device()->vk_allocation_callbacks(), &_cache));
+
+	log_msg(fmt("Pipeline cache loaded: % KB, % material layouts", data.size() / 1024, _layouts.size()), Log::Debug);
+}
+
+VkPipelineCache PipelineCache::vk_pipeline_cache() const {
+	return _cache;
+}
+
+void PipelineCache::register_material_layout(u32 material_template, const RenderPass::Layout& layout) {
+	const auto lock = y_profile_unique_lock(_lock);
+
+	for(const auto& l : _layouts) {
+		if(l.material_template == material_template && l.layout == layout) {
+			return;
+		}
+	}
+	_layouts.emplace_back(MaterialLayout{material_template, layout});
+	_dirty = true;
+}
+
+void PipelineCache::set_dirty() {
+	const auto lock = y_profile_unique_lock(_lock);
+	_dirty = true;
+}
+
+core::Vector<PipelineCache::MaterialLayout> PipelineCache::material_layouts() const {
+	const auto lock = y_profile_unique_lock(_lock);
+	return _layouts;
+}
+
+bool PipelineCache::save() {
+	y_profile();
+
+	const auto save_lock = y_profile_unique_lock(_save_lock);
+
+	core::Vector<MaterialLayout> layouts;
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+		layouts = _layouts;
+		_dirty = false;
+		_last_save.reset();
+	}
+
+	const auto save_failed = [this] {
+		const auto lock = y_profile_unique_lock(_lock);
+		_dirty = true;
+		return false;
+	};
+
+	// vkGetPipelineCacheData is internally synchronized with pipeline creation
+	usize size = 0;
+	vk_check(vkGetPipelineCacheData(device()->vk_device(), _cache, &size, nullptr));
+	core::Vector<u8> data(size, u8(0));
+	vk_check(vkGetPipelineCacheData(device()->vk_device(), _cache, &size, data.data()));
+
+	PipelineCacheHeader header = create_header(device());
+	header.layout_count = u32(layouts.size());
+	header.data_size = u64(size);
+
+	// Write to a temporary file first so that a crash never leaves a truncated cache behind
+	const core::String tmp_name(fmt("%.tmp", _file_name));
+	{
+		auto file = io2::File::create(tmp_name);
+		if(!file || !write_cache(file.unwrap(), header, layouts, core::Span<u8>(data.data(), size))) {
+			log_msg(fmt("Unable to write pipeline cache (%)", tmp_name), Log::Error);
+			return save_failed();
+		}
+	}
+
+	if(!FileSystemModel::local_filesystem()->rename(tmp_name, _file_name)) {
+		log_msg(fmt("Unable to write pipeline cache (%)", _file_name), Log::Error);
+		return save_failed();
+	}
+
+	return true;
+}
+
+bool PipelineCache::save_if_outdated(core::Duration interval) {
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+		if(!_dirty || _last_save.elapsed() < interval) {
+			return false;
+		}
+	}
+	return save();
+}
+
+}
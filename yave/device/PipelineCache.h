@@ -0,0 +1,81 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_DEVICE_PIPELINECACHE_H
+#define YAVE_DEVICE_PIPELINECACHE_H
+
+#include "DeviceLinked.h"
+
+#include <yave/graphics/framebuffer/RenderPass.h>
+
+#include <y/core/String.h>
+#include <y/core/Chrono.h>
+
+#include <mutex>
+
+namespace yave {
+
+// Wraps the device VkPipelineCache and persists it on disk across runs.
+// The cache also remembers which render pass layouts each device material template has been compiled for,
+// so that the matching pipelines can be precompiled on startup.
+class PipelineCache : NonMovable, public DeviceLinked {
+	public:
+		static constexpr std::string_view default_file_name = "pipeline_cache.bin";
+
+		struct MaterialLayout {
+			u32 material_template = 0;
+			RenderPass::Layout layout;
+		};
+
+		PipelineCache(DevicePtr dptr, std::string_view file_name = default_file_name);
+		~PipelineCache();
+
+		VkPipelineCache vk_pipeline_cache() const;
+
+		// Has to be called after creating pipelines with vk_pipeline_cache(), so their data gets saved
+		void set_dirty();
+
+		void register_material_layout(u32 material_template, const RenderPass::Layout& layout);
+		core::Vector<MaterialLayout> material_layouts() const;
+
+		bool save();
+
+		// Only writes the cache if pipelines have been created or registered since the last save
+		bool save_if_outdated(core::Duration interval = core::Duration::seconds(30.0));
+
+	private:
+		void load();
+
+		core::String _file_name;
+		VkPipelineCache _cache = {};
+
+		mutable std::mutex _lock;
+		core::Vector<MaterialLayout> _layouts;
+		bool _dirty = false;
+		core::Chrono _last_save;
+
+		// Serializes saves so they don't write the same temporary file, doesn't block registration
+		std::mutex _save_lock;
+};
+
+}
+
+#endif // YAVE_DEVICE_PIPELINECACHE_H
@@ -27,11 +27,16 @@ namespace yave {
 
 ThreadLocalDevice::ThreadLocalDevice(DevicePtr dptr) :
 		DeviceLinked(dptr),
-		_disposable_cmd_pool(dptr) {
+		_disposable_cmd_pool(dptr),
+		_secondary_cmd_pool(dptr) {
 }
 
 CmdBuffer<CmdBufferUsage::Disposable> ThreadLocalDevice::create_disposable_cmd_buffer() const {
 	return _disposable_cmd_pool.create_buffer();
 }
 
+CmdBuffer<CmdBufferUsage::Secondary> ThreadLocalDevice::create_secondary_cmd_buffer() const {
+	return _secondary_cmd_pool.create_buffer();
+}
+
 }
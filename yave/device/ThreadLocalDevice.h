@@ -34,9 +34,11 @@ class ThreadLocalDevice : NonMovable, public DeviceLinked {
 		ThreadLocalDevice(DevicePtr dptr);
 
 		CmdBuffer<CmdBufferUsage::Disposable> create_disposable_cmd_buffer() const;
+		CmdBuffer<CmdBufferUsage::Secondary> create_secondary_cmd_buffer() const;
 
 	private:
 		mutable CmdBufferPool<CmdBufferUsage::Disposable> _disposable_cmd_pool;
+		mutable CmdBufferPool<CmdBufferUsage::Secondary> _secondary_cmd_pool;
 };
 
 }
@@ -38,15 +38,18 @@ static VkGeometryNV create_mesh_geometry(const StaticMesh& mesh) {
 		geometry.geometry.triangles = vk_struct();
 		geometry.geometry.triangles.sType = VK_STRUCTURE_TYPE_GEOMETRY_TRIANGLES_NV;
 
-		geometry.geometry.triangles.vertexData = mesh.vertex_buffer().vk_buffer();
-		geometry.geometry.triangles.vertexOffset = 0;
-		geometry.geometry.triangles.vertexCount = mesh.vertex_buffer().size();
+		const VertexSubBuffer vertices = mesh.vertex_buffer();
+		const TriangleSubBuffer triangles = mesh.triangle_buffer();
+
+		geometry.geometry.triangles.vertexData = vertices.vk_buffer();
+		geometry.geometry.triangles.vertexOffset = vertices.byte_offset();
+		geometry.geometry.triangles.vertexCount = vertices.size();
 		geometry.geometry.triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
 		geometry.geometry.triangles.vertexStride = sizeof(Vertex);
 
-		geometry.geometry.triangles.indexData = mesh.triangle_buffer().vk_buffer();
-		geometry.geometry.triangles.indexOffset = 0;
-		geometry.geometry.triangles.indexCount = mesh.triangle_buffer().size() * 3;
+		geometry.geometry.triangles.indexData = triangles.vk_buffer();
+		geometry.geometry.triangles.indexOffset = triangles.byte_offset();
+		geometry.geometry.triangles.indexCount = triangles.size() * 3;
 		geometry.geometry.triangles.indexType = VK_INDEX_TYPE_UINT32;
 	}
 	{
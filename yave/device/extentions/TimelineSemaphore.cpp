@@ -0,0 +1,109 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "TimelineSemaphore.h"
+
+#include <yave/device/Device.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace yave {
+
+const char* TimelineSemaphore::extension_name() {
+	return VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME;
+}
+
+bool TimelineSemaphore::is_supported(VkPhysicalDevice physical) {
+	{
+		u32 count = 0;
+		vk_check(vkEnumerateDeviceExtensionProperties(physical, nullptr, &count, nullptr));
+		core::Vector<VkExtensionProperties> extensions(count, VkExtensionProperties{});
+		vk_check(vkEnumerateDeviceExtensionProperties(physical, nullptr, &count, extensions.data()));
+
+		const auto it = std::find_if(extensions.begin(), extensions.end(), [](const VkExtensionProperties& ext) {
+			return !std::strcmp(ext.extensionName, extension_name());
+		});
+		if(it == extensions.end()) {
+			return false;
+		}
+	}
+
+	VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features = vk_struct();
+	VkPhysicalDeviceFeatures2 features = vk_struct();
+	features.pNext = &timeline_features;
+	vkGetPhysicalDeviceFeatures2(physical, &features);
+
+	return timeline_features.timelineSemaphore;
+}
+
+TimelineSemaphore::TimelineSemaphore(DevicePtr dptr) : DeviceLinked(dptr) {
+
+#define GET_PROC(name) reinterpret_cast<PFN_ ## name>(vkGetDeviceProcAddr(device()->vk_device(), #name "KHR"));
+
+	_get_counter_value = GET_PROC(vkGetSemaphoreCounterValue);
+	_wait_semaphores = GET_PROC(vkWaitSemaphores);
+
+#undef GET_PROC
+
+	VkSemaphoreTypeCreateInfo type_create_info = vk_struct();
+	{
+		type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		type_create_info.initialValue = 0;
+	}
+
+	VkSemaphoreCreateInfo create_info = vk_struct();
+	create_info.pNext = &type_create_info;
+	vk_check(vkCreateSemaphore(device()->vk_device(), &create_info, device()->vk_allocation_callbacks(), &_semaphore));
+}
+
+TimelineSemaphore::~TimelineSemaphore() {
+	vkDestroySemaphore(device()->vk_device(), _semaphore, device()->vk_allocation_callbacks());
+}
+
+VkSemaphore TimelineSemaphore::vk_semaphore() const {
+	return _semaphore;
+}
+
+u64 TimelineSemaphore::completed_value() const {
+	u64 value = 0;
+	vk_check(_get_counter_value(device()->vk_device(), _semaphore, &value));
+	return value;
+}
+
+bool TimelineSemaphore::wait(u64 value, core::Duration timeout) const {
+	VkSemaphoreWaitInfo wait_info = vk_struct();
+	{
+		wait_info.semaphoreCount = 1;
+		wait_info.pSemaphores = &_semaphore;
+		wait_info.pValues = &value;
+	}
+
+	const VkResult result = _wait_semaphores(device()->vk_device(), &wait_info, timeout.to_nanos());
+	if(result == VK_TIMEOUT) {
+		return false;
+	}
+	vk_check(result);
+	return true;
+}
+
+}
@@ -0,0 +1,62 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_DEVICE_EXTENTIONS_TIMELINESEMAPHORE_H
+#define YAVE_DEVICE_EXTENTIONS_TIMELINESEMAPHORE_H
+
+#include <yave/device/DeviceLinked.h>
+
+#include <yave/graphics/vk/vk.h>
+
+#include <y/core/Chrono.h>
+
+namespace yave {
+
+// A single VK_KHR_timeline_semaphore counter.
+// Owns its semaphore and destroys it immediately: it is used by the LifetimeManager which outlives the deferred destructions.
+class TimelineSemaphore : public DeviceLinked, NonCopyable {
+	public:
+		static const char* extension_name();
+
+		// The extension and the timelineSemaphore feature are both required
+		static bool is_supported(VkPhysicalDevice physical);
+
+		TimelineSemaphore(DevicePtr dptr);
+		~TimelineSemaphore();
+
+		VkSemaphore vk_semaphore() const;
+
+		// Last value signaled by the GPU
+		u64 completed_value() const;
+
+		// Returns false if value has not been signaled before the timeout
+		bool wait(u64 value, core::Duration timeout) const;
+
+	private:
+		VkSemaphore _semaphore = {};
+
+		PFN_vkGetSemaphoreCounterValue _get_counter_value = nullptr;
+		PFN_vkWaitSemaphores _wait_semaphores = nullptr;
+};
+
+}
+
+#endif // YAVE_DEVICE_EXTENTIONS_TIMELINESEMAPHORE_H
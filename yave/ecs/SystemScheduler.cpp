@@ -0,0 +1,154 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "SystemScheduler.h"
+
+#include <y/concurrent/WorkStealingThreadPool.h>
+#include <y/utils/perf.h>
+#include <y/utils/format.h>
+
+namespace yave {
+namespace ecs {
+
+bool ComponentAccess::conflicts_with(const ComponentAccess& other) const {
+	const auto contains = [](core::Span<ComponentTypeIndex> types, ComponentTypeIndex type) {
+		return std::find(types.begin(), types.end(), type) != types.end();
+	};
+
+	for(const ComponentTypeIndex& type : _writes) {
+		if(contains(other._writes, type) || contains(other._reads, type)) {
+			return true;
+		}
+	}
+	for(const ComponentTypeIndex& type : _reads) {
+		if(contains(other._writes, type)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ComponentAccess::is_read_only() const {
+	return _writes.is_empty();
+}
+
+
+struct SystemScheduler::RunState {
+	const EntityWorld& world;
+	EntityWorld* mutable_world = nullptr;
+	concurrent::WorkStealingThreadPool& pool;
+	std::unique_ptr<std::atomic<u32>[]> remaining;
+	concurrent::DependencyGroup done;
+};
+
+SystemScheduler::System& SystemScheduler::add_system(const char* name, ComponentAccess&& access) {
+	const usize index = _systems.size();
+
+	System& system = _systems.emplace_back();
+	system.name = name;
+	system.access = std::move(access);
+
+	for(usize i = 0; i != index; ++i) {
+		if(_systems[i].access.conflicts_with(system.access)) {
+			_systems[i].successors << index;
+			++system.dependency_count;
+		}
+	}
+
+	return system;
+}
+
+void SystemScheduler::schedule(const char* name, ComponentAccess access, SystemFunc&& func) {
+	add_system(name, std::move(access)).func = std::move(func);
+}
+
+void SystemScheduler::schedule_read_only(const char* name, ComponentAccess access, ReadOnlySystemFunc&& func) {
+	if(!access.is_read_only()) {
+		y_fatal("System \"%\" writes components and can not be read only.", name);
+	}
+	System& system = add_system(name, std::move(access));
+	system.read_only_func = std::move(func);
+	system.read_only = true;
+}
+
+void SystemScheduler::run(EntityWorld& world) {
+	RunState state{world, &world, concurrent::default_thread_pool(), std::make_unique<std::atomic<u32>[]>(_systems.size()), {}};
+	run(state);
+}
+
+void SystemScheduler::run(const EntityWorld& world) {
+	for(const System& system : _systems) {
+		if(!system.read_only) {
+			y_fatal("System \"%\" is not read only and can not run on a const world.", system.name);
+		}
+	}
+
+	RunState state{world, nullptr, concurrent::default_thread_pool(), std::make_unique<std::atomic<u32>[]>(_systems.size()), {}};
+	run(state);
+}
+
+void SystemScheduler::run(RunState& state) {
+	y_profile();
+
+	if(_systems.is_empty()) {
+		return;
+	}
+
+	for(usize i = 0; i != _systems.size(); ++i) {
+		state.remaining[i] = _systems[i].dependency_count;
+	}
+
+	for(usize i = 0; i != _systems.size(); ++i) {
+		if(!_systems[i].dependency_count) {
+			state.pool.schedule([this, &state, i] { run_system(state, i); }, &state.done);
+		}
+	}
+
+	state.pool.wait_until_ready(state.done);
+}
+
+usize SystemScheduler::system_count() const {
+	return _systems.size();
+}
+
+void SystemScheduler::run_system(RunState& state, usize index) {
+	System& system = _systems[index];
+	{
+		y_profile_zone(system.name);
+		if(system.read_only) {
+			system.read_only_func(state.world);
+		} else {
+			y_debug_assert(state.mutable_world);
+			system.func(*state.mutable_world);
+		}
+	}
+
+	// Successors are scheduled before this task is marked as done so state.done can not be ready early
+	for(usize succ : system.successors) {
+		if(--state.remaining[succ] == 0) {
+			state.pool.schedule([this, &state, succ] { run_system(state, succ); }, &state.done);
+		}
+	}
+}
+
+}
+}
@@ -0,0 +1,101 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ECS_SYSTEMSCHEDULER_H
+#define YAVE_ECS_SYSTEMSCHEDULER_H
+
+#include "ecs.h"
+
+#include <y/core/Vector.h>
+#include <y/core/Functor.h>
+
+namespace yave {
+namespace ecs {
+
+class ComponentAccess {
+	public:
+		template<typename... Args>
+		ComponentAccess& read() {
+			(_reads.push_back(index_for_type<Args>()), ...);
+			return *this;
+		}
+
+		template<typename... Args>
+		ComponentAccess& write() {
+			(_writes.push_back(index_for_type<Args>()), ...);
+			return *this;
+		}
+
+		bool conflicts_with(const ComponentAccess& other) const;
+		bool is_read_only() const;
+
+	private:
+		core::Vector<ComponentTypeIndex> _reads;
+		core::Vector<ComponentTypeIndex> _writes;
+};
+
+// Systems only see existing components: they must not create or remove components or entities.
+// A system is ordered after every previously scheduled system it conflicts with, the others run concurrently.
+class SystemScheduler : NonCopyable {
+	public:
+		using SystemFunc = core::Function<void(EntityWorld&)>;
+		using ReadOnlySystemFunc = core::Function<void(const EntityWorld&)>;
+
+		// Names must have static storage
+		void schedule(const char* name, ComponentAccess access, SystemFunc&& func);
+
+		// Read only systems only get a const world, access must not contain any write
+		void schedule_read_only(const char* name, ComponentAccess access, ReadOnlySystemFunc&& func);
+
+		// Runs every system on the default thread pool and waits for all of them
+		void run(EntityWorld& world);
+
+		// Only valid if every system has been scheduled with schedule_read_only
+		void run(const EntityWorld& world);
+
+		usize system_count() const;
+
+	private:
+		struct System {
+			const char* name = nullptr;
+			ComponentAccess access;
+			SystemFunc func;
+			ReadOnlySystemFunc read_only_func;
+			bool read_only = false;
+
+			core::Vector<usize> successors;
+			u32 dependency_count = 0;
+		};
+
+		struct RunState;
+
+		System& add_system(const char* name, ComponentAccess&& access);
+
+		void run(RunState& state);
+		void run_system(RunState& state, usize index);
+
+		core::Vector<System> _systems;
+};
+
+}
+}
+
+#endif // YAVE_ECS_SYSTEMSCHEDULER_H
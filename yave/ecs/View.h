@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include "ComponentContainer.h"
 
+#include <y/concurrent/WorkStealingThreadPool.h>
+
 namespace yave {
 namespace ecs {
 
@@ -238,6 +240,8 @@ class View {
 
 		using end_iterator = EndIterator;
 
+		static constexpr usize default_chunk_size = 1024;
+
 		View(const vector_tuple& vecs) : _vectors(vecs), _short(shortest_range()) {
 		}
 
@@ -259,8 +263,36 @@ class View {
 		}
 
 
+		usize chunk_count(usize chunk_size = default_chunk_size) const {
+			return (_short.size() + chunk_size - 1) / chunk_size;
+		}
+
+		// Splits the view into chunks that are processed on the default thread pool
+		// func(chunk_index, chunk) has to be safe to call concurrently, chunk_index is in [0, chunk_count(chunk_size))
+		template<typename F>
+		void parallel_for_chunks(F&& func, usize chunk_size = default_chunk_size) const {
+			concurrent::default_thread_pool().parallel_for(_short.size(), chunk_size, [&](usize begin, usize end) {
+				const View chunk(_vectors, index_range(_short.data() + begin, end - begin));
+				func(begin / chunk_size, chunk);
+			});
+		}
+
+		// func receives the same values as a for loop over the view and has to be safe to call concurrently
+		template<typename F>
+		void parallel_for_each(F&& func, usize chunk_size = default_chunk_size) const {
+			parallel_for_chunks([&](usize, const View& chunk) {
+				for(auto&& e : chunk) {
+					func(e);
+				}
+			}, chunk_size);
+		}
+
+
 
 	private:
+		View(const vector_tuple& vecs, index_range range) : _vectors(vecs), _short(range) {
+		}
+
 		vector_tuple _vectors;
 		index_range _short;
 };
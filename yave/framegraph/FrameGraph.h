@@ -24,55 +24,23 @@ SOFTWARE.
 
 #include "FrameGraphFrameResources.h"
 #include "FrameGraphPassBuilder.h"
+#include "FrameGraphScheduleBuilder.h"
 
 #include <yave/graphics/barriers/Barrier.h>
 
 namespace yave {
 
 class FrameGraph : NonCopyable {
-
-	struct ResourceCreateInfo {
-		usize last_read = 0;
-		usize last_write = 0;
-		usize first_use = 0;
-
-		bool can_alias_on_last = false;
-
-		usize last_use() const;
-		void register_use(usize index, bool is_written);
-	};
-
-	struct ImageCreateInfo : ResourceCreateInfo {
-		math::Vec2ui size;
-		ImageFormat format;
-		ImageUsage usage = ImageUsage::None;
-
-		FrameGraphImageId copy_src;
-		FrameGraphImageId alias;
-
-		void register_alias(const ImageCreateInfo& other);
-		bool is_aliased() const;
-		bool has_usage() const;
-	};
-
-	struct BufferCreateInfo : ResourceCreateInfo {
-		usize byte_size;
-		BufferUsage usage = BufferUsage::None;
-		MemoryType memory_type = MemoryType::DontCare;
-	};
-
-	struct ImageCopyInfo {
-		usize pass_index = 0;
-		FrameGraphMutableImageId dst;
-		FrameGraphImageId src;
-	};
-
 	public:
 		FrameGraph(std::shared_ptr<FrameGraphResourcePool> pool);
 
 		DevicePtr device() const;
 		const FrameGraphFrameResources& resources() const;
 
+		// Computes allocations, aliasing and barriers, or reuses the result of a previous graph with the same structure.
+		// Does not touch the device. Passes can not be added or modified after this.
+		const FrameGraphSchedule& compile();
+
 		void render(CmdBufferRecorder& recorder) &&;
 
 		FrameGraphPassBuilder add_pass(std::string_view name);
@@ -87,35 +55,32 @@ class FrameGraph : NonCopyable {
 		FrameGraphMutableImageId declare_image(ImageFormat format, const math::Vec2ui& size);
 		FrameGraphMutableBufferId declare_buffer(usize byte_size);
 
-		const ImageCreateInfo& info(FrameGraphImageId res) const;
-		const BufferCreateInfo& info(FrameGraphBufferId res) const;
+		const FrameGraphScheduleBuilder::ImageCreateInfo& info(FrameGraphImageId res) const;
+		const FrameGraphScheduleBuilder::BufferCreateInfo& info(FrameGraphBufferId res) const;
 
-		void register_usage(FrameGraphImageId res, ImageUsage usage, bool is_written, const FrameGraphPass* pass);
-		void register_usage(FrameGraphBufferId res, BufferUsage usage, bool is_written, const FrameGraphPass* pass);
+		void register_usage(FrameGraphImageId res, ImageUsage usage, bool is_written, PipelineStage stage, const FrameGraphPass* pass);
+		void register_usage(FrameGraphBufferId res, BufferUsage usage, bool is_written, PipelineStage stage, const FrameGraphPass* pass);
 		void register_image_copy(FrameGraphMutableImageId dst, FrameGraphImageId src, const FrameGraphPass* pass);
 
 		void set_cpu_visible(FrameGraphMutableBufferId res, const FrameGraphPass* pass);
+		void set_has_side_effects(const FrameGraphPass* pass);
 
 		bool is_attachment(FrameGraphImageId res) const;
 
 	private:
-		const core::String& pass_name(usize pass_index) const;
-
-		void alloc_resources();
-		void alloc_image(FrameGraphImageId res, const ImageCreateInfo& info) const;
+		void alloc_resources(const FrameGraphSchedule& schedule);
 
 		std::unique_ptr<FrameGraphFrameResources> _resources;
 
 		core::Vector<std::unique_ptr<FrameGraphPass>> _passes;
 
-		using hash_t = std::hash<FrameGraphResourceId>;
-		std::unordered_map<FrameGraphImageId, ImageCreateInfo, hash_t> _images;
-		std::unordered_map<FrameGraphBufferId, BufferCreateInfo, hash_t> _buffers;
-
-		core::Vector<ImageCopyInfo> _image_copies;
+		// Device free description of the graph, compiled into the schedule
+		FrameGraphScheduleBuilder _builder;
 
-		usize _pass_index = 0;
+		std::shared_ptr<const FrameGraphSchedule> _schedule;
 
+		// Set while rendering so that secondaries are timed along with the primary
+		GpuTimestamps* _timestamps = nullptr;
 };
 
 }
@@ -22,10 +22,13 @@ SOFTWARE.
 
 #include "FrameGraphFrameResources.h"
 
-namespace yave {
+#include <yave/device/Device.h>
 
-FrameGraphFrameResources::FrameGraphFrameResources(std::shared_ptr<FrameGraphResourcePool> pool) : _pool(pool) {
+namespace yave {
 
+FrameGraphFrameResources::FrameGraphFrameResources(std::shared_ptr<FrameGraphResourcePool> pool) :
+		_pool(pool),
+		_upload_frame(device()->upload_allocator().create_frame()) {
 }
 
 FrameGraphFrameResources::~FrameGraphFrameResources() {
@@ -35,6 +38,10 @@ FrameGraphFrameResources::~FrameGraphFrameResources() {
 	for(auto&& res : _buffer_storage) {
 		_pool->release(std::move(*res));
 	}
+	if(_image_heap) {
+		_pool->release(std::move(_image_heap));
+	}
+	device()->destroy(std::move(_upload_frame));
 	_pool->garbage_collect();
 }
 
@@ -43,12 +50,26 @@ DevicePtr FrameGraphFrameResources::device() const {
 	return _pool->device();
 }
 
-u32 FrameGraphFrameResources::create_resource_id() {
-	return _next_id++;
+FrameGraphResourcePool* FrameGraphFrameResources::pool() const {
+	return _pool.get();
 }
 
 
 
+
+void FrameGraphFrameResources::create_image_heap(const std::shared_ptr<const FrameGraphSchedule>& schedule) {
+	y_debug_assert(!_image_heap);
+
+	_image_heap = _pool->create_image_heap(schedule);
+	for(const auto& [res, image] : _image_heap->images()) {
+		auto& ptr = _images[res];
+		if(ptr) {
+			y_fatal("Image already exists.");
+		}
+		ptr = image;
+	}
+}
+
 void FrameGraphFrameResources::create_image(FrameGraphImageId res, ImageFormat format, const math::Vec2ui& size, ImageUsage usage) {
 	res.check_valid();
 
@@ -64,11 +85,21 @@ void FrameGraphFrameResources::create_buffer(FrameGraphBufferId res, usize byte_
 	res.check_valid();
 
 	auto& buffer = _buffers[res];
-	if(buffer) {
+	if(!buffer.buffer.is_null()) {
 		y_fatal("Buffer already exists.");
 	}
-	_buffer_storage << std::make_unique<TransientBuffer>(_pool->create_buffer(byte_size, usage, memory));
-	buffer = _buffer_storage.last().get();
+
+	if(memory == MemoryType::DontCare) {
+		memory = prefered_memory_type(usage);
+	}
+
+	if(memory == MemoryType::CpuVisible && UploadAllocator::is_compatible(usage, memory)) {
+		buffer = BufferData{device()->upload_allocator().alloc(_upload_frame, byte_size), usage, memory};
+	} else {
+		_buffer_storage << std::make_unique<TransientBuffer>(_pool->create_buffer(byte_size, usage, memory));
+		// Pooled buffers can be larger than requested
+		buffer = BufferData{SubBufferBase(*_buffer_storage.last(), byte_size, 0), usage, memory};
+	}
 }
 
 bool FrameGraphFrameResources::is_alive(FrameGraphImageId res) const {
@@ -86,15 +117,15 @@ ImageBarrier FrameGraphFrameResources::barrier(FrameGraphImageId res, PipelineSt
 
 BufferBarrier FrameGraphFrameResources::barrier(FrameGraphBufferId res, PipelineStage src, PipelineStage dst) const {
 	res.check_valid();
-	return BufferBarrier(*_buffers.find(res)->second, src, dst);
+	return BufferBarrier(find(res).buffer, src, dst);
 }
 
 const ImageBase& FrameGraphFrameResources::image_base(FrameGraphImageId res) const {
 	return find(res);
 }
 
-const BufferBase& FrameGraphFrameResources::buffer_base(FrameGraphBufferId res) const {
-	return find(res);
+const SubBufferBase& FrameGraphFrameResources::buffer_base(FrameGraphBufferId res) const {
+	return find(res).buffer;
 }
 
 
@@ -136,12 +167,12 @@ const TransientImage<>& FrameGraphFrameResources::find(FrameGraphImageId res) co
 	/*return*/ y_fatal("Image resource doesn't exist.");
 }
 
-const TransientBuffer& FrameGraphFrameResources::find(FrameGraphBufferId res) const {
+const FrameGraphFrameResources::BufferData& FrameGraphFrameResources::find(FrameGraphBufferId res) const {
 	if(!res.is_valid()) {
 		y_fatal("Invalid buffer resource.");
 	}
 	if(const auto it = _buffers.find(res); it != _buffers.end()) {
-		return *it->second;
+		return it->second;
 	}
 	/*return*/ y_fatal("Buffer resource doesn't exist.");
 }
@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include "FrameGraphResourcePool.h"
 
+#include <yave/graphics/buffers/UploadAllocator.h>
+
 namespace yave {
 
 class FrameGraphFrameResources final : NonMovable {
@@ -32,9 +34,9 @@ class FrameGraphFrameResources final : NonMovable {
 		~FrameGraphFrameResources();
 
 		DevicePtr device() const;
+		FrameGraphResourcePool* pool() const;
 
-		u32 create_resource_id();
-
+		void create_image_heap(const std::shared_ptr<const FrameGraphSchedule>& schedule);
 		void create_image(FrameGraphImageId res, ImageFormat format, const math::Vec2ui& size, ImageUsage usage);
 		void create_buffer(FrameGraphBufferId res, usize byte_size, BufferUsage usage, MemoryType memory);
 
@@ -45,7 +47,7 @@ class FrameGraphFrameResources final : NonMovable {
 		BufferBarrier barrier(FrameGraphBufferId res, PipelineStage src, PipelineStage dst) const;
 
 		const ImageBase& image_base(FrameGraphImageId res) const;
-		const BufferBase& buffer_base(FrameGraphBufferId res) const;
+		const SubBufferBase& buffer_base(FrameGraphBufferId res) const;
 
 
 		void create_alias(FrameGraphImageId dst, FrameGraphImageId src);
@@ -60,37 +62,51 @@ class FrameGraphFrameResources final : NonMovable {
 
 		template<BufferUsage Usage>
 		SubBuffer<Usage> buffer(FrameGraphBufferId res) const {
-			return TransientSubBuffer<Usage>(find(res));
+			return sub_buffer<Usage>(res);
 		}
 
 		template<BufferUsage Usage, typename T>
 		TypedSubBuffer<T, Usage> buffer(FrameGraphTypedBufferId<T> res) const {
-			return TypedSubBuffer<T, Usage>(TransientSubBuffer<Usage>(find(res)));
+			return TypedSubBuffer<T, Usage>(sub_buffer<Usage>(res));
 		}
 
 		template<typename T>
 		TypedMapping<T> mapped_buffer(FrameGraphMutableTypedBufferId<T> res) const {
 			constexpr BufferUsage usage = BufferUsage::None;
 			constexpr MemoryType memory = MemoryType::CpuVisible;
-			const TypedSubBuffer<T, usage, memory> subbuffer(TransientSubBuffer<usage, memory>(find(res)));
+			const TypedSubBuffer<T, usage, memory> subbuffer(sub_buffer<usage, memory>(res));
 			return TypedMapping<T>(subbuffer);
 		}
 
 	private:
-		const TransientImage<>& find(FrameGraphImageId res) const;
-		const TransientBuffer& find(FrameGraphBufferId res) const;
+		struct BufferData {
+			SubBufferBase buffer;
+			BufferUsage usage = BufferUsage::None;
+			MemoryType memory = MemoryType::DontCare;
+		};
+
+		template<BufferUsage Usage, MemoryType Memory = MemoryType::DontCare>
+		TransientSubBuffer<Usage, Memory> sub_buffer(FrameGraphBufferId res) const {
+			const BufferData& data = find(res);
+			return TransientSubBuffer<Usage, Memory>(data.buffer, data.usage, data.memory);
+		}
 
-		u32 _next_id = 0;
+		const TransientImage<>& find(FrameGraphImageId res) const;
+		const BufferData& find(FrameGraphBufferId res) const;
 
 		Y_TODO(replace by vector)
 		using hash_t = std::hash<FrameGraphResourceId>;
 		std::unordered_map<FrameGraphImageId, TransientImage<>*, hash_t> _images;
-		std::unordered_map<FrameGraphBufferId, TransientBuffer*, hash_t> _buffers;
+		std::unordered_map<FrameGraphBufferId, BufferData, hash_t> _buffers;
 
 		std::shared_ptr<FrameGraphResourcePool> _pool;
 
 		core::Vector<std::unique_ptr<TransientImage<>>> _image_storage;
 		core::Vector<std::unique_ptr<TransientBuffer>> _buffer_storage;
+		std::unique_ptr<FrameGraphImageHeap> _image_heap;
+
+		// CPU visible buffers are bump allocated for the frame instead of going through the pool
+		UploadFrame _upload_frame;
 };
 
 }
@@ -0,0 +1,163 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FrameGraphImageHeap.h"
+
+#include <yave/device/Device.h>
+
+namespace yave {
+
+static usize align_up(usize value, usize alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+FrameGraphImageHeap::FrameGraphImageHeap(DevicePtr dptr, std::shared_ptr<const FrameGraphSchedule> schedule) : DeviceLinked(dptr), _schedule(std::move(schedule)) {
+	y_profile();
+
+	_slot_reqs = core::Vector<VkMemoryRequirements>(_schedule->slot_count(), VkMemoryRequirements{});
+	_slot_offsets = core::Vector<usize>(_schedule->slot_count(), usize(0));
+
+	for(const auto& alloc : _schedule->images()) {
+		if(alloc.alias.is_valid() || alloc.slot == FrameGraphSchedule::no_slot) {
+			continue;
+		}
+
+		_image_storage << std::make_unique<TransientImage<>>(TransientImage<>::create_unbound(dptr, alloc.format, alloc.usage, alloc.size));
+		_images.emplace_back(alloc.res, _image_storage.last().get());
+
+		const VkMemoryRequirements reqs = _image_storage.last()->memory_requirements();
+		_placed.emplace_back(alloc.slot, reqs);
+		_unaliased_byte_size += align_up(reqs.size, reqs.alignment);
+
+		VkMemoryRequirements& slot_reqs = _slot_reqs[alloc.slot];
+		slot_reqs.size = std::max(slot_reqs.size, reqs.size);
+		slot_reqs.alignment = std::max(slot_reqs.alignment, reqs.alignment);
+		slot_reqs.memoryTypeBits = slot_reqs.memoryTypeBits ? (slot_reqs.memoryTypeBits & reqs.memoryTypeBits) : reqs.memoryTypeBits;
+	}
+
+	// All slots go in a single block if possible
+	for(usize i = 0; i != _slot_reqs.size(); ++i) {
+		const VkMemoryRequirements& slot_reqs = _slot_reqs[i];
+		if(!slot_reqs.size) {
+			continue;
+		}
+		y_always_assert(slot_reqs.memoryTypeBits, "Images in the same slot have no common memory type.");
+
+		_block_reqs.alignment = std::max(_block_reqs.alignment, slot_reqs.alignment);
+		_block_reqs.memoryTypeBits = _block_reqs.memoryTypeBits ? (_block_reqs.memoryTypeBits & slot_reqs.memoryTypeBits) : slot_reqs.memoryTypeBits;
+
+		_slot_offsets[i] = align_up(_block_reqs.size, slot_reqs.alignment);
+		_block_reqs.size = _slot_offsets[i] + slot_reqs.size;
+	}
+}
+
+const VkMemoryRequirements& FrameGraphImageHeap::memory_requirements() const {
+	return _block_reqs;
+}
+
+// Memory types are picked from the requirement bits and blocks are aligned on the requirement alignment,
+// so the block is valid for reqs as long as all its possible types are accepted and it is at least as aligned
+bool FrameGraphImageHeap::can_recycle_for(const VkMemoryRequirements& reqs) const {
+	return _single_block &&
+		reqs.memoryTypeBits &&
+		_byte_size >= reqs.size &&
+		_block_reqs.alignment >= reqs.alignment &&
+		(_block_reqs.memoryTypeBits & reqs.memoryTypeBits) == _block_reqs.memoryTypeBits;
+}
+
+void FrameGraphImageHeap::bind_memory(std::unique_ptr<FrameGraphImageHeap> recycled) {
+	y_profile();
+
+	y_debug_assert(_memory.is_empty());
+
+	if(!_block_reqs.size) {
+		return;
+	}
+
+	if(recycled && recycled->can_recycle_for(_block_reqs)) {
+		// The previous images are not used anymore, their memory can be shared with the new ones
+		_memory << std::move(recycled->_memory.last());
+		recycled->_memory.clear();
+
+		_single_block = true;
+		_byte_size = recycled->_byte_size;
+		_block_reqs.alignment = recycled->_block_reqs.alignment;
+		_block_reqs.memoryTypeBits = recycled->_block_reqs.memoryTypeBits;
+	} else if(_block_reqs.memoryTypeBits) {
+		_memory << device()->allocator().alloc(_block_reqs, MemoryType::DeviceLocal);
+		_single_block = true;
+		_byte_size = _block_reqs.size;
+	}
+
+	if(_single_block) {
+		const DeviceMemory& block = _memory.last();
+		for(usize i = 0; i != _image_storage.size(); ++i) {
+			const auto& [slot, reqs] = _placed[i];
+			_image_storage[i]->bind_memory(DeviceMemory(device(), block.vk_memory(), block.vk_offset() + _slot_offsets[slot], reqs.size));
+		}
+	} else {
+		// No memory type works for every slot, allocate them separately
+		for(const VkMemoryRequirements& slot_reqs : _slot_reqs) {
+			if(slot_reqs.size) {
+				_memory << device()->allocator().alloc(slot_reqs, MemoryType::DeviceLocal);
+				_byte_size += slot_reqs.size;
+			} else {
+				_memory.emplace_back();
+			}
+		}
+
+		for(usize i = 0; i != _image_storage.size(); ++i) {
+			const auto& [slot, reqs] = _placed[i];
+			const DeviceMemory& memory = _memory[slot];
+			_image_storage[i]->bind_memory(DeviceMemory(device(), memory.vk_memory(), memory.vk_offset(), reqs.size));
+		}
+	}
+}
+
+FrameGraphImageHeap::~FrameGraphImageHeap() {
+	_images.clear();
+	_image_storage.clear();
+
+	for(DeviceMemory& memory : _memory) {
+		if(memory.device()) {
+			device()->destroy(std::move(memory));
+		}
+	}
+}
+
+const FrameGraphSchedule* FrameGraphImageHeap::schedule() const {
+	return _schedule.get();
+}
+
+core::Span<std::pair<FrameGraphImageId, TransientImage<>*>> FrameGraphImageHeap::images() const {
+	return _images;
+}
+
+usize FrameGraphImageHeap::byte_size() const {
+	return _byte_size;
+}
+
+usize FrameGraphImageHeap::unaliased_byte_size() const {
+	return _unaliased_byte_size;
+}
+
+}
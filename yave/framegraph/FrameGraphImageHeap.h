@@ -0,0 +1,81 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_FRAMEGRAPH_FRAMEGRAPHIMAGEHEAP_H
+#define YAVE_FRAMEGRAPH_FRAMEGRAPHIMAGEHEAP_H
+
+#include "FrameGraphSchedule.h"
+
+#include <y/core/Vector.h>
+
+#include <memory>
+
+namespace yave {
+
+// Creates all the images of a schedule, images in the same slot are placed at the same offset in memory.
+// Images are not kept in a defined layout: FrameGraph discards them at the start of their first pass.
+// Images are created unbound: bind_memory either allocates the memory or takes it from a heap that is no longer used.
+class FrameGraphImageHeap : NonMovable, public DeviceLinked {
+	public:
+		FrameGraphImageHeap(DevicePtr dptr, std::shared_ptr<const FrameGraphSchedule> schedule);
+		~FrameGraphImageHeap();
+
+		// Memory needed to place every slot in a single block
+		const VkMemoryRequirements& memory_requirements() const;
+
+		// The memory of this heap is a single block that can hold a heap with the given requirements
+		bool can_recycle_for(const VkMemoryRequirements& reqs) const;
+
+		// Takes the memory of recycled if possible, allocates otherwise. Must be called once, before the images are used
+		void bind_memory(std::unique_ptr<FrameGraphImageHeap> recycled = nullptr);
+
+		const FrameGraphSchedule* schedule() const;
+
+		core::Span<std::pair<FrameGraphImageId, TransientImage<>*>> images() const;
+
+		// Memory used by the images, can be more than they need if the memory was recycled
+		usize byte_size() const;
+
+		// Memory the images would use if they did not share memory
+		usize unaliased_byte_size() const;
+
+	private:
+		std::shared_ptr<const FrameGraphSchedule> _schedule;
+
+		core::Vector<std::unique_ptr<TransientImage<>>> _image_storage;
+		core::Vector<std::pair<FrameGraphImageId, TransientImage<>*>> _images;
+
+		// Slot and requirements of every image in _image_storage
+		core::Vector<std::pair<usize, VkMemoryRequirements>> _placed;
+		core::Vector<VkMemoryRequirements> _slot_reqs;
+		core::Vector<usize> _slot_offsets;
+		VkMemoryRequirements _block_reqs = {};
+
+		core::Vector<DeviceMemory> _memory;
+		bool _single_block = false;
+
+		usize _byte_size = 0;
+		usize _unaliased_byte_size = 0;
+};
+
+}
+
+#endif // YAVE_FRAMEGRAPH_FRAMEGRAPHIMAGEHEAP_H
@@ -23,6 +23,8 @@ SOFTWARE.
 #include "FrameGraphPass.h"
 #include "FrameGraph.h"
 
+#include <yave/device/Device.h>
+
 namespace yave {
 
 FrameGraphPass::FrameGraphPass(std::string_view name, FrameGraph* parent, usize index) : _name(name), _parent(parent), _index(index) {
@@ -48,15 +50,34 @@ core::Span<DescriptorSet> FrameGraphPass::descriptor_sets() const {
 }
 
 void FrameGraphPass::render(CmdBufferRecorder& recorder) && {
-	_render(recorder, this);
+	if(is_recorded_in_secondaries()) {
+		auto secondaries = render_secondaries();
+		recorder.execute(framebuffer(), secondaries);
+	} else {
+		_render(recorder, this);
+	}
+}
+
+bool FrameGraphPass::is_recorded_in_secondaries() const {
+	return _render_secondaries != secondary_render_func();
+}
+
+core::Vector<SecondaryCmdBufferRecorder> FrameGraphPass::render_secondaries() const {
+	y_debug_assert(is_recorded_in_secondaries());
+	return _render_secondaries(this);
+}
+
+SecondaryCmdBufferRecorder FrameGraphPass::create_secondary_recorder() const {
+	SecondaryCmdBufferRecorder recorder(resources().device()->create_secondary_cmd_buffer(), framebuffer());
+	recorder.set_timestamps(_parent->_timestamps);
+	return recorder;
 }
 
-void FrameGraphPass::init_framebuffer(const FrameGraphFrameResources& resources) {
+void FrameGraphPass::init_framebuffer(const FrameGraphFrameResources& resources, core::Span<FrameGraphImageId> cleared) {
 	y_profile();
 	if(_depth.image.is_valid() || _colors.size()) {
 		auto declared_here = [&](FrameGraphImageId id) {
-			const auto& info = _parent->info(id);
-			return info.first_use == _index && !info.is_aliased();
+			return std::find(cleared.begin(), cleared.end(), id) != cleared.end();
 		};
 
 		Framebuffer::DepthAttachment depth;
@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_FRAMEGRAPH_FRAMEGRAPHPASS_H
 
 #include <y/core/Functor.h>
+#include <y/concurrent/WorkStealingThreadPool.h>
 
 #include <yave/graphics/descriptors/DescriptorSet.h>
 
@@ -43,12 +44,11 @@ class FrameGraphPass final : NonMovable {
 	};
 
 	public:
-		struct ResourceUsageInfo {
-			PipelineStage stage = PipelineStage::None;
-		};
-
 		using render_func = core::Function<void(CmdBufferRecorder&, const FrameGraphPass*)>;
 
+		// Called on a worker thread, returns the secondaries to execute in order inside the framebuffer of the pass
+		using secondary_render_func = core::Function<core::Vector<SecondaryCmdBufferRecorder>(const FrameGraphPass*)>;
+
 		FrameGraphPass(std::string_view name, FrameGraph* parent, usize index);
 
 		const core::String& name() const;
@@ -59,23 +59,46 @@ class FrameGraphPass final : NonMovable {
 
 		void render(CmdBufferRecorder& recorder) &&;
 
+		bool is_recorded_in_secondaries() const;
+		core::Vector<SecondaryCmdBufferRecorder> render_secondaries() const;
+
+		// Records chunk_count secondaries for the framebuffer of this pass in parallel, calling func(render_pass, chunk_index) for each.
+		// Every secondary starts with a fresh state: pipelines, descriptor sets, buffers and the viewport have to be bound again
+		template<typename F>
+		core::Vector<SecondaryCmdBufferRecorder> record_secondaries(usize chunk_count, F&& func) const {
+			auto secondaries = std::make_unique<SecondaryCmdBufferRecorder[]>(chunk_count);
+			concurrent::default_thread_pool().parallel_for(chunk_count, 1, [&](usize begin, usize end) {
+				for(usize i = begin; i != end; ++i) {
+					// Allocated from the pool of the recording thread
+					secondaries[i] = create_secondary_recorder();
+					auto render_pass = secondaries[i].render_pass();
+					func(render_pass, i);
+				}
+			});
+
+			auto recorded = core::vector_with_capacity<SecondaryCmdBufferRecorder>(chunk_count);
+			for(usize i = 0; i != chunk_count; ++i) {
+				recorded.emplace_back(std::move(secondaries[i]));
+			}
+			return recorded;
+		}
+
 	private:
 		friend class FrameGraph;
 		friend class FrameGraphPassBuilder;
 
-		void init_framebuffer(const FrameGraphFrameResources& resources);
+		void init_framebuffer(const FrameGraphFrameResources& resources, core::Span<FrameGraphImageId> cleared);
 		void init_descriptor_sets(const FrameGraphFrameResources& resources);
 
+		SecondaryCmdBufferRecorder create_secondary_recorder() const;
+
 		render_func _render = [](CmdBufferRecorder&, const FrameGraphPass*) {};
+		secondary_render_func _render_secondaries;
 		core::String _name;
 
 		FrameGraph* _parent = nullptr;
 		const usize _index;
 
-		using hash_t = std::hash<FrameGraphResourceId>;
-		std::unordered_map<FrameGraphImageId, ResourceUsageInfo, hash_t> _images;
-		std::unordered_map<FrameGraphBufferId, ResourceUsageInfo, hash_t> _buffers;
-
 		core::Vector<core::Vector<FrameGraphDescriptorBinding>> _bindings;
 		core::Vector<DescriptorSet> _descriptor_sets;
 
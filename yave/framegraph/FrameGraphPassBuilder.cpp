@@ -25,6 +25,19 @@ SOFTWARE.
 
 namespace yave {
 
+static bool is_writable(const Descriptor& desc) {
+	switch(desc.vk_descriptor_type()) {
+		case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+		case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+			return true;
+		default:
+			break;
+	}
+	return false;
+}
+
 FrameGraphPassBuilder::FrameGraphPassBuilder(FrameGraphPass* pass) : _pass(pass) {
 }
 
@@ -36,6 +49,14 @@ void FrameGraphPassBuilder::set_render_func(FrameGraphPass::render_func&& func)
 	_pass->_render = std::move(func);
 }
 
+void FrameGraphPassBuilder::set_secondary_render_func(FrameGraphPass::secondary_render_func&& func) {
+	_pass->_render_secondaries = std::move(func);
+}
+
+void FrameGraphPassBuilder::set_has_side_effects() {
+	parent()->set_has_side_effects(_pass);
+}
+
 
 // --------------------------------- Declarations ---------------------------------
 
@@ -127,9 +148,11 @@ void FrameGraphPassBuilder::add_uniform_input(FrameGraphImageId res, usize ds_in
 
 // --------------------------------- External ---------------------------------
 
+// External storage can be written, and the graph can not see who reads it: never cull the pass
 Y_TODO(external framegraph resources are not synchronized)
 void FrameGraphPassBuilder::add_uniform_input(StorageView tex, usize ds_index, PipelineStage) {
 	add_uniform(Descriptor(tex), ds_index);
+	set_has_side_effects();
 }
 
 void FrameGraphPassBuilder::add_uniform_input(TextureView tex, usize ds_index, PipelineStage) {
@@ -151,10 +174,17 @@ void FrameGraphPassBuilder::add_index_input(FrameGraphBufferId res, PipelineStag
 	add_to_pass(res, BufferUsage::IndexBit, false, stage);
 }
 
+void FrameGraphPassBuilder::add_indirect_input(FrameGraphBufferId res, PipelineStage stage) {
+	add_to_pass(res, BufferUsage::IndirectBit, false, stage);
+}
+
 
 // --------------------------------- stuff ---------------------------------
 
 void FrameGraphPassBuilder::add_descriptor_binding(Descriptor bind, usize ds_index) {
+	if(is_writable(bind)) {
+		set_has_side_effects();
+	}
 	add_uniform(bind, ds_index);
 }
 
@@ -165,27 +195,12 @@ usize FrameGraphPassBuilder::next_descriptor_set_index() {
 	return bindings.size() - 1;
 }
 
-template<typename T>
-void set_stage(const FrameGraphPass* pass, T& info, PipelineStage stage) {
-	if(info.stage != PipelineStage::None) {
-		Y_TODO(This should be either one write or many reads)
-		y_fatal("Resource can only be used once per pass (used twice by \"%\", previous stage was %).", pass->name(), usize(info.stage));
-	}
-	info.stage = stage;
-}
-
 void FrameGraphPassBuilder::add_to_pass(FrameGraphImageId res, ImageUsage usage, bool is_written, PipelineStage stage) {
-	res.check_valid();
-	auto& info = _pass->_images[res];
-	set_stage(_pass, info, stage);
-	parent()->register_usage(res, usage, is_written, _pass);
+	parent()->register_usage(res, usage, is_written, stage, _pass);
 }
 
 void FrameGraphPassBuilder::add_to_pass(FrameGraphBufferId res, BufferUsage usage, bool is_written, PipelineStage stage) {
-	res.check_valid();
-	auto& info = _pass->_buffers[res];
-	set_stage(_pass, info, stage);
-	parent()->register_usage(res, usage, is_written, _pass);
+	parent()->register_usage(res, usage, is_written, stage, _pass);
 }
 
 void FrameGraphPassBuilder::add_uniform(FrameGraphDescriptorBinding binding, usize ds_index) {
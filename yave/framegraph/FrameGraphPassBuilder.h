@@ -61,6 +61,7 @@ class FrameGraphPassBuilder {
 
 		void add_attrib_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::VertexInputBit);
 		void add_index_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::VertexInputBit);
+		void add_indirect_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::DrawIndirectBit);
 
 		template<typename T>
 		void map_update(FrameGraphMutableTypedBufferId<T> res) {
@@ -69,6 +70,15 @@ class FrameGraphPassBuilder {
 
 		void set_render_func(FrameGraphPass::render_func&& func);
 
+		// The pass is recorded on a worker thread, into secondaries executed inside its framebuffer,
+		// while the other passes are recorded. The pass needs attachments and can only draw.
+		void set_secondary_render_func(FrameGraphPass::secondary_render_func&& func);
+
+		// Passes that produce something used outside of the graph are never culled
+		// and their resources are kept alive until the end of the graph.
+		// Storage views and writable descriptor bindings imply side effects.
+		void set_has_side_effects();
+
 		void add_descriptor_binding(Descriptor bind, usize ds_index = 0);
 		usize next_descriptor_set_index();
 
@@ -139,7 +139,7 @@ class FrameGraphResourceId {
 		}
 
 	protected:
-		friend class FrameGraph;
+		friend class FrameGraphScheduleBuilder;
 
 		static constexpr u32 invalid_id = u32(-1);
 
@@ -22,6 +22,10 @@ SOFTWARE.
 
 #include "FrameGraphResourcePool.h"
 
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/utils/hash.h>
+
 namespace yave {
 
 template<typename U>
@@ -31,6 +35,29 @@ static void check_usage(U u) {
 	}
 }
 
+static u64 image_key(ImageFormat format, const math::Vec2ui& size, ImageUsage usage) {
+	u64 key = u64(format.vk_format());
+	hash_combine(key, u64(size.x()));
+	hash_combine(key, u64(size.y()));
+	hash_combine(key, u64(usage));
+	return key;
+}
+
+// Buffers are bucketed by power of two size class so that any big enough buffer can be found in a couple of lookups
+static u64 buffer_key(BufferUsage usage, MemoryType memory, usize size_class) {
+	u64 key = u64(usage);
+	hash_combine(key, u64(memory));
+	hash_combine(key, u64(size_class));
+	return key;
+}
+
+static usize size_class(usize byte_size) {
+	return log2ui(std::max(byte_size, usize(1)));
+}
+
+// Pooled heaps up to (1 + slack) times the needed size can give their memory to another schedule
+static constexpr float heap_slack = 1.0f;
+
 FrameGraphResourcePool::FrameGraphResourcePool(DevicePtr dptr) : DeviceLinked(dptr) {
 }
 
@@ -40,21 +67,25 @@ FrameGraphResourcePool::~FrameGraphResourcePool() {
 
 TransientImage<> FrameGraphResourcePool::create_image(ImageFormat format, const math::Vec2ui& size, ImageUsage usage) {
 	y_profile();
-	const auto lock = y_profile_unique_lock(_lock);
 
 	check_usage(usage);
 
 	TransientImage<> image;
-	if(!create_image_from_pool(image, format, size, usage)) {
-		image = TransientImage<>(device(), format, usage, size);
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+		if(create_image_from_pool(image, format, size, usage)) {
+			++_stats.image_hits;
+			return image;
+		}
+		++_stats.image_misses;
 	}
 
-	return image;
+	// Allocate outside of the lock
+	return TransientImage<>(device(), format, usage, size);
 }
 
 TransientBuffer FrameGraphResourcePool::create_buffer(usize byte_size, BufferUsage usage, MemoryType memory) {
 	y_profile();
-	const auto lock = y_profile_unique_lock(_lock);
 
 	check_usage(usage);
 
@@ -63,49 +94,134 @@ TransientBuffer FrameGraphResourcePool::create_buffer(usize byte_size, BufferUsa
 	}
 
 	TransientBuffer buffer;
-	if(!create_buffer_from_pool(buffer, byte_size, usage, memory)) {
-		buffer = TransientBuffer(device(), byte_size, usage, memory);
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+		if(create_buffer_from_pool(buffer, byte_size, usage, memory)) {
+			++_stats.buffer_hits;
+			return buffer;
+		}
+		++_stats.buffer_misses;
+	}
+
+	return TransientBuffer(device(), byte_size, usage, memory);
+}
+
+std::unique_ptr<FrameGraphImageHeap> FrameGraphResourcePool::create_image_heap(const std::shared_ptr<const FrameGraphSchedule>& schedule) {
+	y_profile();
+
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+		for(auto& [stats, col] : _schedule_stats) {
+			if(stats.hash == schedule->hash()) {
+				col = _collection_id;
+			}
+		}
+
+		for(auto it = _image_heaps.begin(); it != _image_heaps.end(); ++it) {
+			if(it->resource->schedule() == schedule.get()) {
+				auto heap = std::move(it->resource);
+				_stats.pooled_byte_size -= it->byte_size;
+				_image_heaps.erase_unordered(it);
+				++_stats.heap_hits;
+				return heap;
+			}
+		}
+		++_stats.heap_misses;
 	}
 
-	return buffer;
+	auto heap = std::make_unique<FrameGraphImageHeap>(device(), schedule);
+
+	// Schedules with different signatures (after a resize for example) can still share memory, picks the smallest heap that fits
+	std::unique_ptr<FrameGraphImageHeap> recycled;
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+
+		const VkMemoryRequirements& reqs = heap->memory_requirements();
+		const usize max_byte_size = reqs.size + usize(reqs.size * heap_slack);
+
+		auto best = _image_heaps.end();
+		for(auto it = _image_heaps.begin(); it != _image_heaps.end(); ++it) {
+			if(it->byte_size <= max_byte_size && it->resource->can_recycle_for(reqs)) {
+				if(best == _image_heaps.end() || it->byte_size < best->byte_size) {
+					best = it;
+				}
+			}
+		}
+
+		if(best != _image_heaps.end()) {
+			recycled = std::move(best->resource);
+			_stats.pooled_byte_size -= best->byte_size;
+			_image_heaps.erase_unordered(best);
+			++_stats.heap_recycles;
+		}
+	}
+
+	heap->bind_memory(std::move(recycled));
+
+	const ScheduleStats schedule_stats{schedule->hash(), heap->memory_requirements().size, heap->unaliased_byte_size(), schedule->pass_count(), schedule->culled_pass_count()};
+	log_msg(fmt("Frame graph images: %KB (%KB without aliasing), % passes culled out of %",
+		schedule_stats.byte_size / 1024, schedule_stats.unaliased_byte_size / 1024, schedule_stats.culled_pass_count, schedule_stats.pass_count), Log::Perf);
+
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+		const auto it = std::find_if(_schedule_stats.begin(), _schedule_stats.end(), [&](const auto& s) { return s.first.hash == schedule_stats.hash; });
+		if(it == _schedule_stats.end()) {
+			_schedule_stats.emplace_back(schedule_stats, _collection_id);
+		}
+	}
+
+	return heap;
 }
 
 bool FrameGraphResourcePool::create_image_from_pool(TransientImage<>& res, ImageFormat format, const math::Vec2ui& size, ImageUsage usage) {
 	y_profile();
-	for(auto it = _images.begin(); it != _images.end(); ++it) {
-		auto& img = it->first;
 
-		if(img.format() == format && img.size() == size && img.usage() == usage) {
+	const auto bucket = _images.find(image_key(format, size, usage));
+	if(bucket == _images.end()) {
+		return false;
+	}
 
+	auto& images = bucket->second;
+	for(auto it = images.begin(); it != images.end(); ++it) {
+		auto& img = it->resource;
+		if(img.format() == format && img.size() == size && img.usage() == usage) {
 			res = std::move(img);
-			_images.erase_unordered(it);
+			_stats.pooled_byte_size -= it->byte_size;
+			images.erase_unordered(it);
 
-			audit();
 			y_debug_assert(res.device());
-
 			return true;
 		}
 	}
 	return false;
 }
 
-
 bool FrameGraphResourcePool::create_buffer_from_pool(TransientBuffer& res, usize byte_size, BufferUsage usage, MemoryType memory) {
 	y_profile();
-	for(auto it = _buffers.begin(); it != _buffers.end(); ++it) {
-		auto& buffer = it->first;
-
-		if(buffer.byte_size() == byte_size &&
-		   buffer.usage() == usage &&
-		   (buffer.memory_type() == memory || memory == MemoryType::DontCare)) {
 
-			res = std::move(buffer);
-			_buffers.erase_unordered(it);
-
-			audit();
-			y_debug_assert(res.device());
+	const usize max_byte_size = byte_size + usize(byte_size * _buffer_slack);
+	const usize max_class = size_class(max_byte_size);
+	for(usize cl = size_class(byte_size); cl <= max_class; ++cl) {
+		const auto bucket = _buffers.find(buffer_key(usage, memory, cl));
+		if(bucket == _buffers.end()) {
+			continue;
+		}
 
-			return true;
+		auto& buffers = bucket->second;
+		for(auto it = buffers.begin(); it != buffers.end(); ++it) {
+			auto& buffer = it->resource;
+			if(buffer.byte_size() >= byte_size &&
+			   buffer.byte_size() <= max_byte_size &&
+			   buffer.usage() == usage &&
+			   buffer.memory_type() == memory) {
+
+				res = std::move(buffer);
+				_stats.pooled_byte_size -= it->byte_size;
+				buffers.erase_unordered(it);
+
+				y_debug_assert(res.device());
+				return true;
+			}
 		}
 	}
 	return false;
@@ -113,59 +229,166 @@ bool FrameGraphResourcePool::create_buffer_from_pool(TransientBuffer& res, usize
 
 
 void FrameGraphResourcePool::release(TransientImage<> image) {
-	const auto lock = y_profile_unique_lock(_lock);
+	const usize byte_size = image.device_memory().vk_size();
+	const u64 key = image_key(image.format(), image.size(), image.usage());
 
-	_images.emplace_back(std::move(image), _collection_id);
-	audit();
+	const auto lock = y_profile_unique_lock(_lock);
+	_images[key].emplace_back(Pooled<TransientImage<>>{std::move(image), _collection_id, byte_size});
+	_stats.pooled_byte_size += byte_size;
 }
 
 void FrameGraphResourcePool::release(TransientBuffer buffer) {
+	const usize byte_size = buffer.device_memory().vk_size();
+	const u64 key = buffer_key(buffer.usage(), buffer.memory_type(), size_class(buffer.byte_size()));
+
 	const auto lock = y_profile_unique_lock(_lock);
+	_buffers[key].emplace_back(Pooled<TransientBuffer>{std::move(buffer), _collection_id, byte_size});
+	_stats.pooled_byte_size += byte_size;
+}
 
-	_buffers.emplace_back(std::move(buffer), _collection_id);
-	audit();
+void FrameGraphResourcePool::release(std::unique_ptr<FrameGraphImageHeap> heap) {
+	const usize byte_size = heap->byte_size();
+
+	const auto lock = y_profile_unique_lock(_lock);
+	_image_heaps.emplace_back(Pooled<std::unique_ptr<FrameGraphImageHeap>>{std::move(heap), _collection_id, byte_size});
+	_stats.pooled_byte_size += byte_size;
+}
+
+FrameGraphScheduleCache& FrameGraphResourcePool::schedule_cache() {
+	return _schedule_cache;
 }
 
 void FrameGraphResourcePool::garbage_collect() {
 	y_profile();
 	const auto lock = y_profile_unique_lock(_lock);
 
-	audit();
-
-	const u64 max_col_count = 3;
+	evict_over_budget();
 
-	for(usize i = 0; i < _images.size(); ++i) {
-		if(_images[i].second + max_col_count < _collection_id) {
-			_images.erase_unordered(_images.begin() + i);
+	// Graphs can alternate between a few shapes (resize, lights toggling shadows, etc) so keep schedules a bit longer
+	const u64 max_schedule_col_count = 64;
+	_schedule_cache.garbage_collect(max_schedule_col_count);
+	for(usize i = 0; i < _schedule_stats.size(); ++i) {
+		if(_schedule_stats[i].second + max_schedule_col_count < _collection_id) {
+			_schedule_stats.erase_unordered(_schedule_stats.begin() + i);
 			--i;
 		}
 	}
 
-	for(usize i = 0; i < _buffers.size(); ++i) {
-		if(_buffers[i].second + max_col_count < _collection_id) {
-			_buffers.erase_unordered(_buffers.begin() + i);
+	// Heaps that don't get recycled are dropped along with their schedule
+	for(usize i = 0; i < _image_heaps.size(); ++i) {
+		if(_image_heaps[i].collection_id + max_schedule_col_count < _collection_id) {
+			_stats.pooled_byte_size -= _image_heaps[i].byte_size;
+			_image_heaps.erase_unordered(_image_heaps.begin() + i);
+			++_stats.evictions;
 			--i;
 		}
 	}
 
 	++_collection_id;
+}
 
-	audit();
+void FrameGraphResourcePool::set_budget(usize byte_size) {
+	const auto lock = y_profile_unique_lock(_lock);
+	_budget = byte_size;
+}
+
+void FrameGraphResourcePool::set_buffer_slack(float slack) {
+	const auto lock = y_profile_unique_lock(_lock);
+	_buffer_slack = std::max(0.0f, slack);
 }
 
-void FrameGraphResourcePool::audit() const {
-/*#ifdef Y_DEBUG
-	for(const auto& [res, col] : _images) {
-		unused(res, col);
-		y_debug_assert(res.device());
+FrameGraphResourcePool::Stats FrameGraphResourcePool::stats() const {
+	const auto lock = y_profile_unique_lock(_lock);
+
+	Stats stats = _stats;
+	for(const auto& [key, images] : _images) {
+		unused(key);
+		stats.pooled_images += images.size();
+	}
+	for(const auto& [key, buffers] : _buffers) {
+		unused(key);
+		stats.pooled_buffers += buffers.size();
 	}
-	for(const auto& [res, col] : _buffers) {
-		unused(res, col);
-		y_debug_assert(res.device());
+	stats.pooled_heaps = _image_heaps.size();
+	stats.budget = _budget;
+
+	auto sorted = _schedule_stats;
+	std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+	for(const auto& [schedule_stats, col] : sorted) {
+		unused(col);
+		stats.schedules << schedule_stats;
 	}
-#endif*/
+
+	return stats;
 }
 
+// Called with _lock held
+void FrameGraphResourcePool::evict_over_budget() {
+	y_profile();
+
+	while(_stats.pooled_byte_size > _budget) {
+		if(!evict_oldest()) {
+			break;
+		}
+	}
+}
+
+// Called with _lock held
+bool FrameGraphResourcePool::evict_oldest() {
+	enum class Kind { None, Image, Buffer, Heap };
+
+	Kind kind = Kind::None;
+	u64 oldest = u64(-1);
+	u64 bucket = 0;
+	usize index = 0;
+
+	const auto check = [&](Kind k, u64 key, usize i, u64 collection_id) {
+		if(collection_id < oldest) {
+			oldest = collection_id;
+			kind = k;
+			bucket = key;
+			index = i;
+		}
+	};
+
+	for(const auto& [key, images] : _images) {
+		for(usize i = 0; i != images.size(); ++i) {
+			check(Kind::Image, key, i, images[i].collection_id);
+		}
+	}
+	for(const auto& [key, buffers] : _buffers) {
+		for(usize i = 0; i != buffers.size(); ++i) {
+			check(Kind::Buffer, key, i, buffers[i].collection_id);
+		}
+	}
+	for(usize i = 0; i != _image_heaps.size(); ++i) {
+		check(Kind::Heap, 0, i, _image_heaps[i].collection_id);
+	}
+
+	const auto evict = [this](auto& vec, usize i) {
+		_stats.pooled_byte_size -= vec[i].byte_size;
+		vec.erase_unordered(vec.begin() + i);
+		++_stats.evictions;
+	};
+
+	switch(kind) {
+		case Kind::Image:
+			evict(_images[bucket], index);
+		break;
+
+		case Kind::Buffer:
+			evict(_buffers[bucket], index);
+		break;
+
+		case Kind::Heap:
+			evict(_image_heaps, index);
+		break;
+
+		default:
+			return false;
+	}
+
+	return true;
 }
 
-#undef CHECK_NON_CONCURENT
+}
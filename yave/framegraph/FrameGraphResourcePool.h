@@ -29,40 +29,110 @@ SOFTWARE.
 #include <yave/graphics/framebuffer/Framebuffer.h>
 
 #include "FrameGraphResourceToken.h"
+#include "FrameGraphSchedule.h"
+#include "FrameGraphImageHeap.h"
 #include "FrameGraphPass.h"
 
+#include <y/core/HashMap.h>
+
 #include <mutex>
 
 namespace yave {
 
 class FrameGraphResourcePool : NonMovable, public DeviceLinked {
 
+	template<typename T>
+	struct Pooled {
+		T resource;
+		u64 collection_id = 0;
+		usize byte_size = 0;
+	};
+
+	template<typename T>
+	using Buckets = core::ExternalHashMap<u64, core::Vector<Pooled<T>>>;
+
 	public:
+		static constexpr usize default_budget = 256 * 1024 * 1024;
+		static constexpr float default_buffer_slack = 0.5f;
+
+		// Footprint of the images of a schedule, measured when its first heap was created
+		struct ScheduleStats {
+			u64 hash = 0;
+			usize byte_size = 0;
+			usize unaliased_byte_size = 0;
+			usize pass_count = 0;
+			usize culled_pass_count = 0;
+		};
+
+		struct Stats {
+			usize image_hits = 0;
+			usize image_misses = 0;
+			usize buffer_hits = 0;
+			usize buffer_misses = 0;
+			usize heap_hits = 0;
+			usize heap_recycles = 0;
+			usize heap_misses = 0;
+			usize evictions = 0;
+
+			usize pooled_images = 0;
+			usize pooled_buffers = 0;
+			usize pooled_heaps = 0;
+			usize pooled_byte_size = 0;
+			usize budget = 0;
+
+			// Schedules used recently, most recent first
+			core::Vector<ScheduleStats> schedules;
+		};
+
 		FrameGraphResourcePool(DevicePtr dptr);
 		~FrameGraphResourcePool();
 
 
 		TransientImage<> create_image(ImageFormat format, const math::Vec2ui& size, ImageUsage usage);
+
+		// The returned buffer might be larger than byte_size (see set_buffer_slack)
 		TransientBuffer create_buffer(usize byte_size, BufferUsage usage, MemoryType memory);
 
+		// Reuses the heap of the same schedule if pooled, or the memory of any pooled heap that is big enough
+		std::unique_ptr<FrameGraphImageHeap> create_image_heap(const std::shared_ptr<const FrameGraphSchedule>& schedule);
+
 		void release(TransientImage<> image);
 		void release(TransientBuffer buffer);
+		void release(std::unique_ptr<FrameGraphImageHeap> heap);
+
+		FrameGraphScheduleCache& schedule_cache();
 
 		void garbage_collect();
 
+		// Pooled resources are evicted (oldest first) once their total size exceeds the budget
+		void set_budget(usize byte_size);
+
+		// Pooled buffers up to (1 + slack) times the requested size can be reused
+		void set_buffer_slack(float slack);
+
+		Stats stats() const;
+
 	private:
 		bool create_image_from_pool(TransientImage<>& res, ImageFormat format, const math::Vec2ui& size, ImageUsage usage);
 		bool create_buffer_from_pool(TransientBuffer& res, usize byte_size, BufferUsage usage, MemoryType memory);
 
-		core::Vector<std::pair<TransientImage<>, u64>> _images;
-		core::Vector<std::pair<TransientBuffer, u64>> _buffers;
+		void evict_over_budget();
+		bool evict_oldest();
+
+		Buckets<TransientImage<>> _images;
+		Buckets<TransientBuffer> _buffers;
+		core::Vector<Pooled<std::unique_ptr<FrameGraphImageHeap>>> _image_heaps;
+		FrameGraphScheduleCache _schedule_cache;
+		core::Vector<std::pair<ScheduleStats, u64>> _schedule_stats;
 
 		u64 _collection_id = 0;
 
-		void audit() const;
+		usize _budget = default_budget;
+		float _buffer_slack = default_buffer_slack;
+
+		Stats _stats;
 
-		Y_TODO(Find a way to not lock on every method call)
-		std::recursive_mutex _lock;
+		mutable std::mutex _lock;
 };
 
 }
@@ -0,0 +1,102 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FrameGraphSchedule.h"
+
+#include <y/utils/perf.h>
+
+namespace yave {
+
+FrameGraphSchedule::FrameGraphSchedule(u64 hash, core::Vector<u64> signature) : _hash(hash), _signature(std::move(signature)) {
+}
+
+u64 FrameGraphSchedule::hash() const {
+	return _hash;
+}
+
+bool FrameGraphSchedule::matches(core::Span<u64> signature) const {
+	return signature.size() == _signature.size() && std::equal(signature.begin(), signature.end(), _signature.begin());
+}
+
+core::Span<FrameGraphSchedule::ImageAlloc> FrameGraphSchedule::images() const {
+	return _images;
+}
+
+core::Span<FrameGraphSchedule::BufferAlloc> FrameGraphSchedule::buffers() const {
+	return _buffers;
+}
+
+usize FrameGraphSchedule::pass_count() const {
+	return _passes.size();
+}
+
+usize FrameGraphSchedule::culled_pass_count() const {
+	return std::count_if(_passes.begin(), _passes.end(), [](const PassSchedule& pass) { return pass.culled; });
+}
+
+const FrameGraphSchedule::PassSchedule& FrameGraphSchedule::pass(usize index) const {
+	y_debug_assert(index < _passes.size());
+	return _passes[index];
+}
+
+usize FrameGraphSchedule::slot_count() const {
+	return _slot_count;
+}
+
+
+
+std::shared_ptr<const FrameGraphSchedule> FrameGraphScheduleCache::find(u64 hash, core::Span<u64> signature) {
+	const auto lock = y_profile_unique_lock(_lock);
+
+	for(auto& [schedule, col] : _schedules) {
+		if(schedule->hash() == hash && schedule->matches(signature)) {
+			col = _collection_id;
+			return schedule;
+		}
+	}
+	return nullptr;
+}
+
+void FrameGraphScheduleCache::add(std::shared_ptr<const FrameGraphSchedule> schedule) {
+	const auto lock = y_profile_unique_lock(_lock);
+	_schedules.emplace_back(std::move(schedule), _collection_id);
+}
+
+void FrameGraphScheduleCache::garbage_collect(u64 max_age) {
+	const auto lock = y_profile_unique_lock(_lock);
+
+	for(usize i = 0; i < _schedules.size(); ++i) {
+		if(_schedules[i].second + max_age < _collection_id) {
+			_schedules.erase_unordered(_schedules.begin() + i);
+			--i;
+		}
+	}
+
+	++_collection_id;
+}
+
+usize FrameGraphScheduleCache::size() const {
+	const auto lock = y_profile_unique_lock(_lock);
+	return _schedules.size();
+}
+
+}
@@ -0,0 +1,135 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_FRAMEGRAPH_FRAMEGRAPHSCHEDULE_H
+#define YAVE_FRAMEGRAPH_FRAMEGRAPHSCHEDULE_H
+
+#include "FrameGraphResourceId.h"
+
+#include <y/core/Vector.h>
+
+#include <memory>
+#include <mutex>
+
+namespace yave {
+
+// Everything FrameGraph::render needs that only depends on the structure of the graph:
+// culled passes, resource allocation and aliasing, image copies and barriers for every pass.
+// Contains no device object so it can be reused by any graph with the same signature.
+class FrameGraphSchedule : NonCopyable {
+	public:
+		static constexpr u32 no_slot = u32(-1);
+
+		struct ImageAlloc {
+			FrameGraphImageId res;
+			FrameGraphImageId alias;
+
+			// Images in the same slot have disjoint lifetimes and share memory
+			u32 slot = no_slot;
+
+			math::Vec2ui size;
+			ImageFormat format;
+			ImageUsage usage = ImageUsage::None;
+		};
+
+		struct BufferAlloc {
+			FrameGraphBufferId res;
+
+			usize byte_size = 0;
+			BufferUsage usage = BufferUsage::None;
+			MemoryType memory_type = MemoryType::DontCare;
+		};
+
+		template<typename T>
+		struct BarrierInfo {
+			T res;
+			PipelineStage src = PipelineStage::None;
+			PipelineStage dst = PipelineStage::None;
+		};
+
+		struct ImageCopy {
+			FrameGraphImageId src;
+			FrameGraphImageId dst;
+		};
+
+		struct PassSchedule {
+			bool culled = false;
+
+			// Images whose memory might have been used by another image, their content is discarded before the pass
+			core::Vector<FrameGraphImageId> discarded;
+
+			core::Vector<ImageCopy> copies;
+			core::Vector<BarrierInfo<FrameGraphImageId>> image_barriers;
+			core::Vector<BarrierInfo<FrameGraphBufferId>> buffer_barriers;
+
+			// Attachments that are first written by this pass and should be cleared
+			core::Vector<FrameGraphImageId> cleared;
+		};
+
+		u64 hash() const;
+		bool matches(core::Span<u64> signature) const;
+
+		// In order of first use, aliases always come after the image they alias
+		core::Span<ImageAlloc> images() const;
+		core::Span<BufferAlloc> buffers() const;
+
+		usize pass_count() const;
+		usize culled_pass_count() const;
+		const PassSchedule& pass(usize index) const;
+
+		usize slot_count() const;
+
+	private:
+		friend class FrameGraphScheduleBuilder;
+
+		FrameGraphSchedule(u64 hash, core::Vector<u64> signature);
+
+		u64 _hash = 0;
+		core::Vector<u64> _signature;
+
+		core::Vector<ImageAlloc> _images;
+		core::Vector<BufferAlloc> _buffers;
+		core::Vector<PassSchedule> _passes;
+
+		usize _slot_count = 0;
+};
+
+// Recently used schedules, graphs alternate between a few shapes (resize, lights toggling shadows, etc)
+class FrameGraphScheduleCache : NonCopyable {
+	public:
+		std::shared_ptr<const FrameGraphSchedule> find(u64 hash, core::Span<u64> signature);
+		void add(std::shared_ptr<const FrameGraphSchedule> schedule);
+
+		// Drops schedules that haven't been used in the last max_age collections
+		void garbage_collect(u64 max_age);
+
+		usize size() const;
+
+	private:
+		core::Vector<std::pair<std::shared_ptr<const FrameGraphSchedule>, u64>> _schedules;
+		u64 _collection_id = 0;
+
+		mutable std::mutex _lock;
+};
+
+}
+
+#endif // YAVE_FRAMEGRAPH_FRAMEGRAPHSCHEDULE_H
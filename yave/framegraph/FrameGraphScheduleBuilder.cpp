@@ -0,0 +1,613 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FrameGraphScheduleBuilder.h"
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/utils/hash.h>
+#include <y/utils/perf.h>
+
+#include <unordered_set>
+
+namespace yave {
+
+static void check_usage_io(ImageUsage usage, bool is_output) {
+	unused(usage, is_output);
+	switch(usage) {
+		case ImageUsage::TextureBit:
+		case ImageUsage::TransferSrcBit:
+			y_debug_assert(!is_output);
+		break;
+
+		case ImageUsage::DepthBit:
+		case ImageUsage::ColorBit:
+		case ImageUsage::TransferDstBit:
+			y_debug_assert(is_output);
+		break;
+
+		default:
+		break;
+	}
+}
+
+static void check_usage_io(BufferUsage usage, bool is_output) {
+	unused(usage, is_output);
+	switch(usage) {
+		case BufferUsage::AttributeBit:
+		case BufferUsage::IndexBit:
+		case BufferUsage::IndirectBit:
+		case BufferUsage::UniformBit:
+		case BufferUsage::TransferSrcBit:
+			y_debug_assert(!is_output);
+		break;
+
+		case BufferUsage::TransferDstBit:
+			y_debug_assert(is_output);
+		break;
+
+		default:
+		break;
+	}
+}
+
+template<typename U>
+static bool is_none(U u) {
+	return u == U::None;
+}
+
+template<typename T, typename C>
+static auto&& check_exists(C& c, T t) {
+	const auto it = c.find(t);
+	if(it == c.end()) {
+		y_fatal("Resource doesn't exist.");
+	}
+	return it->second;
+}
+
+using BarrierState = std::unordered_map<FrameGraphResourceId, PipelineStage>;
+
+template<typename C, typename B>
+static void build_barriers(const C& resources, B& barriers, BarrierState& to_barrier) {
+	for(auto&& [res, info] : resources) {
+		const auto it = to_barrier.find(res);
+		bool exists = it != to_barrier.end();
+		// barrier around attachments are handled by the renderpass
+		const PipelineStage stage = info.stage & ~PipelineStage::AllAttachmentOutBit;
+		if(stage == PipelineStage::None) {
+			if(exists) {
+				to_barrier.erase(it);
+			}
+			continue;
+		}
+
+		if(exists) {
+			barriers.push_back({res, it->second, info.stage});
+			it->second = info.stage;
+		} else {
+			to_barrier[res] = info.stage;
+		}
+	}
+}
+
+template<typename T>
+static void push_signature(core::Vector<u64>& signature, const T& resources) {
+	auto sorted = core::vector_with_capacity<std::tuple<u32, PipelineStage, bool>>(resources.size());
+	for(auto&& [res, info] : resources) {
+		sorted.emplace_back(res.id(), info.stage, info.written);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+
+	signature << sorted.size();
+	for(const auto& [id, stage, written] : sorted) {
+		signature << id << u64(stage) << written;
+	}
+}
+
+usize FrameGraphScheduleBuilder::add_pass(std::string_view name) {
+	PassInfo& pass = _passes.emplace_back();
+	pass.name = name;
+	pass.index = _passes.size();
+	return pass.index;
+}
+
+const FrameGraphScheduleBuilder::PassInfo& FrameGraphScheduleBuilder::pass(usize pass_index) const {
+	if(!pass_index || pass_index > _passes.size()) {
+		y_fatal("Pass index out of bounds (%).", pass_index);
+	}
+	return _passes[pass_index - 1];
+}
+
+FrameGraphScheduleBuilder::PassInfo& FrameGraphScheduleBuilder::pass_info(usize pass_index) {
+	return const_cast<PassInfo&>(pass(pass_index));
+}
+
+usize FrameGraphScheduleBuilder::pass_count() const {
+	return _passes.size();
+}
+
+FrameGraphMutableImageId FrameGraphScheduleBuilder::declare_image(ImageFormat format, const math::Vec2ui& size) {
+	FrameGraphMutableImageId res;
+	res._id = _next_id++;
+	auto& r = _images[res];
+	r.size = size;
+	r.format = format;
+	return res;
+}
+
+FrameGraphMutableBufferId FrameGraphScheduleBuilder::declare_buffer(usize byte_size) {
+	FrameGraphMutableBufferId res;
+	res._id = _next_id++;
+	auto& r = _buffers[res];
+	r.byte_size = byte_size;
+	return res;
+}
+
+template<typename T>
+static void set_stage(const FrameGraphScheduleBuilder::PassInfo& pass, T& info, PipelineStage stage) {
+	if(info.stage != PipelineStage::None) {
+		Y_TODO(This should be either one write or many reads)
+		y_fatal("Resource can only be used once per pass (used twice by \"%\", previous stage was %).", pass.name, usize(info.stage));
+	}
+	info.stage = stage;
+}
+
+void FrameGraphScheduleBuilder::add_usage(usize pass_index, FrameGraphImageId res, ImageUsage usage, bool is_written, PipelineStage stage) {
+	res.check_valid();
+	check_usage_io(usage, is_written);
+
+	PassInfo& pass = pass_info(pass_index);
+	auto& pass_usage = pass.images[res];
+	set_stage(pass, pass_usage, stage);
+	pass_usage.written |= is_written;
+
+	auto& info = image_info(res);
+	info.usage = info.usage | usage;
+
+	const bool can_alias = info.last_use() != pass_index || info.can_alias_on_last;
+	info.register_use(pass_index, is_written);
+
+	// copies are done before the pass so we can alias even if the image is copied
+	if(can_alias && usage == ImageUsage::TransferSrcBit) {
+		info.can_alias_on_last = true;
+	}
+}
+
+void FrameGraphScheduleBuilder::add_usage(usize pass_index, FrameGraphBufferId res, BufferUsage usage, bool is_written, PipelineStage stage) {
+	res.check_valid();
+	check_usage_io(usage, is_written);
+
+	PassInfo& pass = pass_info(pass_index);
+	auto& pass_usage = pass.buffers[res];
+	set_stage(pass, pass_usage, stage);
+	pass_usage.written |= is_written;
+
+	auto& info = buffer_info(res);
+	info.usage = info.usage | usage;
+	info.register_use(pass_index, is_written);
+}
+
+void FrameGraphScheduleBuilder::add_image_copy(usize pass_index, FrameGraphMutableImageId dst, FrameGraphImageId src) {
+	auto& info = image_info(dst);
+	if(info.copy_src.is_valid()) {
+		y_fatal("Resource is already a copy.");
+	}
+	info.copy_src = src;
+	_image_copies.push_back({pass_index, dst, src});
+}
+
+void FrameGraphScheduleBuilder::set_cpu_visible(usize pass_index, FrameGraphMutableBufferId res) {
+	pass_info(pass_index).mapped_buffers << res;
+
+	auto& info = buffer_info(res);
+	info.memory_type = MemoryType::CpuVisible;
+	info.register_use(pass_index, true);
+}
+
+void FrameGraphScheduleBuilder::set_has_side_effects(usize pass_index) {
+	pass_info(pass_index).has_side_effects = true;
+}
+
+const FrameGraphScheduleBuilder::ImageCreateInfo& FrameGraphScheduleBuilder::info(FrameGraphImageId res) const {
+	return check_exists(_images, res);
+}
+
+const FrameGraphScheduleBuilder::BufferCreateInfo& FrameGraphScheduleBuilder::info(FrameGraphBufferId res) const {
+	return check_exists(_buffers, res);
+}
+
+FrameGraphScheduleBuilder::ImageCreateInfo& FrameGraphScheduleBuilder::image_info(FrameGraphImageId res) {
+	return check_exists(_images, res);
+}
+
+FrameGraphScheduleBuilder::BufferCreateInfo& FrameGraphScheduleBuilder::buffer_info(FrameGraphBufferId res) {
+	return check_exists(_buffers, res);
+}
+
+static u64 signature_hash(core::Span<u64> signature) {
+	u64 hash = 0xfe7c3b2a91d04e65;
+	for(const u64 s : signature) {
+		hash_combine(hash, s);
+	}
+	return hash;
+}
+
+std::shared_ptr<FrameGraphSchedule> FrameGraphScheduleBuilder::build() const {
+	core::Vector<u64> signature = build_signature();
+	const u64 hash = signature_hash(signature);
+
+	auto schedule = std::shared_ptr<FrameGraphSchedule>(new FrameGraphSchedule(hash, std::move(signature)));
+	build_schedule(*schedule);
+	return schedule;
+}
+
+std::shared_ptr<const FrameGraphSchedule> FrameGraphScheduleBuilder::build(FrameGraphScheduleCache& cache) const {
+	y_profile();
+
+	core::Vector<u64> signature = build_signature();
+	const u64 hash = signature_hash(signature);
+
+	if(auto schedule = cache.find(hash, signature)) {
+		return schedule;
+	}
+
+	y_profile_zone("build schedule");
+	auto schedule = std::shared_ptr<FrameGraphSchedule>(new FrameGraphSchedule(hash, std::move(signature)));
+	build_schedule(*schedule);
+	cache.add(schedule);
+	return schedule;
+}
+
+core::Vector<u64> FrameGraphScheduleBuilder::build_signature() const {
+	y_profile();
+
+	core::Vector<u64> signature;
+
+	{
+		auto images = core::vector_with_capacity<std::pair<FrameGraphImageId, const ImageCreateInfo*>>(_images.size());
+		for(const auto& [res, info] : _images) {
+			images.emplace_back(res, &info);
+		}
+		std::sort(images.begin(), images.end(), [](const auto& a, const auto& b) { return a.first.id() < b.first.id(); });
+
+		signature << images.size();
+		for(const auto& [res, info] : images) {
+			signature << res.id() << u64(info->format.vk_format()) << info->size.x() << info->size.y() << u64(info->usage);
+			signature << info->first_use << info->last_read << info->last_write << info->can_alias_on_last << info->copy_src.id();
+		}
+	}
+
+	{
+		auto buffers = core::vector_with_capacity<std::pair<FrameGraphBufferId, const BufferCreateInfo*>>(_buffers.size());
+		for(const auto& [res, info] : _buffers) {
+			buffers.emplace_back(res, &info);
+		}
+		std::sort(buffers.begin(), buffers.end(), [](const auto& a, const auto& b) { return a.first.id() < b.first.id(); });
+
+		signature << buffers.size();
+		for(const auto& [res, info] : buffers) {
+			signature << res.id() << info->byte_size << u64(info->usage) << u64(info->memory_type);
+			signature << info->first_use << info->last_read << info->last_write;
+		}
+	}
+
+	signature << _passes.size();
+	for(const PassInfo& pass : _passes) {
+		signature << pass.index << pass.has_side_effects;
+		push_signature(signature, pass.images);
+		push_signature(signature, pass.buffers);
+
+		signature << pass.mapped_buffers.size();
+		for(const FrameGraphBufferId res : pass.mapped_buffers) {
+			signature << res.id();
+		}
+	}
+
+	signature << _image_copies.size();
+	for(const auto& cpy : _image_copies) {
+		signature << cpy.pass_index << cpy.dst.id() << cpy.src.id();
+	}
+
+	return signature;
+}
+
+void FrameGraphScheduleBuilder::build_schedule(FrameGraphSchedule& schedule) const {
+	y_profile();
+
+	std::unordered_map<usize, usize> pass_positions;
+	for(usize i = 0; i != _passes.size(); ++i) {
+		pass_positions[_passes[i].index] = i;
+		schedule._passes.emplace_back();
+	}
+
+	// Dead pass elimination: walks the graph backward and only keeps passes that write something read by a later live pass
+	{
+		y_profile_zone("culling");
+
+		std::unordered_set<FrameGraphResourceId, hash_t> needed;
+		for(usize i = _passes.size(); i != 0; --i) {
+			const PassInfo& pass = _passes[i - 1];
+
+			bool has_writes = !pass.mapped_buffers.is_empty();
+			bool alive = pass.has_side_effects;
+
+			auto check_writes = [&](const auto& resources) {
+				for(auto&& [res, info] : resources) {
+					if(info.written) {
+						has_writes = true;
+						alive |= needed.find(res) != needed.end();
+					}
+				}
+			};
+			check_writes(pass.images);
+			check_writes(pass.buffers);
+			for(const FrameGraphBufferId res : pass.mapped_buffers) {
+				alive |= needed.find(res) != needed.end();
+			}
+
+			// Passes that do not write anything in the graph have to write somewhere else
+			if(!alive && has_writes) {
+				schedule._passes[i - 1].culled = true;
+				continue;
+			}
+
+			// Written resources might be loaded by the pass, so we need the previous writers too
+			for(auto&& [res, info] : pass.images) {
+				needed.insert(res);
+			}
+			for(auto&& [res, info] : pass.buffers) {
+				needed.insert(res);
+			}
+		}
+	}
+
+	auto is_culled = [&](usize pass_index) {
+		return schedule._passes[pass_positions[pass_index]].culled;
+	};
+
+	auto images = _images;
+
+	auto copies = core::vector_with_capacity<ImageCopyInfo>(_image_copies.size());
+	std::copy_if(_image_copies.begin(), _image_copies.end(), std::back_inserter(copies), [&](const ImageCopyInfo& cpy) { return !is_culled(cpy.pass_index); });
+	std::stable_sort(copies.begin(), copies.end(), [&](const auto& a, const auto& b) { return a.pass_index < b.pass_index; });
+
+	for(const auto& cpy : copies) {
+		y_debug_assert(cpy.pass_index <= check_exists(images, cpy.dst).first_use);
+
+		auto& dst_info = check_exists(images, cpy.dst);
+		auto* src_info = &check_exists(images, cpy.src);
+
+		if(src_info->alias.is_valid()) {
+			src_info = &check_exists(images, src_info->alias);
+		}
+
+		usize src_last_use = src_info->last_use();
+		if(src_last_use < dst_info.first_use || (src_last_use == dst_info.first_use && src_info->can_alias_on_last)) {
+			src_info->register_alias(dst_info);
+
+			dst_info.alias = dst_info.copy_src;
+			dst_info.copy_src = FrameGraphImageId();
+		}
+	}
+
+	// Resolves aliases to the image that actually gets created
+	auto root = [&](FrameGraphImageId res) {
+		while(true) {
+			const FrameGraphImageId alias = check_exists(images, res).alias;
+			if(!alias.is_valid()) {
+				return res;
+			}
+			res = alias;
+		}
+	};
+
+	// Lifetimes of created images in live passes, images used by passes with side effects live until the end of the graph
+	std::unordered_map<FrameGraphResourceId, std::pair<usize, usize>, hash_t> lifetimes;
+	std::unordered_set<FrameGraphResourceId, hash_t> used_buffers;
+	for(usize i = 0; i != _passes.size(); ++i) {
+		if(schedule._passes[i].culled) {
+			continue;
+		}
+
+		const PassInfo& pass = _passes[i];
+		const usize end = pass.has_side_effects ? _passes.size() : i;
+		for(auto&& [res, info] : pass.images) {
+			const auto [it, inserted] = lifetimes.emplace(root(res), std::pair<usize, usize>(i, end));
+			if(!inserted) {
+				it->second.second = std::max(it->second.second, end);
+			}
+		}
+		for(auto&& [res, info] : pass.buffers) {
+			used_buffers.insert(res);
+		}
+		for(const FrameGraphBufferId res : pass.mapped_buffers) {
+			used_buffers.insert(res);
+		}
+	}
+
+	// Assigns images to memory slots so that images with disjoint lifetimes share memory (interval graph coloring).
+	// Larger images are placed first so that slot sizes are mostly decided by the first image.
+	std::unordered_map<FrameGraphResourceId, u32, hash_t> slots;
+	{
+		y_profile_zone("aliasing");
+
+		struct Lifetime {
+			FrameGraphImageId res;
+			usize first = 0;
+			usize last = 0;
+			u64 byte_size = 0;
+		};
+
+		auto sorted = core::vector_with_capacity<Lifetime>(lifetimes.size());
+		for(const auto& [id, lifetime] : lifetimes) {
+			FrameGraphImageId res;
+			res._id = id.id();
+			const ImageCreateInfo& info = check_exists(images, res);
+			const u64 byte_size = u64(info.size.x()) * u64(info.size.y()) * info.format.bit_per_pixel() / 8;
+			sorted.push_back({res, lifetime.first, lifetime.second, byte_size});
+		}
+		std::sort(sorted.begin(), sorted.end(), [](const Lifetime& a, const Lifetime& b) {
+			if(a.byte_size != b.byte_size) {
+				return a.byte_size > b.byte_size;
+			}
+			return a.res.id() < b.res.id();
+		});
+
+		core::Vector<core::Vector<std::pair<usize, usize>>> slot_lifetimes;
+		for(const Lifetime& lifetime : sorted) {
+			auto overlaps = [&](const std::pair<usize, usize>& other) {
+				return !(other.second < lifetime.first || lifetime.last < other.first);
+			};
+
+			usize slot = 0;
+			for(; slot != slot_lifetimes.size(); ++slot) {
+				if(std::none_of(slot_lifetimes[slot].begin(), slot_lifetimes[slot].end(), overlaps)) {
+					break;
+				}
+			}
+			if(slot == slot_lifetimes.size()) {
+				slot_lifetimes.emplace_back();
+			}
+
+			slot_lifetimes[slot].emplace_back(lifetime.first, lifetime.last);
+			slots[lifetime.res] = u32(slot);
+
+			// Memory might have been used by another image since the last use, even in the same graph
+			schedule._passes[lifetime.first].discarded << lifetime.res;
+		}
+
+		schedule._slot_count = slot_lifetimes.size();
+	}
+
+	{
+		auto sorted = core::vector_with_capacity<std::pair<FrameGraphImageId, ImageCreateInfo*>>(images.size());
+		for(auto& [res, info] : images) {
+			if(lifetimes.find(root(res)) != lifetimes.end()) {
+				sorted.emplace_back(res, &info);
+			}
+		}
+		std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+			if(a.second->first_use != b.second->first_use) {
+				return a.second->first_use < b.second->first_use;
+			}
+			return a.first.id() < b.first.id();
+		});
+
+		for(auto&& [res, info] : sorted) {
+			if(!info->alias.is_valid() && !info->has_usage()) {
+				log_msg(fmt("Image declared by % has no usage.", pass(info->first_use).name), Log::Warning);
+				// All images should support texturing, hopefully
+				info->usage = info->usage | ImageUsage::TextureBit;
+			}
+
+			const auto slot = slots.find(res);
+			schedule._images.push_back({res, info->alias, slot == slots.end() ? FrameGraphSchedule::no_slot : slot->second, info->size, info->format, info->usage});
+
+			if(!info->is_aliased()) {
+				if(const auto it = pass_positions.find(info->first_use); it != pass_positions.end()) {
+					schedule._passes[it->second].cleared << res;
+				}
+			}
+		}
+	}
+
+	{
+		auto sorted = core::vector_with_capacity<std::pair<FrameGraphBufferId, BufferCreateInfo>>(_buffers.size());
+		std::copy_if(_buffers.begin(), _buffers.end(), std::back_inserter(sorted), [&](const auto& buffer) { return used_buffers.find(buffer.first) != used_buffers.end(); });
+		std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first.id() < b.first.id(); });
+
+		for(auto&& [res, info] : sorted) {
+			if(is_none(info.usage)) {
+				log_msg("Unused frame graph buffer resource.", Log::Warning);
+				info.usage = info.usage | BufferUsage::StorageBit;
+			}
+			schedule._buffers.push_back({res, info.byte_size, info.usage, info.memory_type});
+		}
+	}
+
+	BarrierState to_barrier;
+	usize copy_index = 0;
+	for(usize i = 0; i != _passes.size(); ++i) {
+		if(schedule._passes[i].culled) {
+			continue;
+		}
+
+		const PassInfo& pass = _passes[i];
+		FrameGraphSchedule::PassSchedule& pass_schedule = schedule._passes[i];
+
+		for(; copy_index < copies.size() && copies[copy_index].pass_index == pass.index; ++copy_index) {
+			const FrameGraphImageId src = copies[copy_index].src;
+			const FrameGraphImageId dst = copies[copy_index].dst;
+
+			Y_TODO(We might end up barriering twice here)
+			if(root(src) == root(dst)) {
+				// Nothing to copy, dst just inherits the pending barrier
+				if(const auto it = to_barrier.find(src); it != to_barrier.end()) {
+					to_barrier[dst] = it->second;
+					to_barrier.erase(src);
+				}
+			} else {
+				to_barrier.erase(src);
+				to_barrier.erase(dst);
+				pass_schedule.copies.push_back({src, dst});
+			}
+		}
+
+		build_barriers(pass.buffers, pass_schedule.buffer_barriers, to_barrier);
+		build_barriers(pass.images, pass_schedule.image_barriers, to_barrier);
+	}
+}
+
+
+
+usize FrameGraphScheduleBuilder::ResourceCreateInfo::last_use() const {
+	return std::max(last_read, last_write);
+}
+
+void FrameGraphScheduleBuilder::ResourceCreateInfo::register_use(usize index, bool is_written) {
+	usize& last = is_written ? last_write : last_read;
+	last = std::max(last, index);
+	if(!first_use) {
+		first_use = index;
+	}
+}
+
+void FrameGraphScheduleBuilder::ImageCreateInfo::register_alias(const ImageCreateInfo& other) {
+	y_debug_assert(other.size == size);
+	y_debug_assert(other.format == format);
+	y_debug_assert(other.first_use > last_write);
+
+	last_write = std::max(last_write, other.last_write);
+	last_read = std::max(last_read, other.last_read);
+	usage = usage | other.usage;
+	can_alias_on_last = false;
+}
+
+bool FrameGraphScheduleBuilder::ImageCreateInfo::is_aliased() const {
+	return copy_src.is_valid() || alias.is_valid();
+}
+
+bool FrameGraphScheduleBuilder::ImageCreateInfo::has_usage() const {
+	return (usage & ~ImageUsage::TransferDstBit) != ImageUsage::None;
+}
+
+}
@@ -0,0 +1,139 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_FRAMEGRAPH_FRAMEGRAPHSCHEDULEBUILDER_H
+#define YAVE_FRAMEGRAPH_FRAMEGRAPHSCHEDULEBUILDER_H
+
+#include "FrameGraphSchedule.h"
+
+#include <y/core/String.h>
+
+#include <unordered_map>
+#include <memory>
+
+namespace yave {
+
+// Declared structure of a frame graph: passes, resources and how passes use them.
+// Builds the FrameGraphSchedule of the graph without touching the device.
+class FrameGraphScheduleBuilder : NonCopyable {
+
+	using hash_t = std::hash<FrameGraphResourceId>;
+
+	public:
+		struct ResourceUsageInfo {
+			PipelineStage stage = PipelineStage::None;
+			bool written = false;
+		};
+
+		struct ResourceCreateInfo {
+			usize last_read = 0;
+			usize last_write = 0;
+			usize first_use = 0;
+
+			bool can_alias_on_last = false;
+
+			usize last_use() const;
+			void register_use(usize index, bool is_written);
+		};
+
+		struct ImageCreateInfo : ResourceCreateInfo {
+			math::Vec2ui size;
+			ImageFormat format;
+			ImageUsage usage = ImageUsage::None;
+
+			FrameGraphImageId copy_src;
+			FrameGraphImageId alias;
+
+			void register_alias(const ImageCreateInfo& other);
+			bool is_aliased() const;
+			bool has_usage() const;
+		};
+
+		struct BufferCreateInfo : ResourceCreateInfo {
+			usize byte_size = 0;
+			BufferUsage usage = BufferUsage::None;
+			MemoryType memory_type = MemoryType::DontCare;
+		};
+
+		struct PassInfo {
+			core::String name;
+			usize index = 0;
+
+			std::unordered_map<FrameGraphImageId, ResourceUsageInfo, hash_t> images;
+			std::unordered_map<FrameGraphBufferId, ResourceUsageInfo, hash_t> buffers;
+
+			// Buffers written by the CPU when the pass is recorded
+			core::Vector<FrameGraphBufferId> mapped_buffers;
+			bool has_side_effects = false;
+		};
+
+		// Returns the index of the new pass, pass indices start at 1
+		usize add_pass(std::string_view name);
+		const PassInfo& pass(usize pass_index) const;
+		usize pass_count() const;
+
+		FrameGraphMutableImageId declare_image(ImageFormat format, const math::Vec2ui& size);
+		FrameGraphMutableBufferId declare_buffer(usize byte_size);
+
+		void add_usage(usize pass_index, FrameGraphImageId res, ImageUsage usage, bool is_written, PipelineStage stage);
+		void add_usage(usize pass_index, FrameGraphBufferId res, BufferUsage usage, bool is_written, PipelineStage stage);
+		void add_image_copy(usize pass_index, FrameGraphMutableImageId dst, FrameGraphImageId src);
+		void set_cpu_visible(usize pass_index, FrameGraphMutableBufferId res);
+		void set_has_side_effects(usize pass_index);
+
+		const ImageCreateInfo& info(FrameGraphImageId res) const;
+		const BufferCreateInfo& info(FrameGraphBufferId res) const;
+
+		// Everything build reads, resource ids are allocated sequentially so identical graphs have identical signatures
+		core::Vector<u64> build_signature() const;
+
+		// Computes allocations, aliasing and barriers
+		std::shared_ptr<FrameGraphSchedule> build() const;
+
+		// Reuses the schedule of a previous graph with the same signature if there is one in the cache
+		std::shared_ptr<const FrameGraphSchedule> build(FrameGraphScheduleCache& cache) const;
+
+	private:
+		struct ImageCopyInfo {
+			usize pass_index = 0;
+			FrameGraphMutableImageId dst;
+			FrameGraphImageId src;
+		};
+
+		PassInfo& pass_info(usize pass_index);
+		ImageCreateInfo& image_info(FrameGraphImageId res);
+		BufferCreateInfo& buffer_info(FrameGraphBufferId res);
+
+		void build_schedule(FrameGraphSchedule& schedule) const;
+
+		core::Vector<PassInfo> _passes;
+
+		std::unordered_map<FrameGraphImageId, ImageCreateInfo, hash_t> _images;
+		std::unordered_map<FrameGraphBufferId, BufferCreateInfo, hash_t> _buffers;
+
+		core::Vector<ImageCopyInfo> _image_copies;
+
+		u32 _next_id = 0;
+};
+
+}
+
+#endif // YAVE_FRAMEGRAPH_FRAMEGRAPHSCHEDULEBUILDER_H
@@ -63,6 +63,15 @@ class TransientSubBuffer final : public SubBuffer<Usage, Memory> {
 				y_fatal("Invalid subbuffer memory type.");
 			}
 		}
+
+		TransientSubBuffer(const SubBufferBase& buffer, BufferUsage usage, MemoryType memory) : SubBuffer<Usage, Memory>(buffer) {
+			if(!this->has(usage, Usage)) {
+				y_fatal("Invalid subbuffer usage.");
+			}
+			if(!is_memory_type_compatible(memory, Memory)) {
+				y_fatal("Invalid subbuffer memory type.");
+			}
+		}
 };
 
 }
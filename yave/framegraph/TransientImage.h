@@ -64,6 +64,18 @@ class TransientImage final : public ImageBase {
 		const size_type& size() const {
 			return image_size().to<size_type::size()>();
 		}
+
+		// For images placed in memory shared with other images
+		static TransientImage create_unbound(DevicePtr dptr, ImageFormat format, ImageUsage usage, const size_type& image_size) {
+			return TransientImage(Unbound(), dptr, format, usage, image_size);
+		}
+
+		using ImageBase::memory_requirements;
+		using ImageBase::bind_memory;
+
+	private:
+		TransientImage(Unbound, DevicePtr dptr, ImageFormat format, ImageUsage usage, const size_type& image_size) : ImageBase(Unbound(), dptr, format, usage, to_3d_size(image_size)) {
+		}
 };
 
 template<ImageUsage Usage, ImageType Type = ImageType::TwoD>
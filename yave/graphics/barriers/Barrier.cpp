@@ -70,6 +70,9 @@ static VkAccessFlags vk_dst_access_flags(PipelineStage dst) {
 		case PipelineStage::TransferBit:
 			return VK_ACCESS_TRANSFER_READ_BIT;
 
+		case PipelineStage::DrawIndirectBit:
+			return VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
 		case PipelineStage::HostBit:
 			return VK_ACCESS_HOST_READ_BIT;
 
@@ -193,6 +196,14 @@ ImageBarrier ImageBarrier::transition_barrier(const ImageBase& image, VkImageLay
 	return barrier;
 }
 
+ImageBarrier ImageBarrier::discard_barrier(const ImageBase& image) {
+	ImageBarrier barrier = transition_from_barrier(image, VK_IMAGE_LAYOUT_UNDEFINED);
+	barrier._barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+	barrier._src = PipelineStage::All;
+
+	return barrier;
+}
+
 ImageBarrier ImageBarrier::transition_to_barrier(const ImageBase& image, VkImageLayout dst_layout) {
 	return transition_barrier(image, vk_image_layout(image.usage()), dst_layout);
 }
@@ -41,6 +41,9 @@ class ImageBarrier {
 		static ImageBarrier transition_to_barrier(const ImageBase& image, VkImageLayout dst_layout);
 		static ImageBarrier transition_from_barrier(const ImageBase& image, VkImageLayout src_layout);
 
+		// Waits for everything that might use the image memory and transitions from an undefined layout, discarding the content
+		static ImageBarrier discard_barrier(const ImageBase& image);
+
 
 		VkImageMemoryBarrier vk_barrier() const;
 
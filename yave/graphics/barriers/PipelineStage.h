@@ -35,6 +35,7 @@ enum class PipelineStage : u32{
 
 	TransferBit		= VK_PIPELINE_STAGE_TRANSFER_BIT,
 	HostBit			= VK_PIPELINE_STAGE_HOST_BIT,
+	DrawIndirectBit	= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
 	VertexInputBit	= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
 	VertexBit		= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
 	FragmentBit		= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
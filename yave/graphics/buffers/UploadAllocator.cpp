@@ -0,0 +1,172 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "UploadAllocator.h"
+
+#include <yave/device/Device.h>
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <algorithm>
+
+namespace yave {
+
+namespace detail {
+struct UploadChunk {
+	UploadChunk(DevicePtr dptr, usize size) : buffer(dptr, size) {
+	}
+
+	Buffer<UploadAllocator::usage, MemoryType::CpuVisible> buffer;
+	usize offset = 0;
+
+	// Number of frames that are using this chunk and may still be in flight
+	std::atomic<u32> frames = 0;
+};
+}
+
+static usize align_up(usize size, usize alignment) {
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+
+// -------------------------------------------------- UploadFrame --------------------------------------------------
+
+UploadFrame::UploadFrame(UploadAllocator* allocator) :
+		DeviceLinked(allocator->device()),
+		_allocator(allocator) {
+}
+
+UploadFrame::~UploadFrame() {
+	if(device()) {
+		y_fatal("UploadFrame has not been freed.");
+	}
+}
+
+UploadFrame::UploadFrame(UploadFrame&& other) {
+	swap(other);
+}
+
+UploadFrame& UploadFrame::operator=(UploadFrame&& other) {
+	swap(other);
+	return *this;
+}
+
+void UploadFrame::swap(UploadFrame& other) {
+	DeviceLinked::swap(other);
+	std::swap(_allocator, other._allocator);
+	std::swap(_chunks, other._chunks);
+}
+
+void UploadFrame::free() {
+	if(_allocator) {
+		for(detail::UploadChunk* chunk : _chunks) {
+			_allocator->release(chunk);
+		}
+	}
+	_chunks.clear();
+	// set device to nullptr
+	struct Empty : DeviceLinked {} empty;
+	DeviceLinked::swap(empty);
+}
+
+
+// -------------------------------------------------- UploadAllocator --------------------------------------------------
+
+UploadAllocator::UploadAllocator(DevicePtr dptr, usize chunk_size) :
+		DeviceLinked(dptr),
+		_chunk_size(chunk_size),
+		_alignment(UploadSubBuffer::alignment(dptr)) {
+}
+
+UploadAllocator::~UploadAllocator() {
+	for(const auto& chunk : _chunks) {
+		unused(chunk);
+		y_debug_assert(!chunk->frames);
+	}
+}
+
+bool UploadAllocator::is_compatible(BufferUsage buffer_usage, MemoryType memory) {
+	return (uenum(usage) & uenum(buffer_usage)) == uenum(buffer_usage) &&
+		   (memory == MemoryType::CpuVisible || memory == MemoryType::DontCare);
+}
+
+UploadFrame UploadAllocator::create_frame() {
+	return UploadFrame(this);
+}
+
+UploadAllocator::UploadSubBuffer UploadAllocator::alloc(UploadFrame& frame, usize byte_size) {
+	y_debug_assert(frame._allocator == this);
+
+	const usize size = align_up(std::max(byte_size, usize(1)), _alignment);
+
+	const std::unique_lock lock(_lock);
+
+	if(!_current || _current->offset + size > _current->buffer.byte_size()) {
+		_current = find_chunk(size);
+	}
+
+	detail::UploadChunk* chunk = _current;
+	if(std::find(frame._chunks.begin(), frame._chunks.end(), chunk) == frame._chunks.end()) {
+		++chunk->frames;
+		frame._chunks.emplace_back(chunk);
+	}
+
+	const usize offset = chunk->offset;
+	chunk->offset += size;
+	return UploadSubBuffer(chunk->buffer, byte_size, offset);
+}
+
+// Called with _lock held
+detail::UploadChunk* UploadAllocator::find_chunk(usize byte_size) {
+	y_profile();
+
+	for(const auto& chunk : _chunks) {
+		if(!chunk->frames && chunk->buffer.byte_size() >= byte_size) {
+			chunk->offset = 0;
+			return chunk.get();
+		}
+	}
+
+	const usize chunk_size = std::max(byte_size, _chunk_size);
+	log_msg(fmt("Allocating new %KB upload chunk (% chunks in use)", chunk_size / 1024, _chunks.size()), Log::Perf);
+	return _chunks.emplace_back(std::make_unique<detail::UploadChunk>(device(), chunk_size)).get();
+}
+
+void UploadAllocator::release(detail::UploadChunk* chunk) {
+	y_debug_assert(chunk->frames);
+	--chunk->frames;
+}
+
+UploadAllocator::Stats UploadAllocator::stats() const {
+	const std::unique_lock lock(_lock);
+
+	Stats stats;
+	stats.chunks = _chunks.size();
+	for(const auto& chunk : _chunks) {
+		stats.total_size += chunk->buffer.byte_size();
+		stats.in_flight_chunks += !!chunk->frames;
+	}
+	return stats;
+}
+
+}
@@ -0,0 +1,115 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_BUFFERS_UPLOADALLOCATOR_H
+#define YAVE_GRAPHICS_BUFFERS_UPLOADALLOCATOR_H
+
+#include "SubBuffer.h"
+
+#include <y/core/Vector.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace yave {
+
+class UploadAllocator;
+
+namespace detail {
+struct UploadChunk;
+}
+
+// Chunks used by a frame. Must be given to the LifetimeManager (using device()->destroy) once the frame has been recorded,
+// chunks are then recycled after the frame's command buffers are done.
+class UploadFrame : NonCopyable, public DeviceLinked {
+
+	public:
+		UploadFrame() = default;
+		~UploadFrame();
+
+		UploadFrame(UploadFrame&& other);
+		UploadFrame& operator=(UploadFrame&& other);
+
+	private:
+		friend class LifetimeManager;
+		friend class UploadAllocator;
+
+		UploadFrame(UploadAllocator* allocator);
+
+		void swap(UploadFrame& other);
+		void free();
+
+		UploadAllocator* _allocator = nullptr;
+		core::SmallVector<detail::UploadChunk*, 4> _chunks;
+};
+
+// Linear allocator for per frame CPU to GPU data (uniforms, transforms, dynamic vertices...).
+// Allocations are bumped out of a ring of persistently mapped chunks: nothing is ever freed individually,
+// a chunk is reused once every frame that allocated from it is done on the GPU.
+class UploadAllocator : NonMovable, public DeviceLinked {
+
+	public:
+		static constexpr usize default_chunk_size = 4 * 1024 * 1024;
+
+		static constexpr BufferUsage usage =
+				BufferUsage::UniformBit | BufferUsage::StorageBit |
+				BufferUsage::AttributeBit | BufferUsage::IndexBit | BufferUsage::IndirectBit |
+				BufferUsage::TransferSrcBit;
+
+		using UploadSubBuffer = SubBuffer<usage, MemoryType::CpuVisible>;
+
+		struct Stats {
+			usize chunks = 0;
+			usize total_size = 0;
+			usize in_flight_chunks = 0;
+		};
+
+		UploadAllocator(DevicePtr dptr, usize chunk_size = default_chunk_size);
+		~UploadAllocator();
+
+		static bool is_compatible(BufferUsage buffer_usage, MemoryType memory);
+
+		UploadFrame create_frame();
+
+		// Thread safe
+		UploadSubBuffer alloc(UploadFrame& frame, usize byte_size);
+
+		Stats stats() const;
+
+	private:
+		friend class UploadFrame;
+
+		void release(detail::UploadChunk* chunk);
+		detail::UploadChunk* find_chunk(usize byte_size);
+
+		core::Vector<std::unique_ptr<detail::UploadChunk>> _chunks;
+		detail::UploadChunk* _current = nullptr;
+
+		usize _chunk_size = 0;
+		usize _alignment = 0;
+
+		mutable std::mutex _lock;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_BUFFERS_UPLOADALLOCATOR_H
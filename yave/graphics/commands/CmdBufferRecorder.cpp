@@ -21,6 +21,8 @@ SOFTWARE.
 **********************************/
 
 #include "CmdBufferRecorder.h"
+#include "RecordedCmdBuffer.h"
+#include "GpuProfiler.h"
 
 #include <yave/material/Material.h>
 #include <yave/graphics/descriptors/DescriptorSet.h>
@@ -40,13 +42,16 @@ bool disable_render = false;
 #endif
 
 static VkCommandBufferUsageFlagBits cmd_usage_flags(CmdBufferUsage u) {
-	return VkCommandBufferUsageFlagBits(uenum(u) /*& ~uenum(CmdBufferUsage::Secondary)*/);
+	return VkCommandBufferUsageFlagBits(uenum(u));
 }
 
 
 // -------------------------------------------------- CmdBufferRegion --------------------------------------------------
 
 CmdBufferRegion::~CmdBufferRegion() {
+	if(_timestamps) {
+		_timestamps->end_zone(_buffer, _zone);
+	}
 	if(device() && device()->debug_utils()) {
 		device()->debug_utils()->end_region(_buffer);
 	}
@@ -54,11 +59,15 @@ CmdBufferRegion::~CmdBufferRegion() {
 
 CmdBufferRegion::CmdBufferRegion(const CmdBufferRecorder& cmd_buffer, const char* name, const math::Vec4& color) :
 		DeviceLinked(cmd_buffer.device()),
-		_buffer(cmd_buffer.vk_cmd_buffer()) {
+		_buffer(cmd_buffer.vk_cmd_buffer()),
+		_timestamps(cmd_buffer.timestamps()) {
 
 	if(const auto marker = device()->debug_utils()) {
 		marker->begin_region(_buffer, name, color);
 	}
+	if(_timestamps) {
+		_zone = _timestamps->begin_zone(_buffer, name);
+	}
 }
 
 
@@ -78,13 +87,34 @@ void RenderPassRecorder::bind_material(const Material& material) {
 }
 
 void RenderPassRecorder::bind_material(const MaterialTemplate* material, DescriptorSetList descriptor_sets) {
-	bind_pipeline(material->compile(*_cmd_buffer._render_pass), descriptor_sets);
+	auto pipeline = material->compile(*_cmd_buffer._render_pass);
+	bind_pipeline(*pipeline, descriptor_sets);
+	keep_alive(std::move(pipeline));
 }
 
 void RenderPassRecorder::bind_pipeline(const GraphicPipeline& pipeline, DescriptorSetList descriptor_sets) {
 	YAVE_VK_CMD;
 
 	vkCmdBindPipeline(vk_cmd_buffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.vk_pipeline());
+	bind_descriptor_sets(pipeline, descriptor_sets);
+}
+
+void RenderPassRecorder::bind_descriptor_sets(const MaterialTemplate* material, DescriptorSetList descriptor_sets) {
+	auto pipeline = material->compile(*_cmd_buffer._render_pass);
+	bind_descriptor_sets(*pipeline, descriptor_sets);
+	keep_alive(std::move(pipeline));
+}
+
+// The material might discard its pipeline while this is recorded (if it gets compiled for too many render passes)
+void RenderPassRecorder::keep_alive(std::shared_ptr<const GraphicPipeline> pipeline) {
+	if(pipeline.get() != _kept_pipeline) {
+		_kept_pipeline = pipeline.get();
+		_cmd_buffer.keep_alive(std::move(pipeline));
+	}
+}
+
+void RenderPassRecorder::bind_descriptor_sets(const GraphicPipeline& pipeline, DescriptorSetList descriptor_sets) {
+	YAVE_VK_CMD;
 
 	if(!descriptor_sets.is_empty()) {
 		vkCmdBindDescriptorSets(
@@ -122,6 +152,20 @@ void RenderPassRecorder::draw(const VkDrawIndirectCommand& indirect) {
 	);
 }
 
+void RenderPassRecorder::draw_indirect(const SubBuffer<BufferUsage::IndirectBit>& indirect, usize first_draw, usize draw_count) {
+	YAVE_VK_CMD;
+
+	static constexpr usize stride = sizeof(VkDrawIndexedIndirectCommand);
+	y_debug_assert((first_draw + draw_count) * stride <= indirect.byte_size());
+
+	vkCmdDrawIndexedIndirect(vk_cmd_buffer(),
+		indirect.vk_buffer(),
+		indirect.byte_offset() + first_draw * stride,
+		draw_count,
+		stride
+	);
+}
+
 void RenderPassRecorder::draw_indexed(usize index_count) {
 	VkDrawIndexedIndirectCommand command = {};
 	command.indexCount = index_count;
@@ -220,12 +264,23 @@ void RenderPassRecorder::set_scissor(const math::Vec2i& offset, const math::Vec2
 
 // -------------------------------------------------- CmdBufferRecorder --------------------------------------------------
 
-CmdBufferRecorder::CmdBufferRecorder(CmdBufferBase&& base, CmdBufferUsage usage)  : CmdBufferBase(std::move(base)) {
+CmdBufferRecorder::CmdBufferRecorder(CmdBufferBase&& base, CmdBufferUsage usage, const Framebuffer* inherited) : CmdBufferBase(std::move(base)) {
+	y_debug_assert((usage == CmdBufferUsage::Secondary) == !!inherited);
 
+	VkCommandBufferInheritanceInfo inheritance_info = vk_struct();
+	if(inherited) {
+		inheritance_info.renderPass = inherited->render_pass().vk_render_pass();
+		inheritance_info.subpass = 0;
+		inheritance_info.framebuffer = inherited->vk_framebuffer();
+
+		_render_pass = &inherited->render_pass();
+		_inherits_renderpass = true;
+	}
 
 	VkCommandBufferBeginInfo begin_info = vk_struct();
 	{
 		begin_info.flags = cmd_usage_flags(usage);
+		begin_info.pInheritanceInfo = inherited ? &inheritance_info : nullptr;
 	}
 
 	vk_check(vkBeginCommandBuffer(vk_cmd_buffer(), &begin_info));
@@ -241,6 +296,11 @@ CmdBufferRecorder::~CmdBufferRecorder() {
 void CmdBufferRecorder::end_renderpass() {
 	y_always_assert(_render_pass, "CmdBufferRecorder has no render pass");
 
+	if(_inherits_renderpass) {
+		// The primary ends the render pass after executing this buffer
+		return;
+	}
+
 	vkCmdEndRenderPass(vk_cmd_buffer());
 	_render_pass = nullptr;
 }
@@ -253,8 +313,16 @@ CmdBufferRegion CmdBufferRecorder::region(const char* name, const math::Vec4& co
 	return CmdBufferRegion(*this, name, color);
 }
 
+GpuTimestamps* CmdBufferRecorder::timestamps() const {
+	return _timestamps;
+}
 
-RenderPassRecorder CmdBufferRecorder::bind_framebuffer(const Framebuffer& framebuffer) {
+void CmdBufferRecorder::set_timestamps(GpuTimestamps* timestamps) {
+	_timestamps = timestamps;
+}
+
+
+void CmdBufferRecorder::begin_renderpass(const Framebuffer& framebuffer, VkSubpassContents contents) {
 	check_no_renderpass();
 
 	auto clear_values = core::vector_with_capacity<VkClearValue>(framebuffer.attachment_count() + 1);
@@ -278,12 +346,35 @@ RenderPassRecorder CmdBufferRecorder::bind_framebuffer(const Framebuffer& frameb
 	}
 
 
-	vkCmdBeginRenderPass(vk_cmd_buffer(), &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBeginRenderPass(vk_cmd_buffer(), &begin_info, contents);
 	_render_pass = &framebuffer.render_pass();
+}
 
+RenderPassRecorder CmdBufferRecorder::bind_framebuffer(const Framebuffer& framebuffer) {
+	begin_renderpass(framebuffer, VK_SUBPASS_CONTENTS_INLINE);
 	return RenderPassRecorder(*this, Viewport(framebuffer.size()));
 }
 
+void CmdBufferRecorder::execute(const Framebuffer& framebuffer, core::MutableSpan<SecondaryCmdBufferRecorder> secondaries) {
+	y_profile();
+
+	auto recorded = core::vector_with_capacity<RecordedCmdBuffer>(secondaries.size());
+	auto buffers = core::vector_with_capacity<VkCommandBuffer>(secondaries.size());
+	for(SecondaryCmdBufferRecorder& secondary : secondaries) {
+		y_debug_assert(secondary._render_pass == &framebuffer.render_pass());
+		recorded.emplace_back(std::move(secondary));
+		buffers << recorded.last().vk_cmd_buffer();
+	}
+
+	begin_renderpass(framebuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+	if(!buffers.is_empty()) {
+		vkCmdExecuteCommands(vk_cmd_buffer(), buffers.size(), buffers.data());
+	}
+	end_renderpass();
+
+	keep_alive(std::move(recorded));
+}
+
 void CmdBufferRecorder::dispatch(const ComputeProgram& program, const math::Vec3ui& size, DescriptorSetList descriptor_sets, const PushConstant& push_constants) {
 	YAVE_VK_CMD;
 
@@ -458,4 +549,17 @@ void CmdBufferRecorder::transition_image(ImageBase& image, VkImageLayout src, Vk
 }
 
 
+// -------------------------------------------------- SecondaryCmdBufferRecorder --------------------------------------------------
+
+SecondaryCmdBufferRecorder::SecondaryCmdBufferRecorder(CmdBuffer<CmdBufferUsage::Secondary>&& buffer, const Framebuffer& framebuffer) :
+		CmdBufferRecorder(std::move(buffer), CmdBufferUsage::Secondary, &framebuffer),
+		_size(framebuffer.size()) {
+}
+
+RenderPassRecorder SecondaryCmdBufferRecorder::render_pass() {
+	y_debug_assert(_render_pass);
+	return RenderPassRecorder(*this, Viewport(_size));
+}
+
+
 }
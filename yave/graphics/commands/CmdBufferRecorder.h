@@ -95,6 +95,9 @@ struct CmdBufferRegion : NonMovable, public DeviceLinked {
 		CmdBufferRegion(const CmdBufferRecorder& cmd_buffer, const char* name, const math::Vec4& color);
 
 		VkCommandBuffer _buffer = {};
+
+		GpuTimestamps* _timestamps = nullptr;
+		u32 _zone = 0;
 };
 
 class RenderPassRecorder : NonMovable {
@@ -111,9 +114,16 @@ class RenderPassRecorder : NonMovable {
 		void bind_material(const MaterialTemplate* material, DescriptorSetList descriptor_sets = {});
 		void bind_pipeline(const GraphicPipeline& pipeline, DescriptorSetList descriptor_sets);
 
+		// rebinds descriptor sets without binding the material's pipeline
+		void bind_descriptor_sets(const MaterialTemplate* material, DescriptorSetList descriptor_sets);
+		void bind_descriptor_sets(const GraphicPipeline& pipeline, DescriptorSetList descriptor_sets);
+
 		void draw(const VkDrawIndexedIndirectCommand& indirect);
 		void draw(const VkDrawIndirectCommand& indirect);
 
+		// draw_count VkDrawIndexedIndirectCommand read from the buffer, starting at first_draw
+		void draw_indirect(const SubBuffer<BufferUsage::IndirectBit>& indirect, usize first_draw, usize draw_count);
+
 		void draw_indexed(usize index_count);
 		void draw_array(usize vertex_count);
 
@@ -132,11 +142,17 @@ class RenderPassRecorder : NonMovable {
 
 	private:
 		friend class CmdBufferRecorder;
+		friend class SecondaryCmdBufferRecorder;
 
 		RenderPassRecorder(CmdBufferRecorder& cmd_buffer, const Viewport& viewport);
 
+		void keep_alive(std::shared_ptr<const GraphicPipeline> pipeline);
+
 		CmdBufferRecorder& _cmd_buffer;
 		Viewport _viewport;
+
+		// Last pipeline kept alive by this recorder, to avoid keeping the same pipeline for every draw
+		const GraphicPipeline* _kept_pipeline = nullptr;
 };
 
 class CmdBufferRecorder : public CmdBufferBase {
@@ -162,6 +178,10 @@ class CmdBufferRecorder : public CmdBufferBase {
 
 		RenderPassRecorder bind_framebuffer(const Framebuffer& framebuffer);
 
+		// Begins the render pass of framebuffer, executes the secondaries in order and ends the render pass.
+		// The secondaries are consumed and kept alive until this command buffer is done.
+		void execute(const Framebuffer& framebuffer, core::MutableSpan<SecondaryCmdBufferRecorder> secondaries);
+
 		void dispatch(const ComputeProgram& program, const math::Vec3ui& size, DescriptorSetList descriptor_sets, const PushConstant& push_constants = PushConstant());
 
 		void dispatch_size(const ComputeProgram& program, const math::Vec3ui& size, DescriptorSetList descriptor_sets, const PushConstant& push_constants = PushConstant());
@@ -181,18 +201,47 @@ class CmdBufferRecorder : public CmdBufferBase {
 		// never use directly, needed for internal work
 		void transition_image(ImageBase& image, VkImageLayout src, VkImageLayout dst);
 
+		// Regions are timed when set, see GpuProfiler
+		GpuTimestamps* timestamps() const;
+		void set_timestamps(GpuTimestamps* timestamps);
+
 	protected:
 		CmdBufferRecorder() = default;
-		CmdBufferRecorder(CmdBufferBase&& base, CmdBufferUsage usage);
+		CmdBufferRecorder(CmdBufferBase&& base, CmdBufferUsage usage, const Framebuffer* inherited = nullptr);
+
+		CmdBufferRecorder& operator=(CmdBufferRecorder&&) = default;
 
 	private:
 		friend class RenderPassRecorder;
+		friend class SecondaryCmdBufferRecorder;
 
+		void begin_renderpass(const Framebuffer& framebuffer, VkSubpassContents contents);
 		void end_renderpass();
 		void check_no_renderpass() const;
 
 		// this could be in RenderPassRecorder, but putting it here makes erroring easier
 		const RenderPass* _render_pass = nullptr;
+
+		// Secondaries inherit the render pass of their primary, they never begin or end one
+		bool _inherits_renderpass = false;
+
+		GpuTimestamps* _timestamps = nullptr;
+};
+
+// Records draws executed by a primary CmdBufferRecorder inside the render pass of framebuffer.
+// Secondaries are allocated from the pool of the calling thread, so they can be recorded on worker threads.
+class SecondaryCmdBufferRecorder : public CmdBufferRecorder {
+	public:
+		SecondaryCmdBufferRecorder() = default;
+		SecondaryCmdBufferRecorder(CmdBuffer<CmdBufferUsage::Secondary>&& buffer, const Framebuffer& framebuffer);
+
+		SecondaryCmdBufferRecorder(SecondaryCmdBufferRecorder&&) = default;
+		SecondaryCmdBufferRecorder& operator=(SecondaryCmdBufferRecorder&&) = default;
+
+		RenderPassRecorder render_pass();
+
+	private:
+		math::Vec2ui _size;
 };
 
 }
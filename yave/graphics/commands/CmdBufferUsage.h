@@ -30,6 +30,7 @@ namespace yave {
 
 enum class CmdBufferUsage {
 	Disposable = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+	Secondary = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
 };
 
 class CmdBufferBase;
@@ -43,6 +44,7 @@ class CmdBuffer;
 
 class RecordedCmdBuffer;
 class CmdBufferRecorder;
+class SecondaryCmdBufferRecorder;
 
 }
 
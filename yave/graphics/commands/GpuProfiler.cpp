@@ -0,0 +1,221 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "GpuProfiler.h"
+#include "CmdBufferRecorder.h"
+
+#include <yave/device/Device.h>
+
+#include <y/utils/perf.h>
+
+#include <algorithm>
+
+namespace yave {
+
+static VkQueryPool create_query_pool(DevicePtr dptr) {
+	VkQueryPoolCreateInfo create_info = vk_struct();
+	{
+		create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		create_info.queryCount = 2 * GpuTimestamps::max_zones;
+	}
+
+	VkQueryPool pool = {};
+	vk_check(vkCreateQueryPool(dptr->vk_device(), &create_info, dptr->vk_allocation_callbacks(), &pool));
+	return pool;
+}
+
+
+// -------------------------------------------------- GpuTimestamps --------------------------------------------------
+
+GpuTimestamps::GpuTimestamps(GpuProfiler* profiler) : _profiler(profiler), _pool(create_query_pool(profiler->device())) {
+}
+
+GpuTimestamps::~GpuTimestamps() {
+	_profiler->device()->destroy(_pool);
+}
+
+u32 GpuTimestamps::begin_zone(VkCommandBuffer cmd_buffer, const char* name) {
+	const u32 zone = _next_zone.fetch_add(1);
+	if(zone >= max_zones) {
+		return invalid_zone;
+	}
+
+	_names[zone] = _profiler->intern(name);
+	vkCmdWriteTimestamp(cmd_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _pool, 2 * zone);
+	return zone;
+}
+
+void GpuTimestamps::end_zone(VkCommandBuffer cmd_buffer, u32 zone) {
+	if(zone != invalid_zone) {
+		vkCmdWriteTimestamp(cmd_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _pool, 2 * zone + 1);
+	}
+}
+
+
+// -------------------------------------------------- Readback --------------------------------------------------
+
+GpuProfiler::Readback::Readback(GpuProfiler* p, std::unique_ptr<GpuTimestamps> t) :
+		profiler(p),
+		timestamps(std::move(t)),
+		perf_reference(perf::timestamp()) {
+}
+
+// Kept alive by the command buffer: destroyed once it has been completed
+GpuProfiler::Readback::~Readback() {
+	if(timestamps) {
+		profiler->read_back(*timestamps, perf_reference);
+		profiler->recycle(std::move(timestamps));
+	}
+}
+
+
+// -------------------------------------------------- GpuProfiler --------------------------------------------------
+
+GpuProfiler::GpuProfiler(DevicePtr dptr) : DeviceLinked(dptr) {
+	const VkPhysicalDeviceLimits& limits = dptr->physical_device().vk_properties().limits;
+	_supported = limits.timestampComputeAndGraphics;
+	_timestamp_period = limits.timestampPeriod;
+}
+
+GpuProfiler::~GpuProfiler() {
+}
+
+bool GpuProfiler::is_supported() const {
+	return _supported;
+}
+
+bool GpuProfiler::is_enabled() const {
+	return _enabled;
+}
+
+void GpuProfiler::set_enabled(bool enabled) {
+	_enabled = enabled && _supported;
+}
+
+void GpuProfiler::begin(CmdBufferRecorder& recorder) {
+	if(!_enabled) {
+		return;
+	}
+
+	y_debug_assert(!recorder.timestamps());
+
+	std::unique_ptr<GpuTimestamps> timestamps;
+	{
+		const std::unique_lock lock(_lock);
+		if(!_free.is_empty()) {
+			timestamps = std::move(_free.last());
+			_free.pop();
+		}
+	}
+
+	if(!timestamps) {
+		timestamps.reset(new GpuTimestamps(this));
+	}
+
+	timestamps->_next_zone = 0;
+	vkCmdResetQueryPool(recorder.vk_cmd_buffer(), timestamps->_pool, 0, 2 * GpuTimestamps::max_zones);
+
+	recorder.set_timestamps(timestamps.release());
+}
+
+void GpuProfiler::end(CmdBufferRecorder& recorder) {
+	if(GpuTimestamps* timestamps = recorder.timestamps()) {
+		recorder.set_timestamps(nullptr);
+		recorder.keep_alive(Readback(this, std::unique_ptr<GpuTimestamps>(timestamps)));
+	}
+}
+
+core::Vector<GpuProfiler::Zone> GpuProfiler::last_frame() const {
+	const std::unique_lock lock(_lock);
+	return _last_frame;
+}
+
+const char* GpuProfiler::intern(const char* name) {
+	const std::unique_lock lock(_lock);
+	return _names.emplace(name).first->c_str();
+}
+
+void GpuProfiler::recycle(std::unique_ptr<GpuTimestamps> timestamps) {
+	const std::unique_lock lock(_lock);
+	_free.emplace_back(std::move(timestamps));
+}
+
+void GpuProfiler::read_back(GpuTimestamps& timestamps, u64 perf_reference) {
+	y_profile();
+
+	const u32 zone_count = std::min(timestamps._next_zone.load(), GpuTimestamps::max_zones);
+	if(!zone_count) {
+		return;
+	}
+
+	core::Vector<u64> results(2 * zone_count, 0);
+	const VkResult result = vkGetQueryPoolResults(device()->vk_device(), timestamps._pool, 0, 2 * zone_count,
+												  results.size() * sizeof(u64), results.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+	if(result != VK_SUCCESS) {
+		// The command buffer might not have been submitted
+		return;
+	}
+
+	struct RawZone {
+		const char* name;
+		u64 begin;
+		u64 end;
+	};
+
+	auto zones = core::vector_with_capacity<RawZone>(zone_count);
+	for(u32 i = 0; i != zone_count; ++i) {
+		zones.emplace_back(RawZone{timestamps._names[i], results[2 * i], std::max(results[2 * i], results[2 * i + 1])});
+	}
+
+	// Zones recorded in secondaries are allocated out of order, parents always begin first
+	std::stable_sort(zones.begin(), zones.end(), [](const RawZone& a, const RawZone& b) { return a.begin < b.begin; });
+
+	const u64 origin = zones[0].begin;
+	const auto to_ns = [&](u64 t) { return u64((t - origin) * _timestamp_period); };
+
+	// Clamp children to their parent so that zones are strictly nested
+	core::Vector<const RawZone*> stack;
+	auto frame = core::vector_with_capacity<Zone>(zone_count);
+	for(RawZone& zone : zones) {
+		while(!stack.is_empty() && stack.last()->end <= zone.begin) {
+			perf::track_leave(track_name, stack.last()->name, perf_reference, to_ns(stack.last()->end));
+			stack.pop();
+		}
+		if(!stack.is_empty()) {
+			zone.end = std::min(zone.end, stack.last()->end);
+		}
+
+		perf::track_enter(track_name, zone.name, perf_reference, to_ns(zone.begin));
+		frame.emplace_back(Zone{zone.name, u32(stack.size()), to_ns(zone.begin) * 1e-6, (zone.end - zone.begin) * _timestamp_period * 1e-6});
+		stack.emplace_back(&zone);
+	}
+
+	while(!stack.is_empty()) {
+		perf::track_leave(track_name, stack.last()->name, perf_reference, to_ns(stack.last()->end));
+		stack.pop();
+	}
+
+	const std::unique_lock lock(_lock);
+	_last_frame = std::move(frame);
+}
+
+}
@@ -0,0 +1,126 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_COMMANDS_GPUPROFILER_H
+#define YAVE_GRAPHICS_COMMANDS_GPUPROFILER_H
+
+#include <yave/device/DeviceLinked.h>
+
+#include <y/core/Vector.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+namespace yave {
+
+class GpuProfiler;
+
+// Timestamp queries of a profiled command buffer and of its secondaries.
+// Every region recorded while a recorder points to it is timed.
+class GpuTimestamps : NonMovable {
+
+	public:
+		static constexpr u32 max_zones = 512;
+		static constexpr u32 invalid_zone = u32(-1);
+
+		~GpuTimestamps();
+
+		// Thread safe
+		u32 begin_zone(VkCommandBuffer cmd_buffer, const char* name);
+		void end_zone(VkCommandBuffer cmd_buffer, u32 zone);
+
+	private:
+		friend class GpuProfiler;
+
+		GpuTimestamps(GpuProfiler* profiler);
+
+		GpuProfiler* _profiler = nullptr;
+		VkQueryPool _pool = {};
+
+		std::atomic<u32> _next_zone = 0;
+		std::array<const char*, max_zones> _names = {};
+};
+
+// Times the regions of a command buffer using timestamp queries.
+// Results are read back once the command buffer has been completed, the GPU is never waited on.
+class GpuProfiler : NonMovable, public DeviceLinked {
+
+	public:
+		static constexpr const char* track_name = "GPU";
+
+		struct Zone {
+			const char* name = nullptr;
+			u32 depth = 0;
+			double begin_ms = 0.0;
+			double duration_ms = 0.0;
+		};
+
+		GpuProfiler(DevicePtr dptr);
+		~GpuProfiler();
+
+		bool is_supported() const;
+
+		bool is_enabled() const;
+		void set_enabled(bool enabled);
+
+		// Regions recorded between begin and end are timed, end must be called before the recorder is submitted.
+		void begin(CmdBufferRecorder& recorder);
+		void end(CmdBufferRecorder& recorder);
+
+		// Zones of the last frame that has been read back, sorted by begin time
+		core::Vector<Zone> last_frame() const;
+
+	private:
+		friend class GpuTimestamps;
+
+		struct Readback : NonCopyable {
+			Readback(GpuProfiler* profiler, std::unique_ptr<GpuTimestamps> timestamps);
+			Readback(Readback&&) = default;
+			~Readback();
+
+			GpuProfiler* profiler = nullptr;
+			std::unique_ptr<GpuTimestamps> timestamps;
+			u64 perf_reference = 0;
+		};
+
+		const char* intern(const char* name);
+		void read_back(GpuTimestamps& timestamps, u64 perf_reference);
+		void recycle(std::unique_ptr<GpuTimestamps> timestamps);
+
+		core::Vector<std::unique_ptr<GpuTimestamps>> _free;
+		core::Vector<Zone> _last_frame;
+
+		std::unordered_set<std::string> _names;
+
+		double _timestamp_period = 0.0;
+		bool _supported = false;
+		std::atomic<bool> _enabled = false;
+
+		mutable std::mutex _lock;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_COMMANDS_GPUPROFILER_H
@@ -26,7 +26,10 @@ SOFTWARE.
 namespace yave {
 
 CmdBufferData::CmdBufferData(VkCommandBuffer buf, VkFence fen, CmdBufferPoolBase* p) :
-		_cmd_buffer(buf), _fence(fen), _pool(p), _resource_fence(device()->lifetime_manager().create_fence()) {
+		_cmd_buffer(buf), _fence(fen), _pool(p) {
+	if(_fence) {
+		_resource_fence = device()->lifetime_manager().create_fence();
+	}
 }
 
 CmdBufferData::CmdBufferData(CmdBufferData&& other) {
@@ -72,6 +75,10 @@ ResourceFence CmdBufferData::resource_fence() const {
 	return _resource_fence;
 }
 
+u64 CmdBufferData::timeline_value() const {
+	return _timeline_value;
+}
+
 void CmdBufferData::swap(CmdBufferData& other) {
 	std::swap(_cmd_buffer, other._cmd_buffer);
 	std::swap(_fence, other._fence);
@@ -80,18 +87,21 @@ void CmdBufferData::swap(CmdBufferData& other) {
 	std::swap(_signal, other._signal);
 	std::swap(_waits, other._waits);
 	std::swap(_resource_fence, other._resource_fence);
+	std::swap(_timeline_value, other._timeline_value);
 }
 
 void CmdBufferData::reset() {
 	y_profile();
-	if(_fence) {
-		vk_check(vkResetFences(device()->vk_device(), 1, &_fence));
-	}
-
 	vk_check(vkResetCommandBuffer(_cmd_buffer, 0));
 	_waits.clear();
 	_signal = Semaphore();
-	_resource_fence = device()->lifetime_manager().create_fence();
+	_timeline_value = 0;
+
+	// Secondary buffers have no fence and never go through the lifetime manager
+	if(_fence) {
+		vk_check(vkResetFences(device()->vk_device(), 1, &_fence));
+		_resource_fence = device()->lifetime_manager().create_fence();
+	}
 }
 
 void CmdBufferData::release_resources() {
@@ -112,7 +122,12 @@ CmdBufferDataProxy::CmdBufferDataProxy(CmdBufferData&& d) : _data(std::move(d))
 
 CmdBufferDataProxy::~CmdBufferDataProxy() {
 	if(!_data.is_null()) {
-		_data.device()->lifetime_manager().recycle(std::move(_data));
+		if(_data.vk_fence()) {
+			_data.device()->lifetime_manager().recycle(std::move(_data));
+		} else {
+			// Secondary buffers are kept alive by their primary, so they can be reused as soon as they are released
+			_data.pool()->release(std::move(_data));
+		}
 	}
 }
 
@@ -95,6 +95,9 @@ class CmdBufferData final : NonCopyable {
 		CmdBufferPoolBase* pool() const;
 		ResourceFence resource_fence() const;
 
+		// Value signaled on the lifetime manager timeline on completion, 0 if the buffer was not submitted with one
+		u64 timeline_value() const;
+
 		VkCommandBuffer vk_cmd_buffer() const;
 		VkFence vk_fence() const;
 
@@ -128,6 +131,7 @@ class CmdBufferData final : NonCopyable {
 		core::Vector<Semaphore> _waits;
 
 		ResourceFence _resource_fence;
+		u64 _timeline_value = 0;
 };
 
 
@@ -30,13 +30,13 @@ SOFTWARE.
 namespace yave {
 
 static VkCommandBufferLevel cmd_level(CmdBufferUsage u) {
-	unused(u);
-	y_debug_assert(u == CmdBufferUsage::Disposable);
-	return VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	return u == CmdBufferUsage::Secondary
+		? VK_COMMAND_BUFFER_LEVEL_SECONDARY
+		: VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 }
 
 static VkCommandPoolCreateFlagBits cmd_create_flags(CmdBufferUsage u) {
-	return u == CmdBufferUsage::Disposable
+	return u == CmdBufferUsage::Disposable || u == CmdBufferUsage::Secondary
 		? VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
 		: VkCommandPoolCreateFlagBits(0);
 }
@@ -65,8 +65,8 @@ CmdBufferPoolBase::CmdBufferPoolBase(DevicePtr dptr, CmdBufferUsage preferred) :
 
 CmdBufferPoolBase::~CmdBufferPoolBase() {
 	if(device()) {
-		if(_fences.size() != _cmd_buffers.size()) {
-			y_fatal("CmdBuffers are still in use (% fences, % buffers).", _fences.size(), _cmd_buffers.size());
+		if(_created != _cmd_buffers.size()) {
+			y_fatal("CmdBuffers are still in use (% created, % buffers).", _created, _cmd_buffers.size());
 		}
 		join_all();
 		_cmd_buffers.clear();
@@ -79,7 +79,7 @@ VkCommandPool CmdBufferPoolBase::vk_pool() const {
 }
 
 void CmdBufferPoolBase::join_all() {
-	if(_fences.is_empty()/* || _usage == CmdBufferUsage::Secondary*/) {
+	if(_fences.is_empty() || _usage == CmdBufferUsage::Secondary) {
 		return;
 	}
 
@@ -127,12 +127,16 @@ CmdBufferData CmdBufferPoolBase::create_data() {
 	}
 
 	VkCommandBuffer buffer = {};
-	VkFence fence = {};
 	vk_check(vkAllocateCommandBuffers(device()->vk_device(), &allocate_info, &buffer));
-	vk_check(vkCreateFence(device()->vk_device(), &fence_create_info, device()->vk_allocation_callbacks(), &fence));
+	++_created;
 
+	// Secondary buffers are never submitted: they are kept alive by the primary that executes them
+	VkFence fence = {};
+	if(_usage != CmdBufferUsage::Secondary) {
+		vk_check(vkCreateFence(device()->vk_device(), &fence_create_info, device()->vk_allocation_callbacks(), &fence));
+		_fences << fence;
+	}
 
-	_fences << fence;
 	return CmdBufferData(buffer, fence, this);
 }
 
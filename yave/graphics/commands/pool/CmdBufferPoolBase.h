@@ -62,6 +62,7 @@ class CmdBufferPoolBase : NonMovable, public DeviceLinked {
 		CmdBufferUsage _usage;
 		core::Vector<CmdBufferData> _cmd_buffers;
 		core::Vector<VkFence> _fences;
+		usize _created = 0;
 
 		const u32 _thread_id;
 };
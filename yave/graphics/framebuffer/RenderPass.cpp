@@ -167,6 +167,14 @@ bool RenderPass::Layout::is_depth_only() const {
 	return _colors.is_empty();
 }
 
+ImageFormat RenderPass::Layout::depth_format() const {
+	return _depth;
+}
+
+core::Span<ImageFormat> RenderPass::Layout::color_formats() const {
+	return _colors;
+}
+
 bool RenderPass::Layout::operator==(const Layout& other) const {
 	return _depth == other._depth && _colors == other._colors;
 }
@@ -183,6 +191,18 @@ RenderPass::RenderPass(DevicePtr dptr, core::Span<ImageData> colors) :
 		RenderPass(dptr, ImageData(), colors) {
 }
 
+RenderPass::RenderPass(DevicePtr dptr, const Layout& layout) : DeviceLinked(dptr), _layout(layout) {
+	// Render pass compatibility only depends on attachment formats and sample counts
+	auto colors = core::vector_with_capacity<ImageData>(layout.color_formats().size());
+	for(const ImageFormat& format : layout.color_formats()) {
+		colors.emplace_back(format, ImageUsage::ColorBit, LoadOp::Clear);
+	}
+
+	const ImageFormat depth = layout.depth_format();
+	_attachment_count = colors.size();
+	_render_pass = create_renderpass(dptr, depth.is_valid() ? ImageData(depth, ImageUsage::DepthBit, LoadOp::Clear) : ImageData(), colors);
+}
+
 RenderPass::~RenderPass() {
 	destroy(_render_pass);
 }
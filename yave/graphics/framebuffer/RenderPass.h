@@ -66,6 +66,9 @@ class RenderPass : NonCopyable, public DeviceLinked {
 				u64 hash() const;
 				bool is_depth_only() const;
 
+				ImageFormat depth_format() const;
+				core::Span<ImageFormat> color_formats() const;
+
 				bool operator==(const Layout& other) const;
 
 			private:
@@ -80,6 +83,9 @@ class RenderPass : NonCopyable, public DeviceLinked {
 		RenderPass(DevicePtr dptr, ImageData depth, core::Span<ImageData> colors);
 		RenderPass(DevicePtr dptr, core::Span<ImageData> colors);
 
+		// Creates a render pass compatible with any render pass sharing the same layout
+		RenderPass(DevicePtr dptr, const Layout& layout);
+
 		~RenderPass();
 
 		bool is_depth_only() const;
@@ -181,6 +181,34 @@ ImageBase::ImageBase(DevicePtr dptr, ImageUsage usage, ImageType type, const Ima
 	upload_data(*this, data);
 }
 
+ImageBase::ImageBase(Unbound, DevicePtr dptr, ImageFormat format, ImageUsage usage, const math::Vec3ui& size) :
+		_size(size),
+		_format(format),
+		_usage(usage),
+		_memory(dptr, VkDeviceMemory{}, 0, 0) {
+
+	check_layer_count(ImageType::TwoD, _size, _layers);
+
+	_image = create_image(dptr, _size, _layers, _mips, _format, _usage, ImageType::TwoD);
+}
+
+VkMemoryRequirements ImageBase::memory_requirements() const {
+	VkMemoryRequirements reqs = {};
+	vkGetImageMemoryRequirements(device()->vk_device(), _image, &reqs);
+	return reqs;
+}
+
+void ImageBase::bind_memory(DeviceMemory memory) {
+	y_debug_assert(!_view);
+
+	DevicePtr dptr = device();
+	bind_image_memory(dptr, _image, memory);
+	_view = create_view(dptr, _image, _format, _layers, _mips, ImageType::TwoD);
+
+	std::swap(_memory, memory);
+	dptr->destroy(std::move(memory));
+}
+
 ImageBase::~ImageBase() {
 	if(device()) {
 		device()->destroy(_view);
@@ -61,6 +61,14 @@ class ImageBase : NonCopyable {
 		ImageBase(DevicePtr dptr, ImageFormat format, ImageUsage usage, const math::Vec3ui& size, ImageType type = ImageType::TwoD, usize layers = 1, usize mips = 1);
 		ImageBase(DevicePtr dptr, ImageUsage usage, ImageType type, const ImageData& data);
 
+		// Creates the image without memory, bind_memory must be called before the image is used.
+		// The image is left in an undefined layout.
+		struct Unbound {};
+		ImageBase(Unbound, DevicePtr dptr, ImageFormat format, ImageUsage usage, const math::Vec3ui& size);
+
+		VkMemoryRequirements memory_requirements() const;
+		void bind_memory(DeviceMemory memory);
+
 
 		math::Vec3ui _size;
 		u32 _layers = 1;
@@ -32,25 +32,11 @@ static usize align_size(usize total_byte_size, usize alignent) {
 	return (total_byte_size + alignent - 1) & ~(alignent - 1);
 }
 
-usize DeviceMemoryHeap::FreeBlock::end_offset() const {
-	return offset + size;
-}
-
-bool DeviceMemoryHeap::FreeBlock::contiguous(const FreeBlock& blck) const {
-	return end_offset() == blck.offset || blck.end_offset() == offset;
-}
-
-void DeviceMemoryHeap::FreeBlock::merge(const FreeBlock& block) {
-	y_debug_assert(contiguous(block));
-	std::tie(offset, size) = std::tuple{std::min(offset, block.offset), size + block.size};
-}
-
-
 DeviceMemoryHeap::DeviceMemoryHeap(DevicePtr dptr, u32 type_bits, MemoryType type, usize heap_size) :
 		DeviceMemoryHeapBase(dptr),
 		_memory(alloc_memory(dptr, heap_size, type_bits, type)),
 		_heap_size(heap_size),
-		_blocks({FreeBlock{0, heap_size}}),
+		_allocator(heap_size, alignment),
 		_mapping(nullptr) {
 
 	if(is_cpu_visible(type)) {
@@ -64,10 +50,7 @@ DeviceMemoryHeap::DeviceMemoryHeap(DevicePtr dptr, u32 type_bits, MemoryType typ
 }
 
 DeviceMemoryHeap::~DeviceMemoryHeap() {
-	if(_blocks.size() != 1) {
-		y_fatal("Not all memory has been free: heap fragmented.");
-	}
-	if(_blocks[0].offset || _blocks[0].size != _heap_size) {
+	if(!_allocator.is_empty()) {
 		y_fatal("Not all memory has been freed.");
 	}
 	if(_mapping) {
@@ -86,72 +69,22 @@ core::Result<DeviceMemory> DeviceMemoryHeap::alloc(VkMemoryRequirements reqs) {
 	const usize size = align_size(reqs.size, alignment);
 
 	const auto lock = y_profile_unique_lock(_lock);
-	for(auto it = _blocks.begin(); it != _blocks.end(); ++it) {
-		const usize full_size = it->size;
-
-		if(full_size < size) {
-			continue;
-		}
-
-		const usize offset = it->offset;
-
-		const usize aligned_offset = align_size(offset, reqs.alignment);
-		const usize align_correction = aligned_offset - offset;
-		const usize aligned_size = full_size - align_correction;
-
-		y_debug_assert(aligned_size % alignment == 0);
-		y_debug_assert(aligned_offset % alignment == 0);
-		y_debug_assert(aligned_offset % reqs.alignment == 0);
-
-		if(aligned_size == size) {
-			_blocks.erase_unordered(it);
-			if(align_correction) {
-				_blocks << FreeBlock{offset, align_correction};
-			}
-			return core::Ok(create(aligned_offset, size));
-		} else if(aligned_size > size) {
-			const usize end = offset + full_size;
-			it->size = end - (it->offset = aligned_offset + size);
-			if(align_correction) {
-				_blocks << FreeBlock{offset, align_correction};
-			}
-			return core::Ok(create(aligned_offset, size));
-		}
+	if(const auto offset = _allocator.allocate(size, reqs.alignment)) {
+		y_debug_assert(offset.unwrap() % alignment == 0);
+		y_debug_assert(offset.unwrap() % reqs.alignment == 0);
+		return core::Ok(create(offset.unwrap(), size));
 	}
 
 	return core::Err();
 }
 
 void DeviceMemoryHeap::free(const DeviceMemory& memory) {
-	y_debug_assert(memory.vk_memory() == _memory);
-	free(FreeBlock {memory.vk_offset(), memory.vk_size()});
-}
-
-void DeviceMemoryHeap::free(const FreeBlock& block) {
 	y_profile();
-	y_debug_assert(block.end_offset() <= size());
-	compact_block(block);
-}
+	y_debug_assert(memory.vk_memory() == _memory);
+	y_debug_assert(memory.vk_offset() + memory.vk_size() <= size());
 
-void DeviceMemoryHeap::compact_block(FreeBlock block) {
-	y_profile();
-	// sort ?
 	const auto lock = y_profile_unique_lock(_lock);
-	bool compacted = false;
-	do {
-		compacted = false;
-		for(auto it = _blocks.begin(); it != _blocks.end(); ++it) {
-			FreeBlock b = *it;
-			if(b.contiguous(block)) {
-				_blocks.erase_unordered(it);
-				b.merge(block);
-				block = b;
-				compacted = true;
-				break;
-			}
-		}
-	} while(compacted);
-	_blocks << block;
+	_allocator.free(memory.vk_offset());
 }
 
 void* DeviceMemoryHeap::map(const DeviceMemoryView& view) {
@@ -167,16 +100,17 @@ usize DeviceMemoryHeap::size() const {
 
 usize DeviceMemoryHeap::available() const {
 	const auto lock = y_profile_unique_lock(_lock);
-	usize tot = 0;
-	for(const auto& b : _blocks) {
-		tot += b.size;
-	}
-	return tot;
+	return _allocator.size() - _allocator.allocated();
 }
 
 usize DeviceMemoryHeap::free_blocks() const {
 	const auto lock = y_profile_unique_lock(_lock);
-	return _blocks.size();
+	return _allocator.free_blocks();
+}
+
+DeviceMemoryHeap::Stats DeviceMemoryHeap::stats() const {
+	const auto lock = y_profile_unique_lock(_lock);
+	return _allocator.stats();
 }
 
 }
@@ -24,7 +24,7 @@ SOFTWARE.
 
 #include "DeviceMemoryHeapBase.h"
 
-#include <y/core/Vector.h>
+#include <y/mem/TLSFAllocator.h>
 
 #include <mutex>
 
@@ -32,17 +32,9 @@ namespace yave {
 
 // For DeviceAllocator, should not be used directly
 class DeviceMemoryHeap : public DeviceMemoryHeapBase {
-
-	struct FreeBlock {
-		usize offset;
-		usize size;
-
-		usize end_offset() const;
-		bool contiguous(const FreeBlock& blck) const;
-		void merge(const FreeBlock& block);
-	};
-
 	public:
+		using Stats = memory::TLSFAllocator::Stats;
+
 		static constexpr usize alignment = 256;
 
 
@@ -56,21 +48,21 @@ class DeviceMemoryHeap : public DeviceMemoryHeapBase {
 		void unmap(const DeviceMemoryView&) override;
 
 		usize size() const;
-		usize available() const; // slow!
+		usize available() const;
 		usize free_blocks() const;
 
+		Stats stats() const;
+
 		bool mapped() const;
 
 	private:
 		void swap(DeviceMemoryHeap& other);
 
 		DeviceMemory create(usize offset, usize size);
-		void free(const FreeBlock& block);
-		void compact_block(FreeBlock block);
 
 		VkDeviceMemory _memory = {};
 		usize _heap_size = 0;
-		core::Vector<FreeBlock> _blocks;
+		memory::TLSFAllocator _allocator;
 		void* _mapping = nullptr;
 
 		mutable std::mutex _lock;
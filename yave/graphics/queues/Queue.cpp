@@ -59,19 +59,41 @@ void Queue::submit_base(CmdBufferBase& base) const {
 	const auto lock = y_profile_unique_lock(*_lock);
 
 	auto cmd = base.vk_cmd_buffer();
+	CmdBufferData& data = base._proxy->data();
 
-	const auto& wait = base._proxy->data()._waits;
+	const auto& wait = data._waits;
 	auto wait_semaphores = core::vector_with_capacity<VkSemaphore>(wait.size());
 	std::transform(wait.begin(), wait.end(), std::back_inserter(wait_semaphores), [](const auto& s) { return s.vk_semaphore(); });
 	const core::Vector<VkPipelineStageFlags> stages(wait.size(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
 
-	const Semaphore& signal = base._proxy->data()._signal;
-	const VkSemaphore sig_semaphore = signal.device() ? signal.vk_semaphore() : VkSemaphore{};
+	const Semaphore& signal = data._signal;
+
+	auto signal_semaphores = core::vector_with_capacity<VkSemaphore>(2);
+	auto signal_values = core::vector_with_capacity<u64>(2);
+	if(signal.device()) {
+		signal_semaphores << signal.vk_semaphore();
+		signal_values << 0; // ignored for binary semaphores
+	}
+
+	// Only fenced buffers go through the lifetime manager
+	LifetimeManager& lifetime = device()->lifetime_manager();
+	if(const TimelineSemaphore* timeline = lifetime.timeline_semaphore(); timeline && base.vk_fence()) {
+		data._timeline_value = lifetime.next_timeline_value();
+		signal_semaphores << timeline->vk_semaphore();
+		signal_values << data._timeline_value;
+	}
+
+	VkTimelineSemaphoreSubmitInfo timeline_info = vk_struct();
+	{
+		timeline_info.signalSemaphoreValueCount = signal_values.size();
+		timeline_info.pSignalSemaphoreValues = signal_values.data();
+	}
 
 	VkSubmitInfo submit_info = vk_struct();
 	{
-		submit_info.signalSemaphoreCount = signal.device() ? 1 : 0;
-		submit_info.pSignalSemaphores = signal.device() ? &sig_semaphore : nullptr;
+		submit_info.pNext = data._timeline_value ? &timeline_info : nullptr;
+		submit_info.signalSemaphoreCount = signal_semaphores.size();
+		submit_info.pSignalSemaphores = signal_semaphores.data();
 		submit_info.waitSemaphoreCount = wait_semaphores.size();
 		submit_info.pWaitSemaphores = wait_semaphores.data();
 		submit_info.pWaitDstStageMask = stages.data();
@@ -76,7 +76,8 @@ ComputeProgram::ComputeProgram(const ComputeShader& comp, const SpecializationDa
 		create_info.stage = stage;
 	}
 
-	vk_check(vkCreateComputePipelines(device()->vk_device(), vk_null(), 1, &create_info, device()->vk_allocation_callbacks(), &_pipeline.get()));
+	vk_check(vkCreateComputePipelines(device()->vk_device(), device()->pipeline_cache().vk_pipeline_cache(), 1, &create_info, device()->vk_allocation_callbacks(), &_pipeline.get()));
+	device()->pipeline_cache().set_dirty();
 }
 
 ComputeProgram::~ComputeProgram() {
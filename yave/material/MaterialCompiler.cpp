@@ -222,7 +222,8 @@ GraphicPipeline MaterialCompiler::compile(const MaterialTemplate* material, cons
 	}
 
 	VkPipeline pipeline = {};
-	vk_check(vkCreateGraphicsPipelines(dptr->vk_device(), vk_null(), 1, &create_info, dptr->vk_allocation_callbacks(), &pipeline));
+	vk_check(vkCreateGraphicsPipelines(dptr->vk_device(), dptr->pipeline_cache().vk_pipeline_cache(), 1, &create_info, dptr->vk_allocation_callbacks(), &pipeline));
+	dptr->pipeline_cache().set_dirty();
 	return GraphicPipeline(material, pipeline, pipeline_layout);
 }
 
@@ -36,12 +36,14 @@ MaterialTemplate::MaterialTemplate(DevicePtr dptr, MaterialTemplateData&& data)
 		_data(std::move(data)) {
 }
 
-const GraphicPipeline& MaterialTemplate::compile(const RenderPass& render_pass) const {
-	Y_TODO(make material compilation thread safe?)
+std::shared_ptr<const GraphicPipeline> MaterialTemplate::compile(const RenderPass& render_pass) const {
 	if(!render_pass.vk_render_pass()) {
 		y_fatal("Unable to compile material: null renderpass.");
 	}
 
+	// Passes can be recorded on several threads at once
+	const auto lock = y_profile_unique_lock(*_lock);
+
 	const auto& key = render_pass.layout();
 	const auto it = _compiled.find(key);
 	if(it == _compiled.end()) {
@@ -51,7 +53,14 @@ const GraphicPipeline& MaterialTemplate::compile(const RenderPass& render_pass)
 			_compiled.pop();
 		}
 
-		_compiled.insert(key, MaterialCompiler::compile(this, render_pass));
+		_compiled.insert(key, std::make_shared<const GraphicPipeline>(MaterialCompiler::compile(this, render_pass)));
+
+		// Remember the layout so the pipeline can be precompiled on the next run
+		const auto& resources = device()->device_resources();
+		if(const auto index = resources.material_template_index(this); index != DeviceResources::MaxMaterialTemplates) {
+			device()->pipeline_cache().register_material_layout(u32(index), key);
+		}
+
 		return _compiled.last().second;
 	}
 	return it->second;
@@ -29,6 +29,8 @@ SOFTWARE.
 
 #include <y/core/AssocVector.h>
 
+#include <mutex>
+
 #include "GraphicPipeline.h"
 #include "MaterialTemplateData.h"
 
@@ -42,14 +44,17 @@ class MaterialTemplate final : NonCopyable, public DeviceLinked {
 		MaterialTemplate() = default;
 		MaterialTemplate(DevicePtr dptr, MaterialTemplateData&& data);
 
-		const GraphicPipeline& compile(const RenderPass& render_pass) const;
+		// The pipeline stays alive as long as the returned pointer does, even if another thread discards it
+		std::shared_ptr<const GraphicPipeline> compile(const RenderPass& render_pass) const;
 
 		const MaterialTemplateData& data() const;
 
 	private:
 		//void swap(Material& other);
 
-		mutable core::AssocVector<RenderPass::Layout, GraphicPipeline> _compiled;
+		// Pipelines are shared so that discarding one doesn't free it while it is being recorded
+		mutable core::AssocVector<RenderPass::Layout, std::shared_ptr<const GraphicPipeline>> _compiled;
+		mutable std::unique_ptr<std::mutex> _lock = std::make_unique<std::mutex>();
 
 		MaterialTemplateData _data;
 };
@@ -0,0 +1,427 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "MeshAllocator.h"
+
+#include <yave/device/Device.h>
+#include <yave/graphics/commands/CmdBufferRecorder.h>
+#include <yave/graphics/commands/RecordedCmdBuffer.h>
+#include <yave/graphics/barriers/Barrier.h>
+
+#include <numeric>
+#include <cstring>
+
+namespace yave {
+
+static usize align_up(usize size, usize granularity) {
+	return (size + granularity - 1) / granularity * granularity;
+}
+
+// Number of elements per allocation unit, so that every range can be used as a sub buffer
+template<typename SubBuff>
+static usize granularity(DevicePtr dptr) {
+	using value_type = typename SubBuff::value_type;
+	const usize alignment = std::max(SubBuff::alignment(dptr), SubBuffer<BufferUsage::TransferDstBit>::alignment(dptr));
+	return std::lcm(sizeof(value_type), alignment) / sizeof(value_type);
+}
+
+template<BufferUsage Usage, typename Buff>
+static SubBuffer<Usage> sub_range(const Buff& buffer, u32 offset, u32 count) {
+	using value_type = typename Buff::value_type;
+	return SubBuffer<Usage>(buffer, count * sizeof(value_type), offset * sizeof(value_type));
+}
+
+template<typename T>
+static StagingBuffer create_staging(DevicePtr dptr, core::Span<T> data) {
+	if(data.is_empty()) {
+		return StagingBuffer();
+	}
+
+	StagingBuffer buffer(dptr, data.size() * sizeof(T));
+	Mapping mapping(buffer);
+	std::memcpy(mapping.data(), data.data(), buffer.byte_size());
+	return buffer;
+}
+
+
+// -------------------------------------------------- MeshAllocation --------------------------------------------------
+
+MeshAllocation::MeshAllocation(MeshAllocator* allocator, detail::MeshRange* range) :
+		DeviceLinked(allocator->device()),
+		_allocator(allocator),
+		_range(range) {
+}
+
+MeshAllocation::~MeshAllocation() {
+	if(device()) {
+		y_fatal("MeshAllocation has not been freed.");
+	}
+}
+
+MeshAllocation::MeshAllocation(MeshAllocation&& other) {
+	swap(other);
+}
+
+MeshAllocation& MeshAllocation::operator=(MeshAllocation&& other) {
+	swap(other);
+	return *this;
+}
+
+void MeshAllocation::swap(MeshAllocation& other) {
+	DeviceLinked::swap(other);
+	std::swap(_allocator, other._allocator);
+	std::swap(_range, other._range);
+}
+
+void MeshAllocation::free() {
+	if(_allocator && _range) {
+		_allocator->free(_range);
+	}
+	_range = nullptr;
+	// set device to nullptr
+	struct Empty : DeviceLinked {} empty;
+	DeviceLinked::swap(empty);
+}
+
+const MeshBuffers& MeshAllocation::buffers() const {
+	y_debug_assert(_range);
+	return *_range->buffers;
+}
+
+TriangleSubBuffer MeshAllocation::triangle_buffer() const {
+	return sub_range<BufferUsage::IndexBit>(buffers().triangles, _range->triangle_offset, _range->triangle_count);
+}
+
+VertexSubBuffer MeshAllocation::vertex_buffer() const {
+	return sub_range<BufferUsage::AttributeBit>(buffers().vertices, _range->vertex_offset, _range->vertex_count);
+}
+
+VkDrawIndexedIndirectCommand MeshAllocation::indirect_data() const {
+	y_debug_assert(_range);
+	VkDrawIndexedIndirectCommand indirect = {};
+	indirect.indexCount = _range->triangle_count * 3;
+	indirect.instanceCount = 1;
+	indirect.firstIndex = _range->triangle_offset * 3;
+	indirect.vertexOffset = i32(_range->vertex_offset);
+	return indirect;
+}
+
+
+// -------------------------------------------------- MeshAllocator --------------------------------------------------
+
+MeshAllocator::MeshAllocator(DevicePtr dptr) :
+		DeviceLinked(dptr),
+		_vertex_granularity(granularity<VertexSubBuffer>(dptr)),
+		_triangle_granularity(granularity<TriangleSubBuffer>(dptr)) {
+}
+
+MeshAllocator::~MeshAllocator() {
+	if(!_ranges.is_empty()) {
+		y_fatal("Not all meshes have been freed.");
+	}
+}
+
+MeshAllocation MeshAllocator::alloc(core::Span<Vertex> vertices, core::Span<IndexedTriangle> triangles) {
+	y_profile();
+
+	PendingUpload upload;
+	upload.vertices = create_staging(device(), vertices);
+	upload.triangles = create_staging(device(), triangles);
+
+	auto range = std::make_unique<detail::MeshRange>();
+	range->vertex_count = u32(vertices.size());
+	range->triangle_count = u32(triangles.size());
+	range->allocated_vertices = u32(align_up(std::max(vertices.size(), usize(1)), _vertex_granularity));
+	range->allocated_triangles = u32(align_up(std::max(triangles.size(), usize(1)), _triangle_granularity));
+
+	const auto lock = y_profile_unique_lock(_lock);
+
+	bool allocated = false;
+	for(usize i = 0; i != _blocks.size() && !allocated; ++i) {
+		allocated = alloc_in_block(i, *range);
+	}
+	if(!allocated && !alloc_in_block(create_block(range->allocated_vertices, range->allocated_triangles), *range)) {
+		y_fatal("Unable to allocate mesh.");
+	}
+
+	detail::MeshRange* range_ptr = range.get();
+	range->index = _ranges.size();
+	_ranges << std::move(range);
+
+	if(!upload.vertices.is_null() || !upload.triangles.is_null()) {
+		upload.range = range_ptr;
+		_pending << std::move(upload);
+	}
+
+	return MeshAllocation(this, range_ptr);
+}
+
+void MeshAllocator::flush_uploads() {
+	y_profile();
+
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+		if(_pending.is_empty()) {
+			return;
+		}
+	}
+
+	// Staging buffers are released after the submit
+	core::Vector<PendingUpload> uploads;
+
+	CmdBufferRecorder recorder(device()->create_disposable_cmd_buffer());
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+		std::swap(uploads, _pending);
+
+		core::Vector<const MeshBuffers*> dst_buffers;
+		for(const PendingUpload& upload : uploads) {
+			const detail::MeshRange& range = *upload.range;
+			if(!upload.vertices.is_null()) {
+				recorder.copy(upload.vertices, sub_range<BufferUsage::TransferDstBit>(range.buffers->vertices, range.vertex_offset, range.vertex_count));
+			}
+			if(!upload.triangles.is_null()) {
+				recorder.copy(upload.triangles, sub_range<BufferUsage::TransferDstBit>(range.buffers->triangles, range.triangle_offset, range.triangle_count));
+			}
+			if(std::find(dst_buffers.begin(), dst_buffers.end(), range.buffers) == dst_buffers.end()) {
+				dst_buffers << range.buffers;
+			}
+		}
+
+		core::Vector<BufferBarrier> barriers;
+		for(const MeshBuffers* buffers : dst_buffers) {
+			barriers << BufferBarrier(buffers->vertices, PipelineStage::TransferBit, PipelineStage::All);
+			barriers << BufferBarrier(buffers->triangles, PipelineStage::TransferBit, PipelineStage::All);
+		}
+		recorder.barriers(barriers);
+
+		++_upload_submits;
+	}
+
+	device()->graphic_queue().submit<AsyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+}
+
+void MeshAllocator::defragment() {
+	y_profile();
+
+	flush_uploads();
+
+	// Old buffers are destroyed after the submit, the lifetime manager keeps them alive while they are in use
+	core::Vector<MeshBuffers> old_buffers;
+
+	const auto is_compact = [](const core::Vector<FreeRange>& free, usize capacity) {
+		return free.is_empty() || (free.size() == 1 && free[0].offset + free[0].size == capacity);
+	};
+
+	CmdBufferRecorder recorder(device()->create_disposable_cmd_buffer());
+	{
+		const auto lock = y_profile_unique_lock(_lock);
+
+		core::Vector<BufferBarrier> barriers;
+		for(usize i = 0; i != _blocks.size(); ++i) {
+			Block& block = *_blocks[i];
+			const usize vertex_capacity = block.buffers.vertices.size();
+			const usize triangle_capacity = block.buffers.triangles.size();
+			if(is_compact(block.free_vertices, vertex_capacity) && is_compact(block.free_triangles, triangle_capacity)) {
+				continue;
+			}
+
+			MeshBuffers compacted;
+			compacted.vertices = MeshVertexBuffer(device(), vertex_capacity);
+			compacted.triangles = MeshTriangleBuffer(device(), triangle_capacity);
+
+			u32 vertex_end = 0;
+			u32 triangle_end = 0;
+			for(const auto& range : _ranges) {
+				if(range->block != i) {
+					continue;
+				}
+
+				if(range->vertex_count) {
+					recorder.copy(
+						sub_range<BufferUsage::TransferSrcBit>(block.buffers.vertices, range->vertex_offset, range->vertex_count),
+						sub_range<BufferUsage::TransferDstBit>(compacted.vertices, vertex_end, range->vertex_count)
+					);
+				}
+				if(range->triangle_count) {
+					recorder.copy(
+						sub_range<BufferUsage::TransferSrcBit>(block.buffers.triangles, range->triangle_offset, range->triangle_count),
+						sub_range<BufferUsage::TransferDstBit>(compacted.triangles, triangle_end, range->triangle_count)
+					);
+				}
+
+				range->vertex_offset = vertex_end;
+				range->triangle_offset = triangle_end;
+				vertex_end += range->allocated_vertices;
+				triangle_end += range->allocated_triangles;
+			}
+
+			old_buffers << std::move(block.buffers);
+			block.buffers = std::move(compacted);
+
+			block.free_vertices.make_empty();
+			block.free_triangles.make_empty();
+			if(vertex_end != vertex_capacity) {
+				block.free_vertices << FreeRange{vertex_end, u32(vertex_capacity - vertex_end)};
+			}
+			if(triangle_end != triangle_capacity) {
+				block.free_triangles << FreeRange{triangle_end, u32(triangle_capacity - triangle_end)};
+			}
+
+			barriers << BufferBarrier(block.buffers.vertices, PipelineStage::TransferBit, PipelineStage::All);
+			barriers << BufferBarrier(block.buffers.triangles, PipelineStage::TransferBit, PipelineStage::All);
+		}
+
+		recorder.barriers(barriers);
+	}
+
+	device()->graphic_queue().submit<AsyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+}
+
+MeshAllocator::Stats MeshAllocator::stats() const {
+	const auto lock = y_profile_unique_lock(_lock);
+
+	Stats stats;
+	stats.blocks = _blocks.size();
+	stats.meshes = _ranges.size();
+	stats.pending_uploads = _pending.size();
+	stats.upload_submits = _upload_submits;
+
+	for(const auto& block : _blocks) {
+		stats.vertex_capacity += block->buffers.vertices.size();
+		stats.triangle_capacity += block->buffers.triangles.size();
+		stats.allocated_vertices += block->buffers.vertices.size();
+		stats.allocated_triangles += block->buffers.triangles.size();
+		for(const FreeRange& range : block->free_vertices) {
+			stats.allocated_vertices -= range.size;
+		}
+		for(const FreeRange& range : block->free_triangles) {
+			stats.allocated_triangles -= range.size;
+		}
+		stats.free_ranges += block->free_vertices.size() + block->free_triangles.size();
+	}
+
+	return stats;
+}
+
+void MeshAllocator::free(detail::MeshRange* range) {
+	y_profile();
+
+	const auto lock = y_profile_unique_lock(_lock);
+
+	Block& block = *_blocks[range->block];
+	release_range(block.free_vertices, FreeRange{range->vertex_offset, range->allocated_vertices});
+	release_range(block.free_triangles, FreeRange{range->triangle_offset, range->allocated_triangles});
+
+	for(usize i = 0; i < _pending.size();) {
+		if(_pending[i].range == range) {
+			_pending.erase_unordered(_pending.begin() + i);
+		} else {
+			++i;
+		}
+	}
+
+	const usize index = range->index;
+	y_debug_assert(_ranges[index].get() == range);
+	if(index != _ranges.size() - 1) {
+		std::swap(_ranges[index], _ranges.last());
+		_ranges[index]->index = index;
+	}
+	_ranges.pop();
+}
+
+bool MeshAllocator::take_range(core::Vector<FreeRange>& ranges, u32 size, u32& offset) {
+	for(auto it = ranges.begin(); it != ranges.end(); ++it) {
+		if(it->size < size) {
+			continue;
+		}
+
+		offset = it->offset;
+		if(it->size == size) {
+			ranges.erase(it);
+		} else {
+			it->offset += size;
+			it->size -= size;
+		}
+		return true;
+	}
+	return false;
+}
+
+void MeshAllocator::release_range(core::Vector<FreeRange>& ranges, FreeRange range) {
+	// ranges are kept sorted by offset so neighbours can be merged
+	const auto next = std::lower_bound(ranges.begin(), ranges.end(), range.offset, [](const FreeRange& r, u32 offset) { return r.offset < offset; });
+	const bool merge_prev = next != ranges.begin() && (next - 1)->offset + (next - 1)->size == range.offset;
+	const bool merge_next = next != ranges.end() && range.offset + range.size == next->offset;
+
+	if(merge_prev && merge_next) {
+		(next - 1)->size += range.size + next->size;
+		ranges.erase(next);
+	} else if(merge_prev) {
+		(next - 1)->size += range.size;
+	} else if(merge_next) {
+		next->offset = range.offset;
+		next->size += range.size;
+	} else {
+		const usize index = next - ranges.begin();
+		ranges << range;
+		std::rotate(ranges.begin() + index, ranges.end() - 1, ranges.end());
+	}
+}
+
+bool MeshAllocator::alloc_in_block(usize block_index, detail::MeshRange& range) {
+	Block& block = *_blocks[block_index];
+
+	u32 vertex_offset = 0;
+	u32 triangle_offset = 0;
+	if(!take_range(block.free_vertices, range.allocated_vertices, vertex_offset)) {
+		return false;
+	}
+	if(!take_range(block.free_triangles, range.allocated_triangles, triangle_offset)) {
+		release_range(block.free_vertices, FreeRange{vertex_offset, range.allocated_vertices});
+		return false;
+	}
+
+	range.buffers = &block.buffers;
+	range.block = block_index;
+	range.vertex_offset = vertex_offset;
+	range.triangle_offset = triangle_offset;
+	return true;
+}
+
+usize MeshAllocator::create_block(usize min_vertices, usize min_triangles) {
+	y_profile();
+
+	const usize vertices = align_up(std::max(default_block_vertices, min_vertices), _vertex_granularity);
+	const usize triangles = align_up(std::max(default_block_triangles, min_triangles), _triangle_granularity);
+
+	auto block = std::make_unique<Block>();
+	block->buffers.vertices = MeshVertexBuffer(device(), vertices);
+	block->buffers.triangles = MeshTriangleBuffer(device(), triangles);
+	block->free_vertices << FreeRange{0, u32(vertices)};
+	block->free_triangles << FreeRange{0, u32(triangles)};
+
+	_blocks << std::move(block);
+	return _blocks.size() - 1;
+}
+
+}
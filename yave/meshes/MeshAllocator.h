@@ -0,0 +1,168 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_MESHES_MESHALLOCATOR_H
+#define YAVE_MESHES_MESHALLOCATOR_H
+
+#include <yave/graphics/buffers/buffers.h>
+
+#include <y/core/Vector.h>
+
+#include <memory>
+#include <mutex>
+
+namespace yave {
+
+class MeshAllocator;
+
+using MeshTriangleBuffer = TypedBuffer<IndexedTriangle, BufferUsage::IndexBit | BufferUsage::TransferDstBit | BufferUsage::TransferSrcBit, MemoryType::DeviceLocal>;
+using MeshVertexBuffer = TypedBuffer<Vertex, BufferUsage::AttributeBit | BufferUsage::TransferDstBit | BufferUsage::TransferSrcBit, MemoryType::DeviceLocal>;
+
+struct MeshBuffers {
+	MeshTriangleBuffer triangles;
+	MeshVertexBuffer vertices;
+};
+
+namespace detail {
+struct MeshRange {
+	const MeshBuffers* buffers = nullptr;
+	usize block = 0;
+	usize index = 0;
+
+	u32 vertex_offset = 0;
+	u32 vertex_count = 0;
+	u32 allocated_vertices = 0;
+
+	u32 triangle_offset = 0;
+	u32 triangle_count = 0;
+	u32 allocated_triangles = 0;
+};
+}
+
+class MeshAllocation : NonCopyable, public DeviceLinked {
+
+	public:
+		MeshAllocation() = default;
+		~MeshAllocation();
+
+		MeshAllocation(MeshAllocation&& other);
+		MeshAllocation& operator=(MeshAllocation&& other);
+
+		const MeshBuffers& buffers() const;
+
+		TriangleSubBuffer triangle_buffer() const;
+		VertexSubBuffer vertex_buffer() const;
+
+		// Offsets are relative to buffers()
+		VkDrawIndexedIndirectCommand indirect_data() const;
+
+	private:
+		friend class MeshAllocator;
+		friend class LifetimeManager;
+
+		MeshAllocation(MeshAllocator* allocator, detail::MeshRange* range);
+
+		void swap(MeshAllocation& other);
+		void free();
+
+		MeshAllocator* _allocator = nullptr;
+		detail::MeshRange* _range = nullptr;
+};
+
+// Suballocates mesh vertices and triangles out of a few large device buffers so that meshes can share bindings.
+// Uploads are staged when the mesh is created and recorded in a single submit by flush_uploads.
+class MeshAllocator : NonMovable, public DeviceLinked {
+
+	struct FreeRange {
+		u32 offset;
+		u32 size;
+	};
+
+	struct Block {
+		MeshBuffers buffers;
+		core::Vector<FreeRange> free_vertices;
+		core::Vector<FreeRange> free_triangles;
+	};
+
+	struct PendingUpload {
+		detail::MeshRange* range = nullptr;
+		StagingBuffer vertices;
+		StagingBuffer triangles;
+	};
+
+	public:
+		static constexpr usize default_block_vertices = 1024 * 1024;
+		static constexpr usize default_block_triangles = 1024 * 1024;
+
+		struct Stats {
+			usize blocks = 0;
+			usize meshes = 0;
+			usize vertex_capacity = 0;
+			usize allocated_vertices = 0;
+			usize triangle_capacity = 0;
+			usize allocated_triangles = 0;
+			usize free_ranges = 0;
+			usize pending_uploads = 0;
+			usize upload_submits = 0;
+		};
+
+		MeshAllocator(DevicePtr dptr);
+		~MeshAllocator();
+
+		// Thread safe, data is copied to a staging buffer and uploaded by the next flush_uploads
+		MeshAllocation alloc(core::Span<Vertex> vertices, core::Span<IndexedTriangle> triangles);
+
+		// Records every pending upload in a single command buffer and submits it without waiting
+		void flush_uploads();
+
+		// Compacts fragmented blocks on the GPU.
+		// Meshes are moved and MeshAllocation readers don't lock: no thread (frame graph workers, thumbnail rendering, etc)
+		// may record draws or read allocations while this runs, the caller is responsible for this.
+		void defragment();
+
+		Stats stats() const;
+
+	private:
+		friend class MeshAllocation;
+
+		void free(detail::MeshRange* range);
+
+		static bool take_range(core::Vector<FreeRange>& ranges, u32 size, u32& offset);
+		static void release_range(core::Vector<FreeRange>& ranges, FreeRange range);
+
+		bool alloc_in_block(usize block_index, detail::MeshRange& range);
+		usize create_block(usize min_vertices, usize min_triangles);
+
+		usize _vertex_granularity = 1;
+		usize _triangle_granularity = 1;
+
+		core::Vector<std::unique_ptr<Block>> _blocks;
+		core::Vector<std::unique_ptr<detail::MeshRange>> _ranges;
+		core::Vector<PendingUpload> _pending;
+
+		usize _upload_submits = 0;
+
+		mutable std::mutex _lock;
+};
+
+}
+
+#endif // YAVE_MESHES_MESHALLOCATOR_H
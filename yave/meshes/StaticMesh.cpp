@@ -21,49 +21,57 @@ SOFTWARE.
 **********************************/
 #include "StaticMesh.h"
 
-#include <yave/graphics/buffers/TypedWrapper.h>
-#include <yave/graphics/commands/CmdBufferRecorder.h>
-#include <yave/graphics/commands/RecordedCmdBuffer.h>
 #include <yave/device/Device.h>
 
 namespace yave {
 
-StaticMesh::StaticMesh(DevicePtr dptr, const MeshData& mesh_data) :
-		_triangle_buffer(dptr, mesh_data.triangles().size()),
-		_vertex_buffer(dptr, mesh_data.vertices().size()),
+StaticMesh::StaticMesh(DevicePtr dptr, const MeshData& mesh_data, AssetLoadingFlags flags) :
+		_allocation(dptr->mesh_allocator().alloc(mesh_data.vertices(), mesh_data.triangles())),
 		_aabb(mesh_data.aabb()) {
 
-	_indirect_data.indexCount = mesh_data.triangles().size() * 3;
-	_indirect_data.instanceCount = 1;
-
-	CmdBufferRecorder recorder(dptr->create_disposable_cmd_buffer());
-	Mapping::stage(_triangle_buffer, recorder, mesh_data.triangles().data());
-	Mapping::stage(_vertex_buffer, recorder, mesh_data.vertices().data());
-	dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+	if((flags & AssetLoadingFlags::KeepCpuGeometryBit) == AssetLoadingFlags::KeepCpuGeometryBit) {
+		_triangles = mesh_data.triangles();
+		_positions.set_min_capacity(mesh_data.vertices().size());
+		for(const Vertex& v : mesh_data.vertices()) {
+			_positions << v.position;
+		}
+	}
 
 	if(dptr->ray_tracing()) {
+		// The acceleration structure build reads the mesh buffers
+		dptr->mesh_allocator().flush_uploads();
 		_ray_tracing_data = RayTracing::AccelerationStructure(*this);
 	}
 }
 
+StaticMesh::~StaticMesh() {
+	if(device()) {
+		device()->destroy(std::move(_allocation));
+	}
+}
+
 DevicePtr StaticMesh::device() const {
-	return _triangle_buffer.device();
+	return _allocation.device();
 }
 
 bool StaticMesh::is_null() const {
 	return !device();
 }
 
-const TriangleBuffer<>& StaticMesh::triangle_buffer() const {
-	return _triangle_buffer;
+TriangleSubBuffer StaticMesh::triangle_buffer() const {
+	return _allocation.triangle_buffer();
+}
+
+VertexSubBuffer StaticMesh::vertex_buffer() const {
+	return _allocation.vertex_buffer();
 }
 
-const VertexBuffer<>& StaticMesh::vertex_buffer() const {
-	return _vertex_buffer;
+const MeshBuffers& StaticMesh::mesh_buffers() const {
+	return _allocation.buffers();
 }
 
-const VkDrawIndexedIndirectCommand& StaticMesh::indirect_data() const {
-	return _indirect_data;
+VkDrawIndexedIndirectCommand StaticMesh::indirect_data() const {
+	return _allocation.indirect_data();
 }
 
 float StaticMesh::radius() const {
@@ -74,5 +82,17 @@ const AABB& StaticMesh::aabb() const {
 	return _aabb;
 }
 
+bool StaticMesh::has_cpu_geometry() const {
+	return !_triangles.is_empty();
+}
+
+core::Span<math::Vec3> StaticMesh::positions() const {
+	return _positions;
+}
+
+core::Span<IndexedTriangle> StaticMesh::triangles() const {
+	return _triangles;
+}
+
 
 }
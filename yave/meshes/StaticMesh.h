@@ -24,10 +24,10 @@ SOFTWARE.
 
 #include "MeshData.h"
 
-#include <yave/graphics/buffers/buffers.h>
-#include <yave/graphics/buffers/TypedWrapper.h>
+#include "MeshAllocator.h"
 
 #include <yave/assets/AssetTraits.h>
+#include <yave/assets/AssetPtr.h>
 
 #include <yave/device/extentions/RayTracing.h>
 
@@ -38,26 +38,41 @@ class StaticMesh : NonCopyable {
 	public:
 		StaticMesh() = default;
 
-		StaticMesh(DevicePtr dptr, const MeshData& mesh_data);
+		StaticMesh(DevicePtr dptr, const MeshData& mesh_data, AssetLoadingFlags flags = AssetLoadingFlags::None);
+
+		~StaticMesh();
+
+		StaticMesh(StaticMesh&&) = default;
+		StaticMesh& operator=(StaticMesh&&) = default;
 
 		DevicePtr device() const;
 		bool is_null() const;
 
-		const TriangleBuffer<>& triangle_buffer() const;
-		const VertexBuffer<>& vertex_buffer() const;
-		const VkDrawIndexedIndirectCommand& indirect_data() const;
+		// Ranges of this mesh inside the shared buffers
+		TriangleSubBuffer triangle_buffer() const;
+		VertexSubBuffer vertex_buffer() const;
+
+		// Buffers shared with other meshes, indirect_data() offsets are relative to those
+		const MeshBuffers& mesh_buffers() const;
+		VkDrawIndexedIndirectCommand indirect_data() const;
 
 		float radius() const;
 		const AABB& aabb() const;
 
-	private:
-		TriangleBuffer<> _triangle_buffer;
-		VertexBuffer<> _vertex_buffer;
+		// CPU side copy of the geometry, used for picking
+		// Only kept for meshes created with AssetLoadingFlags::KeepCpuGeometryBit, empty otherwise
+		bool has_cpu_geometry() const;
+		core::Span<math::Vec3> positions() const;
+		core::Span<IndexedTriangle> triangles() const;
 
-		VkDrawIndexedIndirectCommand _indirect_data = {};
+	private:
+		MeshAllocation _allocation;
 
 		AABB _aabb;
 
+		core::Vector<math::Vec3> _positions;
+		core::Vector<IndexedTriangle> _triangles;
+
 		Y_TODO(Move this somewhere else)
 		RayTracing::AccelerationStructure _ray_tracing_data;
 };
@@ -26,7 +26,7 @@ SOFTWARE.
 
 namespace yave {
 
-GBufferPass GBufferPass::create(FrameGraph& framegraph, const SceneView& view, const math::Vec2ui& size) {
+GBufferPass GBufferPass::create(FrameGraph& framegraph, const SceneView& view, const math::Vec2ui& size, const SceneRenderSubPassSettings& settings) {
 	static constexpr ImageFormat depth_format = VK_FORMAT_D32_SFLOAT;
 	static constexpr ImageFormat color_format = VK_FORMAT_R8G8B8A8_UNORM;
 	static constexpr ImageFormat normal_format = VK_FORMAT_R16G16B16A16_UNORM;
@@ -41,15 +41,21 @@ GBufferPass GBufferPass::create(FrameGraph& framegraph, const SceneView& view, c
 	pass.depth = depth;
 	pass.color = color;
 	pass.normal = normal;
-	pass.scene_pass = SceneRenderSubPass::create(builder, view);
+	pass.scene_pass = SceneRenderSubPass::create(builder, view, settings);
 
 	builder.add_depth_output(depth);
 	builder.add_color_output(color);
 	builder.add_color_output(normal);
-	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+	if(pass.scene_pass.parallel_recording) {
+		builder.set_secondary_render_func([=](const FrameGraphPass* self) {
+			return pass.scene_pass.render_secondaries(self, concurrent::default_thread_pool().concurency());
+		});
+	} else {
+		builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
 			auto render_pass = recorder.bind_framebuffer(self->framebuffer());
 			pass.scene_pass.render(render_pass, self);
 		});
+	}
 
 	return pass;
 }
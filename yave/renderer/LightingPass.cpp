@@ -26,6 +26,7 @@ SOFTWARE.
 #include <yave/framegraph/FrameGraph.h>
 
 #include <yave/ecs/EntityWorld.h>
+#include <yave/ecs/SystemScheduler.h>
 
 #include <yave/components/PointLightComponent.h>
 #include <yave/components/SpotLightComponent.h>
@@ -38,6 +39,8 @@ SOFTWARE.
 #include <y/core/Chrono.h>
 #include <y/io2/File.h>
 
+#include <mutex>
+
 namespace yave {
 
 static constexpr ImageFormat lighting_format = VK_FORMAT_R16G16B16A16_SFLOAT;
@@ -46,6 +49,98 @@ static constexpr usize max_point_lights = 1024;
 static constexpr usize max_spot_lights = 1024;
 static constexpr usize max_shadow_lights = 128;
 
+// Light uploads are cheap, split them finely so large light counts get spread over the thread pool
+static constexpr usize light_chunk_size = 128;
+
+struct LocalLightsPushData {
+	u32 point_count = 0;
+	u32 spot_count = 0;
+	u32 shadow_count = 0;
+};
+
+// Point and spot lights only read components and write to separate buffers, so they are gathered concurrently.
+// The systems are scheduled once, each run writes into the buffers of the frame being recorded.
+// Several views can be rendered at the same time, so runs are serialized.
+class LocalLightsGatherer : NonMovable {
+	public:
+		struct Output {
+			TypedMapping<uniform::PointLight>& points;
+			TypedMapping<uniform::SpotLight>& spots;
+			TypedMapping<uniform::ShadowMapParams>& shadows;
+			const ShadowMapPass::SubPassData& shadow_lights;
+			LocalLightsPushData& push_data;
+		};
+
+		static LocalLightsGatherer& instance() {
+			static LocalLightsGatherer gatherer;
+			return gatherer;
+		}
+
+		void gather(const ecs::EntityWorld& world, Output& output) {
+			const auto lock = y_profile_unique_lock(_lock);
+			_output = &output;
+			_systems.run(world);
+			_output = nullptr;
+		}
+
+	private:
+		LocalLightsGatherer() {
+			_systems.schedule_read_only("point lights", ecs::ComponentAccess().read<TransformableComponent, PointLightComponent>(), [this](const ecs::EntityWorld& world) {
+				gather_point_lights(world, *_output);
+			});
+			_systems.schedule_read_only("spot lights", ecs::ComponentAccess().read<TransformableComponent, SpotLightComponent>(), [this](const ecs::EntityWorld& world) {
+				gather_spot_lights(world, *_output);
+			});
+		}
+
+		static void gather_point_lights(const ecs::EntityWorld& world, Output& output) {
+			std::atomic<u32> point_count = 0;
+			world.view(PointLightArchetype()).parallel_for_each([&](auto point) {
+				auto [t, l] = point.components();
+				output.points[point_count++] = {
+					t.position(),
+					l.radius(),
+					l.color() * l.intensity(),
+					std::max(math::epsilon<float>, l.falloff())
+				};
+			}, light_chunk_size);
+			output.push_data.point_count = point_count;
+		}
+
+		static void gather_spot_lights(const ecs::EntityWorld& world, Output& output) {
+			std::atomic<u32> spot_count = 0;
+			std::atomic<u32> shadow_count = 0;
+			world.view(SpotLightArchetype()).parallel_for_each([&](auto spot) {
+				auto [t, l] = spot.components();
+
+				u32 shadow_index = u32(-1);
+				if(l.cast_shadow()) {
+					if(const auto it = output.shadow_lights.lights.find(spot.index()); it != output.shadow_lights.lights.end()) {
+						output.shadows[shadow_index = shadow_count++] = it->second;
+					}
+				}
+
+				output.spots[spot_count++] = {
+					t.position(),
+					l.radius(),
+					l.color() * l.intensity(),
+					std::max(math::epsilon<float>, l.falloff()),
+					-t.forward(),
+					std::cos(l.half_angle()),
+					std::max(math::epsilon<float>, l.angle_exponent()),
+					shadow_index,
+					{}
+				};
+			}, light_chunk_size);
+			output.push_data.spot_count = spot_count;
+			output.push_data.shadow_count = shadow_count;
+		}
+
+		std::mutex _lock;
+		Output* _output = nullptr;
+		ecs::SystemScheduler _systems;
+};
+
 static FrameGraphMutableImageId ambient_pass(FrameGraphPassBuilder& builder,
 											 const math::Vec2ui& size,
 											 const GBufferPass& gbuffer,
@@ -98,12 +193,6 @@ static void local_lights_pass(FrameGraphMutableImageId lit,
 							  const GBufferPass& gbuffer,
 							  const ShadowMapPass& shadow_pass) {
 
-	struct PushData {
-		u32 point_count = 0;
-		u32 spot_count = 0;
-		u32 shadow_count = 0;
-	};
-
 	const SceneView& scene = gbuffer.scene_pass.scene_view;
 
 	const auto point_buffer = builder.declare_typed_buffer<uniform::PointLight>(max_point_lights);
@@ -125,46 +214,14 @@ static void local_lights_pass(FrameGraphMutableImageId lit,
 	builder.map_update(shadow_buffer);
 
 	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
-		PushData push_data{0, 0, 0};
-
-		{
-			TypedMapping<uniform::PointLight> mapping = self->resources().mapped_buffer(point_buffer);
-			for(auto [t, l] : scene.world().view(PointLightArchetype()).components()) {
-				mapping[push_data.point_count++] = {
-					t.position(),
-					l.radius(),
-					l.color() * l.intensity(),
-					std::max(math::epsilon<float>, l.falloff())
-				};
-			}
-		}
-
-		{
-			TypedMapping<uniform::SpotLight> mapping = self->resources().mapped_buffer(spot_buffer);
-			TypedMapping<uniform::ShadowMapParams> shadow_mapping = self->resources().mapped_buffer(shadow_buffer);
-			for(auto spot : scene.world().view(SpotLightArchetype())) {
-				auto [t, l] = spot.components();
+		LocalLightsPushData push_data;
 
-				u32 shadow_index = u32(-1);
-				if(l.cast_shadow()) {
-					if(const auto it = shadow_pass.sub_passes->lights.find(spot.index()); it != shadow_pass.sub_passes->lights.end()) {
-						shadow_mapping[shadow_index = push_data.shadow_count++] = it->second;
-					}
-				}
+		TypedMapping<uniform::PointLight> point_mapping = self->resources().mapped_buffer(point_buffer);
+		TypedMapping<uniform::SpotLight> spot_mapping = self->resources().mapped_buffer(spot_buffer);
+		TypedMapping<uniform::ShadowMapParams> shadow_mapping = self->resources().mapped_buffer(shadow_buffer);
 
-				mapping[push_data.spot_count++] = {
-					t.position(),
-					l.radius(),
-					l.color() * l.intensity(),
-					std::max(math::epsilon<float>, l.falloff()),
-					-t.forward(),
-					std::cos(l.half_angle()),
-					std::max(math::epsilon<float>, l.angle_exponent()),
-					shadow_index,
-					{}
-				};
-			}
-		}
+		LocalLightsGatherer::Output output{point_mapping, spot_mapping, shadow_mapping, *shadow_pass.sub_passes, push_data};
+		LocalLightsGatherer::instance().gather(scene.world(), output);
 
 		if(push_data.point_count || push_data.spot_count) {
 			const auto& program = recorder.device()->device_resources()[DeviceResources::DeferredLocalsProgram];
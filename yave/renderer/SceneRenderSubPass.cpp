@@ -23,17 +23,15 @@ SOFTWARE.
 #include "SceneRenderSubPass.h"
 
 #include <yave/framegraph/FrameGraph.h>
-
-#include <yave/ecs/EntityWorld.h>
+#include <yave/scene/RenderQueue.h>
 
 #include <yave/components/TransformableComponent.h>
 #include <yave/components/StaticMeshComponent.h>
-#include <yave/entities/entities.h>
 
 
 namespace yave {
 
-SceneRenderSubPass SceneRenderSubPass::create(FrameGraphPassBuilder& builder, const SceneView& view) {
+SceneRenderSubPass SceneRenderSubPass::create(FrameGraphPassBuilder& builder, const SceneView& view, const SceneRenderSubPassSettings& settings) {
 	auto camera_buffer = builder.declare_typed_buffer<Renderable::CameraData>();
 	const auto transform_buffer = builder.declare_typed_buffer<math::Transform<>>(max_batch_size);
 
@@ -42,45 +40,105 @@ SceneRenderSubPass SceneRenderSubPass::create(FrameGraphPassBuilder& builder, co
 	pass.descriptor_set_index = builder.next_descriptor_set_index();
 	pass.camera_buffer = camera_buffer;
 	pass.transform_buffer = transform_buffer;
+	pass.use_indirect = settings.use_indirect;
+	pass.parallel_recording = settings.parallel_recording;
 
 	builder.add_uniform_input(camera_buffer, pass.descriptor_set_index);
 	builder.add_attrib_input(transform_buffer);
 	builder.map_update(camera_buffer);
 	builder.map_update(transform_buffer);
 
+	if(settings.use_indirect) {
+		const auto indirect_buffer = builder.declare_typed_buffer<VkDrawIndexedIndirectCommand>(max_indirect_draws);
+		pass.indirect_buffer = indirect_buffer;
+		builder.add_indirect_input(indirect_buffer);
+		builder.map_update(indirect_buffer);
+	}
+
 	return pass;
 }
 
-static usize render_world(const SceneRenderSubPass* sub_pass, RenderPassRecorder& recorder, const FrameGraphPass* pass, usize index = 0) {
+namespace {
+// Everything written by the CPU before the draws can be recorded
+struct PreparedWorld {
+	RenderQueue queue;
+	u32 first_instance = 0;
+	bool indirect = false;
+};
+}
+
+static PreparedWorld prepare_world(const SceneRenderSubPass* sub_pass, const FrameGraphPass* pass, usize index = 0) {
 	y_profile();
-	const auto region = recorder.region("Scene");
 
-	const ecs::EntityWorld& world = sub_pass->scene_view.world();
+	PreparedWorld world;
+	world.queue = RenderQueue(cull_static_meshes(sub_pass->scene_view));
 
 	auto transform_mapping = pass->resources().mapped_buffer(sub_pass->transform_buffer);
+	for(const TransformableComponent* transform : world.queue.transforms()) {
+		transform_mapping[index++] = transform->transform();
+	}
+
+	world.first_instance = u32(index - world.queue.size());
+	if(sub_pass->use_indirect) {
+		auto indirect_mapping = pass->resources().mapped_buffer(sub_pass->indirect_buffer);
+		const core::MutableSpan<VkDrawIndexedIndirectCommand> commands(indirect_mapping.begin(), indirect_mapping.size());
+		world.indirect = world.queue.write_indirect_commands(commands, world.first_instance);
+	}
+
+	return world;
+}
+
+static RenderQueueStats record_world(const SceneRenderSubPass* sub_pass, const PreparedWorld& world, RenderPassRecorder& recorder, const FrameGraphPass* pass, usize first_batch, usize end_batch) {
+	y_profile();
+	const auto region = recorder.region("Scene");
+
 	const auto transforms = pass->resources().buffer<BufferUsage::AttributeBit>(sub_pass->transform_buffer);
 	const auto& descriptor_set = pass->descriptor_sets()[sub_pass->descriptor_set_index];
 
 	recorder.bind_attrib_buffers({}, {transforms});
 
-	for(const auto& [tr, me] : world.view(StaticMeshArchetype()).components()) {
-		transform_mapping[index] = tr.transform();
-		me.render(recorder, Renderable::SceneData{descriptor_set, u32(index)});
-		++index;
+	if(world.indirect) {
+		const auto indirect = pass->resources().buffer<BufferUsage::IndirectBit>(sub_pass->indirect_buffer);
+		return world.queue.render_indirect_range(first_batch, end_batch, recorder, descriptor_set, indirect);
 	}
+	return world.queue.render_range(first_batch, end_batch, recorder, descriptor_set, world.first_instance);
+}
 
-	return index;
+static void write_camera(const SceneRenderSubPass* sub_pass, const FrameGraphPass* pass) {
+	auto camera_mapping = pass->resources().mapped_buffer(sub_pass->camera_buffer);
+	camera_mapping[0] = sub_pass->scene_view.camera();
 }
 
 void SceneRenderSubPass::render(RenderPassRecorder& recorder, const FrameGraphPass* pass) const {
 	// fill render data
-	auto camera_mapping = pass->resources().mapped_buffer(camera_buffer);
-	camera_mapping[0] = scene_view.camera();
+	write_camera(this, pass);
 
-	usize index = 0;
 	if(scene_view.has_world()) {
-		index = render_world(this, recorder, pass, index);
+		const PreparedWorld world = prepare_world(this, pass);
+		add_render_queue_stats(pass->name(), record_world(this, world, recorder, pass, 0, world.queue.batches().size()));
+	}
+}
+
+core::Vector<SecondaryCmdBufferRecorder> SceneRenderSubPass::render_secondaries(const FrameGraphPass* pass, usize max_chunks) const {
+	y_profile();
+
+	write_camera(this, pass);
+
+	if(!scene_view.has_world()) {
+		return {};
 	}
+
+	// Culling, sorting and buffer writes are done once, only the draws are split
+	const PreparedWorld world = prepare_world(this, pass);
+
+	const usize batch_count = world.queue.batches().size();
+	const usize chunk_count = std::clamp(batch_count / min_batches_per_chunk, usize(1), std::max(max_chunks, usize(1)));
+
+	return pass->record_secondaries(chunk_count, [&](RenderPassRecorder& recorder, usize chunk) {
+		const usize begin = batch_count * chunk / chunk_count;
+		const usize end = batch_count * (chunk + 1) / chunk_count;
+		add_render_queue_stats(pass->name(), record_world(this, world, recorder, pass, begin, end));
+	});
 }
 
 }
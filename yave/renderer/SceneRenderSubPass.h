@@ -30,21 +30,37 @@ SOFTWARE.
 namespace yave {
 
 class RenderPassRecorder;
+class SecondaryCmdBufferRecorder;
 class FrameGraphPassBuilder;
 
+struct SceneRenderSubPassSettings {
+	bool use_indirect = true;
+	bool parallel_recording = true;
+};
+
 struct SceneRenderSubPass {
 	static constexpr usize max_batch_size = 128 * 1024;
+	static constexpr usize max_indirect_draws = 16 * 1024;
+
+	// Below this, splitting the draws costs more than it saves
+	static constexpr usize min_batches_per_chunk = 64;
 
 	SceneView scene_view;
 	usize descriptor_set_index = 0;
+	bool use_indirect = true;
+	bool parallel_recording = true;
 
 	Y_TODO(remove mutable)
 	FrameGraphMutableTypedBufferId<Renderable::CameraData> camera_buffer;
 	FrameGraphMutableTypedBufferId<math::Transform<>> transform_buffer;
+	FrameGraphMutableTypedBufferId<VkDrawIndexedIndirectCommand> indirect_buffer;
 
-	static SceneRenderSubPass create(FrameGraphPassBuilder& builder, const SceneView& view);
+	static SceneRenderSubPass create(FrameGraphPassBuilder& builder, const SceneView& view, const SceneRenderSubPassSettings& settings = SceneRenderSubPassSettings());
 	void render(RenderPassRecorder& recorder, const FrameGraphPass* pass) const;
 
+	// Same as render, but the draws are split between up to max_chunks secondaries recorded in parallel
+	core::Vector<SecondaryCmdBufferRecorder> render_secondaries(const FrameGraphPass* pass, usize max_chunks) const;
+
 };
 
 
@@ -82,16 +82,27 @@ ShadowMapPass ShadowMapPass::create(FrameGraph& framegraph, const SceneView& sce
 	}
 
 	builder.add_depth_output(shadow_map);
-	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
-		auto render_pass = recorder.bind_framebuffer(self->framebuffer());
-
-		usize index = 0;
-		const u32 size = shadow_map_size.x();
-		for(const auto& sub_pass : pass.sub_passes->passes) {
-			render_pass.set_viewport(Viewport(math::Vec2(size, size), math::Vec2(0, index++ * size)));
-			sub_pass.scene_pass.render(render_pass, self);
-		}
-	});
+	if(settings.parallel_recording) {
+		// One secondary per light
+		builder.set_secondary_render_func([=](const FrameGraphPass* self) {
+			const u32 size = shadow_map_size.x();
+			return self->record_secondaries(pass.sub_passes->passes.size(), [&](RenderPassRecorder& render_pass, usize index) {
+				render_pass.set_viewport(Viewport(math::Vec2(size, size), math::Vec2(0, index * size)));
+				pass.sub_passes->passes[index].scene_pass.render(render_pass, self);
+			});
+		});
+	} else {
+		builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+			auto render_pass = recorder.bind_framebuffer(self->framebuffer());
+
+			usize index = 0;
+			const u32 size = shadow_map_size.x();
+			for(const auto& sub_pass : pass.sub_passes->passes) {
+				render_pass.set_viewport(Viewport(math::Vec2(size, size), math::Vec2(0, index++ * size)));
+				sub_pass.scene_pass.render(render_pass, self);
+			}
+		});
+	}
 
 	return pass;
 }
@@ -32,6 +32,7 @@ namespace yave {
 
 struct ShadowMapPassSettings {
 	math::Vec2ui shadow_map_size = math::Vec2ui(1024, 1024 * 8);
+	bool parallel_recording = true;
 };
 
 struct ShadowMapPass {
@@ -29,8 +29,8 @@ DefaultRenderer DefaultRenderer::create(FrameGraph& framegraph, const SceneView&
 
 	DefaultRenderer renderer;
 
-	renderer.gbuffer = GBufferPass::create(framegraph, view, size);
-	renderer.lighting = LightingPass::create(framegraph, renderer.gbuffer, ibl_probe);
+	renderer.gbuffer = GBufferPass::create(framegraph, view, size, settings.scene);
+	renderer.lighting = LightingPass::create(framegraph, renderer.gbuffer, ibl_probe, settings.shadow_map);
 	renderer.sky = RayleighSkyPass::create(framegraph, renderer.lighting.lit, renderer.gbuffer.depth, renderer.gbuffer);
 	renderer.tone_mapping = ToneMappingPass::create(framegraph, renderer.sky.lit, settings.tone_mapping);
 
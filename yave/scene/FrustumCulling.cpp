@@ -0,0 +1,167 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FrustumCulling.h"
+
+#include <yave/ecs/EntityWorld.h>
+#include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/entities/entities.h>
+
+#include <y/utils/perf.h>
+
+#include <atomic>
+
+namespace yave {
+
+// Boxes are tested box_block_size at a time, stored as SoA so that the plane tests vectorize
+static constexpr usize box_block_size = 8;
+static constexpr usize culling_chunk_size = 4096;
+
+static std::atomic<usize> total_visible = 0;
+static std::atomic<usize> total_culled = 0;
+
+namespace {
+struct alignas(32) BoxBlock {
+	float center[3][box_block_size] = {};
+	float half_extent[3][box_block_size] = {};
+
+	void set(usize lane, const math::Transform<>& tr, const AABB& aabb) {
+		const math::Vec3 aabb_center = aabb.center();
+		const math::Vec3 aabb_half_extent = aabb.half_extent();
+		for(usize r = 0; r != 3; ++r) {
+			float c = tr[3][r];
+			float e = 0.0f;
+			for(usize k = 0; k != 3; ++k) {
+				c += tr[k][r] * aabb_center[k];
+				e += std::abs(tr[k][r]) * aabb_half_extent[k];
+			}
+			center[r][lane] = c;
+			half_extent[r][lane] = e;
+		}
+	}
+};
+}
+
+static void test_block(const BoxBlock& block, const Frustum& frustum, u32 (&inside)[box_block_size]) {
+	for(usize i = 0; i != box_block_size; ++i) {
+		inside[i] = 1;
+	}
+
+	for(const Plane& plane : frustum) {
+		const math::Vec3 abs_normal = plane.to<3>().abs();
+		for(usize i = 0; i != box_block_size; ++i) {
+			const float dist = plane.x() * block.center[0][i] + plane.y() * block.center[1][i] + plane.z() * block.center[2][i] + plane.w();
+			const float radius = abs_normal.x() * block.half_extent[0][i] + abs_normal.y() * block.half_extent[1][i] + abs_normal.z() * block.half_extent[2][i];
+			// Written this way so degenerate (NaN) planes never cull anything, like Frustum::is_inside
+			inside[i] &= u32(!(dist + radius < 0.0f));
+		}
+	}
+}
+
+template<typename V>
+static CullingStats cull_chunk(const V& chunk, const Frustum& frustum, core::Vector<VisibleStaticMesh>& visible) {
+	BoxBlock block;
+	VisibleStaticMesh candidates[box_block_size];
+	usize count = 0;
+	usize tested = 0;
+
+	const auto flush = [&] {
+		u32 inside[box_block_size];
+		test_block(block, frustum, inside);
+		for(usize i = 0; i != count; ++i) {
+			if(inside[i]) {
+				visible << candidates[i];
+			}
+		}
+		count = 0;
+	};
+
+	for(auto ent : chunk) {
+		const auto& [tr, me] = ent.components();
+		if(!me.mesh()) {
+			continue;
+		}
+
+		candidates[count] = VisibleStaticMesh{ent.index(), &tr, &me};
+		block.set(count, tr.transform(), me.mesh()->aabb());
+
+		++tested;
+		if(++count == box_block_size) {
+			flush();
+		}
+	}
+
+	if(count) {
+		flush();
+	}
+
+	CullingStats stats;
+	stats.visible = visible.size();
+	stats.culled = tested - visible.size();
+	return stats;
+}
+
+core::Vector<VisibleStaticMesh> cull_static_meshes(const SceneView& view) {
+	y_profile();
+
+	const Frustum frustum = view.camera().frustum();
+	const auto entities = view.world().view(StaticMeshArchetype());
+
+	const usize chunk_count = entities.chunk_count(culling_chunk_size);
+	auto chunks = std::make_unique<core::Vector<VisibleStaticMesh>[]>(chunk_count);
+	auto chunk_stats = std::make_unique<CullingStats[]>(chunk_count);
+
+	entities.parallel_for_chunks([&](usize chunk_index, const auto& chunk) {
+		chunk_stats[chunk_index] = cull_chunk(chunk, frustum, chunks[chunk_index]);
+	}, culling_chunk_size);
+
+	CullingStats stats;
+	core::Vector<VisibleStaticMesh> visible;
+	for(usize i = 0; i != chunk_count; ++i) {
+		stats.visible += chunk_stats[i].visible;
+		stats.culled += chunk_stats[i].culled;
+	}
+
+	if(chunk_count == 1) {
+		visible = std::move(chunks[0]);
+	} else {
+		visible.set_min_capacity(stats.visible);
+		for(usize i = 0; i != chunk_count; ++i) {
+			visible.push_back(chunks[i].begin(), chunks[i].end());
+		}
+	}
+
+	total_visible += stats.visible;
+	total_culled += stats.culled;
+
+	return visible;
+}
+
+CullingStats flush_culling_stats() {
+	CullingStats stats;
+	stats.visible = total_visible.exchange(0);
+	stats.culled = total_culled.exchange(0);
+	return stats;
+}
+
+}
@@ -0,0 +1,56 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_SCENE_FRUSTUMCULLING_H
+#define YAVE_SCENE_FRUSTUMCULLING_H
+
+#include "SceneView.h"
+
+#include <yave/ecs/EntityId.h>
+
+#include <y/core/Vector.h>
+
+namespace yave {
+
+class TransformableComponent;
+class StaticMeshComponent;
+
+struct CullingStats {
+	usize visible = 0;
+	usize culled = 0;
+};
+
+struct VisibleStaticMesh {
+	ecs::EntityIndex index = {};
+	const TransformableComponent* transform = nullptr;
+	const StaticMeshComponent* mesh = nullptr;
+};
+
+// Returns every static mesh of the view's world whose world space AABB intersects the camera frustum, in view iteration order
+// Entities without a mesh are skipped and not counted
+core::Vector<VisibleStaticMesh> cull_static_meshes(const SceneView& view);
+
+// Returns the totals of all cull_static_meshes calls since the previous call
+CullingStats flush_culling_stats();
+
+}
+
+#endif // YAVE_SCENE_FRUSTUMCULLING_H
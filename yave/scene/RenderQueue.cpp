@@ -0,0 +1,260 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "RenderQueue.h"
+
+#include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/device/Device.h>
+
+#include <y/core/HashMap.h>
+#include <y/utils/sort.h>
+#include <y/utils/perf.h>
+
+#include <mutex>
+#include <array>
+
+namespace yave {
+
+// Sort key layout, from most to least significant bits: [template:16][material:24][mesh:24]
+static constexpr usize template_bits = 16;
+static constexpr usize material_bits = 24;
+static constexpr usize mesh_bits = 24;
+
+static_assert(template_bits + material_bits + mesh_bits == 64);
+
+static std::mutex stats_lock;
+static core::Vector<std::pair<core::String, RenderQueueStats>> pass_stats;
+
+namespace {
+struct SortEntry {
+	u64 key = 0;
+	u32 index = 0;
+};
+
+class DenseIndices {
+	public:
+		u32 operator()(const void* ptr) {
+			return _indices.emplace(ptr, u32(_indices.size())).first->second;
+		}
+
+	private:
+		core::ExternalHashMap<const void*, u32> _indices;
+};
+}
+
+RenderQueue::RenderQueue(core::Span<VisibleStaticMesh> meshes) {
+	y_profile();
+
+	DenseIndices templates;
+	DenseIndices materials;
+	DenseIndices static_meshes;
+
+	core::Vector<SortEntry> entries;
+	entries.set_min_capacity(meshes.size());
+
+	for(usize i = 0; i != meshes.size(); ++i) {
+		const StaticMeshComponent* component = meshes[i].mesh;
+		if(!component->material() || !component->mesh()) {
+			continue;
+		}
+
+		const Material* material = component->material().get();
+		const u64 template_index = templates(material->material_template());
+		const u64 material_index = materials(material);
+		const u64 mesh_index = static_meshes(component->mesh().get());
+
+		y_debug_assert(template_index < (u64(1) << template_bits));
+		y_debug_assert(material_index < (u64(1) << material_bits));
+		y_debug_assert(mesh_index < (u64(1) << mesh_bits));
+
+		const u64 key = (template_index << (material_bits + mesh_bits)) | (material_index << mesh_bits) | mesh_index;
+		entries << SortEntry{key, u32(i)};
+	}
+
+	{
+		y_profile_zone("sort");
+		core::Vector<SortEntry> buffer(entries.size(), SortEntry{});
+		radix_sort(entries.data(), entries.data() + entries.size(), buffer.data(), [](const SortEntry& e) { return e.key; });
+	}
+
+	_transforms.set_min_capacity(entries.size());
+	for(usize i = 0; i != entries.size(); ++i) {
+		const VisibleStaticMesh& visible = meshes[entries[i].index];
+		_transforms << visible.transform;
+
+		if(i && entries[i - 1].key == entries[i].key) {
+			++_batches.last().instance_count;
+		} else {
+			_batches << RenderBatch {
+				visible.mesh->material()->material_template(),
+				visible.mesh->material().get(),
+				visible.mesh->mesh().get(),
+				u32(i), 1
+			};
+		}
+	}
+}
+
+core::Span<const TransformableComponent*> RenderQueue::transforms() const {
+	return _transforms;
+}
+
+core::Span<RenderBatch> RenderQueue::batches() const {
+	return _batches;
+}
+
+usize RenderQueue::size() const {
+	return _transforms.size();
+}
+
+static VkDrawIndexedIndirectCommand draw_command(const RenderBatch& batch, u32 first_instance) {
+	VkDrawIndexedIndirectCommand indirect = batch.mesh->indirect_data();
+	indirect.instanceCount = batch.instance_count;
+	indirect.firstInstance = first_instance + batch.first_instance;
+	return indirect;
+}
+
+// Binds pipelines, descriptor sets and buffers only when they change, then calls draw(begin, end, stats)
+// for every run of batches in [first, last) that share the same material and mesh buffers
+template<typename F>
+static RenderQueueStats record_batches(core::Span<RenderBatch> batches, usize first, usize last, RenderPassRecorder& recorder, const DescriptorSetBase& scene_set, F&& draw) {
+	y_debug_assert(first <= last && last <= batches.size());
+
+	RenderQueueStats stats;
+
+	const MaterialTemplate* bound_template = nullptr;
+	const Material* bound_material = nullptr;
+	const MeshBuffers* bound_buffers = nullptr;
+
+	usize begin = first;
+	while(begin != last) {
+		const RenderBatch& batch = batches[begin];
+
+		if(batch.material != bound_material) {
+			const DescriptorSetBase& material_set = batch.material->descriptor_set();
+			const std::array<DescriptorSetBase, 2> sets = {scene_set, material_set};
+			const core::Span<DescriptorSetBase> set_list(sets.data(), material_set.is_null() ? 1 : 2);
+
+			if(batch.material_template != bound_template) {
+				recorder.bind_material(batch.material_template, set_list);
+				bound_template = batch.material_template;
+				++stats.pipeline_binds;
+			} else {
+				recorder.bind_descriptor_sets(batch.material_template, set_list);
+			}
+
+			bound_material = batch.material;
+			++stats.descriptor_binds;
+		}
+
+		// Meshes share buffers, so this usually only happens once per pass
+		if(&batch.mesh->mesh_buffers() != bound_buffers) {
+			bound_buffers = &batch.mesh->mesh_buffers();
+			recorder.bind_buffers(TriangleSubBuffer(bound_buffers->triangles), VertexSubBuffer(bound_buffers->vertices));
+			++stats.buffer_binds;
+		}
+
+		usize end = begin + 1;
+		while(end != last && batches[end].material == bound_material && &batches[end].mesh->mesh_buffers() == bound_buffers) {
+			++end;
+		}
+
+		draw(begin, end, stats);
+		begin = end;
+	}
+
+	return stats;
+}
+
+RenderQueueStats RenderQueue::render(RenderPassRecorder& recorder, const DescriptorSetBase& scene_set, u32 first_instance) const {
+	return render_range(0, _batches.size(), recorder, scene_set, first_instance);
+}
+
+RenderQueueStats RenderQueue::render_range(usize first_batch, usize end_batch, RenderPassRecorder& recorder, const DescriptorSetBase& scene_set, u32 first_instance) const {
+	y_profile();
+
+	return record_batches(_batches, first_batch, end_batch, recorder, scene_set, [&](usize begin, usize end, RenderQueueStats& stats) {
+		for(usize i = begin; i != end; ++i) {
+			recorder.draw(draw_command(_batches[i], first_instance));
+			++stats.draws;
+			stats.instances += _batches[i].instance_count;
+		}
+	});
+}
+
+RenderQueueStats RenderQueue::render_indirect(RenderPassRecorder& recorder, const DescriptorSetBase& scene_set,
+											  core::MutableSpan<VkDrawIndexedIndirectCommand> commands, const SubBuffer<BufferUsage::IndirectBit>& indirect_buffer,
+											  u32 first_instance) const {
+	if(!write_indirect_commands(commands, first_instance)) {
+		return render(recorder, scene_set, first_instance);
+	}
+	return render_indirect_range(0, _batches.size(), recorder, scene_set, indirect_buffer);
+}
+
+bool RenderQueue::write_indirect_commands(core::MutableSpan<VkDrawIndexedIndirectCommand> commands, u32 first_instance) const {
+	y_profile();
+
+	if(_batches.size() > commands.size()) {
+		return false;
+	}
+
+	for(usize i = 0; i != _batches.size(); ++i) {
+		commands[i] = draw_command(_batches[i], first_instance);
+	}
+	return true;
+}
+
+RenderQueueStats RenderQueue::render_indirect_range(usize first_batch, usize end_batch, RenderPassRecorder& recorder, const DescriptorSetBase& scene_set,
+													const SubBuffer<BufferUsage::IndirectBit>& indirect_buffer) const {
+	y_profile();
+
+	return record_batches(_batches, first_batch, end_batch, recorder, scene_set, [&](usize begin, usize end, RenderQueueStats& stats) {
+		recorder.draw_indirect(indirect_buffer, begin, end - begin);
+		++stats.draws;
+		for(usize i = begin; i != end; ++i) {
+			stats.instances += _batches[i].instance_count;
+		}
+	});
+}
+
+void add_render_queue_stats(std::string_view pass_name, const RenderQueueStats& stats) {
+	const std::unique_lock lock(stats_lock);
+
+	const auto it = std::find_if(pass_stats.begin(), pass_stats.end(), [&](const auto& p) { return std::string_view(p.first) == pass_name; });
+	RenderQueueStats& total = it == pass_stats.end()
+		? pass_stats.emplace_back(core::String(pass_name), RenderQueueStats()).second
+		: it->second;
+
+	total.pipeline_binds += stats.pipeline_binds;
+	total.descriptor_binds += stats.descriptor_binds;
+	total.buffer_binds += stats.buffer_binds;
+	total.draws += stats.draws;
+	total.instances += stats.instances;
+}
+
+core::Vector<std::pair<core::String, RenderQueueStats>> flush_render_queue_stats() {
+	const std::unique_lock lock(stats_lock);
+	return std::exchange(pass_stats, {});
+}
+
+}
@@ -0,0 +1,92 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_SCENE_RENDERQUEUE_H
+#define YAVE_SCENE_RENDERQUEUE_H
+
+#include "FrustumCulling.h"
+
+#include <yave/graphics/buffers/SubBuffer.h>
+
+#include <y/core/String.h>
+
+namespace yave {
+
+struct RenderQueueStats {
+	usize pipeline_binds = 0;
+	usize descriptor_binds = 0;
+	usize buffer_binds = 0;
+	usize draws = 0;
+	usize instances = 0;
+};
+
+struct RenderBatch {
+	const MaterialTemplate* material_template = nullptr;
+	const Material* material = nullptr;
+	const StaticMesh* mesh = nullptr;
+	u32 first_instance = 0;
+	u32 instance_count = 0;
+};
+
+// Sits between culling and recording: meshes are sorted by (pipeline, material, mesh)
+// and consecutive identical (material, mesh) pairs are merged into a single instanced draw
+class RenderQueue : NonCopyable {
+	public:
+		RenderQueue() = default;
+		RenderQueue(core::Span<VisibleStaticMesh> meshes);
+
+		// Transforms in instance order, instance i reads the transform at index first_instance + i
+		core::Span<const TransformableComponent*> transforms() const;
+		core::Span<RenderBatch> batches() const;
+
+		usize size() const;
+
+		// Binds a pipeline, descriptor sets or buffers only when they differ from the previous batch
+		RenderQueueStats render(RenderPassRecorder& recorder, const DescriptorSetBase& scene_set, u32 first_instance = 0) const;
+
+		// Writes one command per batch in commands (which should be mapped from indirect_buffer),
+		// then issues a single indirect draw per material and mesh buffers. Falls back to render if commands is too small
+		RenderQueueStats render_indirect(RenderPassRecorder& recorder, const DescriptorSetBase& scene_set,
+										 core::MutableSpan<VkDrawIndexedIndirectCommand> commands, const SubBuffer<BufferUsage::IndirectBit>& indirect_buffer,
+										 u32 first_instance = 0) const;
+
+		// Range variants used to split recording over several command buffers, they only record batches in [first_batch, end_batch).
+		// render_indirect_range reads the commands written by write_indirect_commands, which returns false if commands is too small
+		RenderQueueStats render_range(usize first_batch, usize end_batch, RenderPassRecorder& recorder, const DescriptorSetBase& scene_set, u32 first_instance = 0) const;
+
+		bool write_indirect_commands(core::MutableSpan<VkDrawIndexedIndirectCommand> commands, u32 first_instance = 0) const;
+		RenderQueueStats render_indirect_range(usize first_batch, usize end_batch, RenderPassRecorder& recorder, const DescriptorSetBase& scene_set,
+											   const SubBuffer<BufferUsage::IndirectBit>& indirect_buffer) const;
+
+	private:
+		core::Vector<const TransformableComponent*> _transforms;
+		core::Vector<RenderBatch> _batches;
+};
+
+// Adds stats to the totals of the named pass
+void add_render_queue_stats(std::string_view pass_name, const RenderQueueStats& stats);
+
+// Returns the per pass totals since the previous call
+core::Vector<std::pair<core::String, RenderQueueStats>> flush_render_queue_stats();
+
+}
+
+#endif // YAVE_SCENE_RENDERQUEUE_H
@@ -0,0 +1,192 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "SpatialIndex.h"
+
+#include <yave/ecs/EntityWorld.h>
+#include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/entities/entities.h>
+
+#include <y/utils/perf.h>
+
+namespace yave {
+
+static AABB world_aabb(const math::Transform<>& tr, const AABB& aabb) {
+	const math::Vec3 center = aabb.center();
+	const math::Vec3 half_extent = aabb.half_extent();
+
+	math::Vec3 world_center;
+	math::Vec3 world_half_extent;
+	for(usize r = 0; r != 3; ++r) {
+		world_center[r] = tr[3][r];
+		for(usize k = 0; k != 3; ++k) {
+			world_center[r] += tr[k][r] * center[k];
+			world_half_extent[r] += std::abs(tr[k][r]) * half_extent[k];
+		}
+	}
+
+	return AABB(world_center - world_half_extent, world_center + world_half_extent);
+}
+
+// Möller-Trumbore, double sided. Returns the ray parameter of the closest triangle hit in ]0, max_t[, or max_t
+static float raycast_mesh(const StaticMesh& mesh, const math::Vec3& origin, const math::Vec3& direction, float max_t) {
+	const core::Span<math::Vec3> positions = mesh.positions();
+	for(const IndexedTriangle& tri : mesh.triangles()) {
+		const math::Vec3& a = positions[tri[0]];
+		const math::Vec3 e1 = positions[tri[1]] - a;
+		const math::Vec3 e2 = positions[tri[2]] - a;
+
+		const math::Vec3 p = direction.cross(e2);
+		const float det = e1.dot(p);
+		if(std::abs(det) < math::epsilon<float>) {
+			continue;
+		}
+
+		const float inv_det = 1.0f / det;
+		const math::Vec3 s = origin - a;
+		const float u = s.dot(p) * inv_det;
+		if(u < 0.0f || u > 1.0f) {
+			continue;
+		}
+
+		const math::Vec3 q = s.cross(e1);
+		const float v = direction.dot(q) * inv_det;
+		if(v < 0.0f || u + v > 1.0f) {
+			continue;
+		}
+
+		const float t = e2.dot(q) * inv_det;
+		if(t > 0.0f && t < max_t) {
+			max_t = t;
+		}
+	}
+	return max_t;
+}
+
+SpatialIndex::SpatialIndex() {
+}
+
+usize SpatialIndex::update(const ecs::EntityWorld& world) {
+	y_profile();
+
+	++_stamp;
+	usize updated = 0;
+
+	for(auto ent : world.view(StaticMeshArchetype())) {
+		const auto& [tr, me] = ent.components();
+		const StaticMesh* mesh = me.mesh().get();
+		if(!mesh) {
+			continue;
+		}
+
+		const ecs::EntityIndex index = ent.index();
+		while(_entries.size() <= index) {
+			_entries.emplace_back();
+		}
+
+		Entry& entry = _entries[index];
+		entry.stamp = _stamp;
+
+		if(entry.proxy != math::BVH::invalid_proxy && entry.mesh == mesh && entry.transform == tr.transform()) {
+			continue;
+		}
+
+		entry.mesh = mesh;
+		entry.transform = tr.transform();
+		entry.aabb = world_aabb(entry.transform, mesh->aabb());
+
+		if(entry.proxy == math::BVH::invalid_proxy) {
+			entry.proxy = _bvh.insert(entry.aabb.min(), entry.aabb.max(), index);
+		} else {
+			_bvh.update(entry.proxy, entry.aabb.min(), entry.aabb.max());
+		}
+		++updated;
+	}
+
+	// Entities that weren't seen this update have been removed or lost their mesh
+	for(Entry& entry : _entries) {
+		if(entry.proxy != math::BVH::invalid_proxy && entry.stamp != _stamp) {
+			_bvh.remove(entry.proxy);
+			entry = Entry();
+			++updated;
+		}
+	}
+
+	return updated;
+}
+
+void SpatialIndex::clear() {
+	_bvh.clear();
+	_entries.clear();
+}
+
+usize SpatialIndex::size() const {
+	return _bvh.size();
+}
+
+core::Vector<ecs::EntityIndex> SpatialIndex::query_box(const AABB& aabb) const {
+	core::Vector<ecs::EntityIndex> indexes;
+	_bvh.for_each_in_box(aabb.min(), aabb.max(), [&](u32 index) { indexes << index; });
+	return indexes;
+}
+
+core::Vector<ecs::EntityIndex> SpatialIndex::query_sphere(const math::Vec3& center, float radius) const {
+	core::Vector<ecs::EntityIndex> indexes;
+	_bvh.for_each_in_sphere(center, radius, [&](u32 index) { indexes << index; });
+	return indexes;
+}
+
+core::Vector<ecs::EntityIndex> SpatialIndex::query_frustum(const Frustum& frustum) const {
+	core::Vector<ecs::EntityIndex> indexes;
+	_bvh.for_each_in_frustum(frustum, [&](u32 index) { indexes << index; });
+	return indexes;
+}
+
+core::Result<SpatialIndex::RayHit> SpatialIndex::raycast(const math::Vec3& origin, const math::Vec3& direction, float max_dist) const {
+	y_profile();
+
+	RayHit hit{ecs::EntityIndex(-1), max_dist};
+
+	// Candidates are visited nearest box first and pruned once their box is further than the closest triangle hit
+	_bvh.raycast(origin, direction, max_dist, [&](u32 index, float) {
+		const Entry& entry = _entries[index];
+
+		// The transform is affine, so the ray parameter is the same in local and world space
+		const math::Matrix4<> inv = entry.transform.inverse();
+		const math::Vec3 local_origin = (inv * math::Vec4(origin, 1.0f)).to<3>();
+		const math::Vec3 local_dir = (inv * math::Vec4(direction, 0.0f)).to<3>();
+
+		const float dist = raycast_mesh(*entry.mesh, local_origin, local_dir, hit.distance);
+		if(dist < hit.distance) {
+			hit = RayHit{index, dist};
+		}
+		return hit.distance;
+	});
+
+	if(hit.index == ecs::EntityIndex(-1)) {
+		return core::Err();
+	}
+	return core::Ok(hit);
+}
+
+}
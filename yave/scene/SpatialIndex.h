@@ -0,0 +1,84 @@
+/*******************************
+Copyright (c) 2016-2020 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_SCENE_SPATIALINDEX_H
+#define YAVE_SCENE_SPATIALINDEX_H
+
+#include <yave/camera/Frustum.h>
+#include <yave/meshes/AABB.h>
+#include <yave/ecs/EntityId.h>
+
+#include <y/math/BVH.h>
+#include <y/core/Result.h>
+
+#include <limits>
+
+namespace yave {
+
+namespace ecs {
+class EntityWorld;
+}
+
+class StaticMesh;
+
+// BVH over the world space bounds of the static meshes of an entity world
+class SpatialIndex : NonCopyable {
+
+	struct Entry {
+		math::BVH::ProxyId proxy = math::BVH::invalid_proxy;
+		const StaticMesh* mesh = nullptr;
+		math::Transform<> transform;
+		AABB aabb;
+		u32 stamp = 0;
+	};
+
+	public:
+		struct RayHit {
+			ecs::EntityIndex index;
+			float distance;
+		};
+
+		SpatialIndex();
+
+		// Only entities whose transform or mesh changed since the previous update are moved in the tree
+		// Returns the number of updated entities
+		usize update(const ecs::EntityWorld& world);
+		void clear();
+
+		usize size() const;
+
+		core::Vector<ecs::EntityIndex> query_box(const AABB& aabb) const;
+		core::Vector<ecs::EntityIndex> query_sphere(const math::Vec3& center, float radius) const;
+		core::Vector<ecs::EntityIndex> query_frustum(const Frustum& frustum) const;
+
+		// Returns the closest entity whose mesh triangles are hit by the ray, candidates come from the BVH
+		// Meshes without a CPU copy of their geometry (see StaticMesh::has_cpu_geometry) are never hit
+		core::Result<RayHit> raycast(const math::Vec3& origin, const math::Vec3& direction, float max_dist = std::numeric_limits<float>::max()) const;
+
+	private:
+		math::BVH _bvh;
+		core::Vector<Entry> _entries;
+		u32 _stamp = 0;
+};
+
+}
+
+#endif // YAVE_SCENE_SPATIALINDEX_H
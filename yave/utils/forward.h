@@ -48,6 +48,7 @@ class CmdBufferDataProxy;
 class CmdBufferPoolBase;
 class CmdBufferRecorder;
 class CmdBufferRegion;
+class CompiledAnimation;
 class ComponentContainerBase;
 class ComponentTypeIndex;
 class ComputeProgram;
@@ -97,6 +98,8 @@ class Framebuffer;
 class Frustum;
 class GBufferPass;
 class GenericAssetPtr;
+class GpuProfiler;
+class GpuTimestamps;
 class GraphicPipeline;
 class IBLProbe;
 class ImageBarrier;